@@ -2,6 +2,8 @@
 #define COLLECTIONS_ALL_H_
 
 #include "collections/channel.h"
+#include "collections/file_sink.h"
+#include "collections/mapped_table.h"
 #include "collections/periodic.h"
 #include "collections/scratch.h"
 #include "collections/stdin.h"
@@ -2,24 +2,30 @@
 #define COLLETIONS_CHANNEL_H_
 
 #include <cstddef>
+#include <cstdint>
 
 #include <algorithm>
 #include <array>
+#include <map>
 #include <set>
+#include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
 
 #include "collections/collection.h"
+#include "collections/collection_stats.h"
 #include "collections/util.h"
+#include "common/hash_util.h"
 #include "common/macros.h"
 #include "common/static_assert.h"
 #include "common/status.h"
 #include "common/tuple_util.h"
 #include "common/type_traits.h"
-#include "zmq_util/socket_cache.h"
+#include "zmq_util/transport.h"
 #include "zmq_util/zmq_util.h"
 
 namespace fluent {
@@ -45,6 +51,30 @@ std::tuple<Ts...> parse_tuple(const std::vector<std::string>& columns) {
 // specifying the ZeroMQ to which the tuple should be sent. For example, if
 // adding the tuple ("inproc://a", 1, 2, 3) will send the tuple ("inproc://a",
 // 1, 2, 3) to the node at address ("inproc//a", 1, 2, 3).
+//
+// Tuples merged into a channel are not sent right away. Instead, they are
+// buffered per destination address and flushed when the channel is ticked.
+// All the tuples sent to a given address during a tick are sent as a single
+// multipart message that looks like this:
+//
+//   msgs[0] = dep node id
+//   msgs[1] = channel id
+//   msgs[2] = dep time of tuple 0
+//   msgs[3] = tuple 0 element 0
+//   ...
+//   msgs[2 + N] = tuple 0 element N - 1
+//   msgs[2 + N + 1] = dep time of tuple 1
+//   msgs[2 + N + 2] = tuple 1 element 0
+//   ...
+//
+// where N is the number of columns in the channel. Note that a batch with a
+// single tuple is laid out exactly like an unbatched message.
+//
+// The channel id is the 64-bit FNV-1a hash of the channel's name, sent as 8
+// little-endian bytes (see `zmq_util::uint64_to_message`). Every node derives
+// the same id from the same channel name, so a receiver can route a batch to
+// its channel with a single table lookup rather than by decoding and comparing
+// channel names.
 template <template <typename> class Pickler, typename T, typename... Ts>
 class Channel : public Collection {
   static_assert(StaticAssert<std::is_same<std::string, T>>::value,
@@ -54,16 +84,20 @@ class Channel : public Collection {
  public:
   Channel(std::size_t id, std::string name,
           std::array<std::string, 1 + sizeof...(Ts)> column_names,
-          zmq_util::SocketCache* socket_cache)
+          zmq_util::Transport* transport)
       : id_(id),
         name_(std::move(name)),
+        channel_id_(Fnv1a64(name_)),
         column_names_(std::move(column_names)),
-        socket_cache_(socket_cache) {}
+        transport_(transport) {}
   DISALLOW_COPY_AND_ASSIGN(Channel);
   DEFAULT_MOVE_AND_ASSIGN(Channel);
 
   const std::string& Name() const { return name_; }
 
+  // The id sent on the wire in place of the channel's name.
+  std::uint64_t ChannelId() const { return channel_id_; }
+
   const std::array<std::string, 1 + sizeof...(Ts)>& ColumnNames() const {
     return column_names_;
   }
@@ -72,22 +106,24 @@ class Channel : public Collection {
     return ts_;
   }
 
+  // See collections/collection_stats.h.
+  const CollectionStats<T, Ts...>& Stats() const { return stats_; }
+  void TrackDistinct() { stats_.TrackDistinct(ts_); }
+
   void Merge(const std::tuple<T, Ts...>& t, std::size_t hash,
              int logical_time_inserted) {
     UNUSED(hash);
 
     using zmq_util::string_to_message;
-    std::vector<zmq::message_t> msgs(3 + 1 + sizeof...(Ts));
-    msgs[0] = string_to_message(ToString(id_));
-    msgs[1] = string_to_message(ToString(name_));
-    msgs[2] = string_to_message(ToString(logical_time_inserted));
-
-    TupleIteri(t, [this, &msgs](std::size_t i, const auto& x) {
-      msgs[i + 3] = zmq_util::string_to_message(this->ToString(x));
+    std::vector<zmq::message_t>& msgs = outbound_[std::get<0>(t)];
+    if (msgs.size() == 0) {
+      msgs.push_back(string_to_message(ToString(id_)));
+      msgs.push_back(zmq_util::uint64_to_message(channel_id_));
+    }
+    msgs.push_back(string_to_message(ToString(logical_time_inserted)));
+    TupleIter(t, [this, &msgs](const auto& x) {
+      msgs.push_back(zmq_util::string_to_message(this->ToString(x)));
     });
-
-    zmq::socket_t& socket = socket_cache_->At(std::get<0>(t));
-    zmq_util::send_msgs(std::move(msgs), &socket);
   }
 
   std::tuple<T, Ts...> Parse(const std::vector<std::string>& columns) const {
@@ -96,16 +132,34 @@ class Channel : public Collection {
 
   void Receive(const std::tuple<T, Ts...>& t, std::size_t hash,
                int logical_time_inserted) {
-    MergeCollectionTuple(t, hash, logical_time_inserted, &ts_);
+    auto merged = MergeCollectionTuple(t, hash, logical_time_inserted, &ts_);
+    stats_.RecordMerge(merged.first->first, merged.second);
+  }
+
+  void Receive(std::tuple<T, Ts...>&& t, std::size_t hash,
+               int logical_time_inserted) {
+    auto merged =
+        MergeCollectionTuple(std::move(t), hash, logical_time_inserted, &ts_);
+    stats_.RecordMerge(merged.first->first, merged.second);
   }
 
   std::map<std::tuple<T, Ts...>, CollectionTupleIds> Tick() {
+    Flush();
     std::map<std::tuple<T, Ts...>, CollectionTupleIds> ts;
     std::swap(ts, ts_);
+    stats_.Tick(ts_);
     return ts;
   }
 
  private:
+  // Send every buffered batch to its destination and clear `outbound_`.
+  void Flush() {
+    for (auto& pair : outbound_) {
+      transport_->Send(pair.first, std::move(pair.second));
+    }
+    outbound_.clear();
+  }
+
   template <typename U>
   std::string ToString(const U& x) {
     return Pickler<typename std::decay<U>::type>().Dump(x);
@@ -113,12 +167,20 @@ class Channel : public Collection {
 
   const std::size_t id_;
   const std::string name_;
+  const std::uint64_t channel_id_;
   const std::array<std::string, 1 + sizeof...(Ts)> column_names_;
   std::map<std::tuple<T, Ts...>, CollectionTupleIds> ts_;
+  CollectionStats<T, Ts...> stats_;
+
+  // The batches of tuples that have been merged into the channel since the
+  // last tick, keyed by destination address. See the class comment above for
+  // the layout of each batch.
+  std::map<std::string, std::vector<zmq::message_t>> outbound_;
 
-  // Whenever a tuple with address `a` is added to a Channel, the socket
-  // associated with `a` in `socket_cache_` is used to send the tuple.
-  zmq_util::SocketCache* socket_cache_;
+  // Whenever a batch of tuples with address `a` is flushed, it is sent to `a`
+  // with `transport_`, which is usually a SocketCache (see
+  // zmq_util/transport.h).
+  zmq_util::Transport* transport_;
 
   FRIEND_TEST(Channel, TickClearsChannel);
 };
@@ -11,6 +11,7 @@
 #include "gtest/gtest.h"
 #include "zmq.hpp"
 
+#include "common/hash_util.h"
 #include "common/mock_pickler.h"
 #include "zmq_util/socket_cache.h"
 #include "zmq_util/zmq_util.h"
@@ -41,23 +42,30 @@ TEST(Channel, Merge) {
   c.Merge({a_address, 1}, 1, 0);
   c.Merge({b_address, 2}, 2, 0);
   c.Merge({a_address, 3}, 3, 0);
-  c.Merge({b_address, 4}, 4, 0);
-  c.Merge({a_address, 5}, 5, 0);
-  c.Merge({b_address, 6}, 6, 0);
+  c.Merge({b_address, 4}, 4, 1);
+  c.Merge({a_address, 5}, 5, 1);
+  c.Merge({b_address, 6}, 6, 1);
   expected = {};
   EXPECT_EQ(c.Get(), expected);
+  c.Tick();
 
-  for (int i = 1; i <= 6; ++i) {
+  // Every address receives a single batch with three tuples.
+  for (int i = 1; i <= 2; ++i) {
     zmq::socket_t* recipient = i % 2 == 0 ? &b : &a;
     const std::string& address = i % 2 == 0 ? b_address : a_address;
     std::vector<zmq::message_t> messages = zmq_util::recv_msgs(recipient);
 
-    ASSERT_EQ(messages.size(), static_cast<std::size_t>(5));
+    ASSERT_EQ(messages.size(), static_cast<std::size_t>(2 + 3 * 3));
     EXPECT_EQ("42", zmq_util::message_to_string(messages[0]));
-    EXPECT_EQ("c", zmq_util::message_to_string(messages[1]));
-    EXPECT_EQ("0", zmq_util::message_to_string(messages[2]));
-    EXPECT_EQ(address, zmq_util::message_to_string(messages[3]));
-    EXPECT_EQ(std::to_string(i), zmq_util::message_to_string(messages[4]));
+    EXPECT_EQ(Fnv1a64("c"), zmq_util::message_to_uint64(messages[1]));
+    for (int j = 0; j < 3; ++j) {
+      const int x = i + 2 * j;
+      const std::string time = x <= 3 ? "0" : "1";
+      EXPECT_EQ(time, zmq_util::message_to_string(messages[2 + 3 * j]));
+      EXPECT_EQ(address, zmq_util::message_to_string(messages[3 + 3 * j]));
+      EXPECT_EQ(std::to_string(x),
+                zmq_util::message_to_string(messages[4 + 3 * j]));
+    }
   }
 }
 
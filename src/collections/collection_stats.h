@@ -0,0 +1,179 @@
+#ifndef COLLECTIONS_COLLECTION_STATS_H_
+#define COLLECTIONS_COLLECTION_STATS_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "collections/collection_tuple_ids.h"
+#include "common/hash_util.h"
+#include "common/hyper_log_log.h"
+#include "common/macros.h"
+#include "common/tuple_util.h"
+
+namespace fluent {
+
+// CollectionStats are the statistics that a collection with columns `Ts...`
+// keeps about its tuples for the query optimizer (see ra/cardinality.h):
+//
+//   - the number of tuples in the collection,
+//   - an estimate of the number of distinct values in every column, and
+//   - the number of tuples inserted into and deleted from the collection
+//     during the current and the previous tick (i.e. the collection's delta),
+//     and the number of tuples ever deleted from the collection.
+//
+// Keeping the distinct estimates up to date costs a hash per column of every
+// inserted tuple, and most collections are never read by a plan that needs
+// them, so they are only kept once the owning collection's `TrackDistinct` is
+// called. A FluentExecutor does so for every collection read by a rule whose
+// plan is chosen by cost (see ra/cardinality.h). Until then, every value is
+// assumed to be distinct. Distinct values are estimated with a small
+// HyperLogLog per column, which can't forget deleted values, so the estimates
+// are rebuilt from scratch once enough tuples have been deleted since the last
+// rebuild.
+template <typename... Ts>
+class CollectionStats {
+ public:
+  CollectionStats()
+      : num_rows_(0),
+        num_inserted_(0),
+        num_deleted_(0),
+        num_inserted_last_tick_(0),
+        num_deleted_last_tick_(0),
+        num_deleted_total_(0),
+        num_deleted_since_rebuild_(0),
+        track_distinct_(false) {}
+  DISALLOW_COPY_AND_ASSIGN(CollectionStats);
+  DEFAULT_MOVE_AND_ASSIGN(CollectionStats);
+
+  std::size_t NumRows() const { return num_rows_; }
+
+  // The estimated number of distinct values in column `column`, which is
+  // between 1 and `NumRows()` (or 0 if the collection is empty). If distinct
+  // values aren't tracked, the estimate is `NumRows()`.
+  double NumDistinct(std::size_t column) const {
+    CHECK_LT(column, sizeof...(Ts));
+    if (num_rows_ == 0) {
+      return 0;
+    }
+    if (!track_distinct_) {
+      return static_cast<double>(num_rows_);
+    }
+    const double estimate = std::max(distinct_[column].Estimate(), 1.0);
+    return std::min(estimate, static_cast<double>(num_rows_));
+  }
+
+  std::size_t NumInsertedThisTick() const { return num_inserted_; }
+  std::size_t NumDeletedThisTick() const { return num_deleted_; }
+  std::size_t NumInsertedLastTick() const { return num_inserted_last_tick_; }
+  std::size_t NumDeletedLastTick() const { return num_deleted_last_tick_; }
+
+  // The number of tuples deleted from the collection since it was created,
+  // including the tuples that a collection like a Scratch or a Channel drops
+  // at the end of every tick. If it hasn't changed, every tuple that was in
+  // the collection before is still in it.
+  std::size_t NumDeletedTotal() const { return num_deleted_total_; }
+
+  bool TracksDistinct() const { return track_distinct_; }
+
+  // Start estimating the number of distinct values in every column of the
+  // collection, which currently contains `ts`.
+  template <typename Compare, typename Allocator>
+  void TrackDistinct(const std::map<std::tuple<Ts...>, CollectionTupleIds,
+                                    Compare, Allocator>& ts) {
+    if (track_distinct_) {
+      return;
+    }
+    // 256 one-byte registers per column, for a standard error of 6.5%.
+    const int precision = 8;
+    for (std::size_t i = 0; i < sizeof...(Ts); ++i) {
+      distinct_.emplace_back(precision);
+    }
+    for (const auto& pair : ts) {
+      AddToSketches(pair.first);
+    }
+    num_deleted_since_rebuild_ = 0;
+    track_distinct_ = true;
+  }
+
+  // Record that `t` was merged into the collection. `inserted` is true if `t`
+  // wasn't already in the collection (see `MergeCollectionTuple`).
+  void RecordMerge(const std::tuple<Ts...>& t, bool inserted) {
+    if (!inserted) {
+      return;
+    }
+    num_rows_++;
+    num_inserted_++;
+    if (track_distinct_) {
+      AddToSketches(t);
+    }
+  }
+
+  // Record that a tuple was deleted from the collection.
+  void RecordDelete() {
+    CHECK_GT(num_rows_, static_cast<std::size_t>(0));
+    num_rows_--;
+    num_deleted_++;
+    num_deleted_total_++;
+  }
+
+  // Record the end of a tick, after which the collection contains `ts`.
+  template <typename Compare, typename Allocator>
+  void Tick(const std::map<std::tuple<Ts...>, CollectionTupleIds, Compare,
+                           Allocator>& ts) {
+    num_inserted_last_tick_ = num_inserted_;
+    num_deleted_last_tick_ = num_deleted_;
+    if (num_rows_ > ts.size()) {
+      num_deleted_total_ += num_rows_ - ts.size();
+    }
+    num_inserted_ = 0;
+    num_deleted_ = 0;
+    num_rows_ = ts.size();
+    if (!track_distinct_) {
+      return;
+    }
+
+    // Rebuilding the sketches takes time linear in the size of the
+    // collection, so we only do so once the number of deleted tuples is a
+    // constant fraction of the collection's size.
+    num_deleted_since_rebuild_ += num_deleted_last_tick_;
+    if (ts.size() == 0 || 2 * num_deleted_since_rebuild_ > ts.size()) {
+      for (HyperLogLog& distinct : distinct_) {
+        distinct.Reset();
+      }
+      for (const auto& pair : ts) {
+        AddToSketches(pair.first);
+      }
+      num_deleted_since_rebuild_ = 0;
+    }
+  }
+
+ private:
+  void AddToSketches(const std::tuple<Ts...>& t) {
+    TupleIteri(t, [this](std::size_t i, const auto& x) {
+      using column_type = typename std::decay<decltype(x)>::type;
+      distinct_[i].Add(Mix64(Hash<column_type>()(x)));
+    });
+  }
+
+  std::size_t num_rows_;
+  // Empty unless `track_distinct_`.
+  std::vector<HyperLogLog> distinct_;
+  std::size_t num_inserted_;
+  std::size_t num_deleted_;
+  std::size_t num_inserted_last_tick_;
+  std::size_t num_deleted_last_tick_;
+  std::size_t num_deleted_total_;
+  std::size_t num_deleted_since_rebuild_;
+  bool track_distinct_;
+};
+
+}  // namespace fluent
+
+#endif  // COLLECTIONS_COLLECTION_STATS_H_
@@ -0,0 +1,147 @@
+#include "collections/collection_stats.h"
+
+#include <cstddef>
+
+#include <map>
+#include <string>
+#include <tuple>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+#include "collections/collection_tuple_ids.h"
+
+namespace fluent {
+
+using Map = std::map<std::tuple<int, std::string>, CollectionTupleIds>;
+
+TEST(CollectionStats, Empty) {
+  CollectionStats<int, std::string> stats;
+  EXPECT_EQ(stats.NumRows(), 0u);
+  EXPECT_EQ(stats.NumDistinct(0), 0.0);
+  EXPECT_EQ(stats.NumDistinct(1), 0.0);
+  EXPECT_EQ(stats.NumInsertedThisTick(), 0u);
+  EXPECT_EQ(stats.NumDeletedThisTick(), 0u);
+}
+
+TEST(CollectionStats, DistinctValuesAreNotTrackedByDefault) {
+  CollectionStats<int, std::string> stats;
+  Map ts = {{{1, "a"}, {1, {0}}}, {{2, "a"}, {2, {0}}}};
+  stats.RecordMerge({1, "a"}, true);
+  stats.RecordMerge({2, "a"}, true);
+  EXPECT_FALSE(stats.TracksDistinct());
+  EXPECT_EQ(stats.NumDistinct(0), 2.0);
+  EXPECT_EQ(stats.NumDistinct(1), 2.0);
+
+  // Tracking starts from the collection's current contents.
+  stats.TrackDistinct(ts);
+  EXPECT_TRUE(stats.TracksDistinct());
+  EXPECT_NEAR(stats.NumDistinct(0), 2.0, 0.1);
+  EXPECT_NEAR(stats.NumDistinct(1), 1.0, 0.1);
+  stats.RecordMerge({3, "b"}, true);
+  EXPECT_NEAR(stats.NumDistinct(1), 2.0, 0.1);
+}
+
+TEST(CollectionStats, DuplicatesAreNotCounted) {
+  CollectionStats<int, std::string> stats;
+  stats.TrackDistinct(Map());
+  stats.RecordMerge({1, "a"}, true);
+  stats.RecordMerge({1, "a"}, false);
+  stats.RecordMerge({2, "a"}, true);
+  EXPECT_EQ(stats.NumRows(), 2u);
+  EXPECT_EQ(stats.NumInsertedThisTick(), 2u);
+  EXPECT_NEAR(stats.NumDistinct(0), 2.0, 0.1);
+  EXPECT_NEAR(stats.NumDistinct(1), 1.0, 0.1);
+}
+
+TEST(CollectionStats, DistinctEstimates) {
+  CollectionStats<int, std::string> stats;
+  stats.TrackDistinct(Map());
+  for (int i = 0; i < 10 * 1000; ++i) {
+    stats.RecordMerge({i, std::to_string(i % 100)}, true);
+  }
+  EXPECT_EQ(stats.NumRows(), 10u * 1000);
+  EXPECT_NEAR(stats.NumDistinct(0), 10.0 * 1000, 2.0 * 1000);
+  EXPECT_NEAR(stats.NumDistinct(1), 100.0, 20.0);
+}
+
+TEST(CollectionStats, TickRecordsDelta) {
+  CollectionStats<int, std::string> stats;
+  Map ts = {{{1, "a"}, {1, {0}}}, {{2, "b"}, {2, {0}}}};
+  stats.RecordMerge({1, "a"}, true);
+  stats.RecordMerge({2, "b"}, true);
+  stats.Tick(ts);
+  EXPECT_EQ(stats.NumInsertedLastTick(), 2u);
+  EXPECT_EQ(stats.NumDeletedLastTick(), 0u);
+  EXPECT_EQ(stats.NumInsertedThisTick(), 0u);
+
+  stats.RecordDelete();
+  EXPECT_EQ(stats.NumRows(), 1u);
+  EXPECT_EQ(stats.NumDeletedThisTick(), 1u);
+  ts.erase(std::make_tuple(1, std::string("a")));
+  stats.Tick(ts);
+  EXPECT_EQ(stats.NumInsertedLastTick(), 0u);
+  EXPECT_EQ(stats.NumDeletedLastTick(), 1u);
+  EXPECT_EQ(stats.NumRows(), 1u);
+}
+
+TEST(CollectionStats, TickRebuildsAfterManyDeletes) {
+  CollectionStats<int, std::string> stats;
+  stats.TrackDistinct(Map());
+  Map ts;
+  for (int i = 0; i < 100; ++i) {
+    stats.RecordMerge({i, "a"}, true);
+    ts[std::make_tuple(i, std::string("a"))] = {0, {0}};
+  }
+  stats.Tick(ts);
+  EXPECT_NEAR(stats.NumDistinct(0), 100.0, 10.0);
+
+  // Delete all but 10 tuples. The estimates are rebuilt.
+  for (int i = 10; i < 100; ++i) {
+    stats.RecordDelete();
+    ts.erase(std::make_tuple(i, std::string("a")));
+  }
+  stats.Tick(ts);
+  EXPECT_EQ(stats.NumRows(), 10u);
+  EXPECT_NEAR(stats.NumDistinct(0), 10.0, 1.0);
+}
+
+TEST(CollectionStats, TickWithEmptyCollectionResets) {
+  CollectionStats<int, std::string> stats;
+  stats.TrackDistinct(Map());
+  stats.RecordMerge({1, "a"}, true);
+  stats.Tick(Map());
+  EXPECT_EQ(stats.NumRows(), 0u);
+  EXPECT_EQ(stats.NumDistinct(0), 0.0);
+  stats.RecordMerge({2, "b"}, true);
+  EXPECT_NEAR(stats.NumDistinct(0), 1.0, 0.1);
+}
+
+TEST(CollectionStats, NumDeletedTotal) {
+  CollectionStats<int, std::string> stats;
+  Map ts = {{{1, "a"}, {1, {0}}}, {{2, "b"}, {2, {0}}}};
+  stats.RecordMerge({1, "a"}, true);
+  stats.RecordMerge({2, "b"}, true);
+  stats.Tick(ts);
+  EXPECT_EQ(stats.NumDeletedTotal(), 0u);
+
+  // An explicit delete.
+  stats.RecordDelete();
+  ts.erase(std::make_tuple(1, std::string("a")));
+  stats.Tick(ts);
+  EXPECT_EQ(stats.NumDeletedTotal(), 1u);
+
+  // A collection that drops its tuples at the end of a tick.
+  stats.RecordMerge({3, "c"}, true);
+  stats.Tick(Map());
+  EXPECT_EQ(stats.NumDeletedTotal(), 3u);
+  EXPECT_EQ(stats.NumDeletedLastTick(), 0u);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
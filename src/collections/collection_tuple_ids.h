@@ -3,8 +3,7 @@
 
 #include <cstddef>
 
-#include <set>
-
+#include "collections/logical_times.h"
 #include "common/collection_util.h"
 #include "common/tuple_util.h"
 
@@ -12,14 +11,14 @@ namespace fluent {
 
 struct CollectionTupleIds {
   std::size_t hash;
-  std::set<int> logical_times_inserted;
+  LogicalTimes logical_times_inserted;
 };
 
 namespace {
 
-std::tuple<std::size_t, const std::set<int>&> ToTuple(
+std::tuple<std::size_t, const LogicalTimes&> ToTuple(
     const CollectionTupleIds& ids) {
-  return std::tuple<std::size_t, const std::set<int>&>(
+  return std::tuple<std::size_t, const LogicalTimes&>(
       ids.hash, ids.logical_times_inserted);
 }
 
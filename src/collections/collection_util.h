@@ -12,16 +12,18 @@ namespace fluent {
 // `CollectionTypes` returns the types of the columns of a collection.
 //
 //   CollectionTypes<Table<Ts...>> == <Ts...>
+//   CollectionTypes<MappedTable<Ts...>> == <Ts...>
 //   CollectionTypes<Scratch<Ts...>> == <Ts...>
 //   CollectionTypes<Channel<Pickler, Ts...>> == <Ts...>
 //   CollectionTypes<Periodic<C>> == <Periodic<C>::id, time_point<C>>
 //   CollectionTypes<Stdin> == <std::string>
 //   CollectionTypes<Stdout> == <std::string>
+//   CollectionTypes<FileSink<Pickler, Ts...>> == <Ts...>
 template <typename Collection>
 struct CollectionTypes;
 
-template <typename... Ts>
-struct CollectionTypes<Table<Ts...>> {
+template <template <typename> class Allocator, typename... Ts>
+struct CollectionTypes<BasicTable<Allocator, Ts...>> {
   using type = TypeList<Ts...>;
 };
 
@@ -45,6 +47,11 @@ struct CollectionTypes<Stdout> {
   using type = TypeList<std::string>;
 };
 
+template <template <typename> class Pickler, typename... Ts>
+struct CollectionTypes<FileSink<Pickler, Ts...>> {
+  using type = TypeList<Ts...>;
+};
+
 template <typename Clock>
 struct CollectionTypes<Periodic<Clock>> {
   using id = typename Periodic<Clock>::id;
@@ -86,8 +93,9 @@ enum class CollectionType { TABLE, SCRATCH, CHANNEL, STDIN, STDOUT, PERIODIC };
 template <typename Collection>
 struct GetCollectionType;
 
-template <typename... Ts>
-struct GetCollectionType<Table<Ts...>>
+// A MappedTable behaves exactly like a Table.
+template <template <typename> class Allocator, typename... Ts>
+struct GetCollectionType<BasicTable<Allocator, Ts...>>
     : public std::integral_constant<CollectionType, CollectionType::TABLE> {};
 
 template <typename... Ts>
@@ -106,6 +114,11 @@ template <>
 struct GetCollectionType<Stdout>
     : public std::integral_constant<CollectionType, CollectionType::STDOUT> {};
 
+// A FileSink behaves exactly like Stdout.
+template <template <typename> class Pickler, typename... Ts>
+struct GetCollectionType<FileSink<Pickler, Ts...>>
+    : public std::integral_constant<CollectionType, CollectionType::STDOUT> {};
+
 template <typename Clock>
 struct GetCollectionType<Periodic<Clock>>
     : public std::integral_constant<CollectionType, CollectionType::PERIODIC> {
@@ -69,6 +69,13 @@ TEST(CollectionUtil, CollectionTypes) {
                     TypeList<std::string>>::value,  //
                 "");
 
+  // FileSinks.
+  static_assert(
+      std::is_same<                                                      //
+          CollectionTypes<FileSink<MockPickler, int, std::string>>::type,  //
+          TypeList<int, std::string>>::value,                            //
+      "");
+
   // Periodic.
   static_assert(std::is_same<                                    //
                     CollectionTypes<Periodic<MockClock>>::type,  //
@@ -94,6 +101,8 @@ TEST(CollectionUtil, GetCollectionType) {
 
   EXPECT_EQ(CollectionType::STDIN, (GetCollectionType<Stdin>::value));
   EXPECT_EQ(CollectionType::STDOUT, (GetCollectionType<Stdout>::value));
+  EXPECT_EQ(CollectionType::STDOUT,
+            (GetCollectionType<FileSink<MockPickler, int>>::value));
   EXPECT_EQ(CollectionType::PERIODIC,
             (GetCollectionType<Periodic<MockClock>>::value));
 }
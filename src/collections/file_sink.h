@@ -0,0 +1,131 @@
+#ifndef COLLECTIONS_FILE_SINK_H_
+#define COLLECTIONS_FILE_SINK_H_
+
+#include <cstddef>
+
+#include <array>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "fmt/format.h"
+#include "glog/logging.h"
+
+#include "collections/collection.h"
+#include "collections/collection_tuple_ids.h"
+#include "common/buffered_writer.h"
+#include "common/macros.h"
+#include "common/status.h"
+#include "common/status_or.h"
+#include "common/tuple_file.h"
+
+namespace fluent {
+
+// See `FileSink`.
+constexpr std::size_t kFileSinkFlushThreshold = 1024 * 1024;
+
+// A FileSink is like Stdout (see collections/stdout.h), except that it has
+// arbitrary columns and writes the tuples merged into it to a file instead of
+// to std::cout. Every tuple is laid out in format `format` (see `AppendTuple`
+// in common/tuple_file.h), so a FileSink can, for example, log tuples as JSON
+// lines for some other program to consume, or save tuples as binary records
+// for `FluentExecutor::BulkLoad` to load into a table later.
+//
+//   auto sink = FileSink<MockPickler, int, std::string>::Make(
+//       "log", {{"x", "y"}}, "/tmp/log.json", TupleFileFormat::JSON_LINES,
+//       false).ConsumeValueOrDie();
+//   sink->Merge({1, "a"}, 0x0, 0);
+//   sink->Tick(); // {"x":1,"y":"a"}\n is written to /tmp/log.json.
+//
+// Like Stdout, a FileSink buffers its output and writes it at the end of
+// every tick, or sooner once `kFileSinkFlushThreshold` bytes are buffered. If
+// `background` is true, the output is written by a background thread.
+template <template <typename> class Pickler, typename... Ts>
+class FileSink : public Collection {
+ public:
+  // Create a FileSink which writes to a new file at `path`, replacing any
+  // file already there.
+  static WARN_UNUSED StatusOr<std::unique_ptr<FileSink>> Make(
+      std::string name, std::array<std::string, sizeof...(Ts)> column_names,
+      const std::string& path, TupleFileFormat format, bool background) {
+    auto file = std::make_unique<std::ofstream>(
+        path, std::ios::binary | std::ios::trunc);
+    if (!*file) {
+      return Status(ErrorCode::INVALID_ARGUMENT,
+                    fmt::format("Unable to open file sink file {}.", path));
+    }
+    return std::unique_ptr<FileSink>(new FileSink(
+        std::move(name), std::move(column_names), std::move(file), format,
+        background));
+  }
+
+  DISALLOW_COPY_AND_ASSIGN(FileSink);
+  DEFAULT_MOVE_AND_ASSIGN(FileSink);
+
+  const std::string& Name() const { return name_; }
+
+  const std::array<std::string, sizeof...(Ts)>& ColumnNames() const {
+    return column_names_;
+  }
+
+  void Merge(const std::tuple<Ts...>& t, std::size_t hash,
+             int logical_time_inserted) {
+    UNUSED(hash);
+    UNUSED(logical_time_inserted);
+    Write(t);
+    writer_->MaybeFlush();
+  }
+
+  void DeferredMerge(const std::tuple<Ts...>& t, std::size_t hash,
+                     int logical_time_inserted) {
+    UNUSED(hash);
+    UNUSED(logical_time_inserted);
+    deferred_merge_.insert(t);
+  }
+
+  std::map<std::tuple<Ts...>, CollectionTupleIds> Tick() {
+    for (const std::tuple<Ts...>& t : deferred_merge_) {
+      Write(t);
+    }
+    deferred_merge_.clear();
+    writer_->Flush();
+    return {};
+  }
+
+  // Write out all buffered output and wait for it to be written.
+  void Sync() { writer_->Sync(); }
+
+ private:
+  FileSink(std::string name,
+           std::array<std::string, sizeof...(Ts)> column_names,
+           std::unique_ptr<std::ofstream> file, TupleFileFormat format,
+           bool background)
+      : name_(std::move(name)),
+        column_names_(std::move(column_names)),
+        format_(format),
+        file_(std::move(file)),
+        writer_(std::make_unique<BufferedWriter>(
+            file_.get(), kFileSinkFlushThreshold, background)) {}
+
+  void Write(const std::tuple<Ts...>& t) {
+    AppendTuple<Pickler>(format_, column_names_, t, writer_->Buffer());
+  }
+
+  std::string name_;
+  std::array<std::string, sizeof...(Ts)> column_names_;
+  TupleFileFormat format_;
+
+  // `writer_` writes to `file_`, so it's declared after `file_` to be
+  // destroyed, and to write out its buffered output, before `file_` is.
+  std::unique_ptr<std::ofstream> file_;
+  std::unique_ptr<BufferedWriter> writer_;
+  std::set<std::tuple<Ts...>> deferred_merge_;
+};
+
+}  // namespace fluent
+
+#endif  // COLLECTIONS_FILE_SINK_H_
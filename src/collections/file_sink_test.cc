@@ -0,0 +1,100 @@
+#include "collections/file_sink.h"
+
+#include <cstddef>
+
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+#include "common/mock_pickler.h"
+#include "common/status.h"
+#include "common/status_or.h"
+#include "common/tuple_file.h"
+
+namespace fluent {
+namespace {
+
+using Tuple = std::tuple<int, std::string>;
+using Sink = FileSink<MockPickler, int, std::string>;
+
+const char kPath[] = "/tmp/fluent_file_sink_test";
+
+std::unique_ptr<Sink> MakeSink(TupleFileFormat format,
+                               bool background = false) {
+  StatusOr<std::unique_ptr<Sink>> sink =
+      Sink::Make("sink", {{"x", "y"}}, kPath, format, background);
+  CHECK(sink.ok()) << sink.status();
+  return sink.ConsumeValueOrDie();
+}
+
+std::string ReadFile() {
+  std::ifstream f(kPath, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(f),
+                     std::istreambuf_iterator<char>());
+}
+
+}  // namespace
+
+TEST(FileSink, Csv) {
+  std::unique_ptr<Sink> sink = MakeSink(TupleFileFormat::CSV);
+  EXPECT_EQ(sink->Name(), "sink");
+  sink->Merge({1, "a"}, 0x0, 0);
+  sink->DeferredMerge({3, "c"}, 0x0, 0);
+  sink->DeferredMerge({2, "b"}, 0x0, 0);
+  EXPECT_EQ(ReadFile(), "");
+  sink->Tick();
+  EXPECT_EQ(ReadFile(), "1,a\n2,b\n3,c\n");
+  sink->Merge({4, "d"}, 0x0, 0);
+  sink->Tick();
+  EXPECT_EQ(ReadFile(), "1,a\n2,b\n3,c\n4,d\n");
+}
+
+TEST(FileSink, JsonLines) {
+  std::unique_ptr<Sink> sink = MakeSink(TupleFileFormat::JSON_LINES);
+  sink->Merge({1, "a\nb"}, 0x0, 0);
+  sink->Tick();
+  EXPECT_EQ(ReadFile(), R"({"x":1,"y":"a\nb"})" + std::string("\n"));
+}
+
+TEST(FileSink, RecordsCanBeRead) {
+  {
+    std::unique_ptr<Sink> sink = MakeSink(TupleFileFormat::RECORDS, true);
+    for (int i = 0; i < 1000; ++i) {
+      sink->Merge({i % 100, "a,\nb"}, 0x0, 0);
+      if (i % 10 == 0) {
+        sink->Tick();
+      }
+    }
+  }
+
+  std::vector<Tuple> expected;
+  for (int i = 0; i < 100; ++i) {
+    expected.push_back({i, "a,\nb"});
+  }
+  StatusOr<std::vector<Tuple>> ts =
+      ReadSortedTuples<MockPickler, int, std::string>(
+          kPath, TupleFileFormat::RECORDS, 2);
+  ASSERT_TRUE(ts.ok()) << ts.status();
+  EXPECT_EQ(ts.ValueOrDie(), expected);
+}
+
+TEST(FileSink, UnopenableFile) {
+  StatusOr<std::unique_ptr<Sink>> sink =
+      Sink::Make("sink", {{"x", "y"}}, "/tmp/does/not/exist/sink",
+                 TupleFileFormat::CSV, false);
+  EXPECT_EQ(sink.status().error_code(), ErrorCode::INVALID_ARGUMENT);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,170 @@
+#ifndef COLLECTIONS_LOGICAL_TIMES_H_
+#define COLLECTIONS_LOGICAL_TIMES_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace fluent {
+
+// LogicalTimes is the sorted set of logical times at which a tuple was
+// inserted into a collection (see CollectionTupleIds). Every tuple stored in a
+// collection carries one, so its size matters. A `std::set<int>` takes 48
+// bytes plus a 40 byte heap-allocated node for every time, but almost every
+// tuple is inserted at exactly one logical time. A LogicalTimes stores a
+// single time inline, without allocating, and only spills over into a sorted
+// heap-allocated vector when a second time is inserted. It takes 16 bytes.
+//
+// LogicalTimes implements the subset of the `std::set<int>` interface that the
+// collections use, and iterating over it yields its times in increasing order.
+//
+//   LogicalTimes times(2); // {2}, no allocation
+//   times.insert(1);       // {1, 2}, allocates a vector
+//   times.insert(2);       // {1, 2}, returns false
+//   for (int time : times) { ... }
+class LogicalTimes {
+ public:
+  using value_type = int;
+  using const_iterator = const int*;
+  using iterator = const_iterator;
+
+  // The empty set of times.
+  LogicalTimes() : time_(0), has_time_(false) {}
+
+  // The set {time}.
+  explicit LogicalTimes(int time) : time_(time), has_time_(true) {}
+
+  LogicalTimes(std::initializer_list<int> times) : LogicalTimes() {
+    insert(times.begin(), times.end());
+  }
+
+  LogicalTimes(const LogicalTimes& other)
+      : time_(other.time_), has_time_(other.has_time_) {
+    if (other.overflow_ != nullptr) {
+      overflow_ = std::make_unique<std::vector<int>>(*other.overflow_);
+    }
+  }
+
+  LogicalTimes& operator=(const LogicalTimes& other) {
+    if (this != &other) {
+      LogicalTimes copy(other);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  LogicalTimes(LogicalTimes&&) = default;
+  LogicalTimes& operator=(LogicalTimes&&) = default;
+
+  // Insert `time`. Returns whether `time` was not already in the set.
+  bool insert(int time) {
+    if (overflow_ != nullptr) {
+      auto iter = std::lower_bound(overflow_->begin(), overflow_->end(), time);
+      if (iter != overflow_->end() && *iter == time) {
+        return false;
+      }
+      overflow_->insert(iter, time);
+      return true;
+    }
+
+    if (!has_time_) {
+      time_ = time;
+      has_time_ = true;
+      return true;
+    }
+
+    if (time == time_) {
+      return false;
+    }
+    overflow_ = std::make_unique<std::vector<int>>();
+    overflow_->reserve(2);
+    overflow_->push_back(std::min(time, time_));
+    overflow_->push_back(std::max(time, time_));
+    return true;
+  }
+
+  // Insert every time in the range [first, last).
+  template <typename Iterator>
+  void insert(Iterator first, Iterator last) {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  std::size_t count(int time) const {
+    return std::binary_search(begin(), end(), time) ? 1 : 0;
+  }
+
+  std::size_t size() const {
+    if (overflow_ != nullptr) {
+      return overflow_->size();
+    }
+    return has_time_ ? 1 : 0;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  // The times are stored contiguously, either in `time_` or in `overflow_`,
+  // so iterators are pointers.
+  const_iterator begin() const {
+    return overflow_ != nullptr ? overflow_->data() : &time_;
+  }
+
+  const_iterator end() const { return begin() + size(); }
+
+ private:
+  // If `overflow_` is null, the set is {`time_`} if `has_time_` is true and
+  // empty otherwise. If `overflow_` is not null, the set is `*overflow_`, a
+  // sorted vector of at least two distinct times, and `time_` and `has_time_`
+  // are ignored.
+  int time_;
+  bool has_time_;
+  std::unique_ptr<std::vector<int>> overflow_;
+};
+
+inline bool operator==(const LogicalTimes& lhs, const LogicalTimes& rhs) {
+  return lhs.size() == rhs.size() &&
+         std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+inline bool operator!=(const LogicalTimes& lhs, const LogicalTimes& rhs) {
+  return !(lhs == rhs);
+}
+
+inline bool operator<(const LogicalTimes& lhs, const LogicalTimes& rhs) {
+  return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+                                      rhs.end());
+}
+
+inline bool operator<=(const LogicalTimes& lhs, const LogicalTimes& rhs) {
+  return !(rhs < lhs);
+}
+
+inline bool operator>(const LogicalTimes& lhs, const LogicalTimes& rhs) {
+  return rhs < lhs;
+}
+
+inline bool operator>=(const LogicalTimes& lhs, const LogicalTimes& rhs) {
+  return !(lhs < rhs);
+}
+
+// Formatted like a `std::set<int>`: `{1, 2, 3}`.
+inline std::ostream& operator<<(std::ostream& out, const LogicalTimes& times) {
+  out << "{";
+  for (auto iter = times.begin(); iter != times.end(); ++iter) {
+    if (iter != times.begin()) {
+      out << ", ";
+    }
+    out << *iter;
+  }
+  out << "}";
+  return out;
+}
+
+}  // namespace fluent
+
+#endif  // COLLECTIONS_LOGICAL_TIMES_H_
@@ -0,0 +1,101 @@
+#include "collections/logical_times.h"
+
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace fluent {
+namespace {
+
+std::vector<int> ToVector(const LogicalTimes& times) {
+  return std::vector<int>(times.begin(), times.end());
+}
+
+}  // namespace
+
+TEST(LogicalTimes, Empty) {
+  LogicalTimes times;
+  EXPECT_TRUE(times.empty());
+  EXPECT_EQ(times.size(), 0u);
+  EXPECT_EQ(times.begin(), times.end());
+  EXPECT_EQ(times.count(0), 0u);
+}
+
+TEST(LogicalTimes, SingleTime) {
+  LogicalTimes times(42);
+  EXPECT_FALSE(times.empty());
+  EXPECT_EQ(times.size(), 1u);
+  EXPECT_EQ(times.count(42), 1u);
+  EXPECT_EQ(times.count(0), 0u);
+  EXPECT_EQ(ToVector(times), std::vector<int>({42}));
+  EXPECT_FALSE(times.insert(42));
+  EXPECT_EQ(times.size(), 1u);
+}
+
+TEST(LogicalTimes, InsertKeepsTimesSortedAndUnique) {
+  LogicalTimes times;
+  EXPECT_TRUE(times.insert(3));
+  EXPECT_TRUE(times.insert(1));
+  EXPECT_TRUE(times.insert(2));
+  EXPECT_FALSE(times.insert(1));
+  EXPECT_TRUE(times.insert(0));
+  EXPECT_FALSE(times.insert(3));
+  EXPECT_EQ(ToVector(times), std::vector<int>({0, 1, 2, 3}));
+  EXPECT_EQ(times.count(2), 1u);
+  EXPECT_EQ(times.count(4), 0u);
+
+  LogicalTimes more = {5, 2, 4};
+  times.insert(more.begin(), more.end());
+  EXPECT_EQ(ToVector(times), std::vector<int>({0, 1, 2, 3, 4, 5}));
+}
+
+TEST(LogicalTimes, CopyAndMove) {
+  LogicalTimes single(1);
+  LogicalTimes many = {1, 2, 3};
+
+  LogicalTimes single_copy = single;
+  LogicalTimes many_copy = many;
+  many_copy.insert(4);
+  EXPECT_EQ(single_copy, single);
+  EXPECT_EQ(ToVector(many), std::vector<int>({1, 2, 3}));
+  EXPECT_EQ(ToVector(many_copy), std::vector<int>({1, 2, 3, 4}));
+
+  many_copy = single;
+  EXPECT_EQ(many_copy, single);
+  single_copy = many;
+  EXPECT_EQ(single_copy, many);
+
+  LogicalTimes moved = std::move(many);
+  EXPECT_EQ(ToVector(moved), std::vector<int>({1, 2, 3}));
+}
+
+TEST(LogicalTimes, Comparisons) {
+  EXPECT_EQ(LogicalTimes({1, 2}), LogicalTimes({2, 1}));
+  EXPECT_NE(LogicalTimes({1, 2}), LogicalTimes({1}));
+  EXPECT_NE(LogicalTimes(), LogicalTimes({0}));
+  EXPECT_LT(LogicalTimes(), LogicalTimes({0}));
+  EXPECT_LT(LogicalTimes({1}), LogicalTimes({1, 2}));
+  EXPECT_LT(LogicalTimes({1, 2}), LogicalTimes({2}));
+  EXPECT_LE(LogicalTimes({1, 2}), LogicalTimes({1, 2}));
+  EXPECT_GT(LogicalTimes({3}), LogicalTimes({1, 2}));
+  EXPECT_GE(LogicalTimes({3}), LogicalTimes({3}));
+}
+
+TEST(LogicalTimes, ToString) {
+  std::ostringstream out;
+  out << LogicalTimes() << " " << LogicalTimes(1) << " "
+      << LogicalTimes({3, 1, 2});
+  EXPECT_EQ(out.str(), "{} {1} {1, 2, 3}");
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,38 @@
+#ifndef COLLECTIONS_MAPPED_TABLE_H_
+#define COLLECTIONS_MAPPED_TABLE_H_
+
+#include "collections/table.h"
+#include "common/mapped_heap.h"
+
+namespace fluent {
+
+// A MappedTable is a Table (see collections/table.h) whose std::map nodes are
+// allocated from a MappedHeap (see common/mapped_heap.h) rather than from the
+// regular heap. It is an out-of-core node pool, not a durable table: the
+// kernel keeps the recently used nodes in memory and pages the rest out to
+// the heap's file, so a table of small, fixed-width tuples can grow far larger
+// than the memory of the machine.
+//
+//   auto heap = MappedHeap::Make("/mnt/ssd/kvs.heap").ConsumeValueOrDie();
+//   MappedTable<std::int64_t, std::int64_t> kvs("kvs", {{"k", "v"}},
+//                                               std::move(heap));
+//
+// A MappedTable is a BasicTable, just like a Table, so it has exactly the
+// same interface and semantics as a Table. The table owns its heap, which
+// `Get().get_allocator().heap()` returns. Scans, MergeJoins, and
+// IndexNestedLoopJoins read it through `Get()` like any other collection.
+//
+// Only the map nodes live in the heap, so only tuples of fixed-width columns
+// (e.g. integers) are stored out of core in their entirety. Memory that a
+// tuple allocates on its own (e.g. the characters of a long std::string) and
+// the logical times of a tuple inserted more than once are allocated from the
+// regular heap. A MappedTable constructed with a null heap stores its tuples
+// in memory. The heap's file is unlinked when it is created and is never
+// reopened, so the contents of a MappedTable do not survive a restart; use
+// checkpointing (see FluentExecutor::EnableCheckpointing) for that.
+template <typename... Ts>
+using MappedTable = BasicTable<MappedHeapAllocator, Ts...>;
+
+}  // namespace fluent
+
+#endif  // COLLECTIONS_MAPPED_TABLE_H_
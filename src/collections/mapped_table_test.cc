@@ -0,0 +1,110 @@
+#include "collections/mapped_table.h"
+
+#include <cstddef>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "glog/logging.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "common/mapped_heap.h"
+
+namespace fluent {
+namespace {
+
+using Map = std::map<std::tuple<char, char>, CollectionTupleIds>;
+
+std::unique_ptr<MappedHeap> MakeHeap() {
+  StatusOr<std::unique_ptr<MappedHeap>> heap =
+      MappedHeap::Make("/tmp/fluent_mapped_table_test.heap");
+  CHECK(heap.ok()) << heap.status();
+  return heap.ConsumeValueOrDie();
+}
+
+// The contents of `t` in a regular std::map.
+Map ToMap(const MappedTable<char, char>& t) {
+  return Map(t.Get().begin(), t.Get().end());
+}
+
+}  // namespace
+
+TEST(MappedTable, MappedTableStartsEmpty) {
+  MappedTable<char, char> t("t", {{"x", "y"}}, MakeHeap());
+  EXPECT_EQ(ToMap(t), Map());
+  EXPECT_EQ(t.Get().get_allocator().heap()->BytesAllocated(), 0u);
+}
+
+TEST(MappedTable, Merge) {
+  MappedTable<char, char> t("t", {{"x", "y"}}, MakeHeap());
+  Map expected;
+
+  t.Merge({'a', 'a'}, 0xA, 0);
+  expected = {{{'a', 'a'}, {0xA, {0}}}};
+  EXPECT_EQ(ToMap(t), expected);
+
+  t.Merge({'b', 'b'}, 0xB, 1);
+  t.Merge({'b', 'b'}, 0xB, 2);
+  expected = {{{'a', 'a'}, {0xA, {0}}}, {{'b', 'b'}, {0xB, {1, 2}}}};
+  EXPECT_EQ(ToMap(t), expected);
+  EXPECT_EQ(t.Stats().NumRows(), 2u);
+
+  // The tuples are stored in the heap.
+  EXPECT_GT(t.Get().get_allocator().heap()->BytesAllocated(), 0u);
+}
+
+TEST(MappedTable, DeferredMergeAndDeferredDelete) {
+  MappedTable<char, char> t("t", {{"x", "y"}}, MakeHeap());
+  Map expected;
+
+  t.Merge({'c', 'c'}, 0xC, 0);
+  t.DeferredMerge({'a', 'a'}, 0xA, 0);
+  t.DeferredMerge({'b', 'b'}, 0xB, 1);
+  t.DeferredDelete({'b', 'b'}, 0xB, 2);
+  t.DeferredDelete({'c', 'c'}, 0xC, 3);
+  expected = {{{'c', 'c'}, {0xC, {0}}}};
+  EXPECT_EQ(ToMap(t), expected);
+
+  // Deferred merges are applied before deferred deletes.
+  Map deleted = t.Tick();
+  expected = {{{'a', 'a'}, {0xA, {0}}}};
+  EXPECT_EQ(ToMap(t), expected);
+  expected = {{{'b', 'b'}, {0xB, {1}}}, {{'c', 'c'}, {0xC, {0}}}};
+  EXPECT_EQ(deleted, expected);
+
+  t.DeferredDelete({'a', 'a'}, 0xA, 4);
+  t.Tick();
+  EXPECT_EQ(ToMap(t), Map());
+  EXPECT_EQ(t.Get().get_allocator().heap()->BytesAllocated(), 0u);
+}
+
+TEST(MappedTable, NullHeap) {
+  MappedTable<char, char> t("t", {{"x", "y"}}, nullptr);
+  t.Merge({'a', 'a'}, 0xA, 0);
+  Map expected = {{{'a', 'a'}, {0xA, {0}}}};
+  EXPECT_EQ(ToMap(t), expected);
+  EXPECT_EQ(t.Get().get_allocator().heap(), nullptr);
+}
+
+TEST(MappedTable, ManyTuples) {
+  MappedTable<int, std::string> t("t", {{"x", "y"}}, MakeHeap());
+  for (int i = 0; i < 10000; ++i) {
+    t.Merge(std::make_tuple(i, std::to_string(i)), i, 0);
+  }
+  ASSERT_EQ(t.Get().size(), 10000u);
+  auto iter = t.Get().find(std::make_tuple(1234, std::string("1234")));
+  ASSERT_NE(iter, t.Get().end());
+  EXPECT_EQ(iter->second.hash, 1234u);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
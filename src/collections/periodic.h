@@ -15,6 +15,7 @@
 #include "glog/logging.h"
 
 #include "collections/collection.h"
+#include "collections/collection_stats.h"
 #include "collections/collection_tuple_ids.h"
 #include "collections/util.h"
 #include "common/macros.h"
@@ -45,7 +46,7 @@ class Periodic : public Collection {
  public:
   using id = std::size_t;
   using time = std::chrono::time_point<Clock>;
-  using period = std::chrono::milliseconds;
+  using period = std::chrono::microseconds;
 
   Periodic(std::string name, period period)
       : name_(std::move(name)), period_(std::move(period)), id_(0) {}
@@ -65,6 +66,10 @@ class Periodic : public Collection {
     return ts_;
   }
 
+  // See collections/collection_stats.h.
+  const CollectionStats<id, time>& Stats() const { return stats_; }
+  void TrackDistinct() { stats_.TrackDistinct(ts_); }
+
   id GetAndIncrementId() {
     id i = id_;
     id_++;
@@ -73,20 +78,23 @@ class Periodic : public Collection {
 
   void Merge(const std::tuple<id, time>& t, std::size_t hash,
              int logical_time_inserted) {
-    MergeCollectionTuple(t, hash, logical_time_inserted, &ts_);
+    auto merged = MergeCollectionTuple(t, hash, logical_time_inserted, &ts_);
+    stats_.RecordMerge(merged.first->first, merged.second);
   }
 
   std::map<std::tuple<id, time>, CollectionTupleIds> Tick() {
     std::map<std::tuple<id, time>, CollectionTupleIds> ts;
     std::swap(ts, ts_);
+    stats_.Tick(ts_);
     return ts;
   }
 
  private:
   const std::string name_;
-  const std::chrono::milliseconds period_;
+  const period period_;
   id id_;
   std::map<std::tuple<id, time>, CollectionTupleIds> ts_;
+  CollectionStats<id, time> stats_;
 };
 
 }  // namespace fluent
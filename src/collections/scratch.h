@@ -8,6 +8,7 @@
 #include <tuple>
 
 #include "collections/collection.h"
+#include "collections/collection_stats.h"
 #include "collections/collection_tuple_ids.h"
 #include "collections/util.h"
 #include "common/macros.h"
@@ -34,14 +35,27 @@ class Scratch : public Collection {
     return ts_;
   }
 
+  // See collections/collection_stats.h.
+  const CollectionStats<Ts...>& Stats() const { return stats_; }
+  void TrackDistinct() { stats_.TrackDistinct(ts_); }
+
   void Merge(const std::tuple<Ts...>& t, std::size_t hash,
              int logical_time_inserted) {
-    MergeCollectionTuple(t, hash, logical_time_inserted, &ts_);
+    auto merged = MergeCollectionTuple(t, hash, logical_time_inserted, &ts_);
+    stats_.RecordMerge(merged.first->first, merged.second);
+  }
+
+  void Merge(std::tuple<Ts...>&& t, std::size_t hash,
+             int logical_time_inserted) {
+    auto merged =
+        MergeCollectionTuple(std::move(t), hash, logical_time_inserted, &ts_);
+    stats_.RecordMerge(merged.first->first, merged.second);
   }
 
   std::map<std::tuple<Ts...>, CollectionTupleIds> Tick() {
     std::map<std::tuple<Ts...>, CollectionTupleIds> ts;
     std::swap(ts, ts_);
+    stats_.Tick(ts_);
     return ts;
   }
 
@@ -49,6 +63,7 @@ class Scratch : public Collection {
   const std::string name_;
   const std::array<std::string, sizeof...(Ts)> column_names_;
   std::map<std::tuple<Ts...>, CollectionTupleIds> ts_;
+  CollectionStats<Ts...> stats_;
 };
 
 }  // namespace fluent
@@ -11,9 +11,9 @@
 #include <utility>
 
 #include "glog/logging.h"
-#include "zmq.hpp"
 
 #include "collections/collection.h"
+#include "collections/collection_stats.h"
 #include "collections/collection_tuple_ids.h"
 #include "collections/util.h"
 #include "common/macros.h"
@@ -41,10 +41,12 @@ class Stdin : public Collection {
     return lines_;
   }
 
-  zmq::pollitem_t Pollitem() {
-    return {/* socket */ nullptr, /* fd */ 0, /* events */ ZMQ_POLLIN,
-            /* revents */ 0};
-  }
+  // See collections/collection_stats.h.
+  const CollectionStats<std::string>& Stats() const { return stats_; }
+  void TrackDistinct() { stats_.TrackDistinct(lines_); }
+
+  // The file descriptor from which `ReadLine` reads.
+  int Fd() const { return 0; }
 
   static std::tuple<std::string> ReadLine() {
     std::string line;
@@ -54,17 +56,20 @@ class Stdin : public Collection {
 
   void Merge(const std::tuple<std::string>& t, std::size_t hash,
              int logical_time_inserted) {
-    MergeCollectionTuple(t, hash, logical_time_inserted, &lines_);
+    auto merged = MergeCollectionTuple(t, hash, logical_time_inserted, &lines_);
+    stats_.RecordMerge(merged.first->first, merged.second);
   }
 
   std::map<std::tuple<std::string>, CollectionTupleIds> Tick() {
     std::map<std::tuple<std::string>, CollectionTupleIds> lines;
     std::swap(lines_, lines);
+    stats_.Tick(lines_);
     return lines;
   }
 
  private:
   std::map<std::tuple<std::string>, CollectionTupleIds> lines_;
+  CollectionStats<std::string> stats_;
 };
 
 }  // namespace fluent
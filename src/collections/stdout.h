@@ -1,10 +1,13 @@
 #ifndef COLLECTIONS_STDOUT_H_
 #define COLLECTIONS_STDOUT_H_
 
+#include <cstddef>
+
 #include <algorithm>
 #include <array>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <set>
 #include <type_traits>
 #include <utility>
@@ -14,14 +17,34 @@
 #include "collections/collection.h"
 #include "collections/collection_tuple_ids.h"
 #include "collections/util.h"
+#include "common/buffered_writer.h"
 #include "common/macros.h"
+#include "common/mock_pickler.h"
+#include "common/tuple_file.h"
 #include "common/type_traits.h"
 
 namespace fluent {
 
+// See `Stdout`.
+constexpr std::size_t kStdoutFlushThreshold = 64 * 1024;
+
+// Stdout writes every tuple merged into it to std::cout, laid out in format
+// `format` (see `AppendTuple` in common/tuple_file.h). By default, a tuple is
+// written as its string followed by a newline.
+//
+// Output is buffered (see common/buffered_writer.h) and written at the end of
+// every tick, or sooner once `kStdoutFlushThreshold` bytes are buffered,
+// rather than once per tuple. If `background` is true, the output is written
+// by a background thread. Format `RECORDS` writes binary records (see
+// common/record_file.h), and format `JSON_LINES` writes every tuple as
+// `{"stdout":"..."}`.
 class Stdout : public Collection {
  public:
-  Stdout() {}
+  explicit Stdout(TupleFileFormat format = TupleFileFormat::CSV,
+                  bool background = false)
+      : format_(format),
+        writer_(std::make_unique<BufferedWriter>(
+            &std::cout, kStdoutFlushThreshold, background)) {}
   DISALLOW_COPY_AND_ASSIGN(Stdout);
   DEFAULT_MOVE_AND_ASSIGN(Stdout);
 
@@ -39,7 +62,8 @@ class Stdout : public Collection {
              int logical_time_inserted) {
     UNUSED(hash);
     UNUSED(logical_time_inserted);
-    std::cout << std::get<0>(t) << std::endl;
+    Write(t);
+    writer_->MaybeFlush();
   }
 
   void DeferredMerge(const std::tuple<std::string>& t, std::size_t hash,
@@ -51,13 +75,20 @@ class Stdout : public Collection {
 
   std::map<std::tuple<std::string>, CollectionTupleIds> Tick() {
     for (const std::tuple<std::string>& t : deferred_merge_) {
-      std::cout << std::get<0>(t) << std::endl;
+      Write(t);
     }
     deferred_merge_.clear();
+    writer_->Flush();
     return {};
   }
 
  private:
+  void Write(const std::tuple<std::string>& t) {
+    AppendTuple<MockPickler>(format_, ColumnNames(), t, writer_->Buffer());
+  }
+
+  TupleFileFormat format_;
+  std::unique_ptr<BufferedWriter> writer_;
   std::set<std::tuple<std::string>> deferred_merge_;
 };
 
@@ -4,6 +4,7 @@
 
 #include <iostream>
 #include <set>
+#include <string>
 #include <tuple>
 #include <utility>
 
@@ -11,6 +12,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include "common/tuple_file.h"
 #include "testing/captured_stdout.h"
 
 namespace fluent {
@@ -21,11 +23,24 @@ TEST(Stdout, Merge) {
 
   EXPECT_STREQ("", captured.Get().c_str());
   stdout_.Merge({"hello"}, 0x0, 0);
-  EXPECT_STREQ("hello\n", captured.Get().c_str());
+  EXPECT_STREQ("", captured.Get().c_str());
   stdout_.Merge({"world"}, 0x0, 0);
+  EXPECT_STREQ("", captured.Get().c_str());
+  stdout_.Tick();
   EXPECT_STREQ("hello\nworld\n", captured.Get().c_str());
 }
 
+TEST(Stdout, MergeFlushesLargeOutput) {
+  Stdout stdout_;
+  CapturedStdout captured;
+
+  const std::string line(kStdoutFlushThreshold, 'x');
+  stdout_.Merge({"hello"}, 0x0, 0);
+  EXPECT_STREQ("", captured.Get().c_str());
+  stdout_.Merge({line}, 0x0, 0);
+  EXPECT_EQ("hello\n" + line + "\n", captured.Get());
+}
+
 TEST(Table, DeferredMerge) {
   Stdout stdout_;
   CapturedStdout captured;
@@ -39,6 +54,26 @@ TEST(Table, DeferredMerge) {
   EXPECT_STREQ("hello\nworld\n", captured.Get().c_str());
 }
 
+TEST(Stdout, JsonLines) {
+  Stdout stdout_(TupleFileFormat::JSON_LINES);
+  CapturedStdout captured;
+
+  stdout_.Merge({"a \"quote\""}, 0x0, 0);
+  stdout_.Tick();
+  EXPECT_EQ(R"({"stdout":"a \"quote\""})" + std::string("\n"), captured.Get());
+}
+
+TEST(Stdout, Background) {
+  CapturedStdout captured;
+  {
+    Stdout stdout_(TupleFileFormat::CSV, true);
+    stdout_.Merge({"hello"}, 0x0, 0);
+    stdout_.DeferredMerge({"world"}, 0x0, 0);
+    stdout_.Tick();
+  }
+  EXPECT_STREQ("hello\nworld\n", captured.Get().c_str());
+}
+
 }  // namespace fluent
 
 int main(int argc, char** argv) {
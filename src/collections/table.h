@@ -5,13 +5,16 @@
 #include <array>
 #include <iterator>
 #include <map>
+#include <memory>
 #include <set>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "glog/logging.h"
 
 #include "collections/collection.h"
+#include "collections/collection_stats.h"
 #include "collections/collection_tuple_ids.h"
 #include "collections/util.h"
 #include "common/macros.h"
@@ -19,13 +22,40 @@
 
 namespace fluent {
 
-template <typename... Ts>
-class Table : public Collection {
+// A BasicTable is a table whose tuples are stored in a sorted std::map whose
+// nodes are allocated by an `Allocator`. A `Table` allocates its tuples from
+// the regular heap, and a `MappedTable` allocates them from a MappedHeap
+// (see collections/mapped_table.h).
+template <template <typename> class Allocator, typename... Ts>
+class BasicTable : public Collection {
  public:
-  Table(std::string name, std::array<std::string, sizeof...(Ts)> column_names)
+  using allocator_type =
+      Allocator<std::pair<const std::tuple<Ts...>, CollectionTupleIds>>;
+  using map_type = AllocatedCollectionTupleMap<allocator_type, Ts...>;
+
+  BasicTable(std::string name,
+             std::array<std::string, sizeof...(Ts)> column_names)
       : name_(std::move(name)), column_names_(std::move(column_names)) {}
-  DISALLOW_COPY_AND_ASSIGN(Table);
-  DEFAULT_MOVE_AND_ASSIGN(Table);
+
+  // The heap from which an allocator `A`, like a MappedHeapAllocator,
+  // allocates.
+  template <typename A>
+  using heap_type = typename std::remove_pointer<decltype(
+      std::declval<const A&>().heap())>::type;
+
+  // Create a table whose tuples are allocated by `allocator_type(heap.get())`.
+  // The table owns `heap`, which outlives the table's tuples.
+  template <typename A = allocator_type>
+  BasicTable(std::string name,
+             std::array<std::string, sizeof...(Ts)> column_names,
+             std::unique_ptr<heap_type<A>> heap)
+      : name_(std::move(name)),
+        column_names_(std::move(column_names)),
+        heap_(std::move(heap)),
+        ts_(allocator_type(static_cast<heap_type<A>*>(heap_.get()))) {}
+
+  DISALLOW_COPY_AND_ASSIGN(BasicTable);
+  DEFAULT_MOVE_AND_ASSIGN(BasicTable);
 
   const std::string& Name() const { return name_; }
 
@@ -33,69 +63,129 @@ class Table : public Collection {
     return column_names_;
   }
 
-  const std::map<std::tuple<Ts...>, CollectionTupleIds>& Get() const {
-    return ts_;
-  }
+  const map_type& Get() const { return ts_; }
+
+  // See collections/collection_stats.h.
+  const CollectionStats<Ts...>& Stats() const { return stats_; }
+  void TrackDistinct() { stats_.TrackDistinct(ts_); }
 
   void Merge(const std::tuple<Ts...>& t, std::size_t hash,
              int logical_time_inserted) {
-    MergeCollectionTuple(t, hash, logical_time_inserted, &ts_);
+    auto merged = MergeCollectionTuple(t, hash, logical_time_inserted, &ts_);
+    stats_.RecordMerge(merged.first->first, merged.second);
+  }
+
+  void Merge(std::tuple<Ts...>&& t, std::size_t hash,
+             int logical_time_inserted) {
+    auto merged =
+        MergeCollectionTuple(std::move(t), hash, logical_time_inserted, &ts_);
+    stats_.RecordMerge(merged.first->first, merged.second);
+  }
+
+  // Merge every tuple `t` of the `(t, hash)` pairs `ts`, like `Merge`. If `ts`
+  // is sorted by tuple (e.g. it's the output of `ReadSortedTuples` in
+  // common/tuple_file.h), then every tuple larger than every tuple already in
+  // the table is appended to the end of the table in constant time rather than
+  // searched for, so bulk loading an empty table takes linear time.
+  void BulkMerge(std::vector<std::pair<std::tuple<Ts...>, std::size_t>> ts,
+                 int logical_time_inserted) {
+    using Pair = std::pair<std::tuple<Ts...>, std::size_t>;
+    auto by_tuple = [](const Pair& a, const Pair& b) {
+      return a.first < b.first;
+    };
+    if (!std::is_sorted(ts.begin(), ts.end(), by_tuple)) {
+      std::sort(ts.begin(), ts.end(), by_tuple);
+    }
+
+    for (Pair& pair : ts) {
+      if (ts_.empty() || ts_.rbegin()->first < pair.first) {
+        auto iter = ts_.emplace_hint(
+            ts_.end(), std::move(pair.first),
+            CollectionTupleIds{pair.second, {logical_time_inserted}});
+        stats_.RecordMerge(iter->first, true);
+      } else {
+        Merge(std::move(pair.first), pair.second, logical_time_inserted);
+      }
+    }
   }
 
   void DeferredMerge(const std::tuple<Ts...>& t, std::size_t hash,
                      int logical_time_inserted) {
-    MergeCollectionTuple(t, hash, logical_time_inserted, &deferred_merge_);
+    deferred_merge_.emplace_back(
+        t, CollectionTupleIds{hash, {logical_time_inserted}});
+  }
+
+  void DeferredMerge(std::tuple<Ts...>&& t, std::size_t hash,
+                     int logical_time_inserted) {
+    deferred_merge_.emplace_back(
+        std::move(t), CollectionTupleIds{hash, {logical_time_inserted}});
   }
 
   void DeferredDelete(const std::tuple<Ts...>& t, std::size_t hash,
                       int logical_time_inserted) {
-    MergeCollectionTuple(t, hash, logical_time_inserted, &deferred_delete_);
+    UNUSED(logical_time_inserted);
+    deferred_delete_.emplace_back(t, hash);
+  }
+
+  void DeferredDelete(std::tuple<Ts...>&& t, std::size_t hash,
+                      int logical_time_inserted) {
+    UNUSED(logical_time_inserted);
+    deferred_delete_.emplace_back(std::move(t), hash);
   }
 
   std::map<std::tuple<Ts...>, CollectionTupleIds> Tick() {
-    // Merge deferred_merge_ into ts_.
-    for (const auto& pair : deferred_merge_) {
-      const std::tuple<Ts...>& t = pair.first;
-      const CollectionTupleIds& ids = pair.second;
-      auto iter = ts_.find(t);
-      if (iter == ts_.end()) {
-        ts_.insert(pair);
-      } else {
-        CHECK_EQ(iter->second.hash, ids.hash);
-        auto begin = ids.logical_times_inserted.begin();
-        auto end = ids.logical_times_inserted.end();
-        iter->second.logical_times_inserted.insert(begin, end);
-      }
+    // Merge deferred_merge_ into ts_. Every tuple that isn't already in ts_ is
+    // moved, not copied, into ts_.
+    for (auto& pair : deferred_merge_) {
+      auto merged = MergeCollectionTupleIds(std::move(pair.first),
+                                            std::move(pair.second), &ts_);
+      stats_.RecordMerge(merged.first->first, merged.second);
     }
 
-    // Delete deferred_delete_ from ts_.
+    // Delete deferred_delete_ from ts_. A deleted tuple is moved out of
+    // deferred_delete_, and its ids are moved out of ts_, so deleting a tuple
+    // doesn't copy it.
     std::map<std::tuple<Ts...>, CollectionTupleIds> deleted;
-    for (const auto& pair : deferred_delete_) {
-      const std::tuple<Ts...>& t = pair.first;
-      const CollectionTupleIds& ids = pair.second;
-      auto iter = ts_.find(t);
+    for (auto& pair : deferred_delete_) {
+      auto iter = ts_.find(pair.first);
       if (iter == ts_.end()) {
         // Do nothing.
       } else {
-        CHECK_EQ(iter->second.hash, ids.hash);
-        deleted.insert(*iter);
+        CHECK_EQ(iter->second.hash, pair.second);
+        deleted.emplace(std::move(pair.first), std::move(iter->second));
         ts_.erase(iter);
+        stats_.RecordDelete();
       }
     }
 
     deferred_merge_.clear();
     deferred_delete_.clear();
+    stats_.Tick(ts_);
     return deleted;
   }
 
  private:
   const std::string name_;
   const std::array<std::string, sizeof...(Ts)> column_names_;
-  std::map<std::tuple<Ts...>, CollectionTupleIds> ts_;
-  std::map<std::tuple<Ts...>, CollectionTupleIds> deferred_merge_;
-  std::map<std::tuple<Ts...>, CollectionTupleIds> deferred_delete_;
+
+  // The heap passed to the constructor, if any. `heap_` is declared before
+  // `ts_`, so `ts_` is destroyed first.
+  std::shared_ptr<void> heap_;
+  map_type ts_;
+  CollectionStats<Ts...> stats_;
+
+  // Deferred merges and deletes are buffered in vectors rather than maps so
+  // that the buffered tuples can be moved into (or out of) ts_ when the table
+  // is ticked. Duplicates are resolved by Tick. deferred_delete_ holds the
+  // hash of every tuple.
+  std::vector<std::pair<std::tuple<Ts...>, CollectionTupleIds>>
+      deferred_merge_;
+  std::vector<std::pair<std::tuple<Ts...>, std::size_t>> deferred_delete_;
 };
 
+template <typename... Ts>
+using Table = BasicTable<std::allocator, Ts...>;
+
 }  // namespace fluent
 
 #endif  // COLLECTIONS_TABLE_H_
@@ -0,0 +1,104 @@
+#include "collections/table.h"
+
+#include <unistd.h>
+
+#include <cstddef>
+
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "glog/logging.h"
+
+namespace fluent {
+namespace {
+
+using TableType = Table<std::size_t, std::size_t>;
+using TupleType = std::tuple<std::size_t, std::size_t>;
+
+// The resident set size of this process in bytes, read from /proc.
+long ResidentBytes() {
+  std::ifstream statm("/proc/self/statm");
+  long num_pages = 0;
+  long num_resident_pages = 0;
+  statm >> num_pages >> num_resident_pages;
+  return num_resident_pages * sysconf(_SC_PAGESIZE);
+}
+
+}  // namespace
+
+// Merging `state.range(0)` tuples, each at `state.range(1)` logical times, into
+// a table. The label reports the resident memory used by the table per tuple.
+// Freed memory isn't always returned to the operating system, so the memory
+// is only measured accurately on the first iteration; run with a single
+// iteration.
+void TableMergeMemoryBench(benchmark::State& state) {
+  const std::size_t num_tuples = state.range(0);
+  const int num_times = state.range(1);
+  double bytes_per_tuple = 0;
+
+  while (state.KeepRunning()) {
+    TableType t("t", {{"x", "y"}});
+    const long before = ResidentBytes();
+    for (std::size_t i = 0; i < num_tuples; ++i) {
+      for (int time = 0; time < num_times; ++time) {
+        t.Merge(TupleType(i, i), i, time);
+      }
+    }
+    bytes_per_tuple = static_cast<double>(ResidentBytes() - before) /
+                      static_cast<double>(num_tuples);
+    benchmark::DoNotOptimize(t.Get().size());
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_tuples * num_times);
+  state.SetLabel(std::to_string(bytes_per_tuple) + " bytes/tuple");
+}
+BENCHMARK(TableMergeMemoryBench)->Args({1000 * 1000, 1})->Iterations(1);
+BENCHMARK(TableMergeMemoryBench)->Args({1000 * 1000, 2})->Iterations(1);
+
+// Loading `state.range(0)` sorted tuples into an empty table one at a time,
+// as bootstrap rules do.
+void TableLoadMergeBench(benchmark::State& state) {
+  const std::size_t num_tuples = state.range(0);
+  while (state.KeepRunning()) {
+    TableType t("t", {{"x", "y"}});
+    for (std::size_t i = 0; i < num_tuples; ++i) {
+      t.Merge(TupleType(i, i), i, 0);
+    }
+    benchmark::DoNotOptimize(t.Get().size());
+  }
+  state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+BENCHMARK(TableLoadMergeBench)->Range(1000, 1000 * 1000);
+
+// Loading the same tuples with `BulkMerge`.
+void TableLoadBulkMergeBench(benchmark::State& state) {
+  const std::size_t num_tuples = state.range(0);
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    std::vector<std::pair<TupleType, std::size_t>> ts;
+    ts.reserve(num_tuples);
+    for (std::size_t i = 0; i < num_tuples; ++i) {
+      ts.emplace_back(TupleType(i, i), i);
+    }
+    state.ResumeTiming();
+
+    TableType t("t", {{"x", "y"}});
+    t.BulkMerge(std::move(ts), 0);
+    benchmark::DoNotOptimize(t.Get().size());
+  }
+  state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+BENCHMARK(TableLoadBulkMergeBench)->Range(1000, 1000 * 1000);
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
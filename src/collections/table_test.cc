@@ -10,6 +10,8 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include "common/hash_util.h"
+
 namespace fluent {
 
 TEST(Table, TableStartsEmpty) {
@@ -35,6 +37,32 @@ TEST(Table, Merge) {
   EXPECT_EQ(t.Get(), expected);
 }
 
+TEST(Table, Stats) {
+  Table<int, char> t("t", {{"x", "y"}});
+  t.TrackDistinct();
+  t.Merge({1, 'a'}, 1, 0);
+  t.Merge({2, 'a'}, 2, 0);
+  t.Merge({2, 'a'}, 2, 1);
+  t.DeferredMerge({3, 'b'}, 3, 1);
+  t.DeferredDelete({1, 'a'}, 1, 1);
+
+  EXPECT_EQ(t.Stats().NumRows(), 2u);
+  EXPECT_EQ(t.Stats().NumInsertedThisTick(), 2u);
+  EXPECT_EQ(t.Stats().NumDeletedThisTick(), 0u);
+  EXPECT_NEAR(t.Stats().NumDistinct(0), 2.0, 0.1);
+  EXPECT_NEAR(t.Stats().NumDistinct(1), 1.0, 0.1);
+
+  t.Tick();
+  EXPECT_EQ(t.Stats().NumRows(), 2u);
+  EXPECT_EQ(t.Stats().NumInsertedThisTick(), 0u);
+  EXPECT_EQ(t.Stats().NumInsertedLastTick(), 3u);
+  EXPECT_EQ(t.Stats().NumDeletedLastTick(), 1u);
+  // Half of the table was deleted, so the distinct estimates are rebuilt and
+  // forget the deleted tuple.
+  EXPECT_NEAR(t.Stats().NumDistinct(0), 2.0, 0.1);
+  EXPECT_NEAR(t.Stats().NumDistinct(1), 2.0, 0.1);
+}
+
 TEST(Table, TickDoesntClearTable) {
   Table<char, char> t("t", {{"x", "y"}});
   std::map<std::tuple<char, char>, CollectionTupleIds> expected;
@@ -46,6 +74,30 @@ TEST(Table, TickDoesntClearTable) {
   EXPECT_EQ(t.Get(), expected);
 }
 
+TEST(Table, BulkMerge) {
+  Table<char, char> t("t", {{"x", "y"}});
+  std::map<std::tuple<char, char>, CollectionTupleIds> expected;
+
+  t.BulkMerge({{{'a', 'a'}, 0xA}, {{'c', 'c'}, 0xC}}, 0);
+  expected = {{{'a', 'a'}, {0xA, {0}}}, {{'c', 'c'}, {0xC, {0}}}};
+  EXPECT_EQ(t.Get(), expected);
+  EXPECT_EQ(t.Stats().NumInsertedThisTick(), 2u);
+
+  // Unsorted, overlapping with the table, and with duplicates.
+  t.BulkMerge({{{'d', 'd'}, 0xD},
+               {{'b', 'b'}, 0xB},
+               {{'c', 'c'}, 0xC},
+               {{'d', 'd'}, 0xD}},
+              1);
+  expected = {{{'a', 'a'}, {0xA, {0}}},
+              {{'b', 'b'}, {0xB, {1}}},
+              {{'c', 'c'}, {0xC, {0, 1}}},
+              {{'d', 'd'}, {0xD, {1}}}};
+  EXPECT_EQ(t.Get(), expected);
+  EXPECT_EQ(t.Stats().NumRows(), 4u);
+  EXPECT_EQ(t.Stats().NumInsertedThisTick(), 4u);
+}
+
 TEST(Table, DeferredMerge) {
   Table<char, char> t("t", {{"x", "y"}});
   std::map<std::tuple<char, char>, CollectionTupleIds> expected;
@@ -111,6 +163,55 @@ TEST(Table, DeferredMergeAndDeferredDelete) {
   EXPECT_EQ(t.Get(), expected);
 }
 
+namespace {
+
+// A CopyCounter counts the number of times it has been copied.
+struct CopyCounter {
+  explicit CopyCounter(int x_) : x(x_) {}
+  CopyCounter(const CopyCounter& other) : x(other.x) { num_copies++; }
+  CopyCounter(CopyCounter&& other) = default;
+  CopyCounter& operator=(const CopyCounter& other) {
+    x = other.x;
+    num_copies++;
+    return *this;
+  }
+  CopyCounter& operator=(CopyCounter&& other) = default;
+  bool operator<(const CopyCounter& other) const { return x < other.x; }
+
+  int x;
+  static int num_copies;
+};
+
+int CopyCounter::num_copies = 0;
+
+}  // namespace
+
+// Tables hash their columns to keep statistics. See CollectionStats.
+template <>
+struct Hash<CopyCounter> {
+  std::size_t operator()(const CopyCounter& c) { return Hash<int>()(c.x); }
+};
+
+TEST(Table, RvaluesAreNotCopied) {
+  Table<CopyCounter> t("t", {{"x"}});
+  CopyCounter::num_copies = 0;
+
+  t.Merge(std::make_tuple(CopyCounter(1)), 1, 0);
+  t.DeferredMerge(std::make_tuple(CopyCounter(2)), 2, 1);
+  t.DeferredMerge(std::make_tuple(CopyCounter(2)), 2, 2);
+  t.Tick();
+  t.DeferredDelete(std::make_tuple(CopyCounter(1)), 1, 3);
+  const auto deleted = t.Tick();
+
+  EXPECT_EQ(CopyCounter::num_copies, 0);
+  ASSERT_EQ(deleted.size(), static_cast<std::size_t>(1));
+  EXPECT_EQ(std::get<0>(deleted.begin()->first).x, 1);
+  ASSERT_EQ(t.Get().size(), static_cast<std::size_t>(1));
+  EXPECT_EQ(std::get<0>(t.Get().begin()->first).x, 2);
+  EXPECT_EQ(t.Get().begin()->second.logical_times_inserted,
+            LogicalTimes({1, 2}));
+}
+
 }  // namespace fluent
 
 int main(int argc, char** argv) {
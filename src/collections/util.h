@@ -3,8 +3,10 @@
 
 #include <cstddef>
 
+#include <functional>
 #include <map>
 #include <tuple>
+#include <utility>
 
 #include "glog/logging.h"
 
@@ -13,16 +15,71 @@
 namespace fluent {
 
 template <typename... Ts>
-void MergeCollectionTuple(const std::tuple<Ts...>& t, const std::size_t hash,
-                          const int logical_time_inserted,
-                          std::map<std::tuple<Ts...>, CollectionTupleIds>* ts) {
+using CollectionTupleMap = std::map<std::tuple<Ts...>, CollectionTupleIds>;
+
+// A CollectionTupleMap whose nodes are allocated by `Allocator` (see, for
+// example, MappedTable). The functions below work on either kind of map.
+template <typename Allocator, typename... Ts>
+using AllocatedCollectionTupleMap =
+    std::map<std::tuple<Ts...>, CollectionTupleIds,
+             std::less<std::tuple<Ts...>>, Allocator>;
+
+// Merge the tuple `t`, inserted at time `logical_time_inserted`, into `ts`.
+// Like `std::map::insert`, returns an iterator to `t` in `ts` and whether `t`
+// was not already in `ts`.
+template <typename Allocator, typename... Ts>
+std::pair<typename AllocatedCollectionTupleMap<Allocator, Ts...>::iterator,
+          bool>
+MergeCollectionTuple(const std::tuple<Ts...>& t, const std::size_t hash,
+                     const int logical_time_inserted,
+                     AllocatedCollectionTupleMap<Allocator, Ts...>* ts) {
   auto iter = ts->find(t);
   if (iter == ts->end()) {
     CollectionTupleIds ids = CollectionTupleIds{hash, {logical_time_inserted}};
-    ts->insert(std::make_pair(t, ids));
+    return ts->insert(std::make_pair(t, ids));
   } else {
     CHECK_EQ(iter->second.hash, hash);
     iter->second.logical_times_inserted.insert(logical_time_inserted);
+    return {iter, false};
+  }
+}
+
+// Like the function above, but `t` is moved into `ts` if it is not already in
+// `ts`.
+template <typename Allocator, typename... Ts>
+std::pair<typename AllocatedCollectionTupleMap<Allocator, Ts...>::iterator,
+          bool>
+MergeCollectionTuple(std::tuple<Ts...>&& t, const std::size_t hash,
+                     const int logical_time_inserted,
+                     AllocatedCollectionTupleMap<Allocator, Ts...>* ts) {
+  auto iter = ts->lower_bound(t);
+  if (iter == ts->end() || ts->key_comp()(t, iter->first)) {
+    CollectionTupleIds ids = CollectionTupleIds{hash, {logical_time_inserted}};
+    return {ts->emplace_hint(iter, std::move(t), std::move(ids)), true};
+  } else {
+    CHECK_EQ(iter->second.hash, hash);
+    iter->second.logical_times_inserted.insert(logical_time_inserted);
+    return {iter, false};
+  }
+}
+
+// Merge the tuple `t` with ids `ids` into `ts`. `t` and `ids` are moved into
+// `ts` if `t` is not already in `ts`. Returns the same as
+// `MergeCollectionTuple`.
+template <typename Allocator, typename... Ts>
+std::pair<typename AllocatedCollectionTupleMap<Allocator, Ts...>::iterator,
+          bool>
+MergeCollectionTupleIds(std::tuple<Ts...>&& t, CollectionTupleIds&& ids,
+                        AllocatedCollectionTupleMap<Allocator, Ts...>* ts) {
+  auto iter = ts->lower_bound(t);
+  if (iter == ts->end() || ts->key_comp()(t, iter->first)) {
+    return {ts->emplace_hint(iter, std::move(t), std::move(ids)), true};
+  } else {
+    CHECK_EQ(iter->second.hash, ids.hash);
+    auto begin = ids.logical_times_inserted.begin();
+    auto end = ids.logical_times_inserted.end();
+    iter->second.logical_times_inserted.insert(begin, end);
+    return {iter, false};
   }
 }
 
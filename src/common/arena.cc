@@ -0,0 +1,74 @@
+#include "common/arena.h"
+
+#include <cstdint>
+
+#include "glog/logging.h"
+
+namespace fluent {
+
+namespace {
+
+std::uintptr_t AlignUp(std::uintptr_t x, std::size_t alignment) {
+  return (x + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+}
+
+}  // namespace
+
+constexpr std::size_t Arena::kDefaultBlockSize;
+
+Arena::Arena(std::size_t block_size)
+    : block_size_(block_size), current_(0), offset_(0), bytes_allocated_(0) {
+  CHECK_GT(block_size_, static_cast<std::size_t>(0));
+}
+
+void* Arena::Allocate(std::size_t size, std::size_t alignment) {
+  DCHECK_EQ(alignment & (alignment - 1), static_cast<std::size_t>(0));
+  DCHECK_LE(alignment, alignof(std::max_align_t));
+  bytes_allocated_ += size;
+
+  if (size > block_size_ / 4) {
+    // `new char[]` returns memory suitably aligned for any fundamental type.
+    large_blocks_.push_back(
+        Block{std::unique_ptr<char[]>(new char[size]), size});
+    return large_blocks_.back().data.get();
+  }
+
+  while (current_ < blocks_.size()) {
+    Block& block = blocks_[current_];
+    const std::uintptr_t base =
+        reinterpret_cast<std::uintptr_t>(block.data.get());
+    const std::uintptr_t start = AlignUp(base + offset_, alignment);
+    if (start + size <= base + block.size) {
+      offset_ = start + size - base;
+      return reinterpret_cast<void*>(start);
+    }
+    current_++;
+    offset_ = 0;
+  }
+
+  blocks_.push_back(
+      Block{std::unique_ptr<char[]>(new char[block_size_]), block_size_});
+  current_ = blocks_.size() - 1;
+  offset_ = size;
+  return blocks_.back().data.get();
+}
+
+void Arena::Reset() {
+  large_blocks_.clear();
+  current_ = 0;
+  offset_ = 0;
+  bytes_allocated_ = 0;
+}
+
+std::size_t Arena::BytesReserved() const {
+  std::size_t reserved = 0;
+  for (const Block& block : blocks_) {
+    reserved += block.size;
+  }
+  for (const Block& block : large_blocks_) {
+    reserved += block.size;
+  }
+  return reserved;
+}
+
+}  // namespace fluent
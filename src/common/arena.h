@@ -0,0 +1,125 @@
+#ifndef COMMON_ARENA_H_
+#define COMMON_ARENA_H_
+
+#include <cstddef>
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace fluent {
+
+// An Arena is a monotonic memory allocator. Allocating from an Arena bumps a
+// pointer into a large block of memory, and individual allocations are never
+// freed. Instead, all of the memory allocated from an Arena is reclaimed at
+// once with a call to `Reset`. The blocks backing an Arena are kept across
+// calls to `Reset`, so an Arena that is repeatedly filled and reset (e.g. once
+// per tick) reaches a steady state in which it never calls malloc or free.
+//
+//   Arena arena;
+//   void* x = arena.Allocate(sizeof(int), alignof(int));
+//   void* y = arena.Allocate(sizeof(double), alignof(double));
+//   arena.Reset(); // x and y are now dangling.
+//
+// Containers can allocate from an Arena using an ArenaAllocator (see below).
+class Arena {
+ public:
+  static constexpr std::size_t kDefaultBlockSize = 64 * 1024;
+
+  explicit Arena(std::size_t block_size = kDefaultBlockSize);
+  DISALLOW_COPY_AND_ASSIGN(Arena);
+  DEFAULT_MOVE_AND_ASSIGN(Arena);
+
+  // Allocate `size` bytes aligned to `alignment`, which must be a power of two
+  // no larger than alignof(std::max_align_t).
+  void* Allocate(std::size_t size, std::size_t alignment);
+
+  // Reclaim every allocation made since the last call to `Reset`.
+  void Reset();
+
+  // The number of bytes allocated since the last call to `Reset`.
+  std::size_t BytesAllocated() const { return bytes_allocated_; }
+
+  // The number of bytes of memory owned by the arena.
+  std::size_t BytesReserved() const;
+
+ private:
+  struct Block {
+    std::unique_ptr<char[]> data;
+    std::size_t size;
+  };
+
+  // Allocations larger than a quarter of `block_size_` get their own block,
+  // which is freed by `Reset`. All other allocations are carved out of
+  // `blocks_`, which are kept by `Reset`.
+  std::size_t block_size_;
+  std::vector<Block> blocks_;
+  std::vector<Block> large_blocks_;
+
+  // The next allocation is made at `blocks_[current_].data[offset_]`.
+  std::size_t current_;
+  std::size_t offset_;
+
+  std::size_t bytes_allocated_;
+};
+
+// An ArenaAllocator is an allocator [1] that allocates memory from an Arena.
+// Deallocation is a noop; the memory is reclaimed when the arena is reset.
+//
+//   Arena arena;
+//   ArenaAllocator<int> alloc(&arena);
+//   std::vector<int, ArenaAllocator<int>> xs(alloc);
+//   std::set<int, std::less<int>, ArenaAllocator<int>> ys(alloc);
+//
+// A default constructed ArenaAllocator (or one constructed with a null arena)
+// allocates from the heap, which lets arena-aware code run without an arena.
+//
+// [1]: http://en.cppreference.com/w/cpp/concept/Allocator
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  ArenaAllocator() : arena_(nullptr) {}
+  explicit ArenaAllocator(Arena* arena) : arena_(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+  T* allocate(std::size_t n) {
+    if (arena_ == nullptr) {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* p, std::size_t) {
+    if (arena_ == nullptr) {
+      ::operator delete(p);
+    }
+  }
+
+  Arena* arena() const { return arena_; }
+
+ private:
+  Arena* arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) {
+  return lhs.arena() == rhs.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace fluent
+
+#endif  // COMMON_ARENA_H_
@@ -0,0 +1,116 @@
+#include "common/arena.h"
+
+#include <cstdint>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+namespace fluent {
+
+TEST(Arena, AllocationsAreAligned) {
+  Arena arena(1024);
+  for (std::size_t alignment : {1, 2, 4, 8, 16}) {
+    arena.Allocate(1, 1);
+    void* p = arena.Allocate(3, alignment);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % alignment,
+              static_cast<std::uintptr_t>(0));
+  }
+}
+
+TEST(Arena, AllocationsDoNotOverlap) {
+  Arena arena(64);
+  std::vector<char*> ps;
+  for (int i = 0; i < 100; ++i) {
+    char* p = static_cast<char*>(arena.Allocate(8, 8));
+    std::fill(p, p + 8, static_cast<char>(i));
+    ps.push_back(p);
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(std::string(ps[i], 8), std::string(8, static_cast<char>(i)));
+  }
+  EXPECT_EQ(arena.BytesAllocated(), static_cast<std::size_t>(800));
+}
+
+TEST(Arena, ResetReusesBlocks) {
+  Arena arena(1024);
+  for (int i = 0; i < 100; ++i) {
+    arena.Allocate(100, 8);
+  }
+  const std::size_t reserved = arena.BytesReserved();
+  EXPECT_GE(reserved, static_cast<std::size_t>(100 * 100));
+
+  // Filling the arena up to the same amount again doesn't reserve any more
+  // memory.
+  for (int round = 0; round < 10; ++round) {
+    arena.Reset();
+    EXPECT_EQ(arena.BytesAllocated(), static_cast<std::size_t>(0));
+    for (int i = 0; i < 100; ++i) {
+      arena.Allocate(100, 8);
+    }
+    EXPECT_EQ(arena.BytesReserved(), reserved);
+  }
+}
+
+TEST(Arena, LargeAllocationsAreFreedOnReset) {
+  Arena arena(1024);
+  arena.Allocate(10, 8);
+  const std::size_t reserved = arena.BytesReserved();
+  arena.Allocate(4096, 8);
+  EXPECT_EQ(arena.BytesReserved(), reserved + 4096);
+  arena.Reset();
+  EXPECT_EQ(arena.BytesReserved(), reserved);
+}
+
+TEST(ArenaAllocator, Containers) {
+  Arena arena;
+  using tuple = std::tuple<int, std::string>;
+  ArenaAllocator<tuple> alloc(&arena);
+
+  std::vector<tuple, ArenaAllocator<tuple>> xs(alloc);
+  std::set<tuple, std::less<tuple>, ArenaAllocator<tuple>> ys(alloc);
+  using pair = std::pair<const int, std::vector<int, ArenaAllocator<int>>>;
+  std::map<int, std::vector<int, ArenaAllocator<int>>, std::less<int>,
+           ArenaAllocator<pair>>
+      zs(alloc);
+
+  for (int i = 0; i < 100; ++i) {
+    xs.push_back(tuple(i, std::to_string(i)));
+    ys.insert(tuple(i, std::to_string(i)));
+    auto it = zs.find(i % 10);
+    if (it == zs.end()) {
+      it = zs.emplace(i % 10, std::vector<int, ArenaAllocator<int>>(alloc))
+               .first;
+    }
+    it->second.push_back(i);
+  }
+
+  EXPECT_EQ(xs.size(), static_cast<std::size_t>(100));
+  EXPECT_EQ(ys.size(), static_cast<std::size_t>(100));
+  EXPECT_EQ(zs.size(), static_cast<std::size_t>(10));
+  EXPECT_EQ(zs[3].size(), static_cast<std::size_t>(10));
+  EXPECT_GT(arena.BytesAllocated(), static_cast<std::size_t>(0));
+}
+
+TEST(ArenaAllocator, NullArenaUsesHeap) {
+  std::set<int, std::less<int>, ArenaAllocator<int>> xs;
+  for (int i = 0; i < 100; ++i) {
+    xs.insert(i);
+  }
+  EXPECT_EQ(xs.size(), static_cast<std::size_t>(100));
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
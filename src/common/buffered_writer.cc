@@ -0,0 +1,101 @@
+#include "common/buffered_writer.h"
+
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace fluent {
+
+BufferedWriter::BufferedWriter(std::ostream* out, std::size_t flush_threshold,
+                               bool background)
+    : out_(CHECK_NOTNULL(out)),
+      flush_threshold_(flush_threshold),
+      background_(background),
+      max_pending_(kBufferedWriterMaxPendingFlushes * flush_threshold) {
+  if (background_) {
+    thread_ = std::thread(&BufferedWriter::WriteOutput, this);
+  }
+}
+
+BufferedWriter::~BufferedWriter() {
+  Sync();
+  if (background_) {
+    {
+      std::unique_lock<std::mutex> l(mutex_);
+      done_ = true;
+    }
+    output_available_.notify_one();
+    thread_.join();
+  }
+}
+
+void BufferedWriter::Flush() {
+  if (buffer_.empty()) {
+    return;
+  }
+
+  if (!background_) {
+    Write(buffer_);
+    buffer_.clear();
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> l(mutex_);
+    while (pending_.size() > max_pending_) {
+      output_written_.wait(l);
+    }
+    if (pending_.empty()) {
+      std::swap(pending_, buffer_);
+    } else {
+      pending_ += buffer_;
+    }
+  }
+  buffer_.clear();
+  output_available_.notify_one();
+}
+
+void BufferedWriter::Sync() {
+  Flush();
+  if (background_) {
+    std::unique_lock<std::mutex> l(mutex_);
+    while (!pending_.empty() || writing_) {
+      output_written_.wait(l);
+    }
+  }
+}
+
+void BufferedWriter::Write(const std::string& output) {
+  out_->write(output.data(), output.size());
+  out_->flush();
+  if (!*out_) {
+    LOG(ERROR) << "Failed to write " << output.size()
+               << " bytes of buffered output.";
+  }
+}
+
+void BufferedWriter::WriteOutput() {
+  std::string output;
+  std::unique_lock<std::mutex> l(mutex_);
+  while (true) {
+    while (pending_.empty() && !done_) {
+      output_available_.wait(l);
+    }
+    if (pending_.empty()) {
+      return;
+    }
+
+    // Write without holding the lock, so that the writer can keep handing
+    // us output.
+    std::swap(output, pending_);
+    writing_ = true;
+    l.unlock();
+    Write(output);
+    output.clear();
+    l.lock();
+    writing_ = false;
+    output_written_.notify_all();
+  }
+}
+
+}  // namespace fluent
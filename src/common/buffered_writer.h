@@ -0,0 +1,100 @@
+#ifndef COMMON_BUFFERED_WRITER_H_
+#define COMMON_BUFFERED_WRITER_H_
+
+#include <cstddef>
+
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+#include "common/macros.h"
+
+namespace fluent {
+
+// See `BufferedWriter`.
+constexpr std::size_t kBufferedWriterMaxPendingFlushes = 4;
+
+// A BufferedWriter buffers output in memory and writes it to a std::ostream
+// in large chunks, so that writing many small pieces of output (e.g. a line
+// per tuple) costs a handful of system calls rather than one per piece.
+//
+//   BufferedWriter writer(&std::cout, 64 * 1024, false);
+//   writer.Buffer()->append("hello\n"); // Nothing is written yet.
+//   writer.Buffer()->append("world\n"); // Nothing is written yet.
+//   writer.Flush();                     // "hello\nworld\n" is written.
+//
+// Buffered output is written to the stream, and the stream is flushed, when
+// `Flush` or `Sync` is called, when the BufferedWriter is destroyed, and when
+// `MaybeFlush` is called with at least `flush_threshold` bytes buffered.
+//
+// If `background` is true, output is instead handed to a background thread
+// which writes it, so that a slow stream (e.g. a terminal or a pipe to a slow
+// reader) doesn't block the caller. Output handed to the thread is still
+// written in order. So that a stream that can't keep up doesn't make the
+// output pile up in memory, `Flush` blocks while more than
+// `kBufferedWriterMaxPendingFlushes * flush_threshold` bytes are waiting to be
+// written. The stream must not be used by anyone else while the
+// BufferedWriter is alive.
+class BufferedWriter {
+ public:
+  BufferedWriter(std::ostream* out, std::size_t flush_threshold,
+                 bool background);
+
+  // Writes any buffered output and waits for the background thread, if any,
+  // to write everything handed to it.
+  ~BufferedWriter();
+  DISALLOW_COPY_AND_ASSIGN(BufferedWriter);
+
+  // The buffered output. Append to it to write output.
+  std::string* Buffer() { return &buffer_; }
+
+  // Flush if at least `flush_threshold` bytes are buffered.
+  void MaybeFlush() {
+    if (buffer_.size() >= flush_threshold_) {
+      Flush();
+    }
+  }
+
+  // Write the buffered output to the stream and flush it, or hand the output
+  // to the background thread, first waiting for the thread to catch up if too
+  // much output is waiting for it.
+  void Flush();
+
+  // Flush, and then wait for the background thread, if any, to write
+  // everything handed to it.
+  void Sync();
+
+ private:
+  // Write `output` to the stream and flush it.
+  void Write(const std::string& output);
+
+  // The body of the background thread.
+  void WriteOutput();
+
+  std::ostream* const out_;
+  const std::size_t flush_threshold_;
+  const bool background_;
+  const std::size_t max_pending_;
+  std::string buffer_;
+
+  // `pending_` is the output handed to the background thread but not yet
+  // written by it, and `writing_` is true while the thread writes. Both, and
+  // `done_`, are guarded by `mutex_`. `output_available_` is notified when
+  // output is handed to the thread or when the BufferedWriter is destroyed,
+  // and `output_written_` is notified when the thread finishes writing.
+  // `Flush` waits on `output_written_` while `pending_` holds more than
+  // `max_pending_` bytes.
+  std::mutex mutex_;
+  std::condition_variable output_available_;
+  std::condition_variable output_written_;
+  std::string pending_;
+  bool writing_ = false;
+  bool done_ = false;
+  std::thread thread_;
+};
+
+}  // namespace fluent
+
+#endif  // COMMON_BUFFERED_WRITER_H_
@@ -0,0 +1,137 @@
+#include "common/buffered_writer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+namespace fluent {
+namespace {
+
+// A streambuf whose writes block until `Release` is called.
+class BlockingStreambuf : public std::streambuf {
+ public:
+  void Release() {
+    {
+      std::unique_lock<std::mutex> l(mutex_);
+      released_ = true;
+    }
+    released_cv_.notify_all();
+  }
+
+  std::string str() const { return data_; }
+
+ protected:
+  std::streamsize xsputn(const char* s, std::streamsize n) override {
+    std::unique_lock<std::mutex> l(mutex_);
+    while (!released_) {
+      released_cv_.wait(l);
+    }
+    data_.append(s, n);
+    return n;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable released_cv_;
+  bool released_ = false;
+  std::string data_;
+};
+
+}  // namespace
+
+TEST(BufferedWriter, Flush) {
+  std::ostringstream out;
+  BufferedWriter writer(&out, 1024, false);
+  writer.Buffer()->append("hello\n");
+  writer.Buffer()->append("world\n");
+  EXPECT_EQ(out.str(), "");
+  writer.Flush();
+  EXPECT_EQ(out.str(), "hello\nworld\n");
+  EXPECT_TRUE(writer.Buffer()->empty());
+  writer.Flush();
+  EXPECT_EQ(out.str(), "hello\nworld\n");
+}
+
+TEST(BufferedWriter, MaybeFlush) {
+  std::ostringstream out;
+  BufferedWriter writer(&out, 4, false);
+  writer.Buffer()->append("abc");
+  writer.MaybeFlush();
+  EXPECT_EQ(out.str(), "");
+  writer.Buffer()->append("d");
+  writer.MaybeFlush();
+  EXPECT_EQ(out.str(), "abcd");
+}
+
+TEST(BufferedWriter, FlushOnDestruction) {
+  std::ostringstream out;
+  {
+    BufferedWriter writer(&out, 1024, false);
+    writer.Buffer()->append("hello");
+  }
+  EXPECT_EQ(out.str(), "hello");
+}
+
+TEST(BufferedWriter, Background) {
+  std::ostringstream out;
+  std::string expected;
+  {
+    BufferedWriter writer(&out, 16, true);
+    for (int i = 0; i < 1000; ++i) {
+      const std::string line = std::to_string(i) + "\n";
+      expected += line;
+      writer.Buffer()->append(line);
+      writer.MaybeFlush();
+    }
+    writer.Sync();
+    EXPECT_EQ(out.str(), expected);
+
+    writer.Buffer()->append("done\n");
+    expected += "done\n";
+    writer.Flush();
+  }
+  EXPECT_EQ(out.str(), expected);
+}
+
+TEST(BufferedWriter, BackgroundBacklogIsBounded) {
+  BlockingStreambuf buf;
+  std::ostream out(&buf);
+  std::string expected;
+  std::atomic<int> num_flushes(0);
+  std::thread t([&out, &expected, &num_flushes]() {
+    BufferedWriter writer(&out, 4, true);
+    for (int i = 0; i < 100; ++i) {
+      writer.Buffer()->append("abcd");
+      expected += "abcd";
+      writer.Flush();
+      num_flushes++;
+    }
+  });
+
+  // The background thread is stuck writing the first flush, so `Flush`
+  // blocks once a few more flushes are pending.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_LT(num_flushes.load(), 10);
+
+  buf.Release();
+  t.join();
+  EXPECT_EQ(num_flushes.load(), 100);
+  EXPECT_EQ(buf.str(), expected);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
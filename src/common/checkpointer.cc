@@ -0,0 +1,204 @@
+#include "common/checkpointer.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "glog/logging.h"
+
+namespace fluent {
+
+namespace {
+
+const char kSnapshotPrefix[] = "snapshot.";
+const char kLogPrefix[] = "log.";
+const char kTmpSuffix[] = ".tmp";
+
+Status ErrnoStatus(const std::string& what, const std::string& path) {
+  return Status(ErrorCode::INTERNAL,
+                fmt::format("{} '{}' failed: {}.", what, path,
+                            std::strerror(errno)));
+}
+
+bool StartsWith(const std::string& s, const std::string& prefix) {
+  return s.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool EndsWith(const std::string& s, const std::string& suffix) {
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// If `name` is `prefix` followed by a non-negative integer, store the integer
+// in `index` and return true.
+bool ParseIndex(const std::string& name, const std::string& prefix,
+                int* index) {
+  if (!StartsWith(name, prefix) || name.size() == prefix.size()) {
+    return false;
+  }
+  const std::string digits = name.substr(prefix.size());
+  if (!std::all_of(digits.begin(), digits.end(),
+                   [](char c) { return c >= '0' && c <= '9'; })) {
+    return false;
+  }
+  *index = std::atoi(digits.c_str());
+  return true;
+}
+
+// The names of the entries of the directory `directory`.
+StatusOr<std::vector<std::string>> ListDirectory(const std::string& directory) {
+  DIR* dir = opendir(directory.c_str());
+  if (dir == nullptr) {
+    return ErrnoStatus("Opening directory", directory);
+  }
+  std::vector<std::string> names;
+  while (struct dirent* entry = readdir(dir)) {
+    names.push_back(entry->d_name);
+  }
+  closedir(dir);
+  return names;
+}
+
+}  // namespace
+
+StatusOr<std::unique_ptr<Checkpointer>> Checkpointer::Make(
+    const std::string& directory, CheckpointMode mode) {
+  if (mkdir(directory.c_str(), S_IRWXU) == -1 && errno != EEXIST) {
+    return ErrnoStatus("Creating directory", directory);
+  }
+
+  std::vector<std::string> names;
+  ASSIGN_OR_RETURN(names, ListDirectory(directory));
+
+  std::unique_ptr<Checkpointer> checkpointer(
+      new Checkpointer(directory, mode));
+  int snapshot_index = -1;
+  std::vector<int> log_indexes;
+  for (const std::string& name : names) {
+    int index;
+    if (EndsWith(name, kTmpSuffix)) {
+      // A snapshot that was being written when the process crashed.
+      const std::string path = directory + "/" + name;
+      if (unlink(path.c_str()) == -1) {
+        return ErrnoStatus("Removing", path);
+      }
+    } else if (ParseIndex(name, kSnapshotPrefix, &index)) {
+      snapshot_index = std::max(snapshot_index, index);
+    } else if (ParseIndex(name, kLogPrefix, &index)) {
+      log_indexes.push_back(index);
+    }
+  }
+  checkpointer->Recover(snapshot_index, std::move(log_indexes));
+  return {std::move(checkpointer)};
+}
+
+void Checkpointer::Recover(int snapshot_index, std::vector<int> log_indexes) {
+  std::sort(log_indexes.begin(), log_indexes.end());
+  log_index_ = snapshot_index;
+  if (snapshot_index != -1) {
+    snapshot_ = SnapshotPath(snapshot_index);
+  }
+  for (int index : log_indexes) {
+    log_index_ = std::max(log_index_, index);
+    if (index >= snapshot_index) {
+      logs_.push_back(LogPath(index));
+    }
+  }
+}
+
+Checkpointer::~Checkpointer() {
+  Status status = Reap(true);
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+  }
+}
+
+Status Checkpointer::StartLogging() {
+  CHECK(log_ == nullptr) << "StartLogging called twice.";
+  RETURN_IF_ERROR(OpenLog(log_index_ + 1));
+  return SyncDirectory();
+}
+
+std::string Checkpointer::SnapshotPath(int index) const {
+  return fmt::format("{}/{}{}", directory_, kSnapshotPrefix, index);
+}
+
+std::string Checkpointer::LogPath(int index) const {
+  return fmt::format("{}/{}{}", directory_, kLogPrefix, index);
+}
+
+Status Checkpointer::OpenLog(int index) {
+  // A log with this index can only exist if the process crashed after
+  // creating it but before writing or syncing anything to it, so it is safe
+  // to truncate it.
+  ASSIGN_OR_RETURN(log_, RecordWriter::Make(LogPath(index), true));
+  log_index_ = index;
+  return Status::OK;
+}
+
+Status Checkpointer::SyncDirectory() const {
+  const int fd = open(directory_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd == -1) {
+    return ErrnoStatus("Opening directory", directory_);
+  }
+  const int result = fsync(fd);
+  close(fd);
+  if (result == -1) {
+    return ErrnoStatus("Syncing directory", directory_);
+  }
+  return Status::OK;
+}
+
+Status Checkpointer::RemoveBefore(int index) const {
+  std::vector<std::string> names;
+  ASSIGN_OR_RETURN(names, ListDirectory(directory_));
+  for (const std::string& name : names) {
+    int i;
+    if ((ParseIndex(name, kSnapshotPrefix, &i) ||
+         ParseIndex(name, kLogPrefix, &i)) &&
+        i < index) {
+      const std::string path = directory_ + "/" + name;
+      if (unlink(path.c_str()) == -1) {
+        return ErrnoStatus("Removing", path);
+      }
+    }
+  }
+  return SyncDirectory();
+}
+
+Status Checkpointer::Reap(bool block) {
+  if (snapshotter_ == -1) {
+    return Status::OK;
+  }
+
+  int wstatus;
+  pid_t pid;
+  do {
+    pid = waitpid(snapshotter_, &wstatus, block ? 0 : WNOHANG);
+  } while (pid == -1 && errno == EINTR);
+  if (pid == -1) {
+    return ErrnoStatus("Waiting for snapshot",
+                       SnapshotPath(snapshotter_index_));
+  }
+  if (pid == 0) {
+    // The snapshot is still being written.
+    return Status::OK;
+  }
+
+  const int index = snapshotter_index_;
+  snapshotter_ = -1;
+  snapshotter_index_ = -1;
+  if (!WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != 0) {
+    // The logs written since the previous snapshot are kept, so no state is
+    // lost; the next checkpoint will try again.
+    LOG(ERROR) << "Writing snapshot '" << SnapshotPath(index) << "' failed.";
+    return Status::OK;
+  }
+  return RemoveBefore(index);
+}
+
+}  // namespace fluent
@@ -0,0 +1,229 @@
+#ifndef COMMON_CHECKPOINTER_H_
+#define COMMON_CHECKPOINTER_H_
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fmt/format.h"
+#include "glog/logging.h"
+
+#include "common/macros.h"
+#include "common/record_file.h"
+#include "common/status.h"
+#include "common/status_macros.h"
+#include "common/status_or.h"
+
+namespace fluent {
+
+// How a Checkpointer writes a snapshot. See `Checkpointer::Checkpoint`.
+enum class CheckpointMode {
+  // Fork the process and write the snapshot from the child. The parent
+  // carries on immediately, and the kernel copies the pages the parent
+  // modifies while the child is writing, so the child sees the state at the
+  // time of the fork.
+  FORK,
+
+  // Write the snapshot before returning.
+  SYNCHRONOUS,
+};
+
+// A Checkpointer makes the state of a process durable with a combination of
+// periodic snapshots and a write-ahead log of the inputs received since the
+// last snapshot. It manages a directory of record files (see
+// common/record_file.h):
+//
+//   snapshot.<i>: a snapshot of the state of the process, and
+//   log.<i>:      the inputs received after snapshot <i> was taken.
+//
+// The state of the process is the latest snapshot (or the initial state, if
+// there is no snapshot) followed by every log from that snapshot on, in
+// order. Recovering from a crash takes time proportional to the size of the
+// latest snapshot and of the logs written since it was taken, not to the
+// length of the history of the process.
+//
+//   std::unique_ptr<Checkpointer> c = Checkpointer::Make(dir).Consume...();
+//
+//   // Recover.
+//   if (c->Snapshot() != "") { load c->Snapshot(); }
+//   for (const std::string& log : c->Logs()) { replay log; }
+//
+//   // Log inputs and take snapshots.
+//   RETURN_IF_ERROR(c->StartLogging());
+//   while (true) {
+//     c->Log({"some", "input"});
+//     RETURN_IF_ERROR(c->Sync());
+//     RETURN_IF_ERROR(c->Checkpoint([](RecordWriter* snapshot) { ... }));
+//   }
+//
+// Taking a checkpoint starts a new log, and once the snapshot is completely
+// written, the older snapshots and logs are deleted. Snapshots are written to
+// a temporary file and renamed into place, so a crash while writing one
+// leaves the previous snapshot and its logs intact.
+class Checkpointer {
+ public:
+  // Open (or create) the directory `directory` and find the latest snapshot
+  // and the logs written after it.
+  static WARN_UNUSED StatusOr<std::unique_ptr<Checkpointer>> Make(
+      const std::string& directory, CheckpointMode mode = CheckpointMode::FORK);
+
+  // Waits for any forked snapshot to finish.
+  ~Checkpointer();
+  DISALLOW_COPY_AND_ASSIGN(Checkpointer);
+
+  // The path of the latest snapshot found by `Make`, or the empty string if
+  // there is none.
+  const std::string& Snapshot() const { return snapshot_; }
+
+  // The paths of the logs found by `Make` that were written after
+  // `Snapshot()`, in the order in which they should be replayed.
+  const std::vector<std::string>& Logs() const { return logs_; }
+
+  // Start a new log. Must be called once, after recovery and before any
+  // call to `Log` or `Checkpoint`.
+  WARN_UNUSED Status StartLogging();
+
+  // Whether `StartLogging` has been called.
+  bool Logging() const { return log_ != nullptr; }
+
+  // Buffer the record `record` in the log. Buffered records are not durable
+  // until `Sync` is called.
+  void Log(const std::vector<std::string>& record) { log_->Append(record); }
+
+  // Wait for every logged record to reach the disk.
+  WARN_UNUSED Status Sync() { return log_->Sync(); }
+
+  // Start a new log and take a snapshot by calling `write(snapshot)`, where
+  // `write` has the signature `Status(RecordWriter*)`. In FORK mode, `write`
+  // is called in a child process, and `Checkpoint` returns as soon as the
+  // child is forked; if the previous forked snapshot hasn't finished yet, no
+  // checkpoint is taken.
+  //
+  // A snapshot that can't be written loses no state, since the logs written
+  // since the previous snapshot are kept, so the failure is logged and the
+  // next checkpoint tries again. Only a failure to sync or start a log, which
+  // would lose inputs, is returned.
+  template <typename F>
+  WARN_UNUSED Status Checkpoint(F write) {
+    LogIfError(Reap(false));
+    if (snapshotter_ != -1) {
+      return Status::OK;
+    }
+
+    RETURN_IF_ERROR(Sync());
+    const int index = log_index_ + 1;
+    RETURN_IF_ERROR(OpenLog(index));
+
+    if (mode_ == CheckpointMode::SYNCHRONOUS) {
+      Status status = WriteSnapshot(index, write);
+      if (!status.ok()) {
+        LOG(ERROR) << "Writing snapshot '" << SnapshotPath(index)
+                   << "' failed: " << status;
+        return Status::OK;
+      }
+      LogIfError(RemoveBefore(index));
+      return Status::OK;
+    }
+
+    const pid_t pid = fork();
+    if (pid == -1) {
+      LOG(ERROR) << "fork failed: " << std::strerror(errno) << ".";
+      return Status::OK;
+    }
+    if (pid == 0) {
+      // The child must not run the destructors or atexit handlers of the
+      // parent, so it exits with _exit.
+      _exit(WriteSnapshot(index, write).ok() ? 0 : 1);
+    }
+    snapshotter_ = pid;
+    snapshotter_index_ = index;
+    return Status::OK;
+  }
+
+  // Wait for a forked snapshot, if any, to finish. Like in `Checkpoint`, a
+  // snapshot that failed is logged rather than returned.
+  WARN_UNUSED Status WaitForCheckpoint() { return Reap(true); }
+
+ private:
+  Checkpointer(std::string directory, CheckpointMode mode)
+      : directory_(std::move(directory)),
+        mode_(mode),
+        log_index_(-1),
+        snapshotter_(-1),
+        snapshotter_index_(-1) {}
+
+  // Find the latest snapshot, snapshot.<snapshot_index> (or none, if
+  // `snapshot_index` is -1), and the logs written after it.
+  void Recover(int snapshot_index, std::vector<int> log_indexes);
+
+  std::string SnapshotPath(int index) const;
+  std::string LogPath(int index) const;
+
+  // Close the current log, if any, and start writing to log.<index>.
+  WARN_UNUSED Status OpenLog(int index);
+
+  // Write snapshot.<index> by calling `write` with a writer to a temporary
+  // file that is renamed into place once it is complete.
+  template <typename F>
+  WARN_UNUSED Status WriteSnapshot(int index, F& write) {
+    const std::string path = SnapshotPath(index);
+    const std::string tmp_path = path + ".tmp";
+    {
+      std::unique_ptr<RecordWriter> writer;
+      ASSIGN_OR_RETURN(writer, RecordWriter::Make(tmp_path, true));
+      RETURN_IF_ERROR(write(writer.get()));
+      RETURN_IF_ERROR(writer->Sync());
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+      return Status(ErrorCode::INTERNAL,
+                    fmt::format("Renaming '{}' failed: {}.", tmp_path,
+                                std::strerror(errno)));
+    }
+    return SyncDirectory();
+  }
+
+  // Make the creation, renaming, and deletion of files in the directory
+  // durable.
+  WARN_UNUSED Status SyncDirectory() const;
+
+  // Delete every snapshot and log older than `index`.
+  WARN_UNUSED Status RemoveBefore(int index) const;
+
+  // If a forked snapshot has finished (or, if `block` is true, once it
+  // finishes), delete the snapshots and logs it replaces. If the snapshot
+  // failed, the failure is logged and the logs are kept.
+  WARN_UNUSED Status Reap(bool block);
+
+  static void LogIfError(const Status& status) {
+    if (!status.ok()) {
+      LOG(ERROR) << status;
+    }
+  }
+
+  const std::string directory_;
+  const CheckpointMode mode_;
+
+  // See `Snapshot` and `Logs`.
+  std::string snapshot_;
+  std::vector<std::string> logs_;
+
+  // The current log is log.<log_index_>.
+  int log_index_;
+  std::unique_ptr<RecordWriter> log_;
+
+  // The pid of the child writing snapshot.<snapshotter_index_>, or -1.
+  pid_t snapshotter_;
+  int snapshotter_index_;
+};
+
+}  // namespace fluent
+
+#endif  // COMMON_CHECKPOINTER_H_
@@ -0,0 +1,170 @@
+#include "common/checkpointer.h"
+
+#include <cstdlib>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+namespace fluent {
+namespace {
+
+using Records = std::vector<std::vector<std::string>>;
+
+std::string MakeDirectory() {
+  char directory[] = "/tmp/fluent_checkpointer_test.XXXXXX";
+  CHECK(mkdtemp(directory) != nullptr);
+  return directory;
+}
+
+std::unique_ptr<Checkpointer> MakeCheckpointer(const std::string& directory,
+                                               CheckpointMode mode) {
+  StatusOr<std::unique_ptr<Checkpointer>> c =
+      Checkpointer::Make(directory, mode);
+  CHECK(c.ok()) << c.status();
+  return c.ConsumeValueOrDie();
+}
+
+Records ReadAll(const std::string& path) {
+  StatusOr<std::unique_ptr<RecordReader>> reader = RecordReader::Make(path);
+  CHECK(reader.ok()) << reader.status();
+  Records records;
+  std::vector<std::string> record;
+  while (reader.ValueOrDie()->Next(&record)) {
+    records.push_back(record);
+  }
+  return records;
+}
+
+Records ReadAll(const std::vector<std::string>& paths) {
+  Records records;
+  for (const std::string& path : paths) {
+    Records rs = ReadAll(path);
+    records.insert(records.end(), rs.begin(), rs.end());
+  }
+  return records;
+}
+
+// Log `records` and take a snapshot of `snapshot`.
+void LogAndCheckpoint(Checkpointer* c, const Records& records,
+                      const Records& snapshot) {
+  for (const std::vector<std::string>& record : records) {
+    c->Log(record);
+  }
+  ASSERT_TRUE(c->Sync().ok());
+  Status status = c->Checkpoint([&snapshot](RecordWriter* writer) {
+    for (const std::vector<std::string>& record : snapshot) {
+      writer->Append(record);
+    }
+    return Status::OK;
+  });
+  ASSERT_TRUE(status.ok()) << status;
+  ASSERT_TRUE(c->WaitForCheckpoint().ok());
+}
+
+class CheckpointerTest : public ::testing::TestWithParam<CheckpointMode> {};
+
+TEST_P(CheckpointerTest, EmptyDirectory) {
+  const std::string directory = MakeDirectory();
+  std::unique_ptr<Checkpointer> c = MakeCheckpointer(directory, GetParam());
+  EXPECT_EQ(c->Snapshot(), "");
+  EXPECT_EQ(c->Logs(), std::vector<std::string>{});
+}
+
+TEST_P(CheckpointerTest, LogsWithoutSnapshot) {
+  const std::string directory = MakeDirectory();
+  {
+    std::unique_ptr<Checkpointer> c = MakeCheckpointer(directory, GetParam());
+    ASSERT_TRUE(c->StartLogging().ok());
+    c->Log({"a"});
+    c->Log({"b", "c"});
+    ASSERT_TRUE(c->Sync().ok());
+  }
+  {
+    std::unique_ptr<Checkpointer> c = MakeCheckpointer(directory, GetParam());
+    EXPECT_EQ(c->Snapshot(), "");
+    EXPECT_EQ(ReadAll(c->Logs()), Records({{"a"}, {"b", "c"}}));
+    ASSERT_TRUE(c->StartLogging().ok());
+    c->Log({"d"});
+    ASSERT_TRUE(c->Sync().ok());
+  }
+  std::unique_ptr<Checkpointer> c = MakeCheckpointer(directory, GetParam());
+  EXPECT_EQ(c->Snapshot(), "");
+  EXPECT_EQ(ReadAll(c->Logs()), Records({{"a"}, {"b", "c"}, {"d"}}));
+}
+
+TEST_P(CheckpointerTest, SnapshotReplacesLogs) {
+  const std::string directory = MakeDirectory();
+  {
+    std::unique_ptr<Checkpointer> c = MakeCheckpointer(directory, GetParam());
+    ASSERT_TRUE(c->StartLogging().ok());
+    LogAndCheckpoint(c.get(), {{"a"}, {"b"}}, {{"ab"}});
+    c->Log({"c"});
+    ASSERT_TRUE(c->Sync().ok());
+  }
+  {
+    std::unique_ptr<Checkpointer> c = MakeCheckpointer(directory, GetParam());
+    EXPECT_EQ(ReadAll(c->Snapshot()), Records({{"ab"}}));
+    EXPECT_EQ(ReadAll(c->Logs()), Records({{"c"}}));
+    ASSERT_TRUE(c->StartLogging().ok());
+    LogAndCheckpoint(c.get(), {{"d"}}, {{"abcd"}});
+  }
+  std::unique_ptr<Checkpointer> c = MakeCheckpointer(directory, GetParam());
+  EXPECT_EQ(ReadAll(c->Snapshot()), Records({{"abcd"}}));
+  EXPECT_EQ(ReadAll(c->Logs()), Records({}));
+}
+
+TEST_P(CheckpointerTest, FailedSnapshotKeepsLogs) {
+  const std::string directory = MakeDirectory();
+  {
+    std::unique_ptr<Checkpointer> c = MakeCheckpointer(directory, GetParam());
+    ASSERT_TRUE(c->StartLogging().ok());
+    LogAndCheckpoint(c.get(), {{"a"}}, {{"a"}});
+    c->Log({"b"});
+    // A failed snapshot is logged, not returned.
+    Status status = c->Checkpoint([](RecordWriter* writer) {
+      writer->Append({"partial"});
+      return Status(ErrorCode::INTERNAL, "");
+    });
+    EXPECT_TRUE(status.ok()) << status;
+    EXPECT_TRUE(c->WaitForCheckpoint().ok());
+    c->Log({"c"});
+    ASSERT_TRUE(c->Sync().ok());
+  }
+  std::unique_ptr<Checkpointer> c = MakeCheckpointer(directory, GetParam());
+  EXPECT_EQ(ReadAll(c->Snapshot()), Records({{"a"}}));
+  EXPECT_EQ(ReadAll(c->Logs()), Records({{"b"}, {"c"}}));
+}
+
+TEST_P(CheckpointerTest, CheckpointAfterFailedSnapshot) {
+  const std::string directory = MakeDirectory();
+  {
+    std::unique_ptr<Checkpointer> c = MakeCheckpointer(directory, GetParam());
+    ASSERT_TRUE(c->StartLogging().ok());
+    c->Log({"a"});
+    Status status = c->Checkpoint(
+        [](RecordWriter*) { return Status(ErrorCode::INTERNAL, ""); });
+    ASSERT_TRUE(status.ok()) << status;
+    ASSERT_TRUE(c->WaitForCheckpoint().ok());
+    LogAndCheckpoint(c.get(), {{"b"}}, {{"ab"}});
+  }
+  std::unique_ptr<Checkpointer> c = MakeCheckpointer(directory, GetParam());
+  EXPECT_EQ(ReadAll(c->Snapshot()), Records({{"ab"}}));
+  EXPECT_EQ(ReadAll(c->Logs()), Records({}));
+}
+
+INSTANTIATE_TEST_CASE_P(Modes, CheckpointerTest,
+                        ::testing::Values(CheckpointMode::FORK,
+                                          CheckpointMode::SYNCHRONOUS));
+
+}  // namespace
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,121 @@
+#ifndef COMMON_DEDUP_BUFFER_H_
+#define COMMON_DEDUP_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "common/macros.h"
+
+namespace fluent {
+
+// A DedupBuffer is an append-only buffer of values and their hashes that can
+// drop duplicate values as they are appended. It is the buffer into which a
+// FluentExecutor collects the output of a rule before inserting it into the
+// rule's collection.
+//
+//   DedupBuffer<std::tuple<int>> buffer;
+//   buffer.Insert(std::tuple<int>(1), Hash<std::tuple<int>>()({1}));  // true
+//   buffer.Insert(std::tuple<int>(1), Hash<std::tuple<int>>()({1}));  // false
+//   buffer.Append(std::tuple<int>(1), Hash<std::tuple<int>>()({1}));
+//   buffer.Values().size();  // 2
+//   buffer.Clear();
+//
+// Duplicates are detected with an open-addressing hash table of indexes into
+// the buffer, keyed by the hash passed in by the caller, so inserting a value
+// doesn't rehash it, allocate a node, or compare it with more than a couple of
+// other values. `Clear` empties the buffer but keeps its memory, so a buffer
+// that is reused (e.g. every tick) stops allocating once it has grown to fit
+// its largest batch.
+template <typename T>
+class DedupBuffer {
+ public:
+  using value_type = std::pair<T, std::size_t>;
+
+  DedupBuffer() : num_indexed_(0) {}
+  DISALLOW_COPY_AND_ASSIGN(DedupBuffer);
+  DEFAULT_MOVE_AND_ASSIGN(DedupBuffer);
+
+  // Append `t`, whose hash is `hash`, unless a value equal to `t` was already
+  // inserted with `Insert`. Returns whether `t` was appended.
+  template <typename U>
+  bool Insert(U&& t, std::size_t hash) {
+    if (2 * (num_indexed_ + 1) > slots_.size()) {
+      Grow();
+    }
+    const std::size_t mask = slots_.size() - 1;
+    for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+      const std::uint32_t slot = slots_[i];
+      if (slot == kEmpty) {
+        slots_[i] = static_cast<std::uint32_t>(values_.size());
+        values_.emplace_back(std::forward<U>(t), hash);
+        num_indexed_++;
+        return true;
+      }
+      const value_type& v = values_[slot];
+      if (v.second == hash && v.first == t) {
+        return false;
+      }
+    }
+  }
+
+  // Append `t`, whose hash is `hash`, without checking for duplicates. A
+  // buffer should be filled with either `Insert` or `Append`, but not both,
+  // between calls to `Clear`.
+  template <typename U>
+  void Append(U&& t, std::size_t hash) {
+    values_.emplace_back(std::forward<U>(t), hash);
+  }
+
+  // The values appended since the last call to `Clear`, in the order in which
+  // they were appended. Values may be moved out of the buffer.
+  std::vector<value_type>& Values() { return values_; }
+
+  // Remove every value, keeping the memory of the buffer.
+  void Clear() {
+    values_.clear();
+    if (num_indexed_ > 0) {
+      std::fill(slots_.begin(), slots_.end(), kEmpty);
+      num_indexed_ = 0;
+    }
+  }
+
+ private:
+  static constexpr std::uint32_t kEmpty = static_cast<std::uint32_t>(-1);
+
+  // Double the number of slots and reinsert every indexed value.
+  void Grow() {
+    const std::size_t num_slots = std::max<std::size_t>(16, 2 * slots_.size());
+    CHECK_LT(values_.size(), static_cast<std::size_t>(kEmpty));
+    slots_.assign(num_slots, kEmpty);
+    const std::size_t mask = num_slots - 1;
+    for (std::size_t j = 0; j < values_.size(); ++j) {
+      std::size_t i = values_[j].second & mask;
+      while (slots_[i] != kEmpty) {
+        i = (i + 1) & mask;
+      }
+      slots_[i] = static_cast<std::uint32_t>(j);
+    }
+    num_indexed_ = values_.size();
+  }
+
+  std::vector<value_type> values_;
+
+  // `slots_[i]` is the index into `values_` of a value whose hash, modulo the
+  // number of slots, is at or before `i`, or `kEmpty`. The number of slots is
+  // a power of two and is at least twice the number of indexed values.
+  std::vector<std::uint32_t> slots_;
+  std::size_t num_indexed_;
+};
+
+template <typename T>
+constexpr std::uint32_t DedupBuffer<T>::kEmpty;
+
+}  // namespace fluent
+
+#endif  // COMMON_DEDUP_BUFFER_H_
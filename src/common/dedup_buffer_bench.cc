@@ -0,0 +1,118 @@
+#include "common/dedup_buffer.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "glog/logging.h"
+
+#include "common/hash_util.h"
+
+// These benchmarks measure the cost of buffering the output of a rule before
+// inserting it into the rule's collection (see `FluentExecutor::ExecuteRule`).
+// Every iteration buffers `state.range(0)` tuples, a quarter of which are
+// duplicates, and then drains the buffer. The tuples look like the tuples a
+// chat server multicasts to its clients: an address, an id, and a message.
+
+namespace fluent {
+namespace {
+
+using TupleType = std::tuple<std::string, std::int64_t, std::string>;
+
+// `n` tuples, every fourth of which is a duplicate of the tuple before it.
+std::vector<TupleType> MakeTuples(std::size_t n) {
+  std::vector<TupleType> ts;
+  for (std::size_t i = 0; i < n; ++i) {
+    const std::size_t j = (i % 4 == 3) ? i - 1 : i;
+    ts.push_back(TupleType("tcp://10.0.0." + std::to_string(j % 256) + ":8000",
+                           j, "a chat message of moderate length"));
+  }
+  return ts;
+}
+
+}  // namespace
+
+// A std::set, which allocates a node and compares whole tuples for every
+// tuple.
+void SetBench(benchmark::State& state) {
+  const std::vector<TupleType> ts = MakeTuples(state.range(0));
+  Hash<TupleType> hash;
+  while (state.KeepRunning()) {
+    std::set<TupleType> buffer;
+    for (const TupleType& t : ts) {
+      benchmark::DoNotOptimize(hash(t));
+      buffer.insert(t);
+    }
+    benchmark::DoNotOptimize(buffer.size());
+  }
+  state.SetItemsProcessed(state.iterations() * ts.size());
+}
+BENCHMARK(SetBench)->Range(8, 8 << 10);
+
+// A vector that is sorted and deduplicated once it's full.
+void SortUniqueBench(benchmark::State& state) {
+  const std::vector<TupleType> ts = MakeTuples(state.range(0));
+  Hash<TupleType> hash;
+  std::vector<std::pair<TupleType, std::size_t>> buffer;
+  while (state.KeepRunning()) {
+    buffer.clear();
+    for (const TupleType& t : ts) {
+      buffer.emplace_back(t, hash(t));
+    }
+    std::sort(buffer.begin(), buffer.end());
+    buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+    benchmark::DoNotOptimize(buffer.size());
+  }
+  state.SetItemsProcessed(state.iterations() * ts.size());
+}
+BENCHMARK(SortUniqueBench)->Range(8, 8 << 10);
+
+// A DedupBuffer, reused across iterations, that drops duplicates by hash (as
+// the output of a rule into a channel or stdout is buffered).
+void DedupBufferInsertBench(benchmark::State& state) {
+  const std::vector<TupleType> ts = MakeTuples(state.range(0));
+  Hash<TupleType> hash;
+  DedupBuffer<TupleType> buffer;
+  while (state.KeepRunning()) {
+    buffer.Clear();
+    for (const TupleType& t : ts) {
+      buffer.Insert(t, hash(t));
+    }
+    benchmark::DoNotOptimize(buffer.Values().size());
+  }
+  state.SetItemsProcessed(state.iterations() * ts.size());
+}
+BENCHMARK(DedupBufferInsertBench)->Range(8, 8 << 10);
+
+// A DedupBuffer, reused across iterations, that keeps duplicates (as the
+// output of a rule into a table, scratch, or periodic is buffered).
+void DedupBufferAppendBench(benchmark::State& state) {
+  const std::vector<TupleType> ts = MakeTuples(state.range(0));
+  Hash<TupleType> hash;
+  DedupBuffer<TupleType> buffer;
+  while (state.KeepRunning()) {
+    buffer.Clear();
+    for (const TupleType& t : ts) {
+      buffer.Append(t, hash(t));
+    }
+    benchmark::DoNotOptimize(buffer.Values().size());
+  }
+  state.SetItemsProcessed(state.iterations() * ts.size());
+}
+BENCHMARK(DedupBufferAppendBench)->Range(8, 8 << 10);
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
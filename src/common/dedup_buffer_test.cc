@@ -0,0 +1,83 @@
+#include "common/dedup_buffer.h"
+
+#include <cstddef>
+
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+#include "common/hash_util.h"
+
+namespace fluent {
+
+using Tuple = std::tuple<int, std::string>;
+using Values = std::vector<std::pair<Tuple, std::size_t>>;
+
+std::size_t HashOf(const Tuple& t) { return Hash<Tuple>()(t); }
+
+TEST(DedupBuffer, InsertDropsDuplicates) {
+  DedupBuffer<Tuple> buffer;
+  const Tuple a(1, "a");
+  const Tuple b(2, "b");
+  EXPECT_TRUE(buffer.Insert(a, HashOf(a)));
+  EXPECT_TRUE(buffer.Insert(b, HashOf(b)));
+  EXPECT_FALSE(buffer.Insert(a, HashOf(a)));
+  EXPECT_FALSE(buffer.Insert(Tuple(2, "b"), HashOf(b)));
+  EXPECT_EQ(buffer.Values(), Values({{a, HashOf(a)}, {b, HashOf(b)}}));
+}
+
+TEST(DedupBuffer, AppendKeepsDuplicates) {
+  DedupBuffer<Tuple> buffer;
+  const Tuple a(1, "a");
+  buffer.Append(a, HashOf(a));
+  buffer.Append(a, HashOf(a));
+  EXPECT_EQ(buffer.Values(), Values({{a, HashOf(a)}, {a, HashOf(a)}}));
+}
+
+TEST(DedupBuffer, CollidingHashes) {
+  // Distinct values with the same hash are all kept.
+  DedupBuffer<Tuple> buffer;
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(buffer.Insert(Tuple(i, ""), 42));
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_FALSE(buffer.Insert(Tuple(i, ""), 42));
+  }
+  EXPECT_EQ(buffer.Values().size(), static_cast<std::size_t>(100));
+}
+
+TEST(DedupBuffer, GrowAndClear) {
+  DedupBuffer<Tuple> buffer;
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 10000; ++i) {
+      const Tuple t(i % 5000, "x");
+      EXPECT_EQ(buffer.Insert(t, HashOf(t)), i < 5000);
+    }
+    ASSERT_EQ(buffer.Values().size(), static_cast<std::size_t>(5000));
+    for (int i = 0; i < 5000; ++i) {
+      EXPECT_EQ(std::get<0>(buffer.Values()[i].first), i);
+    }
+    buffer.Clear();
+    EXPECT_EQ(buffer.Values().size(), static_cast<std::size_t>(0));
+  }
+}
+
+TEST(DedupBuffer, MovesValues) {
+  DedupBuffer<Tuple> buffer;
+  Tuple a(1, std::string(100, 'a'));
+  const std::size_t hash = HashOf(a);
+  EXPECT_TRUE(buffer.Insert(std::move(a), hash));
+  EXPECT_EQ(std::get<1>(buffer.Values()[0].first), std::string(100, 'a'));
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -2,7 +2,10 @@
 
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <set>
+#include <string>
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
@@ -12,9 +15,45 @@
 namespace fluent {
 
 TEST(Hash, HashBuiltins) {
-  EXPECT_EQ(Hash<bool>()(true), std::hash<bool>()(true));
-  EXPECT_EQ(Hash<char>()('a'), std::hash<char>()('a'));
-  EXPECT_EQ(Hash<int>()(42), std::hash<int>()(42));
+  EXPECT_EQ(Hash<bool>()(true), WyHash64(1));
+  EXPECT_EQ(Hash<char>()('a'), WyHash64('a'));
+  EXPECT_EQ(Hash<int>()(42), WyHash64(42));
+  EXPECT_EQ(Hash<std::string>()("foo"), WyHash64("foo", 3));
+  EXPECT_EQ(Hash<double>()(4.2), std::hash<double>()(4.2));
+}
+
+TEST(Hash, NearbyIntegersDiffer) {
+  // Unlike std::hash, Hash is not the identity function on integers, so the
+  // top bits of the hashes of consecutive integers differ.
+  std::set<std::size_t> top_bytes;
+  for (int i = 0; i < 16; ++i) {
+    top_bytes.insert(Hash<int>()(i) >> 56);
+  }
+  EXPECT_GT(top_bytes.size(), static_cast<std::size_t>(8));
+}
+
+TEST(WyHash64, EveryLengthAndByteMatters) {
+  // Exercise every code path of WyHash64: empty, 1-3, 4-16, 17-47, and 48 or
+  // more bytes.
+  std::string s;
+  std::set<std::uint64_t> hashes;
+  for (int i = 0; i < 200; ++i) {
+    hashes.insert(WyHash64(s.data(), s.size()));
+    s.push_back('a');
+  }
+  EXPECT_EQ(hashes.size(), static_cast<std::size_t>(200));
+
+  // Flipping any single bit of a long string changes its hash.
+  const std::string x(100, 'x');
+  const std::uint64_t hash_x = WyHash64(x.data(), x.size());
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    std::string y = x;
+    y[i] ^= 1;
+    EXPECT_NE(WyHash64(y.data(), y.size()), hash_x) << i;
+  }
+
+  // The seed changes the hash.
+  EXPECT_NE(WyHash64(x.data(), x.size(), 1), hash_x);
 }
 
 TEST(Hash, TimePointHash) {
@@ -80,6 +119,26 @@ TEST(Hash, TupleTupleHash) {
   EXPECT_EQ(hash_x, hash_z);
 }
 
+TEST(Fnv1a64, KnownValues) {
+  // http://www.isthe.com/chongo/src/fnv/test_fnv.c
+  EXPECT_EQ(Fnv1a64(""), 0xcbf29ce484222325ull);
+  EXPECT_EQ(Fnv1a64("a"), 0xaf63dc4c8601ec8cull);
+  EXPECT_EQ(Fnv1a64("foobar"), 0x85944171f73967e8ull);
+}
+
+TEST(Mix64, KnownValues) {
+  // The first outputs of SplitMix64 seeded with 0 are the mixes of multiples
+  // of its increment. See http://xorshift.di.unimi.it/splitmix64.c.
+  EXPECT_EQ(Mix64(0x9e3779b97f4a7c15ull), 0xe220a8397b1dcdafull);
+  EXPECT_EQ(Mix64(0x3c6ef372fe94f82aull), 0x6e789e6aa1b965f4ull);
+}
+
+TEST(Mix64, NearbyInputsDiffer) {
+  // Consecutive integers differ in their top bits after mixing.
+  EXPECT_NE(Mix64(1) >> 56, Mix64(2) >> 56);
+  EXPECT_EQ(Mix64(0), 0u);
+}
+
 }  // namespace fluent
 
 int main(int argc, char** argv) {
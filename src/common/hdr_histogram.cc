@@ -0,0 +1,159 @@
+#include "common/hdr_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "glog/logging.h"
+
+namespace fluent {
+
+HdrHistogram::HdrHistogram(std::int64_t highest_trackable_value,
+                           int significant_figures)
+    : highest_trackable_value_(highest_trackable_value),
+      significant_figures_(significant_figures),
+      total_count_(0),
+      min_(std::numeric_limits<std::int64_t>::max()),
+      max_(0) {
+  CHECK_GE(significant_figures, 1);
+  CHECK_LE(significant_figures, 5);
+  CHECK_GE(highest_trackable_value, 2);
+  CHECK_LE(highest_trackable_value,
+           std::numeric_limits<std::int64_t>::max() / 2);
+
+  // We need enough sub-buckets to tell apart two values that differ in their
+  // last significant figure.
+  const std::int64_t largest_value_with_single_unit_resolution =
+      2 * static_cast<std::int64_t>(std::pow(10, significant_figures));
+  sub_bucket_count_magnitude_ = static_cast<int>(
+      std::ceil(std::log2(largest_value_with_single_unit_resolution)));
+  sub_bucket_count_ = static_cast<std::int64_t>(1)
+                      << sub_bucket_count_magnitude_;
+  sub_bucket_half_count_ = sub_bucket_count_ / 2;
+  sub_bucket_mask_ = sub_bucket_count_ - 1;
+
+  // Bucket `i` covers values up to `sub_bucket_count_ << i`.
+  bucket_count_ = 1;
+  std::int64_t smallest_untrackable_value = sub_bucket_count_;
+  while (smallest_untrackable_value <= highest_trackable_value) {
+    smallest_untrackable_value <<= 1;
+    bucket_count_++;
+  }
+
+  counts_.resize((bucket_count_ + 1) * sub_bucket_half_count_, 0);
+}
+
+void HdrHistogram::Record(std::int64_t value, std::int64_t count) {
+  value = std::max<std::int64_t>(0, value);
+  value = std::min(value, highest_trackable_value_);
+  counts_[CountsIndex(value)] += count;
+  total_count_ += count;
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+}
+
+void HdrHistogram::Merge(const HdrHistogram& other) {
+  CHECK_EQ(highest_trackable_value_, other.highest_trackable_value_);
+  CHECK_EQ(significant_figures_, other.significant_figures_);
+  for (std::size_t i = 0; i < counts_.size(); ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  total_count_ += other.total_count_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+void HdrHistogram::Reset() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  total_count_ = 0;
+  min_ = std::numeric_limits<std::int64_t>::max();
+  max_ = 0;
+}
+
+std::int64_t HdrHistogram::Min() const {
+  return total_count_ == 0 ? 0 : min_;
+}
+
+std::int64_t HdrHistogram::Max() const { return max_; }
+
+double HdrHistogram::Mean() const {
+  if (total_count_ == 0) {
+    return 0;
+  }
+
+  double total = 0;
+  for (std::size_t i = 0; i < counts_.size(); ++i) {
+    if (counts_[i] != 0) {
+      const std::int64_t value = ValueFromIndex(i);
+      // The midpoint of the values equivalent to `value`.
+      const double midpoint = (value + HighestEquivalentValue(value)) / 2.0;
+      total += midpoint * counts_[i];
+    }
+  }
+  return total / total_count_;
+}
+
+std::int64_t HdrHistogram::ValueAtPercentile(double percentile) const {
+  if (total_count_ == 0) {
+    return 0;
+  }
+
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  const std::int64_t count_at_percentile = std::max<std::int64_t>(
+      1, static_cast<std::int64_t>(
+             std::ceil(percentile / 100.0 * total_count_)));
+  std::int64_t total = 0;
+  for (std::size_t i = 0; i < counts_.size(); ++i) {
+    total += counts_[i];
+    if (total >= count_at_percentile) {
+      return std::min(HighestEquivalentValue(ValueFromIndex(i)), max_);
+    }
+  }
+  return max_;
+}
+
+int HdrHistogram::BucketIndex(std::int64_t value) const {
+  // `value | sub_bucket_mask_` is never zero, so `__builtin_clzll` is defined.
+  const int pow2ceiling =
+      64 - __builtin_clzll(static_cast<unsigned long long>(value) |
+                           static_cast<unsigned long long>(sub_bucket_mask_));
+  return pow2ceiling - sub_bucket_count_magnitude_;
+}
+
+int HdrHistogram::SubBucketIndex(std::int64_t value, int bucket_index) const {
+  return static_cast<int>(value >> bucket_index);
+}
+
+std::size_t HdrHistogram::CountsIndex(std::int64_t value) const {
+  const int bucket_index = BucketIndex(value);
+  const int sub_bucket_index = SubBucketIndex(value, bucket_index);
+  const std::int64_t bucket_base_index = (bucket_index + 1)
+                                         << (sub_bucket_count_magnitude_ - 1);
+  return bucket_base_index + sub_bucket_index - sub_bucket_half_count_;
+}
+
+std::int64_t HdrHistogram::ValueFromIndex(std::size_t index) const {
+  const int half_count_magnitude = sub_bucket_count_magnitude_ - 1;
+  int bucket_index = static_cast<int>(index >> half_count_magnitude) - 1;
+  std::int64_t sub_bucket_index =
+      (index & (sub_bucket_half_count_ - 1)) + sub_bucket_half_count_;
+  if (bucket_index < 0) {
+    sub_bucket_index -= sub_bucket_half_count_;
+    bucket_index = 0;
+  }
+  return sub_bucket_index << bucket_index;
+}
+
+std::int64_t HdrHistogram::HighestEquivalentValue(std::int64_t value) const {
+  const int bucket_index = BucketIndex(value);
+  const int sub_bucket_index = SubBucketIndex(value, bucket_index);
+  const int adjusted_bucket_index =
+      sub_bucket_index >= sub_bucket_count_ ? bucket_index + 1 : bucket_index;
+  const std::int64_t lowest_equivalent_value =
+      static_cast<std::int64_t>(sub_bucket_index) << bucket_index;
+  const std::int64_t size_of_range = static_cast<std::int64_t>(1)
+                                     << adjusted_bucket_index;
+  return lowest_equivalent_value + size_of_range - 1;
+}
+
+}  // namespace fluent
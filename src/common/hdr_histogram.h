@@ -0,0 +1,95 @@
+#ifndef COMMON_HDR_HISTOGRAM_H_
+#define COMMON_HDR_HISTOGRAM_H_
+
+#include <cstdint>
+
+#include <vector>
+
+#include "common/macros.h"
+
+namespace fluent {
+
+// An HdrHistogram is a High Dynamic Range histogram [1] of non-negative
+// integers (e.g. latencies in microseconds). It records values between 0 and
+// `highest_trackable_value` with a fixed number of significant decimal digits
+// of precision, using a fixed amount of memory and constant time per value.
+// For example, a histogram with 3 significant digits reports 1,234,567 as
+// somewhere between 1,234,000 and 1,235,000.
+//
+//   HdrHistogram latencies(60 * 1000 * 1000, 3); // up to a minute in micros
+//   latencies.Record(120);
+//   latencies.Record(95);
+//   latencies.Record(4000);
+//   latencies.ValueAtPercentile(50.0); // 120
+//   latencies.Max();                   // 4000
+//
+// The values are grouped into buckets, where bucket `i` covers the values in
+// [2^i * s / 2, 2^(i + 1) * s / 2) for some power of two `s` (bucket 0 covers
+// [0, s)). Each bucket is divided into `s / 2` equally sized sub-buckets, so
+// the width of every sub-bucket is a fixed fraction of the values in it. This
+// implementation follows HdrHistogram_c [2] with a unit magnitude of 0.
+//
+// [1]: http://hdrhistogram.org/
+// [2]: https://github.com/HdrHistogram/HdrHistogram_c
+class HdrHistogram {
+ public:
+  // `significant_figures` must be between 1 and 5.
+  HdrHistogram(std::int64_t highest_trackable_value, int significant_figures);
+  DISALLOW_COPY_AND_ASSIGN(HdrHistogram);
+  DEFAULT_MOVE_AND_ASSIGN(HdrHistogram);
+
+  // Record `count` occurrences of `value`. Negative values are recorded as 0
+  // and values larger than `highest_trackable_value` are recorded as
+  // `highest_trackable_value`.
+  void Record(std::int64_t value, std::int64_t count = 1);
+
+  // Record every value recorded in `other`, which must have been constructed
+  // with the same arguments as this histogram.
+  void Merge(const HdrHistogram& other);
+
+  // Forget every recorded value.
+  void Reset();
+
+  std::int64_t TotalCount() const { return total_count_; }
+
+  // The smallest, largest, and mean recorded value. All three are 0 if no
+  // values have been recorded.
+  std::int64_t Min() const;
+  std::int64_t Max() const;
+  double Mean() const;
+
+  // The value below which `percentile` percent of the recorded values fall,
+  // where `percentile` is between 0 and 100. The value is reported at the
+  // precision of the histogram (i.e. it is the largest value equivalent to the
+  // recorded value). Returns 0 if no values have been recorded.
+  std::int64_t ValueAtPercentile(double percentile) const;
+
+ private:
+  int BucketIndex(std::int64_t value) const;
+  int SubBucketIndex(std::int64_t value, int bucket_index) const;
+  std::size_t CountsIndex(std::int64_t value) const;
+  std::int64_t ValueFromIndex(std::size_t index) const;
+  std::int64_t HighestEquivalentValue(std::int64_t value) const;
+
+  std::int64_t highest_trackable_value_;
+  int significant_figures_;
+
+  // Every bucket has `sub_bucket_count_` sub-buckets, but the bottom half of
+  // every bucket other than bucket 0 overlaps with the previous bucket, so
+  // only the top `sub_bucket_half_count_` sub-buckets of those buckets are
+  // stored in `counts_`.
+  int sub_bucket_count_magnitude_;
+  std::int64_t sub_bucket_count_;
+  std::int64_t sub_bucket_half_count_;
+  std::int64_t sub_bucket_mask_;
+  int bucket_count_;
+
+  std::vector<std::int64_t> counts_;
+  std::int64_t total_count_;
+  std::int64_t min_;
+  std::int64_t max_;
+};
+
+}  // namespace fluent
+
+#endif  // COMMON_HDR_HISTOGRAM_H_
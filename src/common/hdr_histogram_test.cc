@@ -0,0 +1,89 @@
+#include "common/hdr_histogram.h"
+
+#include <cstdint>
+
+#include <cmath>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+namespace fluent {
+
+TEST(HdrHistogram, EmptyHistogram) {
+  HdrHistogram h(1000 * 1000, 3);
+  EXPECT_EQ(h.TotalCount(), 0);
+  EXPECT_EQ(h.Min(), 0);
+  EXPECT_EQ(h.Max(), 0);
+  EXPECT_EQ(h.Mean(), 0.0);
+  EXPECT_EQ(h.ValueAtPercentile(50.0), 0);
+}
+
+TEST(HdrHistogram, SmallValuesAreExact) {
+  HdrHistogram h(1000 * 1000, 3);
+  for (std::int64_t i = 1; i <= 100; ++i) {
+    h.Record(i);
+  }
+  EXPECT_EQ(h.TotalCount(), 100);
+  EXPECT_EQ(h.Min(), 1);
+  EXPECT_EQ(h.Max(), 100);
+  EXPECT_DOUBLE_EQ(h.Mean(), 50.5);
+  EXPECT_EQ(h.ValueAtPercentile(0.0), 1);
+  EXPECT_EQ(h.ValueAtPercentile(50.0), 50);
+  EXPECT_EQ(h.ValueAtPercentile(99.0), 99);
+  EXPECT_EQ(h.ValueAtPercentile(100.0), 100);
+}
+
+TEST(HdrHistogram, LargeValuesHaveBoundedError) {
+  HdrHistogram h(1000 * 1000 * 1000, 3);
+  for (std::int64_t i = 1; i <= 10000; ++i) {
+    h.Record(i * 1000);
+  }
+  for (double p : {10.0, 50.0, 90.0, 99.0, 99.9}) {
+    const double expected = p * 100 * 1000;
+    const double actual = h.ValueAtPercentile(p);
+    EXPECT_LE(std::abs(actual - expected) / expected, 0.001) << p;
+  }
+  EXPECT_EQ(h.ValueAtPercentile(100.0), 10000 * 1000);
+}
+
+TEST(HdrHistogram, OutOfRangeValuesAreClamped) {
+  HdrHistogram h(1000, 3);
+  h.Record(-10);
+  h.Record(1000 * 1000);
+  EXPECT_EQ(h.Min(), 0);
+  EXPECT_EQ(h.Max(), 1000);
+}
+
+TEST(HdrHistogram, RecordCount) {
+  HdrHistogram h(1000, 3);
+  h.Record(1, 99);
+  h.Record(500);
+  EXPECT_EQ(h.TotalCount(), 100);
+  EXPECT_EQ(h.ValueAtPercentile(99.0), 1);
+  EXPECT_EQ(h.ValueAtPercentile(99.5), 500);
+}
+
+TEST(HdrHistogram, MergeAndReset) {
+  HdrHistogram x(1000 * 1000, 2);
+  HdrHistogram y(1000 * 1000, 2);
+  x.Record(10);
+  y.Record(20);
+  y.Record(30);
+  x.Merge(y);
+  EXPECT_EQ(x.TotalCount(), 3);
+  EXPECT_EQ(x.Min(), 10);
+  EXPECT_EQ(x.Max(), 30);
+  EXPECT_EQ(x.ValueAtPercentile(50.0), 20);
+
+  x.Reset();
+  EXPECT_EQ(x.TotalCount(), 0);
+  EXPECT_EQ(x.ValueAtPercentile(50.0), 0);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,71 @@
+#include "common/hyper_log_log.h"
+
+#include <cstddef>
+
+#include <algorithm>
+#include <cmath>
+
+#include "glog/logging.h"
+
+namespace fluent {
+
+HyperLogLog::HyperLogLog(int precision)
+    : precision_(precision),
+      registers_(static_cast<std::size_t>(1) << precision, 0) {
+  CHECK_GE(precision, 4);
+  CHECK_LE(precision, 16);
+}
+
+void HyperLogLog::Add(std::uint64_t hash) {
+  // The top `precision_` bits of `hash` pick a register, and the register
+  // records the largest number of leading zeros (plus one) seen in the
+  // remaining bits. The sentinel bit bounds the rank when the remaining bits
+  // are all zero and keeps `__builtin_clzll` defined.
+  const std::size_t index = hash >> (64 - precision_);
+  const std::uint64_t sentinel = static_cast<std::uint64_t>(1)
+                                 << (precision_ - 1);
+  const std::uint64_t rest = (hash << precision_) | sentinel;
+  const std::uint8_t rank = static_cast<std::uint8_t>(
+      __builtin_clzll(static_cast<unsigned long long>(rest)) + 1);
+  registers_[index] = std::max(registers_[index], rank);
+}
+
+void HyperLogLog::Merge(const HyperLogLog& other) {
+  CHECK_EQ(precision_, other.precision_);
+  for (std::size_t i = 0; i < registers_.size(); ++i) {
+    registers_[i] = std::max(registers_[i], other.registers_[i]);
+  }
+}
+
+void HyperLogLog::Reset() {
+  std::fill(registers_.begin(), registers_.end(), 0);
+}
+
+double HyperLogLog::Estimate() const {
+  const double m = static_cast<double>(registers_.size());
+  double alpha = 0.7213 / (1.0 + 1.079 / m);
+  if (registers_.size() == 16) {
+    alpha = 0.673;
+  } else if (registers_.size() == 32) {
+    alpha = 0.697;
+  } else if (registers_.size() == 64) {
+    alpha = 0.709;
+  }
+
+  double sum = 0;
+  std::size_t num_zeros = 0;
+  for (const std::uint8_t r : registers_) {
+    sum += std::ldexp(1.0, -r);
+    num_zeros += r == 0 ? 1 : 0;
+  }
+
+  // With 64-bit hashes, we only need the small range correction (linear
+  // counting) of the original paper, not the large range correction.
+  const double estimate = alpha * m * m / sum;
+  if (estimate <= 2.5 * m && num_zeros != 0) {
+    return m * std::log(m / num_zeros);
+  }
+  return estimate;
+}
+
+}  // namespace fluent
@@ -0,0 +1,58 @@
+#ifndef COMMON_HYPER_LOG_LOG_H_
+#define COMMON_HYPER_LOG_LOG_H_
+
+#include <cstdint>
+
+#include <vector>
+
+#include "common/macros.h"
+
+namespace fluent {
+
+// A HyperLogLog [1] estimates the number of distinct values added to it using a
+// small, fixed amount of memory and constant time per value. Values are added
+// by their 64-bit hashes, which must look random (see `Mix64` in
+// common/hash_util.h).
+//
+//   HyperLogLog distinct(8);
+//   for (int x : {1, 2, 2, 3, 3, 3}) {
+//     distinct.Add(Mix64(x));
+//   }
+//   distinct.Estimate(); // roughly 3
+//
+// A HyperLogLog with precision `p` uses 2^p one-byte registers and has a
+// relative standard error of roughly 1.04 / sqrt(2^p) (e.g. 6.5% for p = 8).
+// Adding the same value more than once has no effect, but values cannot be
+// removed.
+//
+// [1]: http://algo.inria.fr/flajolet/Publications/FlFuGaMe07.pdf
+class HyperLogLog {
+ public:
+  // `precision` must be between 4 and 16.
+  explicit HyperLogLog(int precision);
+  DISALLOW_COPY_AND_ASSIGN(HyperLogLog);
+  DEFAULT_MOVE_AND_ASSIGN(HyperLogLog);
+
+  void Add(std::uint64_t hash);
+
+  // Add every value added to `other`, which must have the same precision as
+  // this HyperLogLog.
+  void Merge(const HyperLogLog& other);
+
+  // Forget every added value.
+  void Reset();
+
+  // The estimated number of distinct values added. Returns 0 if no values
+  // have been added.
+  double Estimate() const;
+
+  int Precision() const { return precision_; }
+
+ private:
+  int precision_;
+  std::vector<std::uint8_t> registers_;
+};
+
+}  // namespace fluent
+
+#endif  // COMMON_HYPER_LOG_LOG_H_
@@ -0,0 +1,70 @@
+#include "common/hyper_log_log.h"
+
+#include <cstdint>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+#include "common/hash_util.h"
+
+namespace fluent {
+
+TEST(HyperLogLog, Empty) {
+  HyperLogLog h(8);
+  EXPECT_EQ(h.Estimate(), 0.0);
+}
+
+TEST(HyperLogLog, DuplicatesAreIgnored) {
+  HyperLogLog h(8);
+  for (int i = 0; i < 1000; ++i) {
+    h.Add(Mix64(i % 10));
+  }
+  EXPECT_NEAR(h.Estimate(), 10.0, 1.0);
+}
+
+TEST(HyperLogLog, SmallCardinalities) {
+  HyperLogLog h(8);
+  for (std::uint64_t i = 0; i < 100; ++i) {
+    h.Add(Mix64(i));
+  }
+  EXPECT_NEAR(h.Estimate(), 100.0, 10.0);
+}
+
+TEST(HyperLogLog, LargeCardinalities) {
+  HyperLogLog h(10);
+  for (std::uint64_t i = 0; i < 100 * 1000; ++i) {
+    h.Add(Mix64(i));
+  }
+  // The standard error with 2^10 registers is about 3.25%.
+  EXPECT_NEAR(h.Estimate(), 100.0 * 1000, 10.0 * 1000);
+}
+
+TEST(HyperLogLog, Merge) {
+  HyperLogLog a(8);
+  HyperLogLog b(8);
+  for (std::uint64_t i = 0; i < 1000; ++i) {
+    a.Add(Mix64(i));
+    b.Add(Mix64(i + 500));
+  }
+  a.Merge(b);
+  EXPECT_NEAR(a.Estimate(), 1500.0, 200.0);
+}
+
+TEST(HyperLogLog, Reset) {
+  HyperLogLog h(8);
+  for (std::uint64_t i = 0; i < 1000; ++i) {
+    h.Add(Mix64(i));
+  }
+  h.Reset();
+  EXPECT_EQ(h.Estimate(), 0.0);
+  h.Add(Mix64(42));
+  EXPECT_NEAR(h.Estimate(), 1.0, 0.1);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
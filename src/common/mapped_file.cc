@@ -0,0 +1,68 @@
+#include "common/mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "fmt/format.h"
+#include "glog/logging.h"
+
+#include "common/status.h"
+
+namespace fluent {
+
+namespace {
+
+Status ErrnoStatus(const std::string& what, const std::string& path) {
+  return Status(ErrorCode::INTERNAL,
+                fmt::format("{} '{}' failed: {}.", what, path,
+                            std::strerror(errno)));
+}
+
+}  // namespace
+
+StatusOr<std::unique_ptr<MappedFile>> MappedFile::Make(
+    const std::string& path, MappedFileAccess access) {
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return ErrnoStatus("Opening", path);
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == -1) {
+    Status status = ErrnoStatus("Statting", path);
+    close(fd);
+    return status;
+  }
+
+  // mmap fails for empty files, and there is nothing to map anyway.
+  const std::size_t size = st.st_size;
+  const char* data = nullptr;
+  if (size > 0) {
+    void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+      Status status = ErrnoStatus("Mapping", path);
+      close(fd);
+      return status;
+    }
+    madvise(p, size, access == MappedFileAccess::SEQUENTIAL ? MADV_SEQUENTIAL
+                                                            : MADV_RANDOM);
+    data = static_cast<const char*>(p);
+  }
+
+  // The mapping remains valid after the file is closed.
+  close(fd);
+  return std::unique_ptr<MappedFile>(new MappedFile(data, size));
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+}  // namespace fluent
@@ -0,0 +1,54 @@
+#ifndef COMMON_MAPPED_FILE_H_
+#define COMMON_MAPPED_FILE_H_
+
+#include <cstddef>
+
+#include <memory>
+#include <string>
+
+#include "common/macros.h"
+#include "common/status_or.h"
+
+namespace fluent {
+
+// How a MappedFile will be read, which tells the kernel which pages to read
+// ahead. See madvise(2).
+enum class MappedFileAccess {
+  SEQUENTIAL,
+  RANDOM,
+};
+
+// A MappedFile is a read-only memory mapping of an entire file, so that the
+// file can be parsed directly out of the page cache, without copying it into
+// a buffer first. The contents of the file are `Data()[0]`, ...,
+// `Data()[Size() - 1]`.
+//
+//   std::unique_ptr<MappedFile> file =
+//       MappedFile::Make(path).ConsumeValueOrDie();
+//   Parse(file->Data(), file->Size());
+//
+// The mapping is private, so changes made to the file while it is mapped may
+// or may not be visible through it.
+class MappedFile {
+ public:
+  static WARN_UNUSED StatusOr<std::unique_ptr<MappedFile>> Make(
+      const std::string& path,
+      MappedFileAccess access = MappedFileAccess::SEQUENTIAL);
+
+  ~MappedFile();
+  DISALLOW_COPY_AND_ASSIGN(MappedFile);
+
+  // The contents of the file, or null if the file is empty.
+  const char* Data() const { return data_; }
+  std::size_t Size() const { return size_; }
+
+ private:
+  MappedFile(const char* data, std::size_t size) : data_(data), size_(size) {}
+
+  const char* const data_;
+  const std::size_t size_;
+};
+
+}  // namespace fluent
+
+#endif  // COMMON_MAPPED_FILE_H_
@@ -0,0 +1,52 @@
+#include "common/mapped_file.h"
+
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+namespace fluent {
+namespace {
+
+const char kPath[] = "/tmp/fluent_mapped_file_test";
+
+void WriteFile(const std::string& contents) {
+  std::ofstream f(kPath, std::ios::binary | std::ios::trunc);
+  f << contents;
+}
+
+}  // namespace
+
+TEST(MappedFile, EmptyFile) {
+  WriteFile("");
+  StatusOr<std::unique_ptr<MappedFile>> file = MappedFile::Make(kPath);
+  ASSERT_TRUE(file.ok()) << file.status();
+  EXPECT_EQ(file.ValueOrDie()->Data(), nullptr);
+  EXPECT_EQ(file.ValueOrDie()->Size(), 0u);
+}
+
+TEST(MappedFile, Contents) {
+  const std::string contents("hello\0world\n", 12);
+  WriteFile(contents);
+  StatusOr<std::unique_ptr<MappedFile>> file =
+      MappedFile::Make(kPath, MappedFileAccess::RANDOM);
+  ASSERT_TRUE(file.ok()) << file.status();
+  const MappedFile& f = *file.ValueOrDie();
+  EXPECT_EQ(std::string(f.Data(), f.Size()), contents);
+}
+
+TEST(MappedFile, MissingFile) {
+  StatusOr<std::unique_ptr<MappedFile>> file =
+      MappedFile::Make("/tmp/fluent_mapped_file_test_does_not_exist");
+  EXPECT_FALSE(file.ok());
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,122 @@
+#include "common/mapped_heap.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+#include <algorithm>
+
+#include "fmt/format.h"
+#include "glog/logging.h"
+
+#include "common/status.h"
+
+namespace fluent {
+
+namespace {
+
+std::size_t AlignUp(std::size_t x, std::size_t alignment) {
+  return (x + alignment - 1) / alignment * alignment;
+}
+
+// Every allocation is rounded up to a multiple of `kAllocationAlignment`, so
+// that every allocation is aligned to it and is large enough to hold the free
+// list pointer of a freed allocation.
+constexpr std::size_t kAllocationAlignment = alignof(std::max_align_t);
+
+}  // namespace
+
+constexpr std::size_t MappedHeap::kDefaultCapacity;
+constexpr std::size_t MappedHeap::kGrowthBytes;
+
+StatusOr<std::unique_ptr<MappedHeap>> MappedHeap::Make(const std::string& path,
+                                                       std::size_t capacity) {
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC,
+                      S_IRUSR | S_IWUSR);
+  if (fd == -1) {
+    return Status(ErrorCode::INVALID_ARGUMENT,
+                  fmt::format("Unable to open '{}': {}.", path,
+                              std::strerror(errno)));
+  }
+  PCHECK(unlink(path.c_str()) == 0);
+
+  // The address space is reserved, but not backed by any memory, until it is
+  // mapped to the file by `Grow`.
+  capacity = AlignUp(capacity, sysconf(_SC_PAGESIZE));
+  void* base = mmap(nullptr, capacity, PROT_NONE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (base == MAP_FAILED) {
+    const int error = errno;
+    close(fd);
+    return Status(ErrorCode::RESOURCE_EXHAUSTED,
+                  fmt::format("Unable to reserve {} bytes for '{}': {}.",
+                              capacity, path, std::strerror(error)));
+  }
+
+  return std::unique_ptr<MappedHeap>(
+      new MappedHeap(fd, static_cast<char*>(base), capacity));
+}
+
+MappedHeap::MappedHeap(int fd, char* base, std::size_t capacity)
+    : fd_(fd),
+      base_(base),
+      capacity_(capacity),
+      mapped_(0),
+      offset_(0),
+      bytes_allocated_(0) {}
+
+MappedHeap::~MappedHeap() {
+  PCHECK(munmap(base_, capacity_) == 0);
+  close(fd_);
+}
+
+void* MappedHeap::Allocate(std::size_t size, std::size_t alignment) {
+  DCHECK_EQ(alignment & (alignment - 1), static_cast<std::size_t>(0));
+  DCHECK_LE(alignment, kAllocationAlignment);
+  size = AlignUp(std::max(size, sizeof(void*)), kAllocationAlignment);
+  bytes_allocated_ += size;
+
+  auto iter = free_lists_.find(size);
+  if (iter != free_lists_.end() && iter->second != nullptr) {
+    void* p = iter->second;
+    iter->second = *static_cast<void**>(p);
+    return p;
+  }
+
+  if (offset_ + size > mapped_) {
+    Grow(size);
+  }
+  void* p = base_ + offset_;
+  offset_ += size;
+  return p;
+}
+
+void MappedHeap::Deallocate(void* p, std::size_t size) {
+  size = AlignUp(std::max(size, sizeof(void*)), kAllocationAlignment);
+  DCHECK_GE(bytes_allocated_, size);
+  bytes_allocated_ -= size;
+
+  void*& head = free_lists_[size];
+  *static_cast<void**>(p) = head;
+  head = p;
+}
+
+void MappedHeap::Grow(std::size_t size) {
+  const std::size_t page_size = sysconf(_SC_PAGESIZE);
+  const std::size_t new_mapped = AlignUp(
+      std::max(mapped_ + kGrowthBytes, offset_ + size), page_size);
+  CHECK_LE(new_mapped, capacity_) << "MappedHeap of " << capacity_
+                                  << " bytes is full.";
+
+  PCHECK(ftruncate(fd_, new_mapped) == 0);
+  void* p = mmap(base_ + mapped_, new_mapped - mapped_, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_FIXED, fd_, mapped_);
+  PCHECK(p != MAP_FAILED);
+  mapped_ = new_mapped;
+}
+
+}  // namespace fluent
@@ -0,0 +1,149 @@
+#ifndef COMMON_MAPPED_HEAP_H_
+#define COMMON_MAPPED_HEAP_H_
+
+#include <cstddef>
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+#include "common/macros.h"
+#include "common/status_or.h"
+
+namespace fluent {
+
+// A MappedHeap is a memory allocator whose memory is backed by a file rather
+// than by anonymous memory. The file is memory-mapped with MAP_SHARED, so when
+// the machine runs low on memory, the kernel writes cold pages of a MappedHeap
+// back to the file and drops them from memory instead of swapping them out or
+// killing the process. The kernel's page cache acts as the MappedHeap's buffer
+// pool: recently used pages stay in memory, and the rest live on disk. This
+// lets a data structure allocated from a MappedHeap (e.g. the std::map of a
+// MappedTable) grow far larger than the memory of the machine.
+//
+//   std::unique_ptr<MappedHeap> heap =
+//       MappedHeap::Make("/mnt/ssd/t.heap").ConsumeValueOrDie();
+//   void* x = heap->Allocate(sizeof(int), alignof(int));
+//   heap->Deallocate(x, sizeof(int));
+//
+// A MappedHeap reserves `capacity` bytes of address space up front and maps
+// the file into it in increments of `kGrowthBytes` as it fills up, so the
+// address of an allocation never changes. Freed memory is kept on a free list
+// per allocation size and reused by later allocations of the same size.
+//
+// The file is scratch space. It is unlinked as soon as it is opened, so its
+// disk space is reclaimed when the MappedHeap is destroyed or the process
+// exits, and its contents are not reloaded on restart.
+class MappedHeap {
+ public:
+  // 64 GiB of address space.
+  static constexpr std::size_t kDefaultCapacity = std::size_t(64) << 30;
+  static constexpr std::size_t kGrowthBytes = std::size_t(16) << 20;
+
+  // Create a MappedHeap backed by a new file at `path`, truncating any file
+  // already at `path`.
+  static WARN_UNUSED StatusOr<std::unique_ptr<MappedHeap>> Make(
+      const std::string& path, std::size_t capacity = kDefaultCapacity);
+
+  ~MappedHeap();
+  DISALLOW_COPY_AND_ASSIGN(MappedHeap);
+
+  // Allocate `size` bytes aligned to `alignment`, which must be a power of two
+  // no larger than alignof(std::max_align_t). Allocating more than the
+  // capacity of the heap is a fatal error.
+  void* Allocate(std::size_t size, std::size_t alignment);
+
+  // Free `p`, which must have been returned by `Allocate(size, _)`.
+  void Deallocate(void* p, std::size_t size);
+
+  // The number of bytes currently allocated and not freed.
+  std::size_t BytesAllocated() const { return bytes_allocated_; }
+
+  // The number of bytes of the file that are mapped into memory.
+  std::size_t BytesMapped() const { return mapped_; }
+
+ private:
+  MappedHeap(int fd, char* base, std::size_t capacity);
+
+  // Map more of the file so that at least `size` more bytes can be allocated.
+  void Grow(std::size_t size);
+
+  const int fd_;
+  char* const base_;
+  const std::size_t capacity_;
+
+  // `base_[0, mapped_)` is mapped to the file, and `base_[0, offset_)` has
+  // been handed out by `Allocate`.
+  std::size_t mapped_;
+  std::size_t offset_;
+
+  // `free_lists_[size]` is the head of an intrusive linked list of freed
+  // allocations of `size` bytes. The first word of every freed allocation
+  // points to the next one.
+  std::unordered_map<std::size_t, void*> free_lists_;
+
+  std::size_t bytes_allocated_;
+};
+
+// A MappedHeapAllocator is an allocator [1] that allocates memory from a
+// MappedHeap.
+//
+//   std::unique_ptr<MappedHeap> heap = ...;
+//   MappedHeapAllocator<std::pair<const int, int>> alloc(heap.get());
+//   std::map<int, int, std::less<int>, decltype(alloc)> xs(alloc);
+//
+// A default constructed MappedHeapAllocator (or one constructed with a null
+// heap) allocates from the regular heap.
+//
+// [1]: http://en.cppreference.com/w/cpp/concept/Allocator
+template <typename T>
+class MappedHeapAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  MappedHeapAllocator() : heap_(nullptr) {}
+  explicit MappedHeapAllocator(MappedHeap* heap) : heap_(heap) {}
+  template <typename U>
+  MappedHeapAllocator(const MappedHeapAllocator<U>& other)
+      : heap_(other.heap()) {}
+
+  T* allocate(std::size_t n) {
+    if (heap_ == nullptr) {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    return static_cast<T*>(heap_->Allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* p, std::size_t n) {
+    if (heap_ == nullptr) {
+      ::operator delete(p);
+    } else {
+      heap_->Deallocate(p, n * sizeof(T));
+    }
+  }
+
+  MappedHeap* heap() const { return heap_; }
+
+ private:
+  MappedHeap* heap_;
+};
+
+template <typename T, typename U>
+bool operator==(const MappedHeapAllocator<T>& lhs,
+                const MappedHeapAllocator<U>& rhs) {
+  return lhs.heap() == rhs.heap();
+}
+
+template <typename T, typename U>
+bool operator!=(const MappedHeapAllocator<T>& lhs,
+                const MappedHeapAllocator<U>& rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace fluent
+
+#endif  // COMMON_MAPPED_HEAP_H_
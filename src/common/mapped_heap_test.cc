@@ -0,0 +1,106 @@
+#include "common/mapped_heap.h"
+
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+namespace fluent {
+namespace {
+
+const char kPath[] = "/tmp/fluent_mapped_heap_test.heap";
+
+std::unique_ptr<MappedHeap> MakeHeap() {
+  StatusOr<std::unique_ptr<MappedHeap>> heap = MappedHeap::Make(kPath);
+  CHECK(heap.ok()) << heap.status();
+  return heap.ConsumeValueOrDie();
+}
+
+}  // namespace
+
+TEST(MappedHeap, MakeUnlinksFile) {
+  std::unique_ptr<MappedHeap> heap = MakeHeap();
+  EXPECT_NE(access(kPath, F_OK), 0);
+}
+
+TEST(MappedHeap, MakeFailsOnBadPath) {
+  EXPECT_FALSE(MappedHeap::Make("/this/directory/does/not/exist").ok());
+}
+
+TEST(MappedHeap, AllocateAndDeallocate) {
+  std::unique_ptr<MappedHeap> heap = MakeHeap();
+  EXPECT_EQ(heap->BytesAllocated(), 0u);
+  EXPECT_EQ(heap->BytesMapped(), 0u);
+
+  int* x = static_cast<int*>(heap->Allocate(sizeof(int), alignof(int)));
+  double* y = static_cast<double*>(heap->Allocate(sizeof(double), 8));
+  *x = 42;
+  *y = 3.14;
+  EXPECT_EQ(*x, 42);
+  EXPECT_EQ(*y, 3.14);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(y) % alignof(double), 0u);
+  EXPECT_GT(heap->BytesAllocated(), 0u);
+  EXPECT_EQ(heap->BytesMapped(), MappedHeap::kGrowthBytes);
+
+  // Freed memory is reused by the next allocation of the same size.
+  heap->Deallocate(x, sizeof(int));
+  EXPECT_EQ(heap->Allocate(sizeof(int), alignof(int)), x);
+  heap->Deallocate(x, sizeof(int));
+  heap->Deallocate(y, sizeof(double));
+  EXPECT_EQ(heap->BytesAllocated(), 0u);
+}
+
+TEST(MappedHeap, GrowKeepsAddressesStable) {
+  std::unique_ptr<MappedHeap> heap = MakeHeap();
+  int* x = static_cast<int*>(heap->Allocate(sizeof(int), alignof(int)));
+  *x = 42;
+
+  // Allocate more than one growth increment.
+  const std::size_t size = MappedHeap::kGrowthBytes + 1;
+  char* big = static_cast<char*>(heap->Allocate(size, 1));
+  big[0] = 'a';
+  big[size - 1] = 'z';
+  EXPECT_GE(heap->BytesMapped(), 2 * MappedHeap::kGrowthBytes);
+  EXPECT_EQ(*x, 42);
+  EXPECT_EQ(big[0], 'a');
+  EXPECT_EQ(big[size - 1], 'z');
+}
+
+TEST(MappedHeap, MappedHeapAllocator) {
+  std::unique_ptr<MappedHeap> heap = MakeHeap();
+  using Alloc = MappedHeapAllocator<std::pair<const int, std::string>>;
+  std::map<int, std::string, std::less<int>, Alloc> xs{Alloc(heap.get())};
+  for (int i = 0; i < 1000; ++i) {
+    xs.emplace(i, std::to_string(i));
+  }
+  EXPECT_GT(heap->BytesAllocated(), 1000u * sizeof(std::pair<int, int>));
+  EXPECT_EQ(xs.at(500), "500");
+
+  xs.clear();
+  EXPECT_EQ(heap->BytesAllocated(), 0u);
+}
+
+TEST(MappedHeap, DefaultMappedHeapAllocatorUsesHeap) {
+  MappedHeapAllocator<int> alloc;
+  int* x = alloc.allocate(1);
+  *x = 42;
+  EXPECT_EQ(*x, 42);
+  alloc.deallocate(x, 1);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,153 @@
+#include "common/record_file.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include "fmt/format.h"
+#include "glog/logging.h"
+
+#include "common/hash_util.h"
+#include "common/status_macros.h"
+
+namespace fluent {
+
+namespace {
+
+// The size of the header of a record: its body size and checksum.
+constexpr std::size_t kHeaderSize = 4 + 8;
+
+void AppendUint(std::uint64_t x, std::size_t num_bytes, std::string* s) {
+  for (std::size_t i = 0; i < num_bytes; ++i) {
+    s->push_back(static_cast<char>(x >> (8 * i)));
+  }
+}
+
+std::uint64_t ReadUint(const char* data, std::size_t num_bytes) {
+  std::uint64_t x = 0;
+  for (std::size_t i = 0; i < num_bytes; ++i) {
+    x |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i]))
+         << (8 * i);
+  }
+  return x;
+}
+
+Status ErrnoStatus(const std::string& what, const std::string& path) {
+  return Status(ErrorCode::INTERNAL,
+                fmt::format("{} '{}' failed: {}.", what, path,
+                            std::strerror(errno)));
+}
+
+}  // namespace
+
+StatusOr<std::unique_ptr<RecordWriter>> RecordWriter::Make(
+    const std::string& path, bool truncate) {
+  const int flags =
+      O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (truncate ? O_TRUNC : 0);
+  const int fd = open(path.c_str(), flags, S_IRUSR | S_IWUSR);
+  if (fd == -1) {
+    return ErrnoStatus("Opening", path);
+  }
+  return std::unique_ptr<RecordWriter>(new RecordWriter(path, fd));
+}
+
+RecordWriter::~RecordWriter() {
+  Status status = Flush();
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+  }
+  close(fd_);
+}
+
+void AppendRecord(const std::vector<std::string>& record, std::string* buffer) {
+  std::string body;
+  AppendUint(record.size(), 4, &body);
+  for (const std::string& s : record) {
+    AppendUint(s.size(), 4, &body);
+    body += s;
+  }
+  AppendUint(body.size(), 4, buffer);
+  AppendUint(Fnv1a64(body), 8, buffer);
+  *buffer += body;
+}
+
+void RecordWriter::Append(const std::vector<std::string>& record) {
+  AppendRecord(record, &buffer_);
+}
+
+Status RecordWriter::Flush() {
+  std::size_t written = 0;
+  while (written < buffer_.size()) {
+    const ssize_t n =
+        write(fd_, buffer_.data() + written, buffer_.size() - written);
+    if (n == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return ErrnoStatus("Writing", path_);
+    }
+    written += n;
+  }
+  buffer_.clear();
+  return Status::OK;
+}
+
+Status RecordWriter::Sync() {
+  RETURN_IF_ERROR(Flush());
+  if (fdatasync(fd_) == -1) {
+    return ErrnoStatus("Syncing", path_);
+  }
+  return Status::OK;
+}
+
+StatusOr<std::unique_ptr<RecordReader>> RecordReader::Make(
+    const std::string& path) {
+  // The records are read in order, once.
+  std::unique_ptr<MappedFile> file;
+  ASSIGN_OR_RETURN(file, MappedFile::Make(path, MappedFileAccess::SEQUENTIAL));
+  return std::unique_ptr<RecordReader>(new RecordReader(std::move(file)));
+}
+
+bool RecordReader::Next(std::vector<std::string>* record) {
+  if (size_ - offset_ < kHeaderSize) {
+    return false;
+  }
+  const char* header = data_ + offset_;
+  const std::size_t body_size = ReadUint(header, 4);
+  const std::uint64_t checksum = ReadUint(header + 4, 8);
+  if (size_ - offset_ - kHeaderSize < body_size) {
+    return false;
+  }
+  const std::string body(header + kHeaderSize, body_size);
+  if (Fnv1a64(body) != checksum || body_size < 4) {
+    return false;
+  }
+
+  // The checksum matched, but we still check every size against the size of
+  // the body rather than trusting it.
+  std::size_t i = 0;
+  const std::size_t num_strings = ReadUint(body.data(), 4);
+  i += 4;
+  record->clear();
+  for (std::size_t j = 0; j < num_strings; ++j) {
+    if (body_size - i < 4) {
+      return false;
+    }
+    const std::size_t string_size = ReadUint(body.data() + i, 4);
+    i += 4;
+    if (body_size - i < string_size) {
+      return false;
+    }
+    record->emplace_back(body.data() + i, string_size);
+    i += string_size;
+  }
+
+  offset_ += kHeaderSize + body_size;
+  return true;
+}
+
+}  // namespace fluent
@@ -0,0 +1,117 @@
+#ifndef COMMON_RECORD_FILE_H_
+#define COMMON_RECORD_FILE_H_
+
+#include <cstddef>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/mapped_file.h"
+#include "common/status.h"
+#include "common/status_or.h"
+
+namespace fluent {
+
+// A record file is an append-only file of records, where every record is a
+// vector of strings. It is the on-disk format of both write-ahead logs and
+// snapshots (see common/checkpointer.h). Every record is laid out as
+//
+//   [body size: 4 bytes][checksum: 8 bytes][body]
+//   body = [number of strings: 4 bytes]
+//          [size of string 0: 4 bytes][string 0]
+//          [size of string 1: 4 bytes][string 1]
+//          ...
+//
+// where every integer is little-endian and the checksum is the FNV-1a hash of
+// the body (see common/hash_util.h). If a process crashes while appending to
+// a record file, the file may end with a partially written record. The
+// checksum lets a RecordReader detect and drop it.
+//
+//   std::unique_ptr<RecordWriter> writer =
+//       RecordWriter::Make(path).ConsumeValueOrDie();
+//   writer->Append({"a", "b"});
+//   RETURN_IF_ERROR(writer->Sync());
+//
+//   std::unique_ptr<RecordReader> reader =
+//       RecordReader::Make(path).ConsumeValueOrDie();
+//   std::vector<std::string> record;
+//   while (reader->Next(&record)) { ... }
+//
+// A RecordWriter buffers appended records in memory until it is flushed or
+// synced, so that appending a record doesn't make a system call.
+class RecordWriter {
+ public:
+  // Open the file at `path` for appending, creating it if it doesn't exist.
+  // If `truncate` is true, the file is emptied first.
+  static WARN_UNUSED StatusOr<std::unique_ptr<RecordWriter>> Make(
+      const std::string& path, bool truncate = false);
+
+  // Flushes, but doesn't sync, any buffered records.
+  ~RecordWriter();
+  DISALLOW_COPY_AND_ASSIGN(RecordWriter);
+
+  const std::string& Path() const { return path_; }
+
+  // Buffer the record `record`.
+  void Append(const std::vector<std::string>& record);
+
+  // The number of bytes of records appended but not yet flushed.
+  std::size_t BufferedBytes() const { return buffer_.size(); }
+
+  // Write every buffered record to the file.
+  WARN_UNUSED Status Flush();
+
+  // Write every buffered record to the file and wait for the file to reach
+  // the disk.
+  WARN_UNUSED Status Sync();
+
+ private:
+  RecordWriter(std::string path, int fd) : path_(std::move(path)), fd_(fd) {}
+
+  const std::string path_;
+  const int fd_;
+  std::string buffer_;
+};
+
+// Append the record `record`, laid out as described above, to `buffer`. This
+// is how records are written to something other than a file (e.g. stdout).
+void AppendRecord(const std::vector<std::string>& record, std::string* buffer);
+
+// A RecordReader reads the records of a record file in order. The file is
+// memory-mapped rather than read (see common/mapped_file.h), so the records
+// are parsed directly out of the page cache.
+class RecordReader {
+ public:
+  static WARN_UNUSED StatusOr<std::unique_ptr<RecordReader>> Make(
+      const std::string& path);
+
+  DISALLOW_COPY_AND_ASSIGN(RecordReader);
+
+  // Read the next record into `record`. Returns false if there are no more
+  // records or if the next record is partially written or corrupt, in which
+  // case it and every record after it are ignored.
+  bool Next(std::vector<std::string>* record);
+
+  // Whether every byte of the file has been read. If `Next` returns false and
+  // `AtEnd` returns false, the file ends with a corrupt record.
+  bool AtEnd() const { return offset_ == size_; }
+
+ private:
+  explicit RecordReader(std::unique_ptr<MappedFile> file)
+      : file_(std::move(file)),
+        data_(file_->Data()),
+        size_(file_->Size()),
+        offset_(0) {}
+
+  const std::unique_ptr<MappedFile> file_;
+  const char* const data_;
+  const std::size_t size_;
+  std::size_t offset_;
+};
+
+}  // namespace fluent
+
+#endif  // COMMON_RECORD_FILE_H_
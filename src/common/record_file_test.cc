@@ -0,0 +1,124 @@
+#include "common/record_file.h"
+
+#include <unistd.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+namespace fluent {
+namespace {
+
+const char kPath[] = "/tmp/fluent_record_file_test.records";
+
+std::unique_ptr<RecordWriter> MakeWriter(bool truncate = true) {
+  StatusOr<std::unique_ptr<RecordWriter>> writer =
+      RecordWriter::Make(kPath, truncate);
+  CHECK(writer.ok()) << writer.status();
+  return writer.ConsumeValueOrDie();
+}
+
+std::unique_ptr<RecordReader> MakeReader() {
+  StatusOr<std::unique_ptr<RecordReader>> reader = RecordReader::Make(kPath);
+  CHECK(reader.ok()) << reader.status();
+  return reader.ConsumeValueOrDie();
+}
+
+std::vector<std::vector<std::string>> ReadAll(RecordReader* reader) {
+  std::vector<std::vector<std::string>> records;
+  std::vector<std::string> record;
+  while (reader->Next(&record)) {
+    records.push_back(record);
+  }
+  return records;
+}
+
+}  // namespace
+
+TEST(RecordFile, EmptyFile) {
+  MakeWriter();
+  std::unique_ptr<RecordReader> reader = MakeReader();
+  EXPECT_EQ(ReadAll(reader.get()).size(), 0u);
+  EXPECT_TRUE(reader->AtEnd());
+}
+
+TEST(RecordFile, AppendAndRead) {
+  const std::vector<std::vector<std::string>> expected = {
+      {}, {"a"}, {"", "bc", std::string("\0\1\2", 3)}, {"last"}};
+  {
+    std::unique_ptr<RecordWriter> writer = MakeWriter();
+    writer->Append(expected[0]);
+    writer->Append(expected[1]);
+    ASSERT_TRUE(writer->Flush().ok());
+    writer->Append(expected[2]);
+    ASSERT_TRUE(writer->Sync().ok());
+    // Buffered records are flushed when the writer is destroyed.
+    writer->Append(expected[3]);
+  }
+
+  std::unique_ptr<RecordReader> reader = MakeReader();
+  EXPECT_EQ(ReadAll(reader.get()), expected);
+  EXPECT_TRUE(reader->AtEnd());
+}
+
+TEST(RecordFile, ReopenAppends) {
+  MakeWriter()->Append({"a"});
+  MakeWriter(false)->Append({"b"});
+  std::unique_ptr<RecordReader> reader = MakeReader();
+  const std::vector<std::vector<std::string>> expected = {{"a"}, {"b"}};
+  EXPECT_EQ(ReadAll(reader.get()), expected);
+}
+
+TEST(RecordFile, TornRecordIsDropped) {
+  {
+    std::unique_ptr<RecordWriter> writer = MakeWriter();
+    writer->Append({"a"});
+    writer->Append({"torn"});
+  }
+  // Chop off the last byte of the file, as if we crashed while writing it.
+  std::ifstream in(kPath, std::ios::binary);
+  std::string contents((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+  ASSERT_EQ(truncate(kPath, contents.size() - 1), 0);
+
+  std::unique_ptr<RecordReader> reader = MakeReader();
+  const std::vector<std::vector<std::string>> expected = {{"a"}};
+  EXPECT_EQ(ReadAll(reader.get()), expected);
+  EXPECT_FALSE(reader->AtEnd());
+}
+
+TEST(RecordFile, CorruptRecordIsDropped) {
+  {
+    std::unique_ptr<RecordWriter> writer = MakeWriter();
+    writer->Append({"a"});
+    writer->Append({"corrupt"});
+  }
+  // Flip the last byte of the file.
+  std::fstream f(kPath, std::ios::binary | std::ios::in | std::ios::out);
+  f.seekg(-1, std::ios::end);
+  const char c = static_cast<char>(f.get());
+  f.seekp(-1, std::ios::end);
+  f.put(static_cast<char>(c ^ 1));
+  f.close();
+
+  std::unique_ptr<RecordReader> reader = MakeReader();
+  const std::vector<std::vector<std::string>> expected = {{"a"}};
+  EXPECT_EQ(ReadAll(reader.get()), expected);
+  EXPECT_FALSE(reader->AtEnd());
+}
+
+TEST(RecordFile, MissingFile) {
+  EXPECT_FALSE(RecordReader::Make("/this/file/does/not/exist").ok());
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -64,6 +64,14 @@ struct SizetListFromIndexSequence<std::index_sequence<Is...>> {
   using type = SizetList<Is...>;
 };
 
+// Get
+template <typename SizetList, std::size_t I>
+struct SizetListGet;
+
+template <std::size_t... Is, std::size_t I>
+struct SizetListGet<SizetList<Is...>, I>
+    : public TypeListGet<TypeList<sizet_constant<Is>...>, I>::type {};
+
 // Take
 template <typename SizetList, std::size_t N>
 struct SizetListTake;
@@ -94,6 +102,26 @@ struct SizetListRange {
   using type = typename SizetListDrop<sizet_list, LowInclusive>::type;
 };
 
+// Concat
+template <typename... SizetLists>
+struct SizetListConcat;
+
+template <>
+struct SizetListConcat<> {
+  using type = SizetList<>;
+};
+
+template <std::size_t... Is, typename... SizetLists>
+struct SizetListConcat<SizetList<Is...>, SizetLists...> {
+  using tail = typename SizetListConcat<SizetLists...>::type;
+  using type = typename SizetListConcat<SizetList<Is...>, tail>::type;
+};
+
+template <std::size_t... Is, std::size_t... Js>
+struct SizetListConcat<SizetList<Is...>, SizetList<Js...>> {
+  using type = SizetList<Is..., Js...>;
+};
+
 }  // namespace fluent
 
 #endif  //  COMMON_SIZET_LIST_H_
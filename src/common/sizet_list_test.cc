@@ -132,6 +132,13 @@ TEST(SizetList, SizetListFromIndexSequence) {
   }
 }
 
+TEST(SizetList, SizetListGet) {
+  using sl = SizetList<4, 2, 7>;
+  static_assert(SizetListGet<sl, 0>::value == 4, "");
+  static_assert(SizetListGet<sl, 1>::value == 2, "");
+  static_assert(SizetListGet<sl, 2>::value == 7, "");
+}
+
 TEST(SizetList, SizetListTake) {
   using xs = SizetList<0, 1, 2, 3>;
   using zero = SizetList<>;
@@ -184,6 +191,25 @@ TEST(SizetList, SizetListRange) {
   static_assert(std::is_same<SizetListRange<4, 3>::type, sl43>::value, "");
 }
 
+TEST(SizetList, SizetListConcat) {
+  using sl0 = SizetList<>;
+  using sl1 = SizetList<1>;
+  using sl23 = SizetList<2, 3>;
+  using sl123 = SizetList<1, 2, 3>;
+  using sl12323 = SizetList<1, 2, 3, 2, 3>;
+
+  static_assert(std::is_same<SizetListConcat<>::type, sl0>::value, "");
+  static_assert(std::is_same<SizetListConcat<sl0>::type, sl0>::value, "");
+  static_assert(std::is_same<SizetListConcat<sl1>::type, sl1>::value, "");
+  static_assert(std::is_same<SizetListConcat<sl0, sl0>::type, sl0>::value,
+                "");
+  static_assert(std::is_same<SizetListConcat<sl1, sl23>::type, sl123>::value,
+                "");
+  static_assert(
+      std::is_same<SizetListConcat<sl1, sl0, sl23, sl23>::type, sl12323>::value,
+      "");
+}
+
 }  // namespace fluent
 
 int main(int argc, char** argv) {
@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <iterator>
 
+#include "fmt/format.h"
+
 namespace fluent {
 
 std::vector<std::string> Split(const std::string& s) {
@@ -25,4 +27,34 @@ std::string CrunchWhitespace(std::string s) {
   return s;
 }
 
+void AppendJsonString(const std::string& s, std::string* out) {
+  out->push_back('"');
+  for (const char c : s) {
+    switch (c) {
+      case '"':
+        *out += "\\\"";
+        break;
+      case '\\':
+        *out += "\\\\";
+        break;
+      case '\n':
+        *out += "\\n";
+        break;
+      case '\r':
+        *out += "\\r";
+        break;
+      case '\t':
+        *out += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          *out += fmt::format("\\u{:04x}", static_cast<int>(c));
+        } else {
+          out->push_back(c);
+        }
+    }
+  }
+  out->push_back('"');
+}
+
 }  // namespace fluent
@@ -86,6 +86,15 @@ std::vector<std::string> Split(const std::string& s);
 // CrunchWhitespace("\n \n")  == " "
 std::string CrunchWhitespace(std::string s);
 
+// AppendJsonString(s, &out) appends `s` to `out` as a quoted JSON string,
+// escaping quotes, backslashes, and control characters. Other bytes, including
+// those of multibyte UTF-8 characters, are appended as they are.
+//
+// AppendJsonString("a", &out)     appends "a"
+// AppendJsonString("a\"b", &out) appends "a\"b"
+// AppendJsonString("a\nb", &out) appends "a\nb"
+void AppendJsonString(const std::string& s, std::string* out);
+
 }  // namespace fluent
 
 #endif  //  COMMON_STRING_UTIL_H_
@@ -63,6 +63,22 @@ TEST(StringUtil, CrunchWhitespace) {
   EXPECT_EQ(CrunchWhitespace("\n \n"), " "s);
 }
 
+TEST(StringUtil, AppendJsonString) {
+  using namespace std::literals::string_literals;
+  auto json = [](const std::string& s) {
+    std::string out;
+    AppendJsonString(s, &out);
+    return out;
+  };
+  EXPECT_EQ(json(""), R"("")"s);
+  EXPECT_EQ(json("hello"), R"("hello")"s);
+  EXPECT_EQ(json("a\"b"), R"("a\"b")"s);
+  EXPECT_EQ(json("a\\b"), R"("a\\b")"s);
+  EXPECT_EQ(json("a\nb\rc\td"), R"("a\nb\rc\td")"s);
+  EXPECT_EQ(json(std::string("\x01\x1f", 2)), R"("\u0001\u001f")"s);
+  EXPECT_EQ(json("caf\xc3\xa9"), "\"caf\xc3\xa9\""s);
+}
+
 }  // namespace fluent
 
 int main(int argc, char** argv) {
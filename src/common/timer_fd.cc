@@ -0,0 +1,65 @@
+#include "common/timer_fd.h"
+
+#ifdef __linux__
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include "glog/logging.h"
+
+namespace fluent {
+
+#ifdef __linux__
+
+std::unique_ptr<TimerFd> TimerFd::Make() {
+  const int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (fd == -1) {
+    LOG(WARNING) << "timerfd_create failed: " << std::strerror(errno);
+    return nullptr;
+  }
+  return std::unique_ptr<TimerFd>(new TimerFd(fd));
+}
+
+TimerFd::~TimerFd() { close(fd_); }
+
+void TimerFd::Arm(std::chrono::nanoseconds timeout) {
+  CHECK_GT(timeout.count(), 0);
+  const std::chrono::seconds secs =
+      std::chrono::duration_cast<std::chrono::seconds>(timeout);
+  struct itimerspec spec;
+  std::memset(&spec, 0, sizeof(spec));
+  spec.it_value.tv_sec = secs.count();
+  spec.it_value.tv_nsec = (timeout - secs).count();
+  PCHECK(timerfd_settime(fd_, 0, &spec, nullptr) == 0);
+}
+
+void TimerFd::Clear() {
+  std::uint64_t expirations;
+  // The file descriptor is non-blocking, so if the timer hasn't expired, the
+  // read fails with EAGAIN and there is nothing to clear.
+  if (read(fd_, &expirations, sizeof(expirations)) == -1) {
+    PCHECK(errno == EAGAIN);
+  }
+}
+
+#else
+
+std::unique_ptr<TimerFd> TimerFd::Make() { return nullptr; }
+
+TimerFd::~TimerFd() {}
+
+void TimerFd::Arm(std::chrono::nanoseconds) {
+  LOG(FATAL) << "TimerFds are not supported on this platform.";
+}
+
+void TimerFd::Clear() {
+  LOG(FATAL) << "TimerFds are not supported on this platform.";
+}
+
+#endif
+
+}  // namespace fluent
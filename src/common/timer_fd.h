@@ -0,0 +1,53 @@
+#ifndef COMMON_TIMER_FD_H_
+#define COMMON_TIMER_FD_H_
+
+#include <chrono>
+#include <memory>
+
+#include "common/macros.h"
+
+namespace fluent {
+
+// A TimerFd is a one-shot timer that is exposed as a file descriptor [1]. The
+// file descriptor becomes readable when the timer expires, so a TimerFd can be
+// waited on in a poll set alongside sockets, with nanosecond rather than
+// millisecond resolution.
+//
+//   std::unique_ptr<TimerFd> timer = TimerFd::Make();
+//   if (timer != nullptr) {
+//     timer->Arm(std::chrono::microseconds(250));
+//     // Poll on timer->Fd() becoming readable.
+//     timer->Clear();
+//   }
+//
+// TimerFds are only supported on Linux. On other platforms, `Make` returns
+// nullptr and callers should fall back to a poll timeout.
+//
+// [1]: http://man7.org/linux/man-pages/man2/timerfd_create.2.html
+class TimerFd {
+ public:
+  // Returns nullptr if timerfds are not supported or cannot be created.
+  static std::unique_ptr<TimerFd> Make();
+
+  ~TimerFd();
+  DISALLOW_COPY_AND_ASSIGN(TimerFd);
+
+  int Fd() const { return fd_; }
+
+  // Arm the timer to expire `timeout` from now, replacing any previously armed
+  // timeout and clearing any unread expiration. `timeout` must be positive.
+  void Arm(std::chrono::nanoseconds timeout);
+
+  // Consume an expiration, if any, so that the file descriptor is no longer
+  // readable.
+  void Clear();
+
+ private:
+  explicit TimerFd(int fd) : fd_(fd) {}
+
+  const int fd_;
+};
+
+}  // namespace fluent
+
+#endif  // COMMON_TIMER_FD_H_
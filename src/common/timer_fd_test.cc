@@ -0,0 +1,57 @@
+#include "common/timer_fd.h"
+
+#include <poll.h>
+
+#include <chrono>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+namespace fluent {
+namespace {
+
+bool Readable(const TimerFd& timer, int timeout_ms) {
+  struct pollfd fd = {timer.Fd(), POLLIN, 0};
+  return ::poll(&fd, 1, timeout_ms) == 1 && (fd.revents & POLLIN);
+}
+
+}  // namespace
+
+TEST(TimerFd, ArmAndClear) {
+  std::unique_ptr<TimerFd> timer = TimerFd::Make();
+#ifdef __linux__
+  ASSERT_NE(timer, nullptr);
+#else
+  ASSERT_EQ(timer, nullptr);
+  return;
+#endif
+
+  // An unarmed timer is never readable.
+  EXPECT_FALSE(Readable(*timer, 0));
+
+  // An armed timer becomes readable once it expires and stays readable until
+  // it is cleared.
+  timer->Arm(std::chrono::microseconds(500));
+  EXPECT_TRUE(Readable(*timer, 1000));
+  EXPECT_TRUE(Readable(*timer, 0));
+  timer->Clear();
+  EXPECT_FALSE(Readable(*timer, 0));
+
+  // Clearing an unexpired timer is a noop.
+  timer->Clear();
+  EXPECT_FALSE(Readable(*timer, 0));
+
+  // Re-arming a timer replaces its previous timeout.
+  timer->Arm(std::chrono::seconds(10));
+  timer->Arm(std::chrono::microseconds(100));
+  EXPECT_TRUE(Readable(*timer, 1000));
+  timer->Clear();
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
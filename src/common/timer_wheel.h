@@ -0,0 +1,287 @@
+#ifndef COMMON_TIMER_WHEEL_H_
+#define COMMON_TIMER_WHEEL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "common/macros.h"
+
+namespace fluent {
+
+// A TimerWheel is a hierarchical timing wheel [1] which maps deadlines to
+// values of type `T`. Scheduling a timer and expiring a timer both take
+// amortized constant time, no matter how many timers are scheduled.
+//
+//   using time = std::chrono::system_clock::time_point;
+//   time start = std::chrono::system_clock::now();
+//   TimerWheel<std::chrono::system_clock, std::string> wheel(
+//       start, std::chrono::microseconds(100));
+//   wheel.Schedule(start + std::chrono::milliseconds(1), "a");
+//   wheel.Schedule(start + std::chrono::milliseconds(1), "b");
+//   wheel.Schedule(start + std::chrono::milliseconds(2), "c");
+//   wheel.Advance(start + std::chrono::milliseconds(1)); // {"a", "b"}
+//   wheel.Advance(start + std::chrono::milliseconds(5)); // {"c"}
+//
+// Time is divided into ticks of length `resolution` measured from `start`, and
+// every deadline is rounded up to the next tick. A timer never fires early,
+// and timers whose deadlines fall into the same tick fire together in a single
+// call to `Advance`.
+//
+// The wheel has `kNumLevels` levels of `kNumSlots` slots. A slot in level `l`
+// spans `kNumSlots^l` ticks. A timer is stored in the lowest level in which
+// its tick and the current tick share all higher-order digits (in base
+// `kNumSlots`). As the current tick advances past a slot boundary in level
+// `l`, the timers in the corresponding slot are cascaded down into level
+// `l - 1` or below. Timers too far in the future for even the highest level
+// are kept in an overflow list and are cascaded every time the highest level
+// wraps around.
+//
+// [1]: http://www.cs.columbia.edu/~nahum/w6998/papers/ton97-timing-wheels.pdf
+template <typename Clock, typename T>
+class TimerWheel {
+ public:
+  using time = std::chrono::time_point<Clock>;
+  using duration = std::chrono::nanoseconds;
+
+  TimerWheel(time start, duration resolution)
+      : start_(start), resolution_(resolution), now_(0) {
+    CHECK_GT(resolution_.count(), 0);
+    counts_.fill(0);
+  }
+  DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+  DEFAULT_MOVE_AND_ASSIGN(TimerWheel);
+
+  // Schedule `x` to fire at `deadline`. If `deadline` has already passed, `x`
+  // is returned by the next call to `Advance`.
+  void Schedule(time deadline, T x) {
+    const std::uint64_t tick = CeilTick(deadline);
+    if (tick <= now_) {
+      due_.push_back(std::move(x));
+    } else {
+      Insert(Timer{tick, std::move(x)});
+    }
+  }
+
+  // If any timer is scheduled, `NextDeadline` stores the deadline of the
+  // earliest timer (rounded up to the wheel's resolution) in `deadline` and
+  // returns true. Otherwise, it returns false.
+  bool NextDeadline(time* deadline) const {
+    if (due_.size() != 0) {
+      *deadline = TickToTime(now_);
+      return true;
+    }
+
+    // Every timer in level `l` shares all digits above `l` with `now_` and
+    // has a larger digit `l` than `now_`. Thus, every timer in level `l` fires
+    // before every timer in level `l + 1`, and the first non-empty slot after
+    // `now_` in the lowest non-empty level contains the earliest timer.
+    for (std::size_t level = 0; level < kNumLevels; ++level) {
+      if (counts_[level] == 0) {
+        continue;
+      }
+      for (std::size_t slot = Digit(now_, level) + 1; slot < kNumSlots;
+           ++slot) {
+        const std::vector<Timer>& timers = slots_[level][slot];
+        if (timers.size() != 0) {
+          *deadline = TickToTime(MinTick(timers));
+          return true;
+        }
+      }
+      LOG(FATAL) << "Level " << level << " of a timer wheel has "
+                 << counts_[level] << " timers but no non-empty slot.";
+    }
+
+    if (overflow_.size() != 0) {
+      *deadline = TickToTime(MinTick(overflow_));
+      return true;
+    }
+    return false;
+  }
+
+  // Advance the wheel to `now` and return every timer whose deadline is at or
+  // before `now`, ordered by deadline. Advancing the wheel backwards in time
+  // is a noop.
+  std::vector<T> Advance(time now) {
+    std::vector<T> fired;
+    std::swap(fired, due_);
+
+    const std::uint64_t target = FloorTick(now);
+    while (now_ < target) {
+      // If the lowest `level` levels of the wheel are empty, nothing can fire
+      // or cascade until the next slot boundary of level `level`, so we jump
+      // straight to it.
+      std::size_t level = 0;
+      while (level <= kNumLevels && counts_[level] == 0) {
+        level++;
+      }
+      if (level > kNumLevels) {
+        now_ = target;
+        break;
+      }
+
+      const std::uint64_t next = ((now_ >> (kBits * level)) + 1)
+                                 << (kBits * level);
+      if (next > target) {
+        now_ = target;
+        break;
+      }
+      now_ = next;
+
+      // Cascade from the highest level down, so that timers cascaded out of
+      // a high level can be cascaded again out of a lower one.
+      for (std::size_t l = kNumLevels; l >= 1; --l) {
+        if ((now_ & Mask(l)) == 0) {
+          Cascade(l, &fired);
+        }
+      }
+
+      std::vector<Timer>& timers = slots_[0][Digit(now_, 0)];
+      counts_[0] -= timers.size();
+      for (Timer& timer : timers) {
+        DCHECK_EQ(timer.tick, now_);
+        fired.push_back(std::move(timer.x));
+      }
+      timers.clear();
+    }
+
+    return fired;
+  }
+
+  // The number of scheduled timers.
+  std::size_t Size() const {
+    std::size_t size = due_.size();
+    for (std::size_t count : counts_) {
+      size += count;
+    }
+    return size;
+  }
+
+ private:
+  static constexpr std::size_t kBits = 6;
+  static constexpr std::size_t kNumSlots = 1 << kBits;
+  static constexpr std::size_t kNumLevels = 4;
+
+  struct Timer {
+    std::uint64_t tick;
+    T x;
+  };
+
+  static std::uint64_t Mask(std::size_t level) {
+    return (std::uint64_t(1) << (kBits * level)) - 1;
+  }
+
+  static std::size_t Digit(std::uint64_t tick, std::size_t level) {
+    return (tick >> (kBits * level)) & (kNumSlots - 1);
+  }
+
+  static std::uint64_t MinTick(const std::vector<Timer>& timers) {
+    DCHECK_NE(timers.size(), static_cast<std::size_t>(0));
+    std::uint64_t min = timers[0].tick;
+    for (const Timer& timer : timers) {
+      min = std::min(min, timer.tick);
+    }
+    return min;
+  }
+
+  std::uint64_t FloorTick(time t) const {
+    if (t <= start_) {
+      return 0;
+    }
+    return std::chrono::duration_cast<duration>(t - start_) / resolution_;
+  }
+
+  std::uint64_t CeilTick(time t) const {
+    if (t <= start_) {
+      return 0;
+    }
+    const duration d = std::chrono::duration_cast<duration>(t - start_);
+    return (d + resolution_ - duration(1)) / resolution_;
+  }
+
+  time TickToTime(std::uint64_t tick) const {
+    return start_ + std::chrono::duration_cast<typename Clock::duration>(
+                        resolution_ * static_cast<duration::rep>(tick));
+  }
+
+  // Insert `timer`, which must fire strictly after `now_`, into the level
+  // whose digit is the highest digit in which `timer.tick` and `now_` differ.
+  void Insert(Timer timer) {
+    DCHECK_GT(timer.tick, now_);
+    std::uint64_t diff = (timer.tick ^ now_) >> kBits;
+    std::size_t level = 0;
+    while (diff != 0 && level < kNumLevels) {
+      diff >>= kBits;
+      level++;
+    }
+
+    counts_[level]++;
+    if (level == kNumLevels) {
+      overflow_.push_back(std::move(timer));
+    } else {
+      slots_[level][Digit(timer.tick, level)].push_back(std::move(timer));
+    }
+  }
+
+  // Redistribute the timers in the current slot of level `level` (or the
+  // overflow list if `level == kNumLevels`) into lower levels, appending any
+  // timers that fire at `now_` to `fired`.
+  void Cascade(std::size_t level, std::vector<T>* fired) {
+    if (counts_[level] == 0) {
+      return;
+    }
+
+    std::vector<Timer> timers;
+    if (level == kNumLevels) {
+      std::swap(timers, overflow_);
+    } else {
+      std::swap(timers, slots_[level][Digit(now_, level)]);
+    }
+    counts_[level] -= timers.size();
+
+    for (Timer& timer : timers) {
+      if (timer.tick <= now_) {
+        fired->push_back(std::move(timer.x));
+      } else {
+        Insert(std::move(timer));
+      }
+    }
+  }
+
+  // Ticks are measured in units of `resolution_` since `start_`.
+  const time start_;
+  const duration resolution_;
+
+  // The current tick. Every timer with a tick at or before `now_` has fired.
+  std::uint64_t now_;
+
+  // `slots_[l][s]` holds the timers in slot `s` of level `l`. `counts_[l]` is
+  // the number of timers in level `l`, and `counts_[kNumLevels]` is the number
+  // of timers in `overflow_`.
+  std::array<std::array<std::vector<Timer>, kNumSlots>, kNumLevels> slots_;
+  std::array<std::size_t, kNumLevels + 1> counts_;
+  std::vector<Timer> overflow_;
+
+  // Timers scheduled with a deadline that had already passed.
+  std::vector<T> due_;
+};
+
+template <typename Clock, typename T>
+constexpr std::size_t TimerWheel<Clock, T>::kBits;
+
+template <typename Clock, typename T>
+constexpr std::size_t TimerWheel<Clock, T>::kNumSlots;
+
+template <typename Clock, typename T>
+constexpr std::size_t TimerWheel<Clock, T>::kNumLevels;
+
+}  // namespace fluent
+
+#endif  // COMMON_TIMER_WHEEL_H_
@@ -0,0 +1,123 @@
+#include "common/timer_wheel.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+namespace fluent {
+
+using time = std::chrono::time_point<std::chrono::steady_clock>;
+using us = std::chrono::microseconds;
+using ms = std::chrono::milliseconds;
+
+TEST(TimerWheel, EmptyWheel) {
+  TimerWheel<std::chrono::steady_clock, int> wheel(time(us(0)), us(100));
+  time deadline;
+  EXPECT_FALSE(wheel.NextDeadline(&deadline));
+  EXPECT_EQ(wheel.Advance(time(ms(10))), std::vector<int>({}));
+  EXPECT_EQ(wheel.Size(), static_cast<std::size_t>(0));
+}
+
+TEST(TimerWheel, SimpleSchedule) {
+  TimerWheel<std::chrono::steady_clock, int> wheel(time(us(0)), us(100));
+  wheel.Schedule(time(us(300)), 3);
+  wheel.Schedule(time(us(100)), 1);
+  wheel.Schedule(time(us(200)), 2);
+  EXPECT_EQ(wheel.Size(), static_cast<std::size_t>(3));
+
+  time deadline;
+  ASSERT_TRUE(wheel.NextDeadline(&deadline));
+  EXPECT_EQ(deadline, time(us(100)));
+
+  EXPECT_EQ(wheel.Advance(time(us(99))), std::vector<int>({}));
+  EXPECT_EQ(wheel.Advance(time(us(100))), std::vector<int>({1}));
+  ASSERT_TRUE(wheel.NextDeadline(&deadline));
+  EXPECT_EQ(deadline, time(us(200)));
+  EXPECT_EQ(wheel.Advance(time(us(1000))), std::vector<int>({2, 3}));
+  EXPECT_FALSE(wheel.NextDeadline(&deadline));
+  EXPECT_EQ(wheel.Size(), static_cast<std::size_t>(0));
+}
+
+TEST(TimerWheel, DeadlinesRoundUp) {
+  TimerWheel<std::chrono::steady_clock, int> wheel(time(us(0)), us(100));
+  wheel.Schedule(time(us(150)), 1);
+
+  time deadline;
+  ASSERT_TRUE(wheel.NextDeadline(&deadline));
+  EXPECT_EQ(deadline, time(us(200)));
+  EXPECT_EQ(wheel.Advance(time(us(150))), std::vector<int>({}));
+  EXPECT_EQ(wheel.Advance(time(us(200))), std::vector<int>({1}));
+}
+
+TEST(TimerWheel, Coalescing) {
+  TimerWheel<std::chrono::steady_clock, int> wheel(time(us(0)), us(100));
+  wheel.Schedule(time(us(510)), 1);
+  wheel.Schedule(time(us(550)), 2);
+  wheel.Schedule(time(us(600)), 3);
+  wheel.Schedule(time(us(601)), 4);
+  EXPECT_EQ(wheel.Advance(time(us(600))), std::vector<int>({1, 2, 3}));
+  EXPECT_EQ(wheel.Advance(time(us(700))), std::vector<int>({4}));
+}
+
+TEST(TimerWheel, PastDeadlines) {
+  TimerWheel<std::chrono::steady_clock, int> wheel(time(us(0)), us(100));
+  EXPECT_EQ(wheel.Advance(time(ms(1))), std::vector<int>({}));
+  wheel.Schedule(time(us(500)), 1);
+  wheel.Schedule(time(ms(1)), 2);
+
+  time deadline;
+  ASSERT_TRUE(wheel.NextDeadline(&deadline));
+  EXPECT_EQ(deadline, time(ms(1)));
+  EXPECT_EQ(wheel.Advance(time(ms(1))), std::vector<int>({1, 2}));
+}
+
+TEST(TimerWheel, Cascading) {
+  // With a resolution of 1 microsecond, the levels of the wheel span 64us,
+  // 4096us, 262144us, and 16777216us. We schedule timers that land in every
+  // level and in the overflow list.
+  TimerWheel<std::chrono::steady_clock, int> wheel(time(us(0)), us(1));
+  const std::vector<long> deadlines = {1,      63,       64,       65,
+                                       4095,   4096,     4097,     262143,
+                                       262144, 16777215, 16777216, 40000000};
+  for (std::size_t i = 0; i < deadlines.size(); ++i) {
+    wheel.Schedule(time(us(deadlines[i])), static_cast<int>(i));
+  }
+
+  for (std::size_t i = 0; i < deadlines.size(); ++i) {
+    time deadline;
+    ASSERT_TRUE(wheel.NextDeadline(&deadline));
+    EXPECT_EQ(deadline, time(us(deadlines[i])));
+    EXPECT_EQ(wheel.Advance(time(us(deadlines[i] - 1))), std::vector<int>({}));
+    EXPECT_EQ(wheel.Advance(time(us(deadlines[i]))),
+              std::vector<int>({static_cast<int>(i)}));
+  }
+  EXPECT_EQ(wheel.Size(), static_cast<std::size_t>(0));
+}
+
+TEST(TimerWheel, Rescheduling) {
+  // Mimic a periodic with a period of 3us that is rescheduled every time it
+  // fires.
+  TimerWheel<std::chrono::steady_clock, std::string> wheel(time(us(0)), us(1));
+  wheel.Schedule(time(us(3)), "p");
+  int fired = 0;
+  for (long t = 0; t <= 10000; ++t) {
+    for (const std::string& x : wheel.Advance(time(us(t)))) {
+      EXPECT_EQ(x, "p");
+      EXPECT_EQ(t % 3, 0);
+      wheel.Schedule(time(us(t + 3)), x);
+      fired++;
+    }
+  }
+  EXPECT_EQ(fired, 10000 / 3);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
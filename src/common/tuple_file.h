@@ -0,0 +1,461 @@
+#ifndef COMMON_TUPLE_FILE_H_
+#define COMMON_TUPLE_FILE_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "fmt/format.h"
+#include "glog/logging.h"
+
+#include "common/macros.h"
+#include "common/mapped_file.h"
+#include "common/mock_pickler.h"
+#include "common/record_file.h"
+#include "common/status.h"
+#include "common/status_macros.h"
+#include "common/status_or.h"
+#include "common/string_util.h"
+#include "common/tuple_util.h"
+
+namespace fluent {
+
+// The format of a file of tuples. See `ReadSortedTuples`.
+enum class TupleFileFormat {
+  // One tuple per line, with columns separated by commas (e.g. `1,foo,2.5`),
+  // as in RFC 4180. A column that contains a comma, a quote, or a line break
+  // is enclosed in quotes, and the quotes inside it are doubled (e.g.
+  // `1,"say ""hi"", bob",2.5`). A quote can't appear in an unquoted column.
+  // Columns are parsed with MockPickler (see common/mock_pickler.h). Empty
+  // lines are skipped.
+  CSV,
+
+  // A record file (see common/record_file.h) with one record per tuple, whose
+  // strings are the columns of the tuple pickled with `Pickler`.
+  RECORDS,
+
+  // One JSON object per line, mapping the name of every column to its value
+  // (e.g. `{"x":1,"y":"foo","z":2.500000}`). Strings and chars are written as
+  // JSON strings, bools as JSON booleans, and numbers as JSON numbers, with
+  // non-finite floating point numbers written as null. JSON lines can be
+  // written (see `AppendTuple`) but not read.
+  JSON_LINES,
+};
+
+namespace detail {
+
+// Tuples are parsed in batches of this many records per thread. See
+// `ReadRecordTuples`.
+constexpr std::size_t kTupleFileBatchRecords = 64 * 1024;
+
+// Run `f(0)`, ..., `f(n - 1)`, each in its own thread, and return the first
+// error they return, if any.
+template <typename F>
+Status ParallelFor(std::size_t n, const F& f) {
+  std::vector<Status> statuses(n);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < n; ++i) {
+    threads.emplace_back([&statuses, &f, i]() { statuses[i] = f(i); });
+  }
+  if (n > 0) {
+    statuses[0] = f(0);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (const Status& status : statuses) {
+    RETURN_IF_ERROR(status);
+  }
+  return Status::OK;
+}
+
+template <template <typename> class Pickler, typename... Ts,
+          std::size_t... Is>
+std::tuple<Ts...> TupleFromStrings(const std::vector<std::string>& columns,
+                                   std::index_sequence<Is...>) {
+  return std::tuple<Ts...>(Pickler<Ts>().Load(columns[Is])...);
+}
+
+// Parse `columns` into `ts`. Picklers signal malformed columns by throwing
+// (e.g. std::invalid_argument from std::stoi), which we turn into an error.
+template <template <typename> class Pickler, typename... Ts>
+Status ParseTuple(const std::vector<std::string>& columns,
+                  std::vector<std::tuple<Ts...>>* ts) {
+  if (columns.size() != sizeof...(Ts)) {
+    return Status(ErrorCode::INVALID_ARGUMENT,
+                  fmt::format("Tuple has {} columns instead of {}.",
+                              columns.size(), sizeof...(Ts)));
+  }
+  try {
+    ts->push_back(TupleFromStrings<Pickler, Ts...>(
+        columns, std::index_sequence_for<Ts...>()));
+  } catch (const std::exception& e) {
+    return Status(ErrorCode::INVALID_ARGUMENT,
+                  fmt::format("Malformed column ({}) in tuple [{}].", e.what(),
+                              Join(columns)));
+  }
+  return Status::OK;
+}
+
+// Whether `c` must be quoted in a CSV column. See `TupleFileFormat::CSV`.
+inline bool IsCsvSpecial(char c) {
+  return c == ',' || c == '"' || c == '\n' || c == '\r';
+}
+
+// Append `column` to `out` as a CSV column, quoting it if necessary.
+inline void AppendCsvColumn(const std::string& column, std::string* out) {
+  if (std::none_of(column.begin(), column.end(), IsCsvSpecial)) {
+    out->append(column);
+    return;
+  }
+  out->push_back('"');
+  for (char c : column) {
+    if (c == '"') {
+      out->push_back('"');
+    }
+    out->push_back(c);
+  }
+  out->push_back('"');
+}
+
+// Parse the CSV column that starts at `*p` into `column`, and advance `*p` to
+// the comma or newline that ends it, or to `end`. A carriage return before
+// the newline is dropped.
+inline Status ParseCsvColumn(const char** p, const char* end,
+                             std::string* column) {
+  const char* begin = *p;
+  if (begin == end || *begin != '"') {
+    const char* stop = std::find_if(
+        begin, end, [](char c) { return c == ',' || c == '\n'; });
+    const char* column_end = stop;
+    if (column_end != begin && *(column_end - 1) == '\r' &&
+        (stop == end || *stop == '\n')) {
+      --column_end;
+    }
+    if (std::find(begin, column_end, '"') != column_end) {
+      return Status(ErrorCode::INVALID_ARGUMENT,
+                    "Quote in an unquoted CSV column.");
+    }
+    column->assign(begin, column_end);
+    *p = stop;
+    return Status::OK;
+  }
+
+  column->clear();
+  const char* c = begin + 1;
+  while (true) {
+    const char* quote = std::find(c, end, '"');
+    if (quote == end) {
+      return Status(ErrorCode::INVALID_ARGUMENT, "Unterminated CSV quote.");
+    }
+    column->append(c, quote);
+    c = quote + 1;
+    if (c == end || *c != '"') {
+      break;
+    }
+    column->push_back('"');
+    ++c;
+  }
+  if (c != end && *c == '\r' && (c + 1 == end || *(c + 1) == '\n')) {
+    ++c;
+  }
+  if (c != end && *c != ',' && *c != '\n') {
+    return Status(ErrorCode::INVALID_ARGUMENT,
+                  "Closing CSV quote isn't followed by a comma or newline.");
+  }
+  *p = c;
+  return Status::OK;
+}
+
+// Parse the lines of the CSV text `[begin, end)` into `ts`. `begin` must be
+// the start of a line that isn't inside a quoted column.
+template <typename... Ts>
+Status ParseCsv(const char* begin, const char* end,
+                std::vector<std::tuple<Ts...>>* ts) {
+  std::vector<std::string> columns;
+  while (begin != end) {
+    if (*begin == '\n') {
+      ++begin;
+      continue;
+    }
+    if (*begin == '\r' && (begin + 1 == end || *(begin + 1) == '\n')) {
+      begin = begin + 1 == end ? end : begin + 2;
+      continue;
+    }
+
+    columns.clear();
+    while (true) {
+      columns.emplace_back();
+      RETURN_IF_ERROR(ParseCsvColumn(&begin, end, &columns.back()));
+      if (begin == end) {
+        break;
+      }
+      const char delimiter = *begin++;
+      if (delimiter == '\n') {
+        break;
+      }
+    }
+    RETURN_IF_ERROR((ParseTuple<MockPickler, Ts...>(columns, ts)));
+  }
+  return Status::OK;
+}
+
+// Split `file` into at most `n` pieces at line boundaries and parse each in its
+// own thread. A newline inside a quoted column isn't a line boundary. Since
+// every quote of a well-formed file either opens or closes a quoted column or
+// is one of a pair of doubled quotes, a newline is inside a quoted column
+// exactly when an odd number of quotes precede it.
+template <typename... Ts>
+Status ReadCsvTuples(const MappedFile& file, std::size_t n,
+                     std::vector<std::vector<std::tuple<Ts...>>>* runs) {
+  const char* data = file.Data();
+  const char* end = data + file.Size();
+  std::vector<const char*> bounds = {data};
+  const char* p = data;
+  bool quoted = false;
+  for (std::size_t i = 1; i < n; ++i) {
+    const char* target = std::max(p, data + file.Size() * i / n);
+    if (std::count(p, target, '"') % 2 == 1) {
+      quoted = !quoted;
+    }
+    p = target;
+    while (p != end) {
+      const char* c =
+          std::find_if(p, end, [](char x) { return x == '"' || x == '\n'; });
+      p = c == end ? end : c + 1;
+      if (c != end && *c == '"') {
+        quoted = !quoted;
+      } else if (c != end && !quoted) {
+        break;
+      }
+    }
+    bounds.push_back(p);
+  }
+  bounds.push_back(end);
+
+  runs->resize(n);
+  return ParallelFor(n, [&bounds, runs](std::size_t i) {
+    return ParseCsv<Ts...>(bounds[i], bounds[i + 1], &(*runs)[i]);
+  });
+}
+
+// Read the records of `reader` in batches and unpickle each batch with `n`
+// threads.
+template <template <typename> class Pickler, typename... Ts>
+Status ReadRecordTuples(RecordReader* reader, std::size_t n,
+                        std::vector<std::vector<std::tuple<Ts...>>>* runs) {
+  runs->resize(n);
+  std::vector<std::vector<std::string>> batch(n * kTupleFileBatchRecords);
+  while (true) {
+    std::size_t num_records = 0;
+    while (num_records < batch.size() && reader->Next(&batch[num_records])) {
+      num_records++;
+    }
+    if (num_records == 0) {
+      break;
+    }
+
+    RETURN_IF_ERROR(ParallelFor(n, [&batch, num_records, n,
+                                    runs](std::size_t i) {
+      const std::size_t begin = num_records * i / n;
+      const std::size_t end = num_records * (i + 1) / n;
+      for (std::size_t j = begin; j < end; ++j) {
+        RETURN_IF_ERROR((ParseTuple<Pickler, Ts...>(batch[j], &(*runs)[i])));
+      }
+      return Status::OK;
+    }));
+
+    if (num_records < batch.size()) {
+      break;
+    }
+  }
+
+  if (!reader->AtEnd()) {
+    return Status(ErrorCode::INVALID_ARGUMENT,
+                  "Tuple file ends with a corrupt record.");
+  }
+  return Status::OK;
+}
+
+// Sort every run in its own thread, then merge the runs pairwise, again in
+// parallel, and drop duplicates.
+template <typename T>
+std::vector<T> SortAndMerge(std::vector<std::vector<T>> runs) {
+  Status status = ParallelFor(runs.size(), [&runs](std::size_t i) {
+    std::sort(runs[i].begin(), runs[i].end());
+    return Status::OK;
+  });
+  CHECK_EQ(Status::OK, status);
+
+  while (runs.size() > 1) {
+    std::vector<std::vector<T>> merged(runs.size() / 2);
+    status = ParallelFor(merged.size(), [&runs, &merged](std::size_t i) {
+      std::vector<T>& a = runs[2 * i];
+      std::vector<T>& b = runs[2 * i + 1];
+      merged[i].reserve(a.size() + b.size());
+      std::merge(std::make_move_iterator(a.begin()),
+                 std::make_move_iterator(a.end()),
+                 std::make_move_iterator(b.begin()),
+                 std::make_move_iterator(b.end()),
+                 std::back_inserter(merged[i]));
+      std::vector<T>().swap(a);
+      std::vector<T>().swap(b);
+      return Status::OK;
+    });
+    CHECK_EQ(Status::OK, status);
+    if (runs.size() % 2 == 1) {
+      merged.push_back(std::move(runs.back()));
+    }
+    runs = std::move(merged);
+  }
+
+  if (runs.empty()) {
+    return {};
+  }
+  std::vector<T> ts = std::move(runs[0]);
+  ts.erase(std::unique(ts.begin(), ts.end()), ts.end());
+  return ts;
+}
+
+// `AppendJsonValue(x, out)` appends `x` to `out` as a JSON value. See
+// `TupleFileFormat::JSON_LINES`.
+inline void AppendJsonValue(const std::string& s, std::string* out) {
+  AppendJsonString(s, out);
+}
+
+inline void AppendJsonValue(char c, std::string* out) {
+  AppendJsonString(std::string(1, c), out);
+}
+
+inline void AppendJsonValue(bool b, std::string* out) {
+  out->append(b ? "true" : "false");
+}
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value>::type AppendJsonValue(
+    T x, std::string* out) {
+  out->append(MockPickler<T>().Dump(x));
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value>::type
+AppendJsonValue(T x, std::string* out) {
+  out->append(std::isfinite(x) ? MockPickler<T>().Dump(x) : "null");
+}
+
+}  // namespace detail
+
+// `AppendTuple<Pickler>(format, column_names, t, &buffer)` appends the tuple
+// `t`, whose columns are named `column_names`, to `buffer` in format `format`.
+// This is how collections that write their tuples out (e.g. Stdout and
+// FileSink) lay them out:
+//
+//   std::string buffer;
+//   std::tuple<int, std::string> t(1, "foo");
+//   AppendTuple<MockPickler>(TupleFileFormat::CSV, {{"x", "y"}}, t, &buffer);
+//   // buffer == "1,foo\n"
+//   AppendTuple<MockPickler>(TupleFileFormat::JSON_LINES, {{"x", "y"}}, t,
+//                            &buffer);
+//   // buffer == "1,foo\n{\"x\":1,\"y\":\"foo\"}\n"
+//
+// CSV and JSON lines are written with MockPickler, whatever `Pickler` is, so
+// every column must have a MockPickler. CSV columns are quoted as needed (see
+// `TupleFileFormat::CSV`), so a file of CSV tuples or of records written this
+// way can be read back with `ReadSortedTuples`, whatever its strings contain.
+template <template <typename> class Pickler, typename... Ts>
+void AppendTuple(TupleFileFormat format,
+                 const std::array<std::string, sizeof...(Ts)>& column_names,
+                 const std::tuple<Ts...>& t, std::string* buffer) {
+  switch (format) {
+    case TupleFileFormat::CSV: {
+      TupleIteri(t, [buffer](std::size_t i, const auto& x) {
+        using T = typename std::decay<decltype(x)>::type;
+        if (i != 0) {
+          buffer->push_back(',');
+        }
+        detail::AppendCsvColumn(MockPickler<T>().Dump(x), buffer);
+      });
+      buffer->push_back('\n');
+      break;
+    }
+    case TupleFileFormat::RECORDS: {
+      std::vector<std::string> columns;
+      columns.reserve(sizeof...(Ts));
+      TupleIter(t, [&columns](const auto& x) {
+        using T = typename std::decay<decltype(x)>::type;
+        columns.push_back(Pickler<T>().Dump(x));
+      });
+      AppendRecord(columns, buffer);
+      break;
+    }
+    case TupleFileFormat::JSON_LINES: {
+      buffer->push_back('{');
+      TupleIteri(t, [&column_names, buffer](std::size_t i, const auto& x) {
+        if (i != 0) {
+          buffer->push_back(',');
+        }
+        AppendJsonString(column_names[i], buffer);
+        buffer->push_back(':');
+        detail::AppendJsonValue(x, buffer);
+      });
+      buffer->append("}\n");
+      break;
+    }
+  }
+}
+
+// `ReadSortedTuples<Pickler, Ts...>(path, format, num_threads)` reads every
+// tuple of type `std::tuple<Ts...>` in the file at `path`, which is in format
+// `format`, and returns them sorted and without duplicates. This is the fast
+// way to load a large table when a program starts (see
+// `FluentExecutor::BulkLoad`).
+//
+// The file is memory-mapped (see common/mapped_file.h) and parsed by
+// `num_threads` threads. A CSV file is split into one piece per thread at
+// line boundaries outside quoted columns. A record file is read sequentially,
+// since the boundaries of its records aren't known in advance, but its
+// records are unpickled in parallel. Every thread sorts the tuples it parsed,
+// and the sorted runs are then merged.
+template <template <typename> class Pickler, typename... Ts>
+WARN_UNUSED StatusOr<std::vector<std::tuple<Ts...>>> ReadSortedTuples(
+    const std::string& path, TupleFileFormat format,
+    std::size_t num_threads) {
+  static_assert(sizeof...(Ts) > 0, "Tuples should have >=1 column.");
+  const std::size_t n = std::max<std::size_t>(num_threads, 1);
+  std::vector<std::vector<std::tuple<Ts...>>> runs;
+  switch (format) {
+    case TupleFileFormat::CSV: {
+      std::unique_ptr<MappedFile> file;
+      ASSIGN_OR_RETURN(file, MappedFile::Make(path));
+      RETURN_IF_ERROR(detail::ReadCsvTuples<Ts...>(*file, n, &runs));
+      break;
+    }
+    case TupleFileFormat::RECORDS: {
+      std::unique_ptr<RecordReader> reader;
+      ASSIGN_OR_RETURN(reader, RecordReader::Make(path));
+      RETURN_IF_ERROR(
+          (detail::ReadRecordTuples<Pickler, Ts...>(reader.get(), n, &runs)));
+      break;
+    }
+    case TupleFileFormat::JSON_LINES: {
+      return Status(ErrorCode::INVALID_ARGUMENT,
+                    "Tuple files of JSON lines can't be read.");
+    }
+  }
+  return detail::SortAndMerge(std::move(runs));
+}
+
+}  // namespace fluent
+
+#endif  // COMMON_TUPLE_FILE_H_
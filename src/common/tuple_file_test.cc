@@ -0,0 +1,222 @@
+#include "common/tuple_file.h"
+
+#include <cstddef>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+#include "common/mock_pickler.h"
+#include "common/record_file.h"
+#include "common/status.h"
+#include "common/status_or.h"
+
+namespace fluent {
+namespace {
+
+using Tuple = std::tuple<int, std::string>;
+
+const char kPath[] = "/tmp/fluent_tuple_file_test";
+
+void WriteFile(const std::string& contents) {
+  std::ofstream f(kPath, std::ios::binary | std::ios::trunc);
+  f << contents;
+}
+
+void WriteRecords(const std::vector<std::vector<std::string>>& records) {
+  std::unique_ptr<RecordWriter> writer =
+      RecordWriter::Make(kPath, true).ConsumeValueOrDie();
+  for (const std::vector<std::string>& record : records) {
+    writer->Append(record);
+  }
+}
+
+StatusOr<std::vector<Tuple>> Read(TupleFileFormat format,
+                                  std::size_t num_threads) {
+  return ReadSortedTuples<MockPickler, int, std::string>(kPath, format,
+                                                         num_threads);
+}
+
+}  // namespace
+
+TEST(TupleFile, EmptyCsv) {
+  WriteFile("");
+  for (std::size_t num_threads : {0, 1, 4}) {
+    StatusOr<std::vector<Tuple>> ts = Read(TupleFileFormat::CSV, num_threads);
+    ASSERT_TRUE(ts.ok()) << ts.status();
+    EXPECT_EQ(ts.ValueOrDie(), std::vector<Tuple>{});
+  }
+}
+
+TEST(TupleFile, Csv) {
+  WriteFile("3,c\n1,a\r\n\n2,b\n1,a\n-4,\n2,b");
+  const std::vector<Tuple> expected = {
+      {-4, ""}, {1, "a"}, {2, "b"}, {3, "c"}};
+  for (std::size_t num_threads : {1, 2, 3, 8, 64}) {
+    StatusOr<std::vector<Tuple>> ts = Read(TupleFileFormat::CSV, num_threads);
+    ASSERT_TRUE(ts.ok()) << ts.status();
+    EXPECT_EQ(ts.ValueOrDie(), expected) << num_threads;
+  }
+}
+
+TEST(TupleFile, LargeCsv) {
+  std::string contents;
+  std::vector<Tuple> expected;
+  for (int i = 999; i >= 0; --i) {
+    contents += std::to_string(i) + ",x" + std::to_string(i % 10) + "\n";
+    expected.push_back(Tuple(i, "x" + std::to_string(i % 10)));
+  }
+  WriteFile(contents);
+  std::sort(expected.begin(), expected.end());
+
+  StatusOr<std::vector<Tuple>> ts = Read(TupleFileFormat::CSV, 7);
+  ASSERT_TRUE(ts.ok()) << ts.status();
+  EXPECT_EQ(ts.ValueOrDie(), expected);
+}
+
+TEST(TupleFile, MalformedCsv) {
+  WriteFile("1,a\n2\n");
+  EXPECT_EQ(Read(TupleFileFormat::CSV, 2).status().error_code(),
+            ErrorCode::INVALID_ARGUMENT);
+  WriteFile("1,a\n2,b,c\n");
+  EXPECT_EQ(Read(TupleFileFormat::CSV, 2).status().error_code(),
+            ErrorCode::INVALID_ARGUMENT);
+  WriteFile("1,a\nfoo,b\n");
+  EXPECT_EQ(Read(TupleFileFormat::CSV, 2).status().error_code(),
+            ErrorCode::INVALID_ARGUMENT);
+  WriteFile("1,\"a\n2,b\n");
+  EXPECT_EQ(Read(TupleFileFormat::CSV, 2).status().error_code(),
+            ErrorCode::INVALID_ARGUMENT);
+  WriteFile("1,\"a\"b\n");
+  EXPECT_EQ(Read(TupleFileFormat::CSV, 2).status().error_code(),
+            ErrorCode::INVALID_ARGUMENT);
+  WriteFile("1,a\"b\n");
+  EXPECT_EQ(Read(TupleFileFormat::CSV, 2).status().error_code(),
+            ErrorCode::INVALID_ARGUMENT);
+}
+
+TEST(TupleFile, QuotedCsv) {
+  WriteFile("3,\"c,\"\"d\"\"\"\r\n\"1\",\"a\nb\"\n2,\"\"\n\"1\",\"a\nb\"");
+  const std::vector<Tuple> expected = {{1, "a\nb"}, {2, ""}, {3, "c,\"d\""}};
+  for (std::size_t num_threads : {1, 2, 3, 8, 64}) {
+    StatusOr<std::vector<Tuple>> ts = Read(TupleFileFormat::CSV, num_threads);
+    ASSERT_TRUE(ts.ok()) << ts.status();
+    EXPECT_EQ(ts.ValueOrDie(), expected) << num_threads;
+  }
+}
+
+TEST(TupleFile, Records) {
+  WriteRecords({{"3", "c,d"}, {"1", "a\nb"}, {"2", ""}, {"1", "a\nb"}});
+  const std::vector<Tuple> expected = {{1, "a\nb"}, {2, ""}, {3, "c,d"}};
+  for (std::size_t num_threads : {1, 2, 8}) {
+    StatusOr<std::vector<Tuple>> ts =
+        Read(TupleFileFormat::RECORDS, num_threads);
+    ASSERT_TRUE(ts.ok()) << ts.status();
+    EXPECT_EQ(ts.ValueOrDie(), expected);
+  }
+}
+
+TEST(TupleFile, MalformedRecords) {
+  WriteRecords({{"1", "a"}, {"2"}});
+  EXPECT_EQ(Read(TupleFileFormat::RECORDS, 2).status().error_code(),
+            ErrorCode::INVALID_ARGUMENT);
+}
+
+TEST(TupleFile, MissingFile) {
+  StatusOr<std::vector<std::tuple<int>>> ts =
+      ReadSortedTuples<MockPickler, int>(
+          "/tmp/fluent_tuple_file_test_does_not_exist", TupleFileFormat::CSV,
+          1);
+  EXPECT_FALSE(ts.ok());
+}
+
+TEST(TupleFile, JsonLinesCantBeRead) {
+  WriteFile("{\"x\":1,\"y\":\"a\"}\n");
+  EXPECT_EQ(Read(TupleFileFormat::JSON_LINES, 1).status().error_code(),
+            ErrorCode::INVALID_ARGUMENT);
+}
+
+TEST(TupleFile, AppendTuple) {
+  using namespace std::literals::string_literals;
+  const std::array<std::string, 4> column_names = {{"i", "s", "b", "d"}};
+  const std::tuple<int, std::string, bool, double> t(-1, "a\"b", true, 0.5);
+  const std::tuple<int, std::string, bool, double> inf(
+      2, "", false, std::numeric_limits<double>::infinity());
+
+  std::string csv;
+  AppendTuple<MockPickler>(TupleFileFormat::CSV, column_names, t, &csv);
+  EXPECT_EQ(csv, "-1,\"a\"\"b\",true,0.500000\n"s);
+
+  std::string json;
+  AppendTuple<MockPickler>(TupleFileFormat::JSON_LINES, column_names, t,
+                           &json);
+  AppendTuple<MockPickler>(TupleFileFormat::JSON_LINES, column_names, inf,
+                           &json);
+  EXPECT_EQ(json, R"({"i":-1,"s":"a\"b","b":true,"d":0.500000})"
+                  "\n"
+                  R"({"i":2,"s":"","b":false,"d":null})"
+                  "\n"s);
+}
+
+TEST(TupleFile, AppendedTuplesCanBeRead) {
+  const std::array<std::string, 2> column_names = {{"x", "y"}};
+  const std::vector<Tuple> ts = {{2, "b,\nc"}, {1, "a"}, {2, "b,\nc"}};
+  const std::vector<Tuple> expected = {{1, "a"}, {2, "b,\nc"}};
+
+  std::string records;
+  for (const Tuple& t : ts) {
+    AppendTuple<MockPickler>(TupleFileFormat::RECORDS, column_names, t,
+                             &records);
+  }
+  WriteFile(records);
+  StatusOr<std::vector<Tuple>> read = Read(TupleFileFormat::RECORDS, 2);
+  ASSERT_TRUE(read.ok()) << read.status();
+  EXPECT_EQ(read.ValueOrDie(), expected);
+
+  std::string csv;
+  for (const Tuple& t : ts) {
+    AppendTuple<MockPickler>(TupleFileFormat::CSV, column_names, t, &csv);
+  }
+  WriteFile(csv);
+  read = Read(TupleFileFormat::CSV, 2);
+  ASSERT_TRUE(read.ok()) << read.status();
+  EXPECT_EQ(read.ValueOrDie(), expected);
+}
+
+TEST(TupleFile, AppendedCsvRoundTrips) {
+  const std::array<std::string, 2> column_names = {{"x", "y"}};
+  const std::vector<std::string> strings = {
+      "", "a", ",", "\"", "\"\"", "a,b", "say \"hi\", bob", "\n", "a\nb\n",
+      "a\r\nb", "\",\"\n\"", "\r"};
+  std::string csv;
+  std::vector<Tuple> expected;
+  for (int i = 0; i < 1000; ++i) {
+    const Tuple t(i, strings[i % strings.size()]);
+    AppendTuple<MockPickler>(TupleFileFormat::CSV, column_names, t, &csv);
+    expected.push_back(t);
+  }
+  WriteFile(csv);
+
+  for (std::size_t num_threads : {1, 2, 7, 64}) {
+    StatusOr<std::vector<Tuple>> read =
+        Read(TupleFileFormat::CSV, num_threads);
+    ASSERT_TRUE(read.ok()) << read.status();
+    EXPECT_EQ(read.ValueOrDie(), expected) << num_threads;
+  }
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -6,6 +6,7 @@
 #include <ostream>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "common/macros.h"
@@ -254,6 +255,86 @@ auto TupleDrop(const std::tuple<Ts...>& t) {
   return TupleProjectBySizetList<project_ids>(t);
 }
 
+// Tuple views
+//
+// A tuple view is a tuple of references to the columns of other tuples (e.g.
+// `std::tuple<const int&, const std::string&>`). Projecting, crossing, or
+// joining tuple views doesn't copy any columns, so the relational algebra
+// passes tuple views between physical operators and only converts them into
+// tuples of values when they are stored.
+//
+// The functions below never return a view of a temporary. Given an lvalue
+// tuple, they return references to its columns. Given an rvalue tuple, they
+// return its columns by value, except for columns that are already references,
+// which are passed along as is. Thus, a tuple view only ever refers to tuples
+// that outlive it.
+//
+//   std::tuple<int, std::string> t{1, "a"};
+//   TupleView(t);                        // (const int&, const string&)
+//   TupleView(std::make_tuple(1, 2.0));  // (int, double)
+//   TupleProjectView<1>(t);              // (const string&)
+//   TupleCatView(t, std::make_tuple(2)); // (const int&, const string&, int)
+
+// TupleProjectView<I1, ..., In>(t) = (t[I1], ..., t[In])
+template <std::size_t... Is, typename... Ts>
+auto TupleProjectView(const std::tuple<Ts...>& t) {
+  using tuple = std::tuple<Ts...>;
+  return std::tuple<const typename std::remove_reference<
+      typename std::tuple_element<Is, tuple>::type>::type&...>(
+      std::get<Is>(t)...);
+}
+
+// Columns that aren't references are copied rather than moved, since a column
+// can be projected more than once.
+template <std::size_t... Is, typename... Ts>
+auto TupleProjectView(std::tuple<Ts...>&& t) {
+  using tuple = std::tuple<Ts...>;
+  return std::tuple<typename std::tuple_element<Is, tuple>::type...>(
+      std::get<Is>(t)...);
+}
+
+template <std::size_t... Is, typename... Ts>
+void TupleProjectView(const std::tuple<Ts...>&&) = delete;
+
+// TupleProjectViewBySizetList<SizetList<I1, ..., In>>(t) = (t[I1], ..., t[In])
+template <typename SizetList>
+struct TupleProjectViewBySizetListImpl;
+
+template <std::size_t... Is>
+struct TupleProjectViewBySizetListImpl<SizetList<Is...>> {
+  template <typename Tuple>
+  auto operator()(Tuple&& t) {
+    return TupleProjectView<Is...>(std::forward<Tuple>(t));
+  }
+};
+
+template <typename SizetList, typename Tuple>
+auto TupleProjectViewBySizetList(Tuple&& t) {
+  return TupleProjectViewBySizetListImpl<SizetList>()(std::forward<Tuple>(t));
+}
+
+// TupleView(t) = (t[0], ..., t[n - 1])
+template <typename... Ts>
+auto TupleView(const std::tuple<Ts...>& t) {
+  using ind_sequence = std::index_sequence_for<Ts...>;
+  using sizet_list = typename SizetListFromIndexSequence<ind_sequence>::type;
+  return TupleProjectViewBySizetList<sizet_list>(t);
+}
+
+template <typename... Ts>
+std::tuple<Ts...> TupleView(std::tuple<Ts...>&& t) {
+  return std::move(t);
+}
+
+template <typename... Ts>
+void TupleView(const std::tuple<Ts...>&&) = delete;
+
+// TupleCatView(t1, ..., tn) = std::tuple_cat(TupleView(t1), ..., TupleView(tn))
+template <typename... Tuples>
+auto TupleCatView(Tuples&&... ts) {
+  return std::tuple_cat(TupleView(std::forward<Tuples>(ts))...);
+}
+
 // << operator
 template <typename... Ts>
 std::ostream& operator<<(std::ostream& out, const std::tuple<Ts...>& t) {
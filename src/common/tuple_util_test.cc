@@ -1,7 +1,9 @@
 #include "common/tuple_util.h"
 
 #include <sstream>
+#include <string>
 #include <tuple>
+#include <type_traits>
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
@@ -499,6 +501,67 @@ TEST(TupleUtil, TupleDrop) {
   EXPECT_EQ(TupleDrop<5>(t), t4);
 }
 
+TEST(TupleUtil, TupleProjectView) {
+  std::tuple<int, std::string, float> t{0, "1", 2.0};
+
+  // Projecting an lvalue returns references to its columns.
+  auto view = TupleProjectView<1, 0, 1>(t);
+  using view_type = std::tuple<const std::string&, const int&,  //
+                               const std::string&>;
+  static_assert(std::is_same<decltype(view), view_type>::value, "");
+  EXPECT_EQ(&std::get<0>(view), &std::get<1>(t));
+  EXPECT_EQ(&std::get<1>(view), &std::get<0>(t));
+  EXPECT_EQ(&std::get<2>(view), &std::get<1>(t));
+
+  // Projecting an rvalue copies the columns that aren't references.
+  using mixed_type = std::tuple<const std::string&, int>;
+  auto mixed = TupleProjectView<0, 1>(mixed_type(std::get<1>(t), 42));
+  static_assert(std::is_same<decltype(mixed), mixed_type>::value, "");
+  EXPECT_EQ(&std::get<0>(mixed), &std::get<1>(t));
+  EXPECT_EQ(std::get<1>(mixed), 42);
+
+  EXPECT_EQ(TupleProjectView<>(t), std::tuple<>{});
+}
+
+TEST(TupleUtil, TupleProjectViewBySizetList) {
+  std::tuple<int, char, float> t{0, '1', 2.0};
+  auto view = TupleProjectViewBySizetList<SizetList<2, 0>>(t);
+  using view_type = std::tuple<const float&, const int&>;
+  static_assert(std::is_same<decltype(view), view_type>::value, "");
+  EXPECT_EQ(&std::get<0>(view), &std::get<2>(t));
+  EXPECT_EQ(&std::get<1>(view), &std::get<0>(t));
+}
+
+TEST(TupleUtil, TupleView) {
+  std::tuple<int, std::string> t{0, "1"};
+  auto view = TupleView(t);
+  using view_type = std::tuple<const int&, const std::string&>;
+  static_assert(std::is_same<decltype(view), view_type>::value, "");
+  EXPECT_EQ(&std::get<0>(view), &std::get<0>(t));
+  EXPECT_EQ(&std::get<1>(view), &std::get<1>(t));
+
+  auto moved = TupleView(std::make_tuple(1, std::string("2")));
+  using moved_type = std::tuple<int, std::string>;
+  static_assert(std::is_same<decltype(moved), moved_type>::value, "");
+  EXPECT_EQ(moved, moved_type(1, "2"));
+}
+
+TEST(TupleUtil, TupleCatView) {
+  std::tuple<int, std::string> t{0, "1"};
+  std::tuple<float> u{2.0};
+  auto view = TupleCatView(t, u, std::make_tuple('3'));
+  using view_type = std::tuple<const int&, const std::string&,  //
+                               const float&, char>;
+  static_assert(std::is_same<decltype(view), view_type>::value, "");
+  EXPECT_EQ(&std::get<0>(view), &std::get<0>(t));
+  EXPECT_EQ(&std::get<1>(view), &std::get<1>(t));
+  EXPECT_EQ(&std::get<2>(view), &std::get<0>(u));
+  EXPECT_EQ(std::get<3>(view), '3');
+
+  // Views compare equal to the tuples they refer to.
+  EXPECT_EQ(view, std::make_tuple(0, std::string("1"), 2.0f, '3'));
+}
+
 TEST(TupleUtil, OstreamOperator) {
   std::tuple<int, char, float> t{1, '2', 3.0};
   std::ostringstream os;
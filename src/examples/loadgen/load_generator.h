@@ -0,0 +1,262 @@
+#ifndef EXAMPLES_LOADGEN_LOAD_GENERATOR_H_
+#define EXAMPLES_LOADGEN_LOAD_GENERATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "zmq.hpp"
+
+#include "collections/channel.h"
+#include "common/hash_util.h"
+#include "common/hdr_histogram.h"
+#include "common/macros.h"
+#include "common/static_assert.h"
+#include "zmq_util/socket_cache.h"
+#include "zmq_util/zmq_util.h"
+
+namespace fluent {
+
+struct LoadGeneratorOptions {
+  // The id and address of the load generator. Responses must be sent to
+  // `address`, which the load generator binds to.
+  std::size_t id = 0;
+  std::string address;
+
+  // The names of the request and response channels.
+  std::string request_channel;
+  std::string response_channel;
+
+  // The number of requests sent per second.
+  double rate = 1000;
+
+  // How long requests are sent for.
+  std::chrono::nanoseconds duration = std::chrono::seconds(10);
+
+  // How long to wait for outstanding responses after the last request is sent.
+  std::chrono::nanoseconds drain_timeout = std::chrono::seconds(1);
+};
+
+struct LoadGeneratorResult {
+  LoadGeneratorResult() : latencies(kMaxLatencyMicros, 3) {}
+  DISALLOW_COPY_AND_ASSIGN(LoadGeneratorResult);
+  DEFAULT_MOVE_AND_ASSIGN(LoadGeneratorResult);
+
+  // Latencies larger than a minute are recorded as a minute.
+  static constexpr std::int64_t kMaxLatencyMicros = 60 * 1000 * 1000;
+
+  // The latency of every request that received a response, in microseconds.
+  HdrHistogram latencies;
+
+  std::int64_t num_sent = 0;
+  std::int64_t num_received = 0;
+
+  // The time between sending the first request and receiving the last
+  // response (or giving up on it).
+  std::chrono::nanoseconds elapsed = std::chrono::nanoseconds(0);
+};
+
+// A LoadGenerator is an open-loop client for a Fluent service with a
+// request/response API, like the ones in examples/redis, examples/s3, and
+// examples/cassandra. Requests are sent on a request channel whose first three
+// columns are `dst_addr`, `src_addr`, and `id`, and responses are received on
+// a response channel whose first two columns are `addr` and `id`:
+//
+//   auto f = fluent(...)
+//     .channel<string, string, int64_t, string>(
+//       "get_request", {{"dst_addr", "src_addr", "id", "key"}})
+//     .channel<string, int64_t, string>(
+//       "get_response", {{"addr", "id", "value"}})
+//     ...
+//
+//   using request = std::tuple<string, string, int64_t, string>;
+//   using response = std::tuple<string, int64_t, string>;
+//   LoadGenerator<CerealPickler, request, response> loadgen(&context, options);
+//   LoadGeneratorResult result = loadgen.Run([](std::int64_t id) {
+//     return request("tcp://server:8000", "tcp://loadgen:8001", id, "key");
+//   });
+//
+// Unlike the closed-loop clients in examples/, which send a request and then
+// wait for its response before sending the next one, a LoadGenerator sends
+// requests on a fixed schedule (`options.rate` requests per second) no matter
+// how many requests are outstanding. The latency of a request is measured from
+// the time it was *scheduled* to be sent, not the time it was actually sent.
+// Thus, if the load generator itself falls behind (e.g. because it was
+// descheduled), the delay is charged to the requests that were held up rather
+// than hidden. This avoids the coordinated omission problem [1].
+//
+// Requests are sent using a `Channel`, so they are laid out on the wire
+// exactly like requests sent by a FluentExecutor.
+//
+// [1]: https://www.infoq.com/presentations/latency-pitfalls
+template <template <typename> class Pickler, typename Request,
+          typename Response>
+class LoadGenerator;
+
+template <template <typename> class Pickler, typename... Requests,
+          typename... Responses>
+class LoadGenerator<Pickler, std::tuple<Requests...>,
+                    std::tuple<Responses...>> {
+  using request_tuple = std::tuple<Requests...>;
+  using response_tuple = std::tuple<Responses...>;
+  template <std::size_t I, typename Tuple>
+  using column_type = typename std::tuple_element<I, Tuple>::type;
+
+  static_assert(sizeof...(Requests) >= 3,
+                "A request must have at least three columns.");
+  static_assert(sizeof...(Responses) >= 2,
+                "A response must have at least two columns.");
+  static_assert(
+      StaticAssert<std::is_same<column_type<0, request_tuple>, std::string>>::
+              value &&
+          StaticAssert<std::is_same<column_type<1, request_tuple>,
+                                    std::string>>::value &&
+          StaticAssert<std::is_same<column_type<2, request_tuple>,
+                                    std::int64_t>>::value,
+      "The first three columns of a request must be dst_addr (string), "
+      "src_addr (string), and id (int64_t).");
+  static_assert(
+      StaticAssert<std::is_same<column_type<0, response_tuple>,
+                                std::string>>::value &&
+          StaticAssert<std::is_same<column_type<1, response_tuple>,
+                                    std::int64_t>>::value,
+      "The first two columns of a response must be addr (string) and id "
+      "(int64_t).");
+
+  using Clock = std::chrono::steady_clock;
+
+ public:
+  LoadGenerator(zmq::context_t* context, LoadGeneratorOptions options)
+      : options_(std::move(options)),
+        socket_cache_(context),
+        request_channel_(options_.id, options_.request_channel,
+                         std::array<std::string, sizeof...(Requests)>(),
+                         &socket_cache_),
+        response_channel_id_(Fnv1a64(options_.response_channel)),
+        socket_(*context, ZMQ_PULL) {
+    CHECK_GT(options_.rate, 0);
+    socket_.bind(options_.address);
+  }
+  DISALLOW_COPY_AND_ASSIGN(LoadGenerator);
+
+  // Send requests for `options.duration` and return the latencies of their
+  // responses. `make_request(id)` must return a request with id `id`.
+  template <typename F>
+  LoadGeneratorResult Run(F make_request) {
+    LoadGeneratorResult result;
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / options_.rate));
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point stop = start + options_.duration;
+    Clock::time_point next_send = start;
+    std::int64_t next_id = 0;
+
+    while (Clock::now() < stop) {
+      // Send every request that is due. If we've fallen behind, this sends a
+      // burst of requests, each stamped with the time it was due.
+      const Clock::time_point now = Clock::now();
+      bool sent = false;
+      while (next_send <= now && next_send < stop) {
+        const request_tuple request = make_request(next_id);
+        CHECK_EQ(std::get<2>(request), next_id);
+        request_channel_.Merge(request, 0, 0);
+        outstanding_[next_id] = next_send;
+        result.num_sent++;
+        next_id++;
+        next_send += period;
+        sent = true;
+      }
+      if (sent) {
+        request_channel_.Tick();
+      }
+
+      ReceiveResponses(std::min(next_send, stop), &result);
+    }
+
+    const Clock::time_point drain_stop = Clock::now() + options_.drain_timeout;
+    while (outstanding_.size() != 0 && Clock::now() < drain_stop) {
+      ReceiveResponses(drain_stop, &result);
+    }
+    result.elapsed = Clock::now() - start;
+    outstanding_.clear();
+    return result;
+  }
+
+ private:
+  // Wait until `deadline` for a batch of responses and record the latency of
+  // each in `result`.
+  void ReceiveResponses(Clock::time_point deadline,
+                        LoadGeneratorResult* result) {
+    std::vector<zmq::pollitem_t> items = {
+        {static_cast<void*>(socket_), 0, ZMQ_POLLIN, 0}};
+    Clock::time_point now = Clock::now();
+    while (now < deadline) {
+      // `zmq::poll` has millisecond resolution, so we poll without blocking
+      // when the deadline is less than a millisecond away.
+      const long timeout =
+          std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now)
+              .count();
+      items[0].revents = 0;
+      zmq_util::poll(timeout, &items);
+      if (items[0].revents & ZMQ_POLLIN) {
+        RecordResponses(zmq_util::recv_msgs(&socket_), result);
+        return;
+      }
+      now = Clock::now();
+    }
+  }
+
+  // Record the latency of every response in a batch. See `Channel` for the
+  // layout of a batch.
+  void RecordResponses(const std::vector<zmq::message_t>& msgs,
+                       LoadGeneratorResult* result) {
+    if (msgs.size() < 2 || msgs[1].size() != sizeof(std::uint64_t) ||
+        zmq_util::message_to_uint64(msgs[1]) != response_channel_id_) {
+      LOG(WARNING) << "Ignoring a message not sent to the response channel.";
+      return;
+    }
+
+    const Clock::time_point now = Clock::now();
+    const std::size_t stride = 1 + sizeof...(Responses);
+    for (std::size_t i = 2; i + stride <= msgs.size(); i += stride) {
+      // msgs[i] is the dep time, msgs[i + 1] is the address, and msgs[i + 2]
+      // is the id.
+      const std::int64_t id = Pickler<std::int64_t>().Load(
+          zmq_util::message_to_string(msgs[i + 2]));
+      auto iter = outstanding_.find(id);
+      if (iter == outstanding_.end()) {
+        continue;
+      }
+      const auto latency = now - iter->second;
+      result->latencies.Record(
+          std::chrono::duration_cast<std::chrono::microseconds>(latency)
+              .count());
+      result->num_received++;
+      outstanding_.erase(iter);
+    }
+  }
+
+  const LoadGeneratorOptions options_;
+  zmq_util::SocketCache socket_cache_;
+  Channel<Pickler, Requests...> request_channel_;
+  const std::uint64_t response_channel_id_;
+  zmq::socket_t socket_;
+
+  // The time at which every outstanding request was scheduled to be sent,
+  // keyed by id.
+  std::unordered_map<std::int64_t, Clock::time_point> outstanding_;
+};
+
+}  // namespace fluent
+
+#endif  // EXAMPLES_LOADGEN_LOAD_GENERATOR_H_
@@ -0,0 +1,106 @@
+#include <cstdint>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+
+#include "fmt/format.h"
+#include "glog/logging.h"
+#include "zmq.hpp"
+
+#include "common/cereal_pickler.h"
+#include "common/rand_util.h"
+#include "examples/cassandra/workloads.h"
+#include "examples/loadgen/load_generator.h"
+
+// Drives the key-value store in examples/fluent_kvs at a fixed request rate
+// and prints a summary of the latencies of its responses.
+
+using set_request_tuple = std::tuple<std::string, std::string, std::int64_t,
+                                     std::string, std::string>;
+using set_response_tuple = std::tuple<std::string, std::int64_t>;
+using get_request_tuple =
+    std::tuple<std::string, std::string, std::int64_t, std::string>;
+using get_response_tuple = std::tuple<std::string, std::int64_t, std::string>;
+
+void PrintResult(const fluent::LoadGeneratorResult& result) {
+  const fluent::HdrHistogram& latencies = result.latencies;
+  const double seconds =
+      std::chrono::duration<double>(result.elapsed).count();
+  std::cout << fmt::format("sent     = {}", result.num_sent) << std::endl;
+  std::cout << fmt::format("received = {}", result.num_received) << std::endl;
+  std::cout << fmt::format("rate     = {:.1f} responses/s",
+                           result.num_received / seconds)
+            << std::endl;
+  std::cout << fmt::format("mean     = {:.1f} us", latencies.Mean())
+            << std::endl;
+  for (double p : {50.0, 90.0, 99.0, 99.9, 99.99}) {
+    std::cout << fmt::format("p{:<7} = {} us", p,
+                             latencies.ValueAtPercentile(p))
+              << std::endl;
+  }
+  std::cout << fmt::format("max      = {} us", latencies.Max()) << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  google::InitGoogleLogging(argv[0]);
+
+  if (argc != 8) {
+    std::cerr << "usage: " << argv[0] << " \\" << std::endl  //
+              << "  <server_address> \\" << std::endl        //
+              << "  <client_address> \\" << std::endl        //
+              << "  <get|set> \\" << std::endl               //
+              << "  <requests_per_second> \\" << std::endl   //
+              << "  <duration_seconds> \\" << std::endl      //
+              << "  <workload> \\" << std::endl              //
+              << "  <num_keys> \\" << std::endl;
+    return 1;
+  }
+
+  const std::string server_address = argv[1];
+  const std::string client_address = argv[2];
+  const std::string request_type = argv[3];
+  const double rate = std::stod(argv[4]);
+  const int duration_seconds = std::stoi(argv[5]);
+  const Workload workload = StringToWorkload(argv[6]);
+  const int num_keys = std::stoi(argv[7]);
+  CHECK(request_type == "get" || request_type == "set") << request_type;
+
+  std::random_device random_device;
+  std::mt19937 engine(random_device());
+  std::discrete_distribution<int> workload_distribution =
+      WorkloadToDistribution(workload, num_keys);
+  auto random_key = [&]() {
+    return std::to_string(workload_distribution(engine));
+  };
+
+  zmq::context_t context(1);
+  fluent::LoadGeneratorOptions options;
+  options.address = client_address;
+  options.rate = rate;
+  options.duration = std::chrono::seconds(duration_seconds);
+
+  if (request_type == "get") {
+    options.request_channel = "get_request";
+    options.response_channel = "get_response";
+    fluent::LoadGenerator<fluent::CerealPickler, get_request_tuple,
+                          get_response_tuple>
+        loadgen(&context, options);
+    PrintResult(loadgen.Run([&](std::int64_t id) {
+      return get_request_tuple(server_address, client_address, id,
+                               random_key());
+    }));
+  } else {
+    options.request_channel = "set_request";
+    options.response_channel = "set_response";
+    fluent::LoadGenerator<fluent::CerealPickler, set_request_tuple,
+                          set_response_tuple>
+        loadgen(&context, options);
+    PrintResult(loadgen.Run([&](std::int64_t id) {
+      return set_request_tuple(server_address, client_address, id,
+                               random_key(), fluent::RandomAlphanum(10));
+    }));
+  }
+}
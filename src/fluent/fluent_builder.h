@@ -20,11 +20,13 @@
 #include "common/cereal_pickler.h"
 #include "common/hash_util.h"
 #include "common/macros.h"
+#include "common/mapped_heap.h"
 #include "common/static_assert.h"
 #include "common/status.h"
 #include "common/status_macros.h"
 #include "common/status_or.h"
 #include "common/string_util.h"
+#include "common/tuple_file.h"
 #include "common/type_list.h"
 #include "common/type_traits.h"
 #include "fluent/fluent_executor.h"
@@ -35,6 +37,7 @@
 #include "lineagedb/to_sql.h"
 #include "ra/logical/logical_ra.h"
 #include "zmq_util/socket_cache.h"
+#include "zmq_util/transport.h"
 
 namespace fluent {
 namespace detail {
@@ -109,10 +112,10 @@ class FluentBuilder<
   DEFAULT_MOVE_AND_ASSIGN(FluentBuilder);
 
   // Collections ///////////////////////////////////////////////////////////////
-  // Create a table, scratch, channel, stdin, stdout, or periodic. Note the
-  // `&&` at the end of each declaration. This means that these methods can
-  // only be invoked on an rvalue-reference, which is necessary since the
-  // methods move their contents.
+  // Create a table, mapped table, scratch, channel, stdin, stdout, or
+  // periodic. Note the `&&` at the end of each declaration. This means that
+  // these methods can only be invoked on an rvalue-reference, which is
+  // necessary since the methods move their contents.
   template <typename... Us>
   WithCollection<Table<Us...>> table(
       const std::string& name,
@@ -122,6 +125,21 @@ class FluentBuilder<
         std::make_unique<Table<Us...>>(name, std::move(column_names)));
   }
 
+  // Create a MappedTable whose nodes are allocated from a MappedHeap backed by
+  // a new scratch file at `path` (see collections/mapped_table.h).
+  template <typename... Us>
+  WithCollection<MappedTable<Us...>> mapped_table(
+      const std::string& name,
+      std::array<std::string, sizeof...(Us)> column_names,
+      const std::string& path) && {
+    LOG(INFO) << "Adding mapped table " << name << "("
+              << Join(column_names) << ") backed by " << path << ".";
+    std::unique_ptr<MappedHeap> heap =
+        MappedHeap::Make(path).ConsumeValueOrDie();
+    return AddCollection(std::make_unique<MappedTable<Us...>>(
+        name, std::move(column_names), std::move(heap)));
+  }
+
   template <typename... Us>
   WithCollection<Scratch<Us...>> scratch(
       const std::string& name,
@@ -137,7 +155,7 @@ class FluentBuilder<
       std::array<std::string, sizeof...(Us)> column_names) && {
     LOG(INFO) << "Adding channel " << name << "(" << Join(column_names) << ").";
     auto c = std::make_unique<Channel<Pickler, Us...>>(
-        id_, name, std::move(column_names), &network_state_->socket_cache);
+        id_, name, std::move(column_names), network_state_->transport);
     return AddCollection(std::move(c));
   }
 
@@ -148,9 +166,30 @@ class FluentBuilder<
     return AddCollection(std::move(stdin_ptr));
   }
 
-  WithCollection<Stdout> stdout() && {
+  // Create a Stdout which writes tuples in format `format`, on a background
+  // thread if `background` is true (see collections/stdout.h).
+  WithCollection<Stdout> stdout(TupleFileFormat format = TupleFileFormat::CSV,
+                                bool background = false) && {
     LOG(INFO) << "Adding stdout.";
-    return AddCollection(std::make_unique<Stdout>());
+    return AddCollection(std::make_unique<Stdout>(format, background));
+  }
+
+  // Create a FileSink which writes tuples in format `format` to a new file at
+  // `path`, on a background thread if `background` is true (see
+  // collections/file_sink.h).
+  template <typename... Us>
+  WithCollection<FileSink<Pickler, Us...>> file_sink(
+      const std::string& name,
+      std::array<std::string, sizeof...(Us)> column_names,
+      const std::string& path, TupleFileFormat format,
+      bool background = false) && {
+    LOG(INFO) << "Adding file sink " << name << "(" << Join(column_names)
+              << ") writing to " << path << ".";
+    std::unique_ptr<FileSink<Pickler, Us...>> sink =
+        FileSink<Pickler, Us...>::Make(name, std::move(column_names), path,
+                                       format, background)
+            .ConsumeValueOrDie();
+    return AddCollection(std::move(sink));
   }
 
   WithCollection<Periodic<Clock>> periodic(
@@ -211,14 +250,14 @@ class FluentBuilder<
   // Constructors //////////////////////////////////////////////////////////////
   static WARN_UNUSED StatusOr<FluentBuilder> Make(
       const std::string& name, const std::string& address,
-      zmq::context_t* context,
+      std::unique_ptr<NetworkState> network_state,
       const lineagedb::ConnectionConfig& connection_config) {
     const std::size_t id = Hash<std::string>()(name);
     using Client = LineageDbClient<Hash, ToSql, Clock>;
     StatusOr<std::unique_ptr<Client>> client_or =
         Client::Make(name, id, address, connection_config);
     RETURN_IF_ERROR(client_or.status());
-    return FluentBuilder(name, id, address, context,
+    return FluentBuilder(name, id, std::move(network_state),
                          client_or.ConsumeValueOrDie());
   }
 
@@ -226,12 +265,12 @@ class FluentBuilder<
   // be called when Collections and BootstrapRules are both empty. This private
   // constructor is used primarily by the `fluent` function down below.
   FluentBuilder(
-      const std::string& name, std::size_t id, const std::string& address,
-      zmq::context_t* context,
+      const std::string& name, std::size_t id,
+      std::unique_ptr<NetworkState> network_state,
       std::unique_ptr<LineageDbClient<Hash, ToSql, Clock>> lineagedb_client)
       : name_(name),
         id_(id),
-        network_state_(std::make_unique<NetworkState>(address, context)),
+        network_state_(std::move(network_state)),
         stdin_(nullptr),
         lineagedb_client_(std::move(lineagedb_client)) {
     static_assert(
@@ -495,6 +534,17 @@ class FluentBuilder<
   fluent(const std::string& name, const std::string& address,
          zmq::context_t* context,
          const lineagedb::ConnectionConfig& connection_config);
+
+  template <template <template <typename> class Hash_,
+                      template <typename> class ToSql_, typename Clock_>
+            class LineageDbClient_,
+            template <typename> class Hash_, template <typename> class ToSql_,
+            template <typename> class Pickler_, typename Clock_>
+  friend StatusOr<FluentBuilder<TypeList<>, TypeList<>, false, LineageDbClient_,
+                                Hash_, ToSql_, Pickler_, Clock_>>
+  fluent(const std::string& name, const std::string& address,
+         zmq_util::Transport* transport,
+         const lineagedb::ConnectionConfig& connection_config);
 };
 
 // Create an empty FluentBuilder.
@@ -511,8 +561,32 @@ fluent(const std::string& name, const std::string& address,
        zmq::context_t* context,
        const lineagedb::ConnectionConfig& connection_config) {
   return FluentBuilder<TypeList<>, TypeList<>, false, LineageDbClient, Hash,
-                       ToSql, Pickler, Clock>::Make(name, address, context,
-                                                    connection_config);
+                       ToSql, Pickler, Clock>::
+      Make(name, address, std::make_unique<NetworkState>(address, context),
+           connection_config);
+}
+
+// Create an empty FluentBuilder whose channels send messages with `transport`
+// and whose executor doesn't listen on the network. Its executor receives
+// messages with `FluentExecutor::ReceiveMessages` instead of `Receive` and
+// cannot read from stdin. `address` is only used to register the node with
+// lineagedb. See fluent/simulation.h.
+template <template <template <typename> class Hash,
+                    template <typename> class ToSql, typename Clock>
+          class LineageDbClient,
+          template <typename> class Hash = Hash,
+          template <typename> class ToSql = lineagedb::ToSql,
+          template <typename> class Pickler = CerealPickler,
+          typename Clock = std::chrono::system_clock>
+StatusOr<FluentBuilder<TypeList<>, TypeList<>, false, LineageDbClient, Hash,
+                       ToSql, Pickler, Clock>>
+fluent(const std::string& name, const std::string& address,
+       zmq_util::Transport* transport,
+       const lineagedb::ConnectionConfig& connection_config) {
+  return FluentBuilder<TypeList<>, TypeList<>, false, LineageDbClient, Hash,
+                       ToSql, Pickler, Clock>::
+      Make(name, address, std::make_unique<NetworkState>(transport),
+           connection_config);
 }
 
 }  // namespace fluent
@@ -4,37 +4,53 @@
 #include <cstddef>
 #include <cstdint>
 
+#include <algorithm>
+#include <array>
 #include <functional>
 #include <map>
 #include <memory>
-#include <queue>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "fmt/format.h"
 #include "glog/logging.h"
 #include "gtest/gtest.h"
 #include "zmq.hpp"
 
 #include "collections/all.h"
 #include "collections/collection_util.h"
+#include "common/arena.h"
+#include "common/checkpointer.h"
+#include "common/dedup_buffer.h"
 #include "common/macros.h"
+#include "common/record_file.h"
 #include "common/static_assert.h"
 #include "common/status.h"
 #include "common/status_macros.h"
 #include "common/status_or.h"
 #include "common/string_util.h"
+#include "common/timer_fd.h"
+#include "common/timer_wheel.h"
+#include "common/tuple_file.h"
 #include "common/tuple_util.h"
 #include "common/type_list.h"
+#include "fluent/lineage_view.h"
 #include "fluent/network_state.h"
 #include "fluent/rule.h"
 #include "fluent/rule_tags.h"
 #include "fluent/timestamp_wrapper.h"
 #include "lineagedb/connection_config.h"
 #include "lineagedb/to_sql.h"
+#include "ra/compiled_plan.h"
+#include "ra/logical/for_each_collection.h"
+#include "ra/logical/rewrite.h"
 #include "ra/logical_to_physical.h"
+#include "zmq_util/event_loop.h"
 #include "zmq_util/socket_cache.h"
 
 namespace fluent {
@@ -53,25 +69,24 @@ struct IsRuleTagInsert<DeferredMergeTag> : public std::true_type {};
 template <>
 struct IsRuleTagInsert<DeferredDeleteTag> : public std::false_type {};
 
-// UpdateCollection
-template <typename Collection, typename... Ts>
-void UpdateCollection(Collection* collection, const std::tuple<Ts...>& t,
-                      std::size_t hash, int logical_time_inserted, MergeTag) {
-  collection->Merge(t, hash, logical_time_inserted);
+// UpdateCollection. `t` is forwarded to the collection, so passing an rvalue
+// lets the collection move, rather than copy, the tuple.
+template <typename Collection, typename T>
+void UpdateCollection(Collection* collection, T&& t, std::size_t hash,
+                      int logical_time_inserted, MergeTag) {
+  collection->Merge(std::forward<T>(t), hash, logical_time_inserted);
 }
 
-template <typename Collection, typename... Ts>
-void UpdateCollection(Collection* collection, const std::tuple<Ts...>& t,
-                      std::size_t hash, int logical_time_inserted,
-                      DeferredMergeTag) {
-  collection->DeferredMerge(t, hash, logical_time_inserted);
+template <typename Collection, typename T>
+void UpdateCollection(Collection* collection, T&& t, std::size_t hash,
+                      int logical_time_inserted, DeferredMergeTag) {
+  collection->DeferredMerge(std::forward<T>(t), hash, logical_time_inserted);
 }
 
-template <typename Collection, typename... Ts>
-void UpdateCollection(Collection* collection, const std::tuple<Ts...>& t,
-                      std::size_t hash, int logical_time_inserted,
-                      DeferredDeleteTag) {
-  collection->DeferredDelete(t, hash, logical_time_inserted);
+template <typename Collection, typename T>
+void UpdateCollection(Collection* collection, T&& t, std::size_t hash,
+                      int logical_time_inserted, DeferredDeleteTag) {
+  collection->DeferredDelete(std::forward<T>(t), hash, logical_time_inserted);
 }
 
 // ProcessChannel
@@ -98,6 +113,188 @@ Status ProcessChannel(Collection* c, F f) {
   return ProcessChannelImpl<Collection>()(c, f);
 }
 
+// A CompiledRule is a rule together with the compiled physical plan of its
+// rewritten relational algebra expression (see ra/logical/rewrite.h and
+// ra/compiled_plan.h) and the buffer into which its output is collected every
+// time it is executed. The rule is copied, rather than pointed to, so that a
+// CompiledRule stays valid when the executor that owns it is moved.
+template <typename Rule>
+struct CompiledRule;
+
+template <typename Collection, typename RuleTag, typename Ra>
+struct CompiledRule<Rule<Collection, RuleTag, Ra>> {
+  using tuple_type = typename TypeListToTuple<typename Ra::column_types>::type;
+
+  CompiledRule(const Rule<Collection, RuleTag, Ra>& rule_, Arena* arena)
+      : rule(rule_), plan(ra::logical::Rewrite(rule_.ra), arena) {}
+  DISALLOW_COPY_AND_ASSIGN(CompiledRule);
+  DEFAULT_MOVE_AND_ASSIGN(CompiledRule);
+
+  Rule<Collection, RuleTag, Ra> rule;
+  ra::CompiledPlan<typename ra::logical::Rewritten<Ra>::type> plan;
+
+  // The buffer into which the rule's output is collected every time it is
+  // executed. See `FluentExecutor::ExecutePhysical`.
+  DedupBuffer<tuple_type> output;
+};
+
+// Whether the output of a rule has to be deduplicated before it is inserted
+// into a collection of type `Collection`. Tables, scratches, and periodics are
+// maps, so merging a tuple into one twice is the same as merging it once. A
+// channel, on the other hand, sends a tuple every time it is merged, and
+// stdout prints it.
+template <typename Collection>
+struct NeedsDedup
+    : public std::integral_constant<
+          bool,
+          GetCollectionType<Collection>::value == CollectionType::CHANNEL ||
+              GetCollectionType<Collection>::value == CollectionType::STDOUT> {
+};
+
+// `CompileRules(rules, arena)` compiles every rule in the tuple `rules`.
+template <typename... Rules, std::size_t... Is>
+std::tuple<CompiledRule<Rules>...> CompileRules(
+    const std::tuple<Rules...>& rules, Arena* arena,
+    std::index_sequence<Is...>) {
+  return std::tuple<CompiledRule<Rules>...>(
+      CompiledRule<Rules>(std::get<Is>(rules), arena)...);
+}
+
+template <typename... Rules>
+std::tuple<CompiledRule<Rules>...> CompileRules(
+    const std::tuple<Rules...>& rules, Arena* arena) {
+  return CompileRules(rules, arena, std::index_sequence_for<Rules...>());
+}
+
+// Whether the rewritten plan `Ra` of a rule is chosen by cost when the rule is
+// executed (see ra/compiled_plan.h), in which case the collections the rule
+// reads have to estimate their distinct values (see
+// collections/collection_stats.h).
+template <typename Ra>
+struct IsCostBased : public std::false_type {};
+
+template <typename... Ras>
+struct IsCostBased<ra::logical::Alternatives<Ras...>> : public std::true_type {
+};
+
+// `TrackDistinctIfSame(c, leaf)` calls `c->TrackDistinct()` if `c` is the
+// collection that the logical plan leaf `leaf` reads.
+template <typename C>
+void TrackDistinctIfSame(C* c, const C* leaf) {
+  if (c == leaf) {
+    c->TrackDistinct();
+  }
+}
+
+template <typename C, typename Leaf>
+void TrackDistinctIfSame(C*, const Leaf*) {}
+
+// The first string of a record of a log or of a snapshot. See
+// `FluentExecutor::EnableCheckpointing`.
+constexpr char kMessageRecord[] = "message";
+constexpr char kTickRecord[] = "tick";
+constexpr char kTimeRecord[] = "time";
+
+// IsMappedTable
+template <typename Collection>
+struct IsMappedTable : public std::false_type {};
+
+template <typename... Ts>
+struct IsMappedTable<MappedTable<Ts...>> : public std::true_type {};
+
+// SnapshotImpl<Pickler, Collection>::Write(c, snapshot) appends a record to
+// `snapshot` for every tuple in `c`, and SnapshotImpl<Pickler,
+// Collection>::Load(c, record) merges the tuple of one such record back into
+// `c`. A tuple's record holds the name of its collection, its hash, its
+// logical times, and its pickled columns:
+//
+//   [name, hash, n, time 1, ..., time n, column 1, ..., column m]
+//
+// Only tables and mapped tables are snapshotted. Every other collection
+// is emptied at the end of every tick, so it is empty at the tick boundaries
+// when snapshots are taken.
+template <template <typename> class Pickler, typename Collection>
+struct SnapshotImpl {
+  Status Write(const Collection&, RecordWriter*) { return Status::OK; }
+  Status Load(Collection*, const std::vector<std::string>&) {
+    return Status(ErrorCode::INVALID_ARGUMENT,
+                  "Snapshot contains a collection that isn't a table.");
+  }
+};
+
+template <template <typename> class Pickler, typename Collection,
+          typename... Ts>
+struct TableSnapshotImpl {
+  // Records are flushed in batches of about this many bytes, so that the
+  // snapshot isn't buffered in memory in its entirety.
+  static constexpr std::size_t kFlushBytes = std::size_t(1) << 20;
+
+  Status Write(const Collection& c, RecordWriter* snapshot) {
+    std::vector<std::string> record;
+    for (const auto& pair : c.Get()) {
+      const LogicalTimes& times = pair.second.logical_times_inserted;
+      record.clear();
+      record.push_back(c.Name());
+      record.push_back(std::to_string(pair.second.hash));
+      record.push_back(std::to_string(times.size()));
+      for (int time : times) {
+        record.push_back(std::to_string(time));
+      }
+      TupleIter(pair.first, [&record](const auto& x) {
+        using T = typename std::decay<decltype(x)>::type;
+        record.push_back(Pickler<T>().Dump(x));
+      });
+      snapshot->Append(record);
+      if (snapshot->BufferedBytes() >= kFlushBytes) {
+        RETURN_IF_ERROR(snapshot->Flush());
+      }
+    }
+    return Status::OK;
+  }
+
+  Status Load(Collection* c, const std::vector<std::string>& record) {
+    const Status malformed(ErrorCode::INVALID_ARGUMENT,
+                           "Malformed snapshot record for " + c->Name() + ".");
+    if (record.size() < 3 + sizeof...(Ts)) {
+      return malformed;
+    }
+
+    // std::stoul and friends throw on malformed numbers, which we turn into
+    // an error like `ParseTuple` in common/tuple_file.h does.
+    std::size_t hash;
+    std::vector<int> times;
+    try {
+      const std::size_t num_times = std::stoul(record[2]);
+      if (num_times != record.size() - 3 - sizeof...(Ts)) {
+        return malformed;
+      }
+      hash = std::stoull(record[1]);
+      for (std::size_t i = 0; i < num_times; ++i) {
+        times.push_back(std::stoi(record[3 + i]));
+      }
+    } catch (const std::exception& e) {
+      return Status(ErrorCode::INVALID_ARGUMENT,
+                    fmt::format("Malformed snapshot record for {} ({}).",
+                                c->Name(), e.what()));
+    }
+
+    const std::vector<std::string> columns(record.end() - sizeof...(Ts),
+                                           record.end());
+    std::vector<std::tuple<Ts...>> ts;
+    RETURN_IF_ERROR((ParseTuple<Pickler, Ts...>(columns, &ts)));
+    for (int time : times) {
+      c->Merge(ts.front(), hash, time);
+    }
+    return Status::OK;
+  }
+};
+
+template <template <typename> class Pickler,
+          template <typename> class Allocator, typename... Ts>
+struct SnapshotImpl<Pickler, BasicTable<Allocator, Ts...>>
+    : public TableSnapshotImpl<Pickler, BasicTable<Allocator, Ts...>, Ts...> {
+};
+
 }  // namespace detail
 
 // See below.
@@ -166,12 +363,64 @@ class FluentExecutor<
         stdin_(stdin),
         periodics_(std::move(periodics)),
         lineagedb_client_(std::move(lineagedb_client)),
-        rules_(rules) {
-    // Initialize periodic timeouts. See the comment above `PeriodicTimeout`
+        rules_(rules),
+        timer_wheel_(Clock::now(), std::chrono::microseconds(100)),
+        timer_fd_(network_state_->socket != nullptr ? TimerFd::Make()
+                                                    : nullptr),
+        event_loop_(network_state_->socket != nullptr
+                        ? std::make_unique<zmq_util::EventLoop>()
+                        : nullptr),
+        arena_(std::make_unique<Arena>()),
+        compiled_bootstrap_rules_(
+            detail::CompileRules(bootstrap_rules_, arena_.get())),
+        compiled_rules_(detail::CompileRules(rules_, arena_.get())) {
+    // Index every channel by its channel id. See the comment above
+    // `channel_indices_` below for more information.
+    TupleIteri(collections_, [this](std::size_t i, auto& collection_ptr) {
+      Status status = detail::ProcessChannel(
+          collection_ptr.get(), [this, i](auto* channel) {
+            const bool inserted =
+                channel_indices_.emplace(channel->ChannelId(), i).second;
+            CHECK(inserted) << "Channel " << channel->Name()
+                            << " has the same channel id as another channel.";
+            return Status::OK;
+          });
+      CHECK(status.ok());
+    });
+
+    TupleIter(rules_, [this](const auto& rule) { this->TrackDistinct(rule); });
+
+    // Initialize periodic timeouts. See the comment above `timer_wheel_`
     // below for more information.
     Time now = Clock::now();
     for (Periodic<Clock>* p : periodics_) {
-      timeout_queue_.push(PeriodicTimeout{now + p->Period(), p});
+      timer_wheel_.Schedule(now + p->Period(), p);
+    }
+
+    // An executor without a network socket has no event loop. It's driven by
+    // `ReceiveMessages` instead of `Receive`.
+    if (event_loop_ == nullptr) {
+      CHECK(stdin_ == nullptr)
+          << "An executor without a network socket cannot read from stdin.";
+      return;
+    }
+
+    // Register the network socket, stdin, and the timerfd with the event
+    // loop. See the comment above `event_loop_` below for more information.
+    event_loop_->AddSocket(network_state_->socket.get());
+    event_handlers_.push_back(
+        [](FluentExecutor* self) { return self->ReceiveFromNetwork(); });
+    if (stdin_ != nullptr) {
+      event_loop_->AddFd(stdin_->Fd());
+      event_handlers_.push_back(
+          [](FluentExecutor* self) { return self->ReceiveFromStdin(); });
+    }
+    if (timer_fd_ != nullptr) {
+      event_loop_->AddFd(timer_fd_->Fd());
+      event_handlers_.push_back([](FluentExecutor* self) {
+        self->timer_fd_->Clear();
+        return Status::OK;
+      });
     }
   }
   DISALLOW_COPY_AND_ASSIGN(FluentExecutor);
@@ -270,7 +519,8 @@ class FluentExecutor<
   // physical time.
   //
   //   -- redis_get_response_lineage_impl(time_inserted, key, value)
-  //   CREATE redis_get_response_lineage_impl(integer, text, text)
+  //   CREATE OR REPLACE FUNCTION
+  //     redis_get_response_lineage_impl(integer, text, text)
   //   RETURNS TABLE(node_name text,
   //                 collection_name text,
   //                 hash integer,
@@ -291,7 +541,7 @@ class FluentExecutor<
   //
   //   -- id
   //   get_response_lineage(id)
-  //   CREATE FUNCTION redis_get_response_lineage(integer)
+  //   CREATE OR REPLACE FUNCTION redis_get_response_lineage(integer)
   //   RETURNS TABLE(node_name text,
   //                 collection_name text,
   //                 hash integer,
@@ -416,108 +666,208 @@ class FluentExecutor<
     }
 
     RETURN_IF_ERROR(TupleIteriStatus(
-        bootstrap_rules_, [this](std::size_t rule_number, auto& rule) {
-          return this->ExecuteRule(rule_number, &rule);
+        compiled_bootstrap_rules_,
+        [this](std::size_t rule_number, auto& compiled) {
+          return this->ExecuteRule(rule_number, &compiled);
         }));
     time_++;
-    return TupleIterStatus(collections_, [this](auto& c) {
+    RETURN_IF_ERROR(TupleIterStatus(collections_, [this](auto& c) {
       return this->TickCollection(c.get());
-    });
+    }));
+    arena_->Reset();
+    return Status::OK;
+  }
+
+  // BulkLoad<I>(path, format, num_threads) loads every tuple in the file at
+  // `path` into the Ith collection, which must be a Table. The file is parsed
+  // by `num_threads` threads and the tuples are appended to the table in
+  // sorted order (see `ReadSortedTuples` in common/tuple_file.h and
+  // `Table::BulkMerge`), and their history is recorded in lineagedb with a
+  // handful of bulk inserts. Loading a large table this way is much faster
+  // than loading it with a bootstrap rule over an in-memory set, which merges
+  // and records every tuple one at a time. Like `BootstrapTick`, BulkLoad
+  // takes one logical time and should be called before `Run`.
+  template <std::size_t I>
+  WARN_UNUSED Status BulkLoad(
+      const std::string& path, TupleFileFormat format,
+      std::size_t num_threads = std::thread::hardware_concurrency()) {
+    using num_collections = sizet_constant<sizeof...(Collections)>;
+    static_assert(StaticAssert<Lt<sizet_constant<I>, num_collections>>::value,
+                  "Index out of bounds.");
+    using Collection = typename std::decay<decltype(Get<I>())>::type;
+    static_assert(
+        GetCollectionType<Collection>::value == CollectionType::TABLE &&
+            !detail::IsMappedTable<Collection>::value,
+        "Only tables can be bulk loaded.");
+    return BulkLoadTable(&MutableGet<I>(), path, format, num_threads,
+                         typename CollectionTypes<Collection>::type{});
   }
 
   // Sequentially execute each registered query and then invoke the `Tick`
   // method of every collection.
   WARN_UNUSED Status Tick() {
-    RETURN_IF_ERROR(
-        TupleIteriStatus(rules_, [this](std::size_t rule_number, auto& rule) {
-          return this->ExecuteRule(rule_number, &rule);
+    RETURN_IF_ERROR(TupleIteriStatus(
+        compiled_rules_, [this](std::size_t rule_number, auto& compiled) {
+          return this->ExecuteRule(rule_number, &compiled);
         }));
     time_++;
-    return TupleIterStatus(collections_, [this](auto& c) {
+    RETURN_IF_ERROR(TupleIterStatus(collections_, [this](auto& c) {
       return this->TickCollection(c.get());
-    });
+    }));
+    arena_->Reset();
+
+    if (checkpointer_ != nullptr && checkpointer_->Logging()) {
+      checkpointer_->Log({detail::kTickRecord});
+      if (++ticks_since_checkpoint_ >= ticks_per_checkpoint_) {
+        ticks_since_checkpoint_ = 0;
+        RETURN_IF_ERROR(Checkpoint());
+      }
+    }
+    return Status::OK;
   }
 
   // (Potentially) block and receive messages sent by other Fluent nodes.
   // Receiving a message will insert it into the appropriate channel.
   WARN_UNUSED Status Receive() {
+    CHECK(event_loop_ != nullptr)
+        << "An executor without a network socket must receive messages with "
+           "ReceiveMessages.";
     time_++;
 
-    zmq::pollitem_t sock_pollitem = {static_cast<void*>(network_state_->socket),
-                                     0, ZMQ_POLLIN, 0};
-    std::vector<zmq::pollitem_t> pollitems = {sock_pollitem};
-    if (stdin_ != nullptr) {
-      pollitems.push_back(stdin_->Pollitem());
-    }
-
-    long timeout = GetPollTimeoutInMicros();
-    zmq_util::poll(timeout, &pollitems);
-
-    // Read from the network.
-    if (pollitems[0].revents & ZMQ_POLLIN) {
-      // msgs[0] = dep node id
-      // msgs[1] = dep collection name
-      // msgs[2] = dep time
-      // msgs[3] = tuple element 0
-      // msgs[4] = tuple element 1
-      // ...
-      std::vector<zmq::message_t> msgs =
-          zmq_util::recv_msgs(&network_state_->socket);
-
-      std::vector<std::string> strings;
-      for (std::size_t i = 3; i < msgs.size(); ++i) {
-        strings.push_back(zmq_util::message_to_string(msgs[i]));
+    long timeout = -1;
+    Time deadline;
+    if (timer_wheel_.NextDeadline(&deadline)) {
+      const Time now = Clock::now();
+      if (deadline <= now) {
+        timeout = 0;
+      } else if (timer_fd_ != nullptr) {
+        timer_fd_->Arm(deadline - now);
+      } else {
+        timeout = GetPollTimeoutInMillis(deadline - now);
       }
+    }
 
-      const std::string dep_node_id_str = zmq_util::message_to_string(msgs[0]);
-      const std::string channel_name_str = zmq_util::message_to_string(msgs[1]);
-      const std::string dep_time_str = zmq_util::message_to_string(msgs[2]);
-      const std::size_t dep_node_id =
-          Pickler<std::size_t>().Load(dep_node_id_str);
-      const std::string channel_name =
-          Pickler<std::string>().Load(channel_name_str);
-      const int dep_time = Pickler<int>().Load(dep_time_str);
-
-      RETURN_IF_ERROR(TupleIterStatus(
-          collections_,  //
-          [&, dep_node_id, dep_time](auto& collection_ptr) {
-            return detail::ProcessChannel(
-                collection_ptr.get(),
-                [&, dep_node_id, dep_time](auto* channel) {
-                  if (channel->Name() != channel_name) {
-                    return Status::OK;
-                  }
-
-                  const auto t = channel->Parse(strings);
-                  Hash<typename std::decay<decltype(t)>::type> hash;
-                  channel->Receive(t, hash(t), time_);
-                  RETURN_IF_ERROR(lineagedb_client_->InsertTuple(
-                      channel->Name(), time_, Clock::now(), t));
-                  RETURN_IF_ERROR(lineagedb_client_->AddNetworkedLineage(
-                      dep_node_id, dep_time, channel->Name(), hash(t), time_));
-                  return Status::OK;
-
-                });
-          }));
-    }
-
-    // Read from stdin.
-    if (stdin_ != nullptr && pollitems[1].revents & ZMQ_POLLIN) {
-      const std::tuple<std::string> line = stdin_->ReadLine();
-      stdin_->Merge(line, Hash<std::tuple<std::string>>()(line), time_);
-      RETURN_IF_ERROR(lineagedb_client_->InsertTuple(stdin_->Name(), time_,
-                                                     Clock::now(), line));
+    // Dispatch every event. See `event_loop_` for more information.
+    event_loop_->Wait(timeout, &ready_events_);
+    for (const std::size_t event_id : ready_events_) {
+      RETURN_IF_ERROR(event_handlers_[event_id](this));
     }
 
     // Trigger periodics.
     RETURN_IF_ERROR(TockPeriodics());
+    return SyncReceivedMessages();
+  }
+
+  // Receive `messages`, each a message sent by a channel of another node (see
+  // `Channel`), and trigger every periodic that's ready, like `Receive` does,
+  // but without waiting on the network. An executor whose NetworkState has no
+  // socket receives messages this way rather than with `Receive`:
+  //
+  //   f.BootstrapTick();
+  //   while (true) {
+  //     f.ReceiveMessages(NextMessages());
+  //     f.Tick();
+  //   }
+  //
+  // See fluent/simulation.h.
+  WARN_UNUSED Status ReceiveMessages(
+      const std::vector<std::vector<std::string>>& messages) {
+    time_++;
+    for (const std::vector<std::string>& frames : messages) {
+      RETURN_IF_ERROR(ReceiveMessage(frames));
+    }
+    RETURN_IF_ERROR(TockPeriodics());
+    return SyncReceivedMessages();
+  }
+
+  // If a periodic is scheduled, `NextPeriodicDeadline` stores the time at which
+  // the next periodic is ready to be triggered in `deadline` and returns true.
+  // Otherwise, it returns false.
+  bool NextPeriodicDeadline(Time* deadline) const {
+    return timer_wheel_.NextDeadline(deadline);
+  }
+
+  // RegisterFd<I>(fd, f) registers the file descriptor `fd` (e.g. the
+  // completion fd of an asynchronous redis or gRPC client) with the executor's
+  // event loop. Whenever `fd` is readable during a call to `Receive`, `f` is
+  // invoked and every tuple in the vector it returns is received into the Ith
+  // collection, which must be a channel. For example:
+  //
+  //   auto f = fluent("redis_client", ...)
+  //     .channel<std::string, std::int64_t, std::string>("get_response", ...)
+  //     .RegisterRules(...);
+  //   f.RegisterFd<0>(redis_fd, [&client]() {
+  //     return client.ReadResponses(); // std::vector<std::tuple<...>>
+  //   });
+  //
+  // This lets a black box service deliver its results as events instead of
+  // blocking inside of a rule. `fd` must remain open for the lifetime of the
+  // executor.
+  template <std::size_t I, typename F>
+  void RegisterFd(int fd, F f) {
+    using num_collections = sizet_constant<sizeof...(Collections)>;
+    static_assert(StaticAssert<Lt<sizet_constant<I>, num_collections>>::value,
+                  "Index out of bounds.");
+    using Collection = typename std::decay<decltype(Get<I>())>::type;
+    static_assert(
+        GetCollectionType<Collection>::value == CollectionType::CHANNEL,
+        "Only channels can receive tuples from a file descriptor.");
+
+    CHECK(event_loop_ != nullptr)
+        << "An executor without a network socket cannot register a file "
+           "descriptor.";
+    event_loop_->AddFd(fd);
+    event_handlers_.push_back([f](FluentExecutor* self) mutable {
+      return self->ReceiveTuples(&self->template MutableGet<I>(), f());
+    });
+  }
 
+  // Make the tables of the executor durable. Every `ticks_per_checkpoint`
+  // ticks, a snapshot of every Table and MappedTable is written to
+  // `directory`, and every message received from the network in between is
+  // logged there before it is processed (see common/checkpointer.h). Must be
+  // called before `Run`. If `directory` holds the snapshot and logs of a
+  // previous run of the executor, `Run` recovers from them instead of running
+  // `BootstrapTick`: it loads the latest snapshot and replays the messages
+  // logged since, one tick at a time, so recovering takes time proportional
+  // to the size of the tables and the number of ticks since the snapshot.
+  //
+  // Snapshots are taken at tick boundaries by a forked child process, so the
+  // executor doesn't stall while a snapshot is written. The memory of a
+  // MappedTable is shared with the child rather than copied on write, so
+  // if the executor has one, snapshots are instead written synchronously.
+  //
+  // Only messages received from the network are logged. Tuples read from
+  // stdin, tocked by periodics, or received from a file descriptor passed to
+  // `RegisterFd` are not, and are lost if the executor crashes before the next
+  // snapshot. Replaying the log reexecutes every rule, so tuples sent over
+  // channels since the snapshot are sent again after a crash. Their lineage,
+  // which was recorded before the crash, isn't recorded again.
+  WARN_UNUSED Status EnableCheckpointing(const std::string& directory,
+                                         int ticks_per_checkpoint) {
+    bool has_mapped_table = false;
+    TupleIter(collections_, [&has_mapped_table](const auto& c) {
+      using collection_type =
+          typename Unwrap<typename std::decay<decltype(c)>::type>::type;
+      if (detail::IsMappedTable<collection_type>::value) {
+        has_mapped_table = true;
+      }
+    });
+    const CheckpointMode mode = has_mapped_table
+                                    ? CheckpointMode::SYNCHRONOUS
+                                    : CheckpointMode::FORK;
+    ASSIGN_OR_RETURN(checkpointer_, Checkpointer::Make(directory, mode));
+    ticks_per_checkpoint_ = ticks_per_checkpoint;
     return Status::OK;
   }
 
   // Runs a fluent program.
   WARN_UNUSED Status Run() {
-    RETURN_IF_ERROR(BootstrapTick());
+    if (checkpointer_ != nullptr) {
+      RETURN_IF_ERROR(Recover());
+    } else {
+      RETURN_IF_ERROR(BootstrapTick());
+    }
     while (true) {
       RETURN_IF_ERROR(Receive());
       RETURN_IF_ERROR(Tick());
@@ -556,7 +906,8 @@ class FluentExecutor<
           return lineagedb_client_->AddRule(i, false, rule.ToDebugString());
         }));
 
-    return Status::OK;
+    // The queries above are buffered and issued together in one transaction.
+    return lineagedb_client_->CommitSchema();
   }
 
   // Register a collection with the lineagedb database.
@@ -568,28 +919,315 @@ class FluentExecutor<
         c->ColumnNames());
   }
 
+  // See `BulkLoad`.
+  template <typename... Ts>
+  WARN_UNUSED Status BulkLoadTable(Table<Ts...>* table, const std::string& path,
+                                   TupleFileFormat format,
+                                   std::size_t num_threads, TypeList<Ts...>) {
+    std::vector<std::tuple<Ts...>> ts;
+    ASSIGN_OR_RETURN(ts, (ReadSortedTuples<Pickler, Ts...>(path, format,
+                                                          num_threads)));
+    time_++;
+    Hash<std::tuple<Ts...>> hash;
+    std::vector<std::pair<std::tuple<Ts...>, std::size_t>> pairs;
+    pairs.reserve(ts.size());
+    for (std::tuple<Ts...>& t : ts) {
+      const std::size_t tuple_hash = hash(t);
+      pairs.emplace_back(std::move(t), tuple_hash);
+    }
+    RETURN_IF_ERROR(lineagedb_client_->InsertTuples(table->Name(), time_,
+                                                    Clock::now(), pairs));
+    table->BulkMerge(std::move(pairs), time_);
+    return Status::OK;
+  }
+
   // Tick a collection and insert the deleted tuples into the lineagedb
   // database.
   template <typename Collection>
   WARN_UNUSED Status TickCollection(Collection* c) {
     auto deleted = c->Tick();
+    if (replaying_) {
+      return Status::OK;
+    }
     for (const auto& pair : deleted) {
       const auto& t = pair.first;
-      RETURN_IF_ERROR(
-          lineagedb_client_->DeleteTuple(c->Name(), time_, Clock::now(), t));
+      RETURN_IF_ERROR(lineagedb_client_->DeleteTuple(
+          c->Name(), time_, Clock::now(), pair.second.hash, t));
+    }
+    return Status::OK;
+  }
+
+  // Receive a message from the network. See `ReceiveMessage`.
+  WARN_UNUSED Status ReceiveFromNetwork() {
+    std::vector<zmq::message_t> msgs =
+        zmq_util::recv_msgs(network_state_->socket.get());
+    std::vector<std::string> frames;
+    frames.reserve(msgs.size());
+    for (const zmq::message_t& msg : msgs) {
+      frames.push_back(zmq_util::message_to_string(msg));
+    }
+    return ReceiveMessage(frames);
+  }
+
+  // Receive a message. A message is a batch of one or more tuples sent to the
+  // same channel. See the comment on `Channel` for more information.
+  //
+  //   frames[0] = dep node id
+  //   frames[1] = dep channel id
+  //   frames[2] = dep time of tuple 0
+  //   frames[3] = tuple 0 element 0
+  //   frames[4] = tuple 0 element 1
+  //   ...
+  //
+  // A message without a channel id or for a channel we don't have (e.g. one
+  // sent by a node running a different program) is dropped, like a malformed
+  // batch (see `ReceiveBatch`).
+  WARN_UNUSED Status ReceiveMessage(const std::vector<std::string>& frames) {
+    if (frames.size() < 2 || frames[1].size() != sizeof(std::uint64_t)) {
+      LOG(WARNING) << "Dropping a message without a channel id.";
+      return Status::OK;
+    }
+
+    const std::uint64_t channel_id = zmq_util::string_to_uint64(frames[1]);
+    const auto iter = channel_indices_.find(channel_id);
+    if (iter == channel_indices_.end()) {
+      LOG(WARNING) << "Dropping a message for unknown channel id "
+                   << channel_id << ".";
+      return Status::OK;
+    }
+
+    if (checkpointer_ != nullptr && checkpointer_->Logging()) {
+      std::vector<std::string> record;
+      record.reserve(1 + frames.size());
+      record.push_back(detail::kMessageRecord);
+      record.insert(record.end(), frames.begin(), frames.end());
+      checkpointer_->Log(record);
+      unsynced_messages_ = true;
+    }
+
+    const std::vector<std::string> strings(frames.begin() + 2, frames.end());
+    const std::size_t dep_node_id = Pickler<std::size_t>().Load(frames[0]);
+    const auto& receivers =
+        ChannelReceivers(std::make_index_sequence<sizeof...(Collections)>());
+    return receivers[iter->second](this, dep_node_id, strings);
+  }
+
+  // See `channel_indices_`.
+  using ChannelReceiver = Status (*)(FluentExecutor*, std::size_t,
+                                     const std::vector<std::string>&);
+
+  // Receive a batch of tuples into the `I`th collection, which must be a
+  // channel. See `channel_indices_`.
+  template <std::size_t I>
+  static Status ReceiveIntoCollection(FluentExecutor* self,
+                                      std::size_t dep_node_id,
+                                      const std::vector<std::string>& strings) {
+    return detail::ProcessChannel(
+        std::get<I>(self->collections_).get(), [&](auto* channel) {
+          return self->ReceiveBatch(channel, dep_node_id, strings);
+        });
+  }
+
+  // `ChannelReceivers(...)[i]` is `ReceiveIntoCollection<i>`. See
+  // `channel_indices_`.
+  template <std::size_t... Is>
+  static const std::array<ChannelReceiver, sizeof...(Is)>& ChannelReceivers(
+      std::index_sequence<Is...>) {
+    static const std::array<ChannelReceiver, sizeof...(Is)> receivers = {
+        {&FluentExecutor::template ReceiveIntoCollection<Is>...}};
+    return receivers;
+  }
+
+  // Recover the executor from the latest snapshot and the logs written since.
+  // See `EnableCheckpointing`.
+  //
+  // The lineage of the recovered state was recorded in the lineagedb database
+  // by the run that wrote the snapshot and logs, so none of it is recorded
+  // again while they're replayed. See `replaying_`.
+  WARN_UNUSED Status Recover() {
+    replaying_ = checkpointer_->Snapshot() != "" ||
+                 !checkpointer_->Logs().empty();
+    Status status = Replay();
+    replaying_ = false;
+    RETURN_IF_ERROR(status);
+    return checkpointer_->StartLogging();
+  }
+
+  // Load the latest snapshot and replay the logs written since. See
+  // `Recover`.
+  WARN_UNUSED Status Replay() {
+    if (checkpointer_->Snapshot() != "") {
+      RETURN_IF_ERROR(LoadSnapshot(checkpointer_->Snapshot()));
+    } else {
+      RETURN_IF_ERROR(BootstrapTick());
+    }
+
+    // Every log is a sequence of rounds, one per iteration of `Run`: the
+    // messages received by `Receive` followed by a tick record written by
+    // `Tick`. A round that was cut short by a crash is left unticked.
+    bool in_round = false;
+    for (const std::string& log : checkpointer_->Logs()) {
+      std::unique_ptr<RecordReader> reader;
+      ASSIGN_OR_RETURN(reader, RecordReader::Make(log));
+      std::vector<std::string> record;
+      while (reader->Next(&record)) {
+        if (!in_round) {
+          time_++;
+          in_round = true;
+        }
+        if (record.size() == 1 && record[0] == detail::kTickRecord) {
+          RETURN_IF_ERROR(Tick());
+          in_round = false;
+        } else if (record.size() >= 1 && record[0] == detail::kMessageRecord) {
+          RETURN_IF_ERROR(ReceiveMessage(
+              std::vector<std::string>(record.begin() + 1, record.end())));
+        } else {
+          return Status(ErrorCode::INVALID_ARGUMENT,
+                        "Malformed record in log " + log + ".");
+        }
+      }
     }
     return Status::OK;
   }
 
-  // `GetPollTimeoutInMicros` returns the minimum time (in microseconds) that we
-  // need to wait before a PeriodicTimeout in `timeout_queue_` is ready. If
-  // `timeout_queue_` is empty, then we return -1, which indicates that we
-  // should wait forever.
-  long GetPollTimeoutInMicros() {
-    if (timeout_queue_.size() == 0) {
-      return -1;
+  // Write a snapshot of every table. See `detail::SnapshotImpl`.
+  WARN_UNUSED Status Checkpoint() {
+    return checkpointer_->Checkpoint([this](RecordWriter* snapshot) {
+      snapshot->Append({detail::kTimeRecord, std::to_string(time_)});
+      return TupleIterStatus(collections_, [snapshot](auto& c) {
+        using collection_type = typename std::decay<decltype(*c)>::type;
+        return detail::SnapshotImpl<Pickler, collection_type>().Write(
+            *c, snapshot);
+      });
+    });
+  }
+
+  // Load the snapshot at `path` written by `Checkpoint`.
+  WARN_UNUSED Status LoadSnapshot(const std::string& path) {
+    std::unique_ptr<RecordReader> reader;
+    ASSIGN_OR_RETURN(reader, RecordReader::Make(path));
+    std::vector<std::string> record;
+    if (!reader->Next(&record) || record.size() != 2 ||
+        record[0] != detail::kTimeRecord) {
+      return Status(ErrorCode::INVALID_ARGUMENT,
+                    "Snapshot " + path + " has no time.");
+    }
+    try {
+      time_ = std::stoi(record[1]);
+    } catch (const std::exception& e) {
+      return Status(ErrorCode::INVALID_ARGUMENT,
+                    fmt::format("Snapshot {} has a malformed time ({}).", path,
+                                e.what()));
+    }
+
+    std::unordered_map<std::string, std::size_t> indices;
+    TupleIteri(collections_, [&indices](std::size_t i, const auto& c) {
+      indices.emplace(c->Name(), i);
+    });
+    const auto& loaders =
+        SnapshotLoaders(std::make_index_sequence<sizeof...(Collections)>());
+    while (reader->Next(&record)) {
+      const auto iter =
+          record.size() == 0 ? indices.end() : indices.find(record[0]);
+      if (iter == indices.end()) {
+        return Status(ErrorCode::INVALID_ARGUMENT,
+                      "Snapshot " + path + " has a record for an unknown "
+                      "collection.");
+      }
+      RETURN_IF_ERROR(loaders[iter->second](this, record));
+    }
+    if (!reader->AtEnd()) {
+      return Status(ErrorCode::INVALID_ARGUMENT,
+                    "Snapshot " + path + " is corrupt.");
     }
+    return Status::OK;
+  }
+
+  // See `LoadSnapshot`.
+  using SnapshotLoader = Status (*)(FluentExecutor*,
+                                    const std::vector<std::string>&);
 
+  // Merge the tuple of the snapshot record `record` into the `I`th
+  // collection.
+  template <std::size_t I>
+  static Status LoadIntoCollection(FluentExecutor* self,
+                                   const std::vector<std::string>& record) {
+    auto* c = std::get<I>(self->collections_).get();
+    using collection_type = typename std::decay<decltype(*c)>::type;
+    return detail::SnapshotImpl<Pickler, collection_type>().Load(c, record);
+  }
+
+  // `SnapshotLoaders(...)[i]` is `LoadIntoCollection<i>`, like
+  // `ChannelReceivers`.
+  template <std::size_t... Is>
+  static const std::array<SnapshotLoader, sizeof...(Is)>& SnapshotLoaders(
+      std::index_sequence<Is...>) {
+    static const std::array<SnapshotLoader, sizeof...(Is)> loaders = {
+        {&FluentExecutor::template LoadIntoCollection<Is>...}};
+    return loaders;
+  }
+
+  // Read a line from stdin.
+  WARN_UNUSED Status ReceiveFromStdin() {
+    const std::tuple<std::string> line = stdin_->ReadLine();
+    const std::size_t hash = Hash<std::tuple<std::string>>()(line);
+    stdin_->Merge(line, hash, time_);
+    return lineagedb_client_->InsertTuple(stdin_->Name(), time_, Clock::now(),
+                                          hash, line);
+  }
+
+  // Receive the tuples `ts` read from a file descriptor into `channel`. See
+  // `RegisterFd`.
+  template <typename Channel, typename T>
+  WARN_UNUSED Status ReceiveTuples(Channel* channel, const std::vector<T>& ts) {
+    Hash<T> hash;
+    for (const T& t : ts) {
+      const std::size_t tuple_hash = hash(t);
+      channel->Receive(t, tuple_hash, time_);
+      RETURN_IF_ERROR(lineagedb_client_->InsertTuple(
+          channel->Name(), time_, Clock::now(), tuple_hash, t));
+    }
+    return Status::OK;
+  }
+
+  // Insert a batch of tuples received from node `dep_node_id` into `channel`.
+  // `strings` holds the dep time and columns of every tuple in the batch. A
+  // malformed batch is the sender's fault, not ours, so it is dropped rather
+  // than returned as an error, which would stop `Run`.
+  template <typename Channel>
+  WARN_UNUSED Status ReceiveBatch(Channel* channel, std::size_t dep_node_id,
+                                  const std::vector<std::string>& strings) {
+    const std::size_t num_columns = channel->ColumnNames().size();
+    if (strings.size() == 0 || strings.size() % (1 + num_columns) != 0) {
+      LOG(WARNING) << "Dropping a malformed batch of " << strings.size()
+                   << " frames for channel " << channel->Name() << ".";
+      return Status::OK;
+    }
+
+    std::vector<std::string> columns(num_columns);
+    for (std::size_t i = 0; i < strings.size(); i += 1 + num_columns) {
+      const int dep_time = Pickler<int>().Load(strings[i]);
+      std::copy(strings.begin() + i + 1, strings.begin() + i + 1 + num_columns,
+                columns.begin());
+
+      auto t = channel->Parse(columns);
+      Hash<typename std::decay<decltype(t)>::type> hash;
+      const std::size_t tuple_hash = hash(t);
+      if (!replaying_) {
+        RETURN_IF_ERROR(lineagedb_client_->InsertTuple(
+            channel->Name(), time_, Clock::now(), tuple_hash, t));
+        RETURN_IF_ERROR(lineagedb_client_->AddNetworkedLineage(
+            dep_node_id, dep_time, channel->Name(), tuple_hash, time_));
+      }
+      channel->Receive(std::move(t), tuple_hash, time_);
+    }
+    return Status::OK;
+  }
+
+  // `GetPollTimeoutInMillis` converts `timeout` into a poll timeout in
+  // milliseconds, rounding up so that we never wake up before a periodic is
+  // ready. It is only used when timerfds are unavailable.
+  long GetPollTimeoutInMillis(typename Clock::duration timeout) {
     // The `zmq_poll` API is a bit confusing. It says "zmq_poll() shall wait
     // timeout microseconds for an event to occur" but then also says "The
     // resolution of timeout is 1 millisecond". Then, if you look at `zmq.hpp`,
@@ -597,29 +1235,37 @@ class FluentExecutor<
     // experimentation, it definitely takes milliseconds.
     //
     // [1]: http://bit.ly/2n3SqEx
-    std::chrono::milliseconds timeout =
-        std::chrono::duration_cast<std::chrono::milliseconds>(
-            timeout_queue_.top().timeout - Clock::now());
-    return std::max<long>(0, timeout.count());
+    const std::chrono::milliseconds one_milli(1);
+    std::chrono::milliseconds millis =
+        std::chrono::duration_cast<std::chrono::milliseconds>(timeout);
+    if (millis < timeout) {
+      millis += one_milli;
+    }
+    return std::max<long>(0, millis.count());
+  }
+
+  // Make the messages we just received durable before we act on them. See
+  // `EnableCheckpointing`.
+  WARN_UNUSED Status SyncReceivedMessages() {
+    if (unsynced_messages_) {
+      unsynced_messages_ = false;
+      RETURN_IF_ERROR(checkpointer_->Sync());
+    }
+    return Status::OK;
   }
 
   // Call `Tock` on every Periodic that's ready to be tocked. See the comment
-  // on `PeriodicTimeout` down below for more information.
+  // on `timer_wheel_` down below for more information.
   WARN_UNUSED Status TockPeriodics() {
     Time now = Clock::now();
-    while (timeout_queue_.size() != 0 && timeout_queue_.top().timeout <= now) {
-      PeriodicTimeout timeout = timeout_queue_.top();
-      timeout_queue_.pop();
-
-      // TODO(mwhittaker): Make Periodic templated on Clock.
-      PeriodicId id = timeout.periodic->GetAndIncrementId();
+    for (Periodic<Clock>* periodic : timer_wheel_.Advance(now)) {
+      PeriodicId id = periodic->GetAndIncrementId();
       std::tuple<PeriodicId, Time> t(id, now);
-      Hash<std::tuple<PeriodicId, Time>> hash;
-      timeout.periodic->Merge(t, hash(t), time_);
-      RETURN_IF_ERROR(lineagedb_client_->InsertTuple(timeout.periodic->Name(),
-                                                     time_, now, t));
-      timeout.timeout = now + timeout.periodic->Period();
-      timeout_queue_.push(timeout);
+      const std::size_t hash = Hash<std::tuple<PeriodicId, Time>>()(t);
+      periodic->Merge(t, hash, time_);
+      RETURN_IF_ERROR(lineagedb_client_->InsertTuple(periodic->Name(), time_,
+                                                     now, hash, t));
+      timer_wheel_.Schedule(now + periodic->Period(), periodic);
     }
     return Status::OK;
   }
@@ -731,7 +1377,7 @@ class FluentExecutor<
     auto seq = std::make_index_sequence<1 + num_args + num_rets>();
     const std::string lineage_impl_command = fmt::format(
         R"(
-      CREATE FUNCTION {}_{}_lineage_impl(integer, {})
+      CREATE OR REPLACE FUNCTION {}_{}_lineage_impl(integer, {})
       RETURNS TABLE(node_name text,
                     collection_name text,
                     hash bigint,
@@ -744,7 +1390,7 @@ class FluentExecutor<
 
     const std::string lineage_command = fmt::format(
         R"(
-      CREATE FUNCTION {0}_{2}_lineage(bigint)
+      CREATE OR REPLACE FUNCTION {0}_{2}_lineage(bigint)
       RETURNS TABLE(node_name text,
                     collection_name text,
                     hash bigint,
@@ -797,10 +1443,26 @@ class FluentExecutor<
         {std::move(lineage_impl_command), std::move(lineage_command)});
   }
 
-  // TODO(mwhittaker): Document.
+  // If the plan of `rule` is chosen by cost, have every collection that
+  // `rule` reads estimate its distinct values, which the cost estimates use.
   template <typename Collection, typename RuleTag, typename Ra>
+  void TrackDistinct(const Rule<Collection, RuleTag, Ra>& rule) {
+    using plan_type = typename ra::logical::Rewritten<Ra>::type;
+    if (!detail::IsCostBased<plan_type>::value) {
+      return;
+    }
+    ra::logical::ForEachCollection(rule.ra, [this](const auto* leaf) {
+      TupleIter(collections_, [leaf](auto& c) {
+        detail::TrackDistinctIfSame(c.get(), leaf);
+      });
+    });
+  }
+
+  // Execute a rule by running the physical plan compiled for it when the
+  // executor was constructed (see `compiled_rules_`).
+  template <typename RuleType>
   WARN_UNUSED Status ExecuteRule(int rule_number,
-                                 Rule<Collection, RuleTag, Ra>* rule) {
+                                 detail::CompiledRule<RuleType>* compiled) {
     VLOG(1) << "Executing rule " << rule_number << ".";
 
     if (logical_time_wrapper_ != nullptr) {
@@ -808,64 +1470,108 @@ class FluentExecutor<
     }
     time_++;
 
-    using column_types = typename Ra::column_types;
-    using tuple_type = typename TypeListToTuple<column_types>::type;
-    Hash<tuple_type> hash;
+    RuleType* rule = &compiled->rule;
+    auto* output = &compiled->output;
+    auto execute = [this, rule_number, rule, output](auto* phy) {
+      return this->ExecutePhysical(rule_number, rule, phy, output);
+    };
+    return compiled->plan.Run(execute);
+  }
+
+  // Execute `phy`, a physical plan for `rule`, collecting its output in
+  // `output`, the rule's `DedupBuffer` (see `detail::CompiledRule`).
+  template <typename Collection, typename RuleTag, typename Ra,
+            typename Physical, typename Output>
+  WARN_UNUSED Status ExecutePhysical(int rule_number,
+                                     Rule<Collection, RuleTag, Ra>* rule,
+                                     Physical* phy, Output* output) {
     const bool is_insert = detail::IsRuleTagInsert<RuleTag>::value;
 
-    auto phy = ra::LogicalToPhysical(rule->ra);
-    auto rng = phy.ToRange();
-    std::set<tuple_type> ts;
+    auto rng = phy->ToRange();
+    // Imagine a rule like t <= make_collection(t) which feeds t back into
+    // itself. We have to be careful not to insert something into t while
+    // we're iterating over it. If we do, we'll invaidate our iterators.
+    // Instead, we buffer the tuples (and their hashes) and insert them down
+    // below. Every tuple produced by the rule is constructed in the buffer
+    // exactly once: a tuple the rule computed (e.g. with a map) is moved into
+    // it, and a tuple the rule views in place (e.g. a scanned or projected
+    // tuple of another collection) is copied into it, after the view has been
+    // hashed. Tuples are then moved out of the buffer into the collection.
+    // The buffer is reused every time the rule is executed, so once it has
+    // grown to fit the rule's output, buffering doesn't allocate.
+    //
+    // A rule's output is a set, so duplicate tuples must not reach the
+    // collection more than once. Tables, scratches, and periodics drop
+    // duplicates on their own, so their rules' tuples are simply appended to
+    // the buffer. Channels would send a tuple, and stdout would print it, once
+    // for every time it was derived, so their rules' tuples are deduplicated
+    // by hash as they're buffered. See `detail::NeedsDedup`.
+    const bool dedup = detail::NeedsDedup<Collection>::value;
+    output->Clear();
     std::chrono::time_point<Clock> physical_time = Clock::now();
 
     for (auto iter = ranges::begin(rng); iter != ranges::end(rng); iter++) {
-      const auto tuple_and_ids = *iter;
+      // `tuple` is either a tuple or a view of one (e.g. a reference into a
+      // scanned collection, or the columns of a projection; see `TupleView`
+      // in common/tuple_util.h). It is hashed and logged without being
+      // copied.
+      auto tuple_and_ids = *iter;
       const auto& tuple = std::get<0>(tuple_and_ids);
-      const std::set<LocalTupleId>& ids = std::get<1>(tuple_and_ids);
-
-      // Imagine a rule like t <= make_collection(t) which feeds t back into
-      // itself. We have to be careful not to insert something into t while
-      // we're iterating over it. If we do, we'll invaidate our iterators.
-      // Instead, we buffer the tuples and insert them down below.
-      ts.insert(tuple);
-
-      if (is_insert) {
-        RETURN_IF_ERROR(lineagedb_client_->InsertTuple(
-            rule->collection->Name(), time_, Clock::now(), tuple));
-
-        switch (GetCollectionType<Collection>::value) {
-          case CollectionType::CHANNEL:
-          case CollectionType::STDOUT: {
-            // When a tuple is is_insert into a channel or stdout, it isn't
-            // really is_insert at all. Channels send their tuples away and
-            // stdout just prints the message to the screen. Thus, we insert
-            // and then immediately delete the tuple.
-            RETURN_IF_ERROR(lineagedb_client_->DeleteTuple(
-                rule->collection->Name(), time_, Clock::now(), tuple));
-          }
-          case CollectionType::TABLE:
-          case CollectionType::SCRATCH:
-          case CollectionType::STDIN:
-          case CollectionType::PERIODIC: {
-            // Do nothing.
+      const auto& ids = std::get<1>(tuple_and_ids);
+      using view_type = typename std::decay<decltype(tuple)>::type;
+      const std::size_t tuple_hash = Hash<view_type>()(tuple);
+
+      if (!replaying_) {
+        if (is_insert) {
+          RETURN_IF_ERROR(lineagedb_client_->InsertTuple(
+              rule->collection->Name(), time_, Clock::now(), tuple_hash,
+              tuple));
+
+          switch (GetCollectionType<Collection>::value) {
+            case CollectionType::CHANNEL:
+            case CollectionType::STDOUT: {
+              // When a tuple is is_insert into a channel or stdout, it isn't
+              // really is_insert at all. Channels send their tuples away and
+              // stdout just prints the message to the screen. Thus, we insert
+              // and then immediately delete the tuple.
+              RETURN_IF_ERROR(lineagedb_client_->DeleteTuple(
+                  rule->collection->Name(), time_, Clock::now(), tuple_hash,
+                  tuple));
+            }
+            case CollectionType::TABLE:
+            case CollectionType::SCRATCH:
+            case CollectionType::STDIN:
+            case CollectionType::PERIODIC: {
+              // Do nothing.
+            }
           }
+        } else {
+          RETURN_IF_ERROR(lineagedb_client_->DeleteTuple(
+              rule->collection->Name(), time_, Clock::now(), tuple_hash,
+              tuple));
         }
-      } else {
-        RETURN_IF_ERROR(lineagedb_client_->DeleteTuple(
-            rule->collection->Name(), time_, Clock::now(), tuple));
-      }
 
-      for (const LocalTupleId& dep_id : ids) {
-        RETURN_IF_ERROR(lineagedb_client_->AddDerivedLineage(
-            dep_id, rule_number, is_insert, physical_time,
-            LocalTupleId{rule->collection->Name(), hash(tuple), time_}));
+        // `ids` is either a set of LocalTupleIds or a LineageView into the
+        // storage of a scanned collection. See fluent/lineage_view.h.
+        RETURN_IF_ERROR(ForEachLocalTupleId(
+            ids, [&](const LocalTupleId& dep_id) {
+              return lineagedb_client_->AddDerivedLineage(
+                  dep_id, rule_number, is_insert, physical_time,
+                  LocalTupleId{rule->collection->Name(), tuple_hash, time_});
+            }));
       }
 
+      if (dedup) {
+        output->Insert(std::move(std::get<0>(tuple_and_ids)), tuple_hash);
+      } else {
+        output->Append(std::move(std::get<0>(tuple_and_ids)), tuple_hash);
+      }
       physical_time = Clock::now();
     };
 
-    for (const auto& t : ts) {
-      detail::UpdateCollection(rule->collection, t, hash(t), time_, RuleTag());
+    for (auto& t : output->Values()) {
+      detail::UpdateCollection(rule->collection, std::move(t.first), t.second,
+                               time_, RuleTag());
     }
 
     return Status::OK;
@@ -876,6 +1582,11 @@ class FluentExecutor<
   // tuples. More concretely, grep for `time_++`.
   int time_ = 0;
 
+  // True while `Recover` replays a snapshot and logs whose lineage is already
+  // in the lineagedb database. Nothing is recorded in lineagedb while
+  // replaying.
+  bool replaying_ = false;
+
   // See `FluentBuilder`.
   const std::string name_;
   const std::size_t id_;
@@ -906,14 +1617,10 @@ class FluentExecutor<
   //   3. a Periodic in a fluent program can trigger.
   //
   // To simultaneously wait for the first two events, we perform a zmq::poll.
-  // To wait for the last type of event, we have to set the timeout to
-  // zmq::poll just right. Here's how that works.
-  //
-  // We maintain a priority queue `timeout_queue_` of PeriodicTimeout structs:
-  // one for each Periodic in `periodics_`. Each PeriodicTimeout records the
-  // time at which it should be triggered and the associated Periodic. These
-  // PeriodicTimeouts are ordered by increasing timeout using the
-  // PeriodicTimeoutCompare struct below.
+  // To wait for the last type of event, we schedule every Periodic in a timer
+  // wheel `timer_wheel_` (see common/timer_wheel.h) keyed by the next time it
+  // should be triggered. Scheduling a Periodic and expiring a Periodic both
+  // take constant time, no matter how many Periodics there are.
   //
   // For example, imagine we have 3 periodics:
   //
@@ -921,54 +1628,91 @@ class FluentExecutor<
   //   - y with a period of 4, and
   //   - z with a period of 16.
   //
-  // Here is the contents of `timeout_queue_` at time 0.
-  //
-  //           +--------------+--------------+--------------+
-  //   time  0 | timeout:  2  | timeout:  4  | timeout:  16 |
-  //           | periodic: &x | periodic: &y | periodic: &z |
-  //           +--------------+--------------+--------------+
-  //
-  // Then, we set our poll timeout to wake up just in time for the first
-  // timeout. In our example, our poll timeout would be 2. Every time, the poll
-  // is triggered, we iterate through the PeriodicTimeouts that should be
-  // triggered, trigger them, update their timeout, and then push them back
-  // onto the queue. Here's what the state of the queue looks like over time:
-  //
-  //           +--------------+--------------+--------------+
-  //   time  2 | timeout:  4  | timeout:  4  | timeout:  16 |
-  //           | periodic: &x | periodic: &y | periodic: &z |
-  //           +--------------+--------------+--------------+
-  //           +--------------+--------------+--------------+
-  //   time  4 | timeout:  6  | timeout:  8  | timeout:  16 |
-  //           | periodic: &x | periodic: &y | periodic: &z |
-  //           +--------------+--------------+--------------+
-  //           +--------------+--------------+--------------+
-  //   time  6 | timeout:  8  | timeout:  8  | timeout:  16 |
-  //           | periodic: &x | periodic: &y | periodic: &z |
-  //           +--------------+--------------+--------------+
+  // At time 0, x is scheduled at time 2, y at time 4, and z at time 16. Before
+  // we poll, we ask the timer wheel for its earliest deadline (2) and arm the
+  // timerfd `timer_fd_` to expire at that deadline. `timer_fd_` is part of the
+  // poll set, so the poll wakes up just in time for the first deadline with
+  // sub-millisecond precision. After the poll, we advance the timer wheel to
+  // the current time, trigger every Periodic that it returns, and reschedule
+  // each one a period later:
+  //
+  //   time  2: trigger x       | x at  4, y at  4, z at 16
+  //   time  4: trigger x and y | x at  6, y at  8, z at 16
+  //   time  6: trigger x       | x at  8, y at  8, z at 16
   //   ...
-  //           +--------------+--------------+--------------+
-  //   time 16 | timeout:  18 | timeout:  20 | timeout:  32 |
-  //           | periodic: &x | periodic: &y | periodic: &z |
-  //           +--------------+--------------+--------------+
-  struct PeriodicTimeout {
-    Time timeout;
-    Periodic<Clock>* periodic;
-  };
-
-  // See `PeriodicTimeout`.
-  struct PeriodicTimeoutCompare {
-    bool operator()(const PeriodicTimeout& lhs, const PeriodicTimeout& rhs) {
-      return lhs.timeout < rhs.timeout;
-    }
-  };
-
-  // See `PeriodicTimeout`.
-  std::priority_queue<PeriodicTimeout, std::vector<PeriodicTimeout>,
-                      PeriodicTimeoutCompare>
-      timeout_queue_;
+  //   time 16: trigger x and z | x at 18, y at 20, z at 32
+  //
+  // `timer_wheel_` has a resolution of 100 microseconds. Periodics whose
+  // deadlines fall within the same 100 microsecond window are coalesced: they
+  // are triggered by a single wake up and are all stamped with the same time.
+  // If timerfds are not available, we fall back to a zmq::poll timeout, which
+  // has a resolution of 1 millisecond.
+  TimerWheel<Clock, Periodic<Clock>*> timer_wheel_;
+
+  // See `timer_wheel_`. `timer_fd_` is null if timerfds are not supported or
+  // if the executor has no network socket.
+  std::unique_ptr<TimerFd> timer_fd_;
+
+  // The network socket, stdin, `timer_fd_`, and every file descriptor passed
+  // to `RegisterFd` are registered with `event_loop_` once, when they are
+  // created. The event with id `i` is handled by `event_handlers_[i]`. Every
+  // call to `Receive` waits on `event_loop_` and then invokes the handler of
+  // every ready event. Handlers take the executor as an argument rather than
+  // capturing `this`, so that they remain valid when the executor is moved.
+  // `event_loop_` is null if the executor has no network socket, so that a
+  // simulation of many executors doesn't use a file descriptor per executor.
+  std::unique_ptr<zmq_util::EventLoop> event_loop_;
+  std::vector<std::function<Status(FluentExecutor*)>> event_handlers_;
+
+  // The ids of the ready events. See `event_loop_`.
+  std::vector<std::size_t> ready_events_;
+
+  // Every message received from the network is a batch of tuples for a single
+  // channel, identified by its channel id (see `Channel`). `channel_indices_`
+  // maps the id of every channel to its index in `collections_`, and the
+  // index is used to look up the channel's receiver in a jump table of
+  // `ReceiveIntoCollection<I>` instantiations built at compile time (see
+  // `ChannelReceivers`). Thus, routing a message to its channel takes a single
+  // hash table lookup and an indirect call, no matter how many collections
+  // there are.
+  std::unordered_map<std::uint64_t, std::size_t> channel_indices_;
+
+  // Executing a rule allocates a lot of short-lived memory: the buffer of
+  // tuples produced by the rule and the buffers of physical operators like
+  // HashJoin and GroupBy. All of it is allocated from `arena_`, which is reset
+  // at the end of every tick, so that in steady state, executing a rule
+  // doesn't call malloc or free for any of it. `arena_` is heap allocated so
+  // that its address is stable when the executor is moved.
+  std::unique_ptr<Arena> arena_;
+
+  // Converting a rule's logical plan into a physical plan copies its lambdas
+  // and builds its operators, so we do it once, when the executor is
+  // constructed, rather than every time the rule is executed. Before a rule is
+  // compiled, its plan is rewritten: typed filters are pushed down, crosses
+  // are turned into joins, and three-way joins are given alternative join
+  // orders, the cheapest of which is run every tick (see ra/compiled_plan.h).
+  // The compiled plans allocate their buffers from `arena_`, so they are
+  // declared after it, and they release their buffers after every rule
+  // execution, before `arena_` is reset.
+  std::tuple<detail::CompiledRule<
+      Rule<BootstrapCollections, BootstrapRuleTags, BootstrapRas>>...>
+      compiled_bootstrap_rules_;
+  std::tuple<detail::CompiledRule<Rule<RuleCollections, RuleTags, Ras>>...>
+      compiled_rules_;
+
+  // `checkpointer_` is null unless `EnableCheckpointing` is called. Messages
+  // received by `Receive` are logged as they're received and synced once at
+  // the end of `Receive`; `unsynced_messages_` is true if there are messages
+  // to sync.
+  std::unique_ptr<Checkpointer> checkpointer_;
+  int ticks_per_checkpoint_ = 0;
+  int ticks_since_checkpoint_ = 0;
+  bool unsynced_messages_ = false;
 
   FRIEND_TEST(FluentExecutor, SimpleCommunication);
+  FRIEND_TEST(FluentExecutor, CheckpointAndRecover);
+  FRIEND_TEST(FluentExecutor, RecoverDoesntRecordLineageAgain);
+  FRIEND_TEST(FluentExecutor, RecoverFromCorruptSnapshot);
 };
 
 }  // namespace fluent
@@ -0,0 +1,327 @@
+#include "fluent/fluent_executor.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "fmt/format.h"
+#include "glog/logging.h"
+#include "zmq.hpp"
+
+#include "common/hash_util.h"
+#include "common/mock_pickler.h"
+#include "common/status.h"
+#include "fluent/fluent_builder.h"
+#include "fluent/infix.h"
+#include "lineagedb/connection_config.h"
+#include "lineagedb/mock_client.h"
+#include "lineagedb/noop_client.h"
+#include "lineagedb/to_sql.h"
+#include "ra/logical/all.h"
+
+namespace ldb = fluent::lineagedb;
+namespace lra = fluent::ra::logical;
+
+// These benchmarks measure the throughput and latency of the executor itself:
+// receiving tuples from the network, executing rules, and sending tuples back
+// out. A client FluentExecutor and a server FluentExecutor talk to each other
+// over `inproc://` sockets; the server runs on its own thread. No external
+// services (e.g. Redis or Postgres) are needed.
+//
+// Every benchmark uses the same two channels:
+//
+//   request(dst_addr: string, src_addr: string, id: int64, key: int64,
+//           payload: string)
+//   response(addr: string, id: int64, payload: string)
+//
+// Every iteration, the client sends `concurrency` requests in a single tick
+// and then receives and ticks until it has received a response to every one
+// of them. Each benchmark takes two arguments: the concurrency and the size
+// of each request's payload in bytes. Throughput is reported as items (i.e.
+// requests) per second, and the p50, p99, and p999 request latencies are
+// reported in the benchmark's label.
+
+namespace fluent {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using request_tuple =
+    std::tuple<std::string, std::string, std::int64_t, std::int64_t,
+               std::string>;
+using row_tuple = std::tuple<std::int64_t, std::string>;
+
+constexpr char kServerAddress[] = "inproc://fluent_executor_bench_server";
+constexpr char kClientAddress[] = "inproc://fluent_executor_bench_client";
+
+// The number of rows in each of the server's tables.
+constexpr std::int64_t kTableSize = 1000;
+
+template <template <template <typename> class, template <typename> class,
+                    typename> class LineageDbClient>
+auto benchfluent(const std::string& name, const std::string& address,
+                 zmq::context_t* context) {
+  ldb::ConnectionConfig connection_config;
+  return fluent<LineageDbClient, Hash, ldb::ToSql, MockPickler, Clock>(
+             name, address, context, connection_config)
+      .ConsumeValueOrDie()
+      .template channel<std::string, std::string, std::int64_t, std::int64_t,
+                        std::string>(
+          "request", {{"dst_addr", "src_addr", "id", "key", "payload"}})
+      .template channel<std::string, std::int64_t, std::string>(
+          "response", {{"addr", "id", "payload"}});
+}
+
+// Returns a client that sends every tuple in `requests` whenever it ticks.
+auto MakeClient(zmq::context_t* context, std::vector<request_tuple>* requests) {
+  return benchfluent<ldb::NoopClient>("client", kClientAddress, context)
+      .RegisterRules([requests](auto& request, auto&) {
+        using namespace fluent::infix;
+        return std::make_tuple(request <= lra::make_iterable(requests));
+      })
+      .ConsumeValueOrDie();
+}
+
+// Returns `kTableSize` rows (0, "0"), (1, "1"), ...
+std::vector<row_tuple> MakeRows() {
+  std::vector<row_tuple> rows;
+  for (std::int64_t i = 0; i < kTableSize; ++i) {
+    rows.push_back(row_tuple(i, std::to_string(i)));
+  }
+  return rows;
+}
+
+// Formats the p50, p99, and p999 of `latencies`, which are in microseconds.
+std::string LatencyLabel(std::vector<double>* latencies) {
+  if (latencies->size() == 0) {
+    return "";
+  }
+  std::sort(latencies->begin(), latencies->end());
+  auto percentile = [latencies](double p) {
+    const std::size_t i = static_cast<std::size_t>(p * latencies->size());
+    return (*latencies)[std::min(i, latencies->size() - 1)];
+  };
+  return fmt::format("p50={:.1f}us p99={:.1f}us p999={:.1f}us",
+                     percentile(0.50), percentile(0.99), percentile(0.999));
+}
+
+// Drives `client` against `server`, which is run on its own thread until the
+// benchmark is over. See the comment at the top of the file.
+template <typename Client, typename Server>
+void RunBenchmark(benchmark::State& state, Client* client,
+                  std::vector<request_tuple>* requests, Server* server) {
+  const std::size_t concurrency = state.range(0);
+  const std::string payload(state.range(1), 'x');
+
+  std::atomic<bool> done(false);
+  std::thread server_thread([server, &done]() {
+    CHECK_EQ(Status::OK, server->BootstrapTick());
+    while (!done.load()) {
+      CHECK_EQ(Status::OK, server->Receive());
+      CHECK_EQ(Status::OK, server->Tick());
+    }
+  });
+
+  std::int64_t id = 0;
+  std::unordered_map<std::int64_t, Clock::time_point> send_times;
+  std::vector<double> latencies;
+  while (state.KeepRunning()) {
+    const Clock::time_point now = Clock::now();
+    for (std::size_t i = 0; i < concurrency; ++i) {
+      requests->push_back(request_tuple(kServerAddress, kClientAddress, id,
+                                        id % kTableSize, payload));
+      send_times[id] = now;
+      id++;
+    }
+    CHECK_EQ(Status::OK, client->Tick());
+    requests->clear();
+
+    while (send_times.size() != 0) {
+      CHECK_EQ(Status::OK, client->Receive());
+      const Clock::time_point received = Clock::now();
+      for (const auto& pair : client->template Get<1>().Get()) {
+        auto iter = send_times.find(std::get<1>(pair.first));
+        CHECK(iter != send_times.end());
+        latencies.push_back(
+            std::chrono::duration<double, std::micro>(received - iter->second)
+                .count());
+        send_times.erase(iter);
+      }
+      CHECK_EQ(Status::OK, client->Tick());
+    }
+  }
+
+  // The server blocks in `Receive` until it receives a request, so we send
+  // one last request to wake it up after telling it to stop.
+  done.store(true);
+  requests->push_back(
+      request_tuple(kServerAddress, kClientAddress, id, 0, payload));
+  CHECK_EQ(Status::OK, client->Tick());
+  requests->clear();
+  server_thread.join();
+
+  state.SetItemsProcessed(state.iterations() * concurrency);
+  state.SetLabel(LatencyLabel(&latencies));
+}
+
+void Args(benchmark::internal::Benchmark* b) {
+  for (int concurrency : {1, 16, 256}) {
+    b->Args({concurrency, 16});
+  }
+  for (int payload_size : {256, 4096}) {
+    b->Args({16, payload_size});
+  }
+  b->UseRealTime();
+}
+
+// The server echoes every request.
+void EchoBench(benchmark::State& state) {
+  zmq::context_t context(1);
+  std::vector<request_tuple> requests;
+  auto client = MakeClient(&context, &requests);
+  auto server =
+      benchfluent<ldb::NoopClient>("server", kServerAddress, &context)
+          .RegisterRules([](auto& request, auto& response) {
+            using namespace fluent::infix;
+            return std::make_tuple(
+                response <= (lra::make_collection(&request) |
+                             lra::project<1, 2, 4>()));
+          })
+          .ConsumeValueOrDie();
+  RunBenchmark(state, &client, &requests, &server);
+}
+BENCHMARK(EchoBench)->Apply(Args);
+
+// The server echoes every request and records lineage with a MockClient, so
+// this benchmark measures the overhead of tracking lineage in the executor
+// (but not of writing it to a database).
+void EchoWithLineageBench(benchmark::State& state) {
+  zmq::context_t context(1);
+  std::vector<request_tuple> requests;
+  auto client = MakeClient(&context, &requests);
+  auto server =
+      benchfluent<ldb::MockClient>("server", kServerAddress, &context)
+          .RegisterRules([](auto& request, auto& response) {
+            using namespace fluent::infix;
+            return std::make_tuple(
+                response <= (lra::make_collection(&request) |
+                             lra::project<1, 2, 4>()));
+          })
+          .ConsumeValueOrDie();
+  RunBenchmark(state, &client, &requests, &server);
+}
+BENCHMARK(EchoWithLineageBench)->Apply(Args);
+
+// Every request is a put into a key-value store backed by a table, like the
+// one in examples/fluent_kvs.
+void KvsPutBench(benchmark::State& state) {
+  zmq::context_t context(1);
+  std::vector<request_tuple> requests;
+  auto client = MakeClient(&context, &requests);
+  std::vector<row_tuple> rows = MakeRows();
+  auto server =
+      benchfluent<ldb::NoopClient>("server", kServerAddress, &context)
+          .table<std::int64_t, std::string>("kvs", {{"key", "value"}})
+          .RegisterBootstrapRules([&rows](auto&, auto&, auto& kvs) {
+            using namespace fluent::infix;
+            return std::make_tuple(kvs <= lra::make_iterable(&rows));
+          })
+          .RegisterRules([](auto& request, auto& response, auto& kvs) {
+            using namespace fluent::infix;
+            using lra::LeftKeys;
+            using lra::RightKeys;
+            auto del = kvs -= (lra::make_hash_join<LeftKeys<0>, RightKeys<3>>(
+                                   lra::make_collection(&kvs),
+                                   lra::make_collection(&request)) |
+                               lra::project<0, 1>());
+            auto add = kvs += (lra::make_collection(&request) |
+                               lra::project<3, 4>());
+            auto ack = response <= (lra::make_collection(&request) |
+                                    lra::project<1, 2, 4>());
+            return std::make_tuple(del, add, ack);
+          })
+          .ConsumeValueOrDie();
+  RunBenchmark(state, &client, &requests, &server);
+}
+BENCHMARK(KvsPutBench)->Apply(Args);
+
+// Every request is a get from a key-value store backed by a table. Every get
+// hash joins the requests with the whole table.
+void KvsGetBench(benchmark::State& state) {
+  zmq::context_t context(1);
+  std::vector<request_tuple> requests;
+  auto client = MakeClient(&context, &requests);
+  std::vector<row_tuple> rows = MakeRows();
+  auto server =
+      benchfluent<ldb::NoopClient>("server", kServerAddress, &context)
+          .table<std::int64_t, std::string>("kvs", {{"key", "value"}})
+          .RegisterBootstrapRules([&rows](auto&, auto&, auto& kvs) {
+            using namespace fluent::infix;
+            return std::make_tuple(kvs <= lra::make_iterable(&rows));
+          })
+          .RegisterRules([](auto& request, auto& response, auto& kvs) {
+            using namespace fluent::infix;
+            using lra::LeftKeys;
+            using lra::RightKeys;
+            return std::make_tuple(
+                response <= (lra::make_hash_join<LeftKeys<0>, RightKeys<3>>(
+                                 lra::make_collection(&kvs),
+                                 lra::make_collection(&request)) |
+                             lra::project<3, 4, 1>()));
+          })
+          .ConsumeValueOrDie();
+  RunBenchmark(state, &client, &requests, &server);
+}
+BENCHMARK(KvsGetBench)->Apply(Args);
+
+// Every request is joined with two tables.
+void JoinBench(benchmark::State& state) {
+  zmq::context_t context(1);
+  std::vector<request_tuple> requests;
+  auto client = MakeClient(&context, &requests);
+  std::vector<row_tuple> rows = MakeRows();
+  auto server =
+      benchfluent<ldb::NoopClient>("server", kServerAddress, &context)
+          .table<std::int64_t, std::string>("a", {{"key", "value"}})
+          .table<std::int64_t, std::string>("b", {{"key", "value"}})
+          .RegisterBootstrapRules([&rows](auto&, auto&, auto& a, auto& b) {
+            using namespace fluent::infix;
+            return std::make_tuple(a <= lra::make_iterable(&rows),
+                                   b <= lra::make_iterable(&rows));
+          })
+          .RegisterRules([](auto& request, auto& response, auto& a, auto& b) {
+            using namespace fluent::infix;
+            using lra::LeftKeys;
+            using lra::RightKeys;
+            // (b.key, b.value, a.key, a.value, dst_addr, src_addr, id, key,
+            // payload)
+            auto joined = lra::make_hash_join<LeftKeys<0>, RightKeys<0>>(
+                lra::make_collection(&b),
+                lra::make_hash_join<LeftKeys<0>, RightKeys<3>>(
+                    lra::make_collection(&a), lra::make_collection(&request)));
+            return std::make_tuple(
+                response <= (std::move(joined) | lra::project<5, 6, 1>()));
+          })
+          .ConsumeValueOrDie();
+  RunBenchmark(state, &client, &requests, &server);
+}
+BENCHMARK(JoinBench)->Apply(Args);
+
+}  // namespace
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -1,11 +1,16 @@
 #include "fluent/fluent_executor.h"
 
+#include <unistd.h>
+
 #include <cstddef>
 #include <cstdint>
 
+#include <fstream>
 #include <set>
+#include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "glog/logging.h"
 #include "gmock/gmock.h"
@@ -14,11 +19,14 @@
 
 #include "collections/channel.h"
 #include "collections/collection_tuple_ids.h"
+#include "common/hash_util.h"
 #include "common/mock_pickler.h"
+#include "common/record_file.h"
 #include "common/status.h"
 #include "common/status_or.h"
 #include "common/string_util.h"
 #include "common/time_util.h"
+#include "common/tuple_file.h"
 #include "fluent/fluent_builder.h"
 #include "fluent/infix.h"
 #include "fluent/local_tuple_id.h"
@@ -26,9 +34,11 @@
 #include "lineagedb/mock_client.h"
 #include "lineagedb/mock_to_sql.h"
 #include "lineagedb/noop_client.h"
+#include "ra/keys.h"
 #include "ra/logical/all.h"
 #include "testing/captured_stdout.h"
 #include "testing/mock_clock.h"
+#include "zmq_util/zmq_util.h"
 
 namespace ldb = fluent::lineagedb;
 namespace lra = fluent::ra::logical;
@@ -44,6 +54,38 @@ auto noopfluent(const std::string& name, const std::string& address,
       name, address, context, connection_config);
 }
 
+// A column that counts how many times it has been copied.
+struct Copied {
+  explicit Copied(int x_) : x(x_) {}
+  Copied(const Copied& c) : x(c.x) { num_copies++; }
+  Copied(Copied&&) = default;
+  Copied& operator=(const Copied& c) {
+    x = c.x;
+    num_copies++;
+    return *this;
+  }
+  Copied& operator=(Copied&&) = default;
+
+  static int num_copies;
+  int x;
+};
+
+int Copied::num_copies = 0;
+
+bool operator==(const Copied& a, const Copied& b) { return a.x == b.x; }
+bool operator<(const Copied& a, const Copied& b) { return a.x < b.x; }
+
+template <>
+struct Hash<Copied> {
+  std::size_t operator()(const Copied& c) { return Hash<int>()(c.x); }
+};
+
+template <>
+struct MockPickler<Copied> {
+  std::string Dump(const Copied& c) { return std::to_string(c.x); }
+  Copied Load(const std::string& s) { return Copied(std::stoi(s)); }
+};
+
 TEST(FluentExecutor, SimpleProgram) {
   zmq::context_t context(1);
   ldb::ConnectionConfig connection_config;
@@ -164,6 +206,166 @@ TEST(FluentExecutor, SimpleProgramWithLogicalTime) {
   EXPECT_EQ(f.Get<0>().Get(), expected);
 }
 
+TEST(FluentExecutor, CheckpointAndRecover) {
+  zmq::context_t context(1);
+  ldb::ConnectionConfig connection_config;
+  std::set<std::tuple<int>> xs = {{0}};
+  std::map<std::tuple<int>, CollectionTupleIds> expected;
+  Hash<std::tuple<int>> hash;
+  char directory[] = "/tmp/fluent_executor_test.XXXXXX";
+  ASSERT_NE(mkdtemp(directory), nullptr);
+
+  auto make_executor = [&]() {
+    auto fb_or =
+        noopfluent("name", "inproc://yolo", &context, connection_config);
+    CHECK_EQ(Status::OK, fb_or.status());
+    auto fe_or = fb_or.ConsumeValueOrDie()
+                     .logical_time()
+                     .table<int>("t", {{"x"}})
+                     .RegisterRules([&xs](auto& logical_time, auto& t) {
+                       using namespace fluent::infix;
+                       auto rule =
+                           t <= (lra::make_iterable(&xs) |
+                                 lra::map([&](const auto&) -> std::tuple<int> {
+                                   return {logical_time.Get()};
+                                 }));
+                       return std::make_tuple(rule);
+                     });
+    CHECK_EQ(Status::OK, fe_or.status());
+    return fe_or.ConsumeValueOrDie();
+  };
+
+  // Run three rounds, taking a snapshot after the second. The third round is
+  // only recorded in the log. Every round of `Run` increments the logical time
+  // in `Receive` and then ticks.
+  {
+    auto f = make_executor();
+    ASSERT_EQ(Status::OK, f.EnableCheckpointing(directory, 2));
+    ASSERT_EQ(Status::OK, f.Recover());
+    f.time_++;
+    ASSERT_EQ(Status::OK, f.Tick());
+    f.time_++;
+    ASSERT_EQ(Status::OK, f.Tick());
+    ASSERT_EQ(Status::OK, f.checkpointer_->WaitForCheckpoint());
+    f.time_++;
+    ASSERT_EQ(Status::OK, f.Tick());
+  }
+
+  // Recovering loads {2, 5} from the snapshot and replays the third round.
+  auto g = make_executor();
+  ASSERT_EQ(Status::OK, g.EnableCheckpointing(directory, 2));
+  ASSERT_EQ(Status::OK, g.Recover());
+  expected = {{{2}, {hash({2}), {2}}},
+              {{5}, {hash({5}), {5}}},
+              {{8}, {hash({8}), {8}}}};
+  EXPECT_EQ(g.Get<0>().Get(), expected);
+  EXPECT_EQ(g.time_, 9);
+}
+
+TEST(FluentExecutor, RecoverDoesntRecordLineageAgain) {
+  zmq::context_t context(1);
+  ldb::ConnectionConfig connection_config;
+  std::set<std::tuple<int>> xs = {{0}};
+  char directory[] = "/tmp/fluent_executor_test.XXXXXX";
+  ASSERT_NE(mkdtemp(directory), nullptr);
+
+  auto make_executor = [&]() {
+    auto fb_or =
+        fluent<ldb::MockClient, Hash, ldb::MockToSql, MockPickler, MockClock>(
+            "name", "inproc://yolo", &context, connection_config);
+    CHECK_EQ(Status::OK, fb_or.status());
+    auto fe_or = fb_or.ConsumeValueOrDie()
+                     .logical_time()
+                     .table<int>("t", {{"x"}})
+                     .RegisterBootstrapRules([&xs](auto&, auto& t) {
+                       using namespace fluent::infix;
+                       return std::make_tuple(t <= lra::make_iterable(&xs));
+                     })
+                     .RegisterRules([&xs](auto& logical_time, auto& t) {
+                       using namespace fluent::infix;
+                       auto rule =
+                           t <= (lra::make_iterable(&xs) |
+                                 lra::map([&](const auto&) -> std::tuple<int> {
+                                   return {logical_time.Get()};
+                                 }));
+                       return std::make_tuple(rule);
+                     });
+    CHECK_EQ(Status::OK, fe_or.status());
+    return fe_or.ConsumeValueOrDie();
+  };
+
+  // The first run records the bootstrap tuple and the tuple of every round.
+  {
+    auto f = make_executor();
+    ASSERT_EQ(Status::OK, f.EnableCheckpointing(directory, 2));
+    ASSERT_EQ(Status::OK, f.Recover());
+    for (int i = 0; i < 3; ++i) {
+      f.time_++;
+      ASSERT_EQ(Status::OK, f.Tick());
+    }
+    ASSERT_EQ(Status::OK, f.checkpointer_->WaitForCheckpoint());
+    EXPECT_EQ(f.GetLineageDbClient().GetInsertTuple().size(),
+              static_cast<std::size_t>(4));
+  }
+
+  // Recovering replays the third round, which was already recorded.
+  auto g = make_executor();
+  ASSERT_EQ(Status::OK, g.EnableCheckpointing(directory, 2));
+  ASSERT_EQ(Status::OK, g.Recover());
+  EXPECT_EQ(g.Get<0>().Get().size(), static_cast<std::size_t>(4));
+  EXPECT_EQ(g.GetLineageDbClient().GetInsertTuple().size(),
+            static_cast<std::size_t>(0));
+  EXPECT_EQ(g.GetLineageDbClient().GetAddDerivedLineage().size(),
+            static_cast<std::size_t>(0));
+
+  // Ticks after recovery are recorded.
+  g.time_++;
+  ASSERT_EQ(Status::OK, g.Tick());
+  EXPECT_EQ(g.GetLineageDbClient().GetInsertTuple().size(),
+            static_cast<std::size_t>(1));
+}
+
+TEST(FluentExecutor, RecoverFromCorruptSnapshot) {
+  zmq::context_t context(1);
+  ldb::ConnectionConfig connection_config;
+
+  auto recover = [&](const std::vector<std::vector<std::string>>& records) {
+    char directory[] = "/tmp/fluent_executor_test.XXXXXX";
+    CHECK_NE(mkdtemp(directory), nullptr);
+    {
+      auto writer = RecordWriter::Make(std::string(directory) + "/snapshot.0")
+                        .ConsumeValueOrDie();
+      for (const std::vector<std::string>& record : records) {
+        writer->Append(record);
+      }
+    }
+
+    auto fb_or =
+        noopfluent("name", "inproc://yolo", &context, connection_config);
+    CHECK_EQ(Status::OK, fb_or.status());
+    auto fe_or = fb_or.ConsumeValueOrDie()
+                     .table<int>("t", {{"x"}})
+                     .RegisterRules([](auto&) { return std::make_tuple(); });
+    CHECK_EQ(Status::OK, fe_or.status());
+    auto f = fe_or.ConsumeValueOrDie();
+    CHECK_EQ(Status::OK, f.EnableCheckpointing(directory, 2));
+    return f.Recover().error_code();
+  };
+
+  EXPECT_EQ(ErrorCode::OK, recover({{"time", "3"}, {"t", "7", "1", "2", "5"}}));
+  EXPECT_EQ(ErrorCode::INVALID_ARGUMENT, recover({{"time", "three"}}));
+  EXPECT_EQ(ErrorCode::INVALID_ARGUMENT,
+            recover({{"time", "3"}, {"t", "seven", "1", "2", "5"}}));
+  EXPECT_EQ(ErrorCode::INVALID_ARGUMENT,
+            recover({{"time", "3"}, {"t", "7", "one", "2", "5"}}));
+  EXPECT_EQ(ErrorCode::INVALID_ARGUMENT,
+            recover({{"time", "3"}, {"t", "7", "1", "two", "5"}}));
+  EXPECT_EQ(ErrorCode::INVALID_ARGUMENT,
+            recover({{"time", "3"}, {"t", "7", "1", "2", "five"}}));
+  EXPECT_EQ(ErrorCode::INVALID_ARGUMENT,
+            recover({{"time", "3"}, {"t", "7", "18446744073709551615", "5"}}));
+}
+
 TEST(FluentExecutor, SimpleBootstrap) {
   zmq::context_t context(1);
   lineagedb::ConnectionConfig connection_config;
@@ -200,6 +402,152 @@ TEST(FluentExecutor, SimpleBootstrap) {
   EXPECT_EQ(f.Get<1>().Get(), expected);
 }
 
+TEST(FluentExecutor, BulkLoad) {
+  zmq::context_t context(1);
+  lineagedb::ConnectionConfig connection_config;
+  std::map<std::tuple<int, std::string>, CollectionTupleIds> expected;
+  Hash<std::tuple<int, std::string>> hash;
+  const char path[] = "/tmp/fluent_executor_test_bulk_load.csv";
+  {
+    std::ofstream f(path, std::ios::trunc);
+    f << "2,b\n1,a\n3,c\n2,b\n";
+  }
+
+  auto fb_or =
+      fluent<ldb::MockClient, Hash, ldb::MockToSql, MockPickler, MockClock>(
+          "name", "inproc://yolo", &context, connection_config);
+  ASSERT_EQ(Status::OK, fb_or.status());
+  auto fe_or = fb_or.ConsumeValueOrDie()
+                   .table<int, std::string>("t", {{"x", "y"}})
+                   .RegisterRules([](auto&) { return std::make_tuple(); });
+  ASSERT_EQ(Status::OK, fe_or.status());
+  auto f = fe_or.ConsumeValueOrDie();
+
+  ASSERT_EQ(Status::OK, f.BulkLoad<0>(path, TupleFileFormat::CSV, 2));
+  expected = {{{1, "a"}, {hash({1, "a"}), {1}}},
+              {{2, "b"}, {hash({2, "b"}), {1}}},
+              {{3, "c"}, {hash({3, "c"}), {1}}}};
+  EXPECT_EQ(f.Get<0>().Get(), expected);
+
+  // The tuples are recorded in lineagedb at the same logical time.
+  using MockClient = ldb::MockClient<Hash, ldb::MockToSql, MockClock>;
+  using InsertTupleTuple = MockClient::InsertTupleTuple;
+  using time_point = std::chrono::time_point<MockClock>;
+  const std::vector<InsertTupleTuple> inserted = {
+      InsertTupleTuple("t", 1, time_point(), {"1", "a"}),
+      InsertTupleTuple("t", 1, time_point(), {"2", "b"}),
+      InsertTupleTuple("t", 1, time_point(), {"3", "c"})};
+  EXPECT_EQ(f.GetLineageDbClient().GetInsertTuple(), inserted);
+
+  EXPECT_NE(Status::OK,
+            f.BulkLoad<0>("/tmp/fluent_executor_test_does_not_exist",
+                          TupleFileFormat::CSV, 2));
+}
+
+TEST(FluentExecutor, FileSink) {
+  zmq::context_t context(1);
+  lineagedb::ConnectionConfig connection_config;
+  std::set<std::tuple<int, std::string>> xs = {{2, "b"}, {1, "a"}};
+  std::map<std::tuple<int, std::string>, CollectionTupleIds> expected;
+  Hash<std::tuple<int, std::string>> hash;
+  const char path[] = "/tmp/fluent_executor_test_file_sink.records";
+
+  auto fb_or = noopfluent("name", "inproc://yolo", &context, connection_config);
+  ASSERT_EQ(Status::OK, fb_or.status());
+  auto fe_or = fb_or.ConsumeValueOrDie()
+                   .table<int, std::string>("t", {{"x", "y"}})
+                   .table<int, std::string>("u", {{"x", "y"}})
+                   .file_sink<int, std::string>("sink", {{"x", "y"}}, path,
+                                                TupleFileFormat::RECORDS)
+                   .RegisterBootstrapRules([&xs](auto& t, auto&, auto&) {
+                     using namespace fluent::infix;
+                     return std::make_tuple(t <= lra::make_iterable(&xs));
+                   })
+                   .RegisterRules([](auto& t, auto&, auto& sink) {
+                     using namespace fluent::infix;
+                     return std::make_tuple(sink <= lra::make_collection(&t));
+                   });
+  ASSERT_EQ(Status::OK, fe_or.status());
+  auto f = fe_or.ConsumeValueOrDie();
+
+  // The tuples written to the sink during a tick are in its file at the end
+  // of the tick, so they can be loaded back into a table.
+  ASSERT_EQ(Status::OK, f.BootstrapTick());
+  ASSERT_EQ(Status::OK, f.Tick());
+  ASSERT_EQ(Status::OK, f.BulkLoad<1>(path, TupleFileFormat::RECORDS, 2));
+  expected = {{{1, "a"}, {hash({1, "a"}), {5}}},
+              {{2, "b"}, {hash({2, "b"}), {5}}}};
+  EXPECT_EQ(f.Get<1>().Get(), expected);
+}
+
+// A tuple derived by a rule is copied exactly once, into the rule's output
+// buffer, and is then moved into its collection.
+TEST(FluentExecutor, RuleOutputIsCopiedOnce) {
+  zmq::context_t context(1);
+  lineagedb::ConnectionConfig connection_config;
+  std::set<std::tuple<Copied, int>> xs = {std::make_tuple(Copied(1), 2)};
+
+  auto fb_or = noopfluent("name", "inproc://yolo", &context, connection_config);
+  ASSERT_EQ(Status::OK, fb_or.status());
+  auto fe_or =
+      fb_or.ConsumeValueOrDie()
+          .table<Copied, int>("t", {{"x", "y"}})
+          .table<Copied>("u", {{"x"}})
+          .table<Copied>("v", {{"x"}})
+          .RegisterBootstrapRules([&xs](auto& t, auto&, auto&) {
+            using namespace fluent::infix;
+            return std::make_tuple(t <= lra::make_iterable(&xs));
+          })
+          .RegisterRules([](auto& t, auto& u, auto& v) {
+            using namespace fluent::infix;
+            return std::make_tuple(
+                u <= (lra::make_collection(&t) | lra::project<0>()),
+                v <= lra::make_collection(&u));
+          });
+  ASSERT_EQ(Status::OK, fe_or.status());
+  auto f = fe_or.ConsumeValueOrDie();
+  ASSERT_EQ(Status::OK, f.BootstrapTick());
+
+  // Rule 0 projects a view of t's tuple, and rule 1 scans u's tuple in
+  // place.
+  Copied::num_copies = 0;
+  ASSERT_EQ(Status::OK, f.Tick());
+  EXPECT_EQ(f.Get<1>().Get().size(), static_cast<std::size_t>(1));
+  EXPECT_EQ(f.Get<2>().Get().size(), static_cast<std::size_t>(1));
+  EXPECT_EQ(Copied::num_copies, 2);
+}
+
+// The collections read by a rule whose join order is chosen by cost estimate
+// their distinct values, and the other collections don't.
+TEST(FluentExecutor, CostBasedRulesTrackDistinct) {
+  zmq::context_t context(1);
+  lineagedb::ConnectionConfig connection_config;
+
+  auto fb_or = noopfluent("name", "inproc://yolo", &context, connection_config);
+  ASSERT_EQ(Status::OK, fb_or.status());
+  auto fe_or =
+      fb_or.ConsumeValueOrDie()
+          .table<int, int>("a", {{"x", "y"}})
+          .table<int, int>("b", {{"x", "y"}})
+          .table<int, int>("c", {{"x", "y"}})
+          .table<int, int>("d", {{"x", "y"}})
+          .RegisterRules([](auto& a, auto& b, auto& c, auto& d) {
+            using namespace fluent::infix;
+            auto ab = lra::make_hash_join<ra::LeftKeys<1>, ra::RightKeys<1>>(
+                lra::make_collection(&a), lra::make_collection(&b));
+            auto abc = lra::make_hash_join<ra::LeftKeys<0>, ra::RightKeys<0>>(
+                ab, lra::make_collection(&c));
+            return std::make_tuple(d <= (abc | lra::project<0, 1>()),
+                                   a <= lra::make_collection(&d));
+          });
+  ASSERT_EQ(Status::OK, fe_or.status());
+  auto f = fe_or.ConsumeValueOrDie();
+  EXPECT_TRUE(f.Get<0>().Stats().TracksDistinct());
+  EXPECT_TRUE(f.Get<1>().Stats().TracksDistinct());
+  EXPECT_TRUE(f.Get<2>().Stats().TracksDistinct());
+  EXPECT_FALSE(f.Get<3>().Stats().TracksDistinct());
+}
+
 TEST(FluentExecutor, ComplexProgram) {
   auto add1_mult2 = [](const std::tuple<int>& t) {
     return std::tuple<int>((1 + std::get<0>(t)) * 2);
@@ -278,6 +626,52 @@ TEST(FluentExecutor, ComplexProgram) {
   EXPECT_STREQ("0\n2\n", captured.Get().c_str());
 }
 
+TEST(FluentExecutor, MalformedBatchIsDropped) {
+  zmq::context_t context(1);
+  lineagedb::ConnectionConfig connection_config;
+  auto fb_or = noopfluent("name", "inproc://yolo", &context, connection_config);
+  ASSERT_EQ(Status::OK, fb_or.status());
+  auto fe_or = fb_or.ConsumeValueOrDie()
+                   .channel<std::string, int>("c", {{"addr", "x"}})
+                   .RegisterRules([](auto&) { return std::make_tuple(); });
+  ASSERT_EQ(Status::OK, fe_or.status());
+  auto f = fe_or.ConsumeValueOrDie();
+
+  const std::string node_id = MockPickler<std::size_t>().Dump(0);
+  const std::string channel_id = zmq_util::message_to_string(
+      zmq_util::uint64_to_message(Fnv1a64("c")));
+
+  // The tuple is missing a column, so the batch is dropped.
+  ASSERT_EQ(Status::OK,
+            f.ReceiveMessages({{node_id, channel_id, "0", "inproc://a"}}));
+  EXPECT_EQ(f.Get<0>().Get().size(), static_cast<std::size_t>(0));
+
+  ASSERT_EQ(Status::OK,
+            f.ReceiveMessages({{node_id, channel_id, "0", "inproc://a", "1"}}));
+  EXPECT_EQ(f.Get<0>().Get().size(), static_cast<std::size_t>(1));
+}
+
+TEST(FluentExecutor, MessageForUnknownChannelIsDropped) {
+  zmq::context_t context(1);
+  lineagedb::ConnectionConfig connection_config;
+  auto fb_or = noopfluent("name", "inproc://yolo", &context, connection_config);
+  ASSERT_EQ(Status::OK, fb_or.status());
+  auto fe_or = fb_or.ConsumeValueOrDie()
+                   .channel<std::string, int>("c", {{"addr", "x"}})
+                   .RegisterRules([](auto&) { return std::make_tuple(); });
+  ASSERT_EQ(Status::OK, fe_or.status());
+  auto f = fe_or.ConsumeValueOrDie();
+
+  const std::string node_id = MockPickler<std::size_t>().Dump(0);
+  const std::string unknown_id = zmq_util::message_to_string(
+      zmq_util::uint64_to_message(Fnv1a64("d")));
+  ASSERT_EQ(Status::OK, f.ReceiveMessages({{node_id}}));
+  ASSERT_EQ(Status::OK, f.ReceiveMessages({{node_id, "short"}}));
+  ASSERT_EQ(Status::OK, f.ReceiveMessages(
+                            {{node_id, unknown_id, "0", "inproc://a", "1"}}));
+  EXPECT_EQ(f.Get<0>().Get().size(), static_cast<std::size_t>(0));
+}
+
 TEST(FluentExecutor, SimpleCommunication) {
   auto reroute = [](const std::string& s) {
     return [s](const std::tuple<std::string, int>& t) {
@@ -365,6 +759,80 @@ TEST(FluentExecutor, SimpleCommunication) {
   ASSERT_EQ(pong.Get<0>().Get(), expected);
 }
 
+TEST(FluentExecutor, BatchedCommunication) {
+  zmq::context_t context(1);
+  lineagedb::ConnectionConfig conn_config;
+  std::set<std::tuple<std::string, int>> xs = {{"inproc://pong", 1},
+                                               {"inproc://pong", 2},
+                                               {"inproc://pong", 3}};
+  std::map<std::tuple<std::string, int>, CollectionTupleIds> expected;
+  Hash<std::tuple<std::string, int>> hash;
+
+  auto ping_fb_or = noopfluent("name", "inproc://ping", &context, conn_config);
+  ASSERT_EQ(Status::OK, ping_fb_or.status());
+  auto ping_fe_or = ping_fb_or.ConsumeValueOrDie()
+                        .channel<std::string, int>("c", {{"addr", "x"}})
+                        .RegisterBootstrapRules([&xs](auto& c) {
+                          using namespace fluent::infix;
+                          auto brule = c <= lra::make_iterable(&xs);
+                          return std::make_tuple(brule);
+                        })
+                        .RegisterRules([](auto&) { return std::tuple<>(); });
+  ASSERT_EQ(Status::OK, ping_fe_or.status());
+  auto ping = ping_fe_or.ConsumeValueOrDie();
+
+  auto pong_fb_or = noopfluent("name", "inproc://pong", &context, conn_config);
+  ASSERT_EQ(Status::OK, pong_fb_or.status());
+  auto pong_fe_or = pong_fb_or.ConsumeValueOrDie()
+                        .channel<std::string, int>("c", {{"addr", "x"}})
+                        .RegisterRules([](auto&) { return std::tuple<>(); });
+  ASSERT_EQ(Status::OK, pong_fe_or.status());
+  auto pong = pong_fe_or.ConsumeValueOrDie();
+
+  // All three tuples are sent in a single batch, so a single call to Receive
+  // receives all of them.
+  ASSERT_EQ(Status::OK, ping.BootstrapTick());
+  ASSERT_EQ(Status::OK, pong.Receive());
+  expected = {{{"inproc://pong", 1}, {hash({"inproc://pong", 1}), {1}}},
+              {{"inproc://pong", 2}, {hash({"inproc://pong", 2}), {1}}},
+              {{"inproc://pong", 3}, {hash({"inproc://pong", 3}), {1}}}};
+  EXPECT_EQ(pong.Get<0>().Get(), expected);
+}
+
+TEST(FluentExecutor, RegisterFd) {
+  zmq::context_t context(1);
+  lineagedb::ConnectionConfig conn_config;
+  std::map<std::tuple<std::string, int>, CollectionTupleIds> expected;
+  Hash<std::tuple<std::string, int>> hash;
+
+  auto fb_or = noopfluent("name", "inproc://a", &context, conn_config);
+  ASSERT_EQ(Status::OK, fb_or.status());
+  auto fe_or = fb_or.ConsumeValueOrDie()
+                   .channel<std::string, int>("c", {{"addr", "x"}})
+                   .RegisterRules([](auto&) { return std::tuple<>(); });
+  ASSERT_EQ(Status::OK, fe_or.status());
+  auto f = fe_or.ConsumeValueOrDie();
+
+  // Every byte written to the pipe is received into c as a tuple.
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  f.RegisterFd<0>(fds[0], [&fds]() {
+    char c;
+    EXPECT_EQ(read(fds[0], &c, 1), 1);
+    return std::vector<std::tuple<std::string, int>>{{"inproc://a", c}};
+  });
+
+  const char x = 1;
+  ASSERT_EQ(write(fds[1], &x, 1), 1);
+  ASSERT_EQ(Status::OK, f.Receive());
+  expected = {{{"inproc://a", 1}, {hash({"inproc://a", 1}), {1}}}};
+  EXPECT_EQ(f.Get<0>().Get(), expected);
+  ASSERT_EQ(Status::OK, f.Tick());
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
 TEST(FluentExecutor, SimplePeriodic) {
   zmq::context_t context(1);
   lineagedb::ConnectionConfig conn_config;
@@ -653,14 +1121,14 @@ TEST(FluentExecutor, BlackBoxLineage) {
   const Client::RegisterBlackBoxLineageTuple& t = black_box_lineage_tuples[0];
   EXPECT_EQ(CrunchWhitespace(std::get<0>(t)), CrunchWhitespace("f_response"));
   EXPECT_EQ(CrunchWhitespace(std::get<1>(t)[0]), CrunchWhitespace(R"(
-    CREATE FUNCTION name_f_response_lineage_impl(integer, int, int)
+    CREATE OR REPLACE FUNCTION name_f_response_lineage_impl(integer, int, int)
     RETURNS TABLE(node_name text, collection_name text, hash bigint,
                   time_inserted integer, physical_time_inserted timestamp with
                   time zone)
     AS $$hello world$$ LANGUAGE SQL;
   )"));
   EXPECT_EQ(CrunchWhitespace(std::get<1>(t)[1]), CrunchWhitespace(R"(
-    CREATE FUNCTION name_f_response_lineage(bigint)
+    CREATE OR REPLACE FUNCTION name_f_response_lineage(bigint)
     RETURNS TABLE(node_name text, collection_name text, hash bigint,
                   time_inserted integer)
     AS $$
@@ -49,24 +49,30 @@ namespace infix {
 //   std::literals::chrono_literals), so make sure to add `using namespace
 //   fluent::infix` before using the functions.
 
-// Table <=
-template <typename... Ts, typename LogicalRa>
-Rule<Table<Ts...>, MergeTag, typename std::decay<LogicalRa>::type> operator<=(
-    Table<Ts...>& t, LogicalRa&& rhs) {
+// Table <= (and MappedTable <=)
+template <template <typename> class Allocator, typename... Ts,
+          typename LogicalRa>
+Rule<BasicTable<Allocator, Ts...>, MergeTag,
+     typename std::decay<LogicalRa>::type>
+operator<=(BasicTable<Allocator, Ts...>& t, LogicalRa&& rhs) {
   return {&t, MergeTag(), std::forward<LogicalRa>(rhs)};
 }
 
-// Table +=
-template <typename... Ts, typename LogicalRa>
-Rule<Table<Ts...>, DeferredMergeTag, typename std::decay<LogicalRa>::type>
-operator+=(Table<Ts...>& t, LogicalRa&& rhs) {
+// Table += (and MappedTable +=)
+template <template <typename> class Allocator, typename... Ts,
+          typename LogicalRa>
+Rule<BasicTable<Allocator, Ts...>, DeferredMergeTag,
+     typename std::decay<LogicalRa>::type>
+operator+=(BasicTable<Allocator, Ts...>& t, LogicalRa&& rhs) {
   return {&t, DeferredMergeTag(), std::forward<LogicalRa>(rhs)};
 }
 
-// Table -=
-template <typename... Ts, typename LogicalRa>
-Rule<Table<Ts...>, DeferredDeleteTag, typename std::decay<LogicalRa>::type>
-operator-=(Table<Ts...>& t, LogicalRa&& rhs) {
+// Table -= (and MappedTable -=)
+template <template <typename> class Allocator, typename... Ts,
+          typename LogicalRa>
+Rule<BasicTable<Allocator, Ts...>, DeferredDeleteTag,
+     typename std::decay<LogicalRa>::type>
+operator-=(BasicTable<Allocator, Ts...>& t, LogicalRa&& rhs) {
   return {&t, DeferredDeleteTag(), std::forward<LogicalRa>(rhs)};
 }
 
@@ -99,6 +105,23 @@ Rule<Stdout, DeferredMergeTag, typename std::decay<LogicalRa>::type> operator+=(
   return {&o, DeferredMergeTag(), std::forward<LogicalRa>(rhs)};
 }
 
+// FileSink <=
+template <template <typename> class Pickler, typename... Ts,
+          typename LogicalRa>
+Rule<FileSink<Pickler, Ts...>, MergeTag, typename std::decay<LogicalRa>::type>
+operator<=(FileSink<Pickler, Ts...>& f, LogicalRa&& rhs) {
+  return {&f, MergeTag(), std::forward<LogicalRa>(rhs)};
+}
+
+// FileSink +=
+template <template <typename> class Pickler, typename... Ts,
+          typename LogicalRa>
+Rule<FileSink<Pickler, Ts...>, DeferredMergeTag,
+     typename std::decay<LogicalRa>::type>
+operator+=(FileSink<Pickler, Ts...>& f, LogicalRa&& rhs) {
+  return {&f, DeferredMergeTag(), std::forward<LogicalRa>(rhs)};
+}
+
 }  // namespace infix
 }  // namespace fluent
 
@@ -0,0 +1,111 @@
+#ifndef FLUENT_LINEAGE_VIEW_H_
+#define FLUENT_LINEAGE_VIEW_H_
+
+#include <cstddef>
+
+#include <set>
+#include <string>
+
+#include "collections/logical_times.h"
+#include "common/status.h"
+#include "common/status_macros.h"
+#include "fluent/local_tuple_id.h"
+
+namespace fluent {
+
+// When a rule scans a collection, every tuple is paired with its lineage: the
+// set of LocalTupleIds of the tuple's insertions into the collection. Building
+// a `std::set<LocalTupleId>` for every scanned tuple allocates a set node and
+// copies the collection's name for every id, even if the lineage is never
+// used (e.g. when lineage is tracked by a NoopClient).
+//
+// A LineageView is a lazy, non-owning stand-in for such a set. It points into
+// the collection's storage and is only converted into a
+// `std::set<LocalTupleId>` when an operator needs one (e.g. to union the
+// lineages of two joined tuples). `ForEachLocalTupleId` iterates over the ids
+// in a LineageView without building a set at all.
+//
+//   std::string name = "t";
+//   LogicalTimes times = {1, 2};
+//   LineageView lineage(&name, 0xA, &times);
+//   std::set<LocalTupleId> ids = lineage; // {("t", 0xA, 1), ("t", 0xA, 2)}
+//
+// A LineageView must not outlive the collection name and logical times it
+// points to.
+class LineageView {
+ public:
+  // The empty lineage.
+  LineageView()
+      : collection_name_(nullptr), hash_(0), times_(nullptr), time_(0) {}
+
+  // The lineage {(collection_name, hash, t) | t in times}.
+  LineageView(const std::string* collection_name, std::size_t hash,
+              const LogicalTimes* times)
+      : collection_name_(collection_name),
+        hash_(hash),
+        times_(times),
+        time_(0) {}
+
+  // The lineage {(collection_name, hash, time)}.
+  LineageView(const std::string* collection_name, std::size_t hash, int time)
+      : collection_name_(collection_name),
+        hash_(hash),
+        times_(nullptr),
+        time_(time) {}
+
+  // Call `f(id)` for every id in the lineage, stopping at the first error.
+  template <typename F>
+  WARN_UNUSED Status ForEach(F f) const {
+    if (collection_name_ == nullptr) {
+      return Status::OK;
+    }
+    LocalTupleId id{*collection_name_, hash_, time_};
+    if (times_ == nullptr) {
+      return f(id);
+    }
+    for (int time : *times_) {
+      id.logical_time_inserted = time;
+      RETURN_IF_ERROR(f(id));
+    }
+    return Status::OK;
+  }
+
+  operator std::set<LocalTupleId>() const {
+    std::set<LocalTupleId> ids;
+    Status status = ForEach([&ids](const LocalTupleId& id) {
+      ids.insert(id);
+      return Status::OK;
+    });
+    UNUSED(status);
+    return ids;
+  }
+
+ private:
+  // `collection_name_` is null for the empty lineage. `times_` is null for a
+  // lineage with the single logical time `time_`.
+  const std::string* collection_name_;
+  std::size_t hash_;
+  const LogicalTimes* times_;
+  int time_;
+};
+
+// `ForEachLocalTupleId(lineage, f)` calls `f(id)` for every id in `lineage`,
+// which is either a `std::set<LocalTupleId>` or a LineageView, stopping at the
+// first error.
+template <typename F>
+WARN_UNUSED Status ForEachLocalTupleId(const std::set<LocalTupleId>& lineage,
+                                       F f) {
+  for (const LocalTupleId& id : lineage) {
+    RETURN_IF_ERROR(f(id));
+  }
+  return Status::OK;
+}
+
+template <typename F>
+WARN_UNUSED Status ForEachLocalTupleId(const LineageView& lineage, F f) {
+  return lineage.ForEach(f);
+}
+
+}  // namespace fluent
+
+#endif  // FLUENT_LINEAGE_VIEW_H_
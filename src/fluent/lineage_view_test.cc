@@ -0,0 +1,87 @@
+#include "fluent/lineage_view.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+#include "common/status.h"
+#include "fluent/local_tuple_id.h"
+
+namespace fluent {
+namespace {
+
+std::vector<LocalTupleId> Ids(const LineageView& lineage) {
+  std::vector<LocalTupleId> ids;
+  Status status = ForEachLocalTupleId(lineage, [&ids](const LocalTupleId& id) {
+    ids.push_back(id);
+    return Status::OK;
+  });
+  EXPECT_EQ(Status::OK, status);
+  return ids;
+}
+
+}  // namespace
+
+TEST(LineageView, Empty) {
+  LineageView lineage;
+  EXPECT_EQ(std::set<LocalTupleId>{}, std::set<LocalTupleId>(lineage));
+  EXPECT_EQ(std::vector<LocalTupleId>{}, Ids(lineage));
+}
+
+TEST(LineageView, SingleTime) {
+  const std::string name = "t";
+  LineageView lineage(&name, 42, 1);
+  const LocalTupleId id{"t", 42, 1};
+  EXPECT_EQ(std::set<LocalTupleId>{id}, std::set<LocalTupleId>(lineage));
+  EXPECT_EQ(std::vector<LocalTupleId>{id}, Ids(lineage));
+}
+
+TEST(LineageView, ManyTimes) {
+  const std::string name = "t";
+  LogicalTimes times = {1, 2, 3};
+  LineageView lineage(&name, 42, &times);
+  const std::vector<LocalTupleId> expected = {
+      {"t", 42, 1}, {"t", 42, 2}, {"t", 42, 3}};
+  EXPECT_EQ(std::set<LocalTupleId>(expected.begin(), expected.end()),
+            std::set<LocalTupleId>(lineage));
+  EXPECT_EQ(expected, Ids(lineage));
+
+  // A LineageView refers to the logical times; it doesn't copy them.
+  times.insert(4);
+  EXPECT_EQ(4u, Ids(lineage).size());
+}
+
+TEST(LineageView, ForEachStopsAtFirstError) {
+  const std::string name = "t";
+  const LogicalTimes times = {1, 2, 3};
+  LineageView lineage(&name, 42, &times);
+  int num_calls = 0;
+  Status status = lineage.ForEach([&num_calls](const LocalTupleId&) {
+    num_calls++;
+    return Status(ErrorCode::INVALID_ARGUMENT, "");
+  });
+  EXPECT_EQ(ErrorCode::INVALID_ARGUMENT, status.error_code());
+  EXPECT_EQ(1, num_calls);
+}
+
+TEST(LineageView, ForEachLocalTupleIdSet) {
+  const std::set<LocalTupleId> lineage = {{"t", 1, 1}, {"u", 2, 2}};
+  std::set<LocalTupleId> ids;
+  Status status = ForEachLocalTupleId(lineage, [&ids](const LocalTupleId& id) {
+    ids.insert(id);
+    return Status::OK;
+  });
+  EXPECT_EQ(Status::OK, status);
+  EXPECT_EQ(lineage, ids);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,31 +1,50 @@
 #ifndef FLUENT_NETWORK_STATE_H_
 #define FLUENT_NETWORK_STATE_H_
 
+#include <memory>
 #include <string>
 
+#include "glog/logging.h"
 #include "zmq.hpp"
 
 #include "zmq_util/socket_cache.h"
+#include "zmq_util/transport.h"
 
 namespace fluent {
 
 // NetworkState is a simple struct holding all of the networking junk a
-// FluentExecutor needs. Specifically, there are three things:
+// FluentExecutor needs. Specifically, there are four things:
 //
 // 1. A zmq::context_t because all zmq networking requires a context.
 // 2. A PULL zmq:socket_t on which a FluentExecutor receives from other nodes.
 // 3. A SocketCache which channels use to figure out where to send messages.
+// 4. The Transport which channels send messages with. It is the SocketCache.
+//
+// Alternatively, a NetworkState can hold nothing but a Transport. Channels
+// send messages with the transport, and the FluentExecutor doesn't listen on
+// the network at all. Instead, messages are handed to it directly with
+// `FluentExecutor::ReceiveMessages`. This is how a `Simulation` runs many
+// executors in a single process (see fluent/simulation.h).
 struct NetworkState {
   explicit NetworkState(const std::string& address,
                         zmq::context_t* const context_)
-      : context(context_), socket(*context, ZMQ_PULL), socket_cache(context) {
-    socket.bind(address);
+      : context(context_),
+        socket(std::make_unique<zmq::socket_t>(*context, ZMQ_PULL)),
+        socket_cache(std::make_unique<zmq_util::SocketCache>(context)),
+        transport(socket_cache.get()) {
+    socket->bind(address);
     LOG(INFO) << "Fluent executor listening on '" << address << "'.";
   }
 
+  explicit NetworkState(zmq_util::Transport* const transport_)
+      : context(nullptr), transport(transport_) {}
+
+  // `context`, `socket`, and `socket_cache` are null if the NetworkState was
+  // constructed with only a Transport.
   zmq::context_t* const context;
-  zmq::socket_t socket;
-  zmq_util::SocketCache socket_cache;
+  std::unique_ptr<zmq::socket_t> socket;
+  std::unique_ptr<zmq_util::SocketCache> socket_cache;
+  zmq_util::Transport* const transport;
 };
 
 }  // namespace fluent
@@ -0,0 +1,434 @@
+#ifndef FLUENT_SIMULATION_H_
+#define FLUENT_SIMULATION_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "zmq.hpp"
+
+#include "common/macros.h"
+#include "common/status.h"
+#include "common/status_macros.h"
+#include "zmq_util/transport.h"
+#include "zmq_util/zmq_util.h"
+
+namespace fluent {
+namespace detail {
+
+// A SimulatedExecutor is a FluentExecutor of any type, from the point of view
+// of a `Simulation`.
+template <typename Clock>
+class SimulatedExecutor {
+ public:
+  virtual ~SimulatedExecutor() {}
+  virtual Status BootstrapTick() = 0;
+  virtual Status ReceiveMessages(
+      const std::vector<std::vector<std::string>>& messages) = 0;
+  virtual Status Tick() = 0;
+  virtual bool NextPeriodicDeadline(
+      std::chrono::time_point<Clock>* deadline) const = 0;
+};
+
+template <typename Clock, typename Executor>
+class SimulatedExecutorImpl : public SimulatedExecutor<Clock> {
+ public:
+  explicit SimulatedExecutorImpl(Executor executor)
+      : executor_(std::move(executor)) {}
+
+  Executor* Get() { return &executor_; }
+
+  Status BootstrapTick() override { return executor_.BootstrapTick(); }
+
+  Status ReceiveMessages(
+      const std::vector<std::vector<std::string>>& messages) override {
+    return executor_.ReceiveMessages(messages);
+  }
+
+  Status Tick() override { return executor_.Tick(); }
+
+  bool NextPeriodicDeadline(
+      std::chrono::time_point<Clock>* deadline) const override {
+    return executor_.NextPeriodicDeadline(deadline);
+  }
+
+ private:
+  Executor executor_;
+};
+
+}  // namespace detail
+
+// The link from one simulated node to another. A message sent over a link
+// first waits for every message sent before it over the same link, then takes
+// its size divided by `bytes_per_second` to be transmitted, and then arrives
+// `latency` later. A `bytes_per_second` of 0 means the link's bandwidth is
+// infinite. Messages sent over a link arrive in the order they were sent.
+struct SimulatedLink {
+  std::chrono::nanoseconds latency = std::chrono::nanoseconds::zero();
+  double bytes_per_second = 0;
+};
+
+struct SimulationStats {
+  // Messages sent by channels, and their sizes in bytes.
+  std::size_t messages_sent = 0;
+  std::size_t bytes_sent = 0;
+
+  // Messages received by nodes, and messages sent to addresses without a node.
+  std::size_t messages_delivered = 0;
+  std::size_t messages_dropped = 0;
+
+  // Rounds run by nodes. A round is a call to `ReceiveMessages` followed by a
+  // call to `Tick`, like one iteration of `FluentExecutor::Run`.
+  std::size_t rounds = 0;
+};
+
+// # Overview
+// A Simulation runs many FluentExecutors in a single process, on a single
+// thread, in virtual time. Instead of sending messages over ZeroMQ, channels
+// send them over an in-memory network with configurable latency and bandwidth
+// (see `SimulatedLink`), and instead of sleeping until the next periodic is
+// ready, a Simulation jumps straight to it. Simulating a thousand nodes
+// gossiping for an hour of virtual time takes as long as it takes to execute
+// their rules, and every run of a simulation behaves exactly the same.
+//
+// # Usage
+// Every node is built with a `fluent` overload that takes a Transport rather
+// than a zmq::context_t (see fluent/fluent_builder.h), using the transport
+// returned by `Endpoint`, and is then added to the simulation:
+//
+//   Simulation<MockClock> sim;
+//   sim.SetLinkModel([](const std::string& from, const std::string& to) {
+//     return SimulatedLink{std::chrono::milliseconds(10), 1e6};
+//   });
+//
+//   for (std::size_t i = 0; i < 1000; ++i) {
+//     const std::string address = "inproc://" + std::to_string(i);
+//     auto f = fluent<NoopClient, Hash, ToSql, CerealPickler, MockClock>(
+//                  "node" + std::to_string(i), address, sim.Endpoint(address),
+//                  connection_config)
+//                  .ConsumeValueOrDie()
+//                  .channel<std::string, int>("c", {{"addr", "x"}})
+//                  .periodic("p", std::chrono::seconds(1))
+//                  .RegisterRules(...)
+//                  .ConsumeValueOrDie();
+//     sim.AddNode(address, std::move(f));
+//   }
+//
+//   // Run every node's bootstrap rules and then simulate a minute.
+//   sim.RunFor(std::chrono::minutes(1));
+//   sim.Stats(); // messages sent, bytes sent, ...
+//
+// # Virtual Time
+// `Clock` must be a clock like MockClock (see testing/mock_clock.h) whose
+// time is advanced with `Clock::Advance`, and every node must be an executor
+// with the same `Clock`. Virtual time starts at `Clock::now()`. Since the
+// time of a clock like MockClock is global, only one Simulation should run at
+// a time.
+//
+// The simulation is a discrete-event simulation. Its events are the arrivals
+// of messages and the deadlines of periodics. Repeatedly, the simulation
+// advances virtual time to the earliest event and, for every node with an
+// event at that time, runs one round: the node receives every message that
+// arrived and triggers every periodic that's ready (see
+// `FluentExecutor::ReceiveMessages`), and then ticks. Executing rules takes no
+// virtual time, so a message sent in a round leaves at the time of the round.
+//
+// Nodes run their rounds in a deterministic order, and messages sent over
+// links with equal arrival times arrive in the order they were sent.
+template <typename Clock>
+class Simulation {
+ public:
+  using Time = std::chrono::time_point<Clock>;
+  using LinkModel = std::function<SimulatedLink(const std::string& from,
+                                                const std::string& to)>;
+
+  Simulation() : link_model_([](const std::string&, const std::string&) {
+    return SimulatedLink();
+  }) {}
+  DISALLOW_COPY_AND_ASSIGN(Simulation);
+
+  // `link_model(from, to)` returns the link from the node at address `from` to
+  // the node at address `to`. It's invoked every time a message is sent, so
+  // it can model links that change over time. By default, every link has no
+  // latency and infinite bandwidth.
+  void SetLinkModel(LinkModel link_model) {
+    link_model_ = std::move(link_model);
+  }
+
+  // The transport with which the node at address `address` sends messages.
+  // Pass it to `fluent` when building the node.
+  zmq_util::Transport* Endpoint(const std::string& address) {
+    return nodes_[NodeIndex(address)].endpoint.get();
+  }
+
+  // Add the executor `executor` at address `address` to the simulation, and
+  // return a pointer to it. `executor` must have been built with
+  // `Endpoint(address)`. It runs its bootstrap rules at the beginning of the
+  // next call to `RunUntil` or `RunFor`.
+  template <typename Executor>
+  Executor* AddNode(const std::string& address, Executor executor) {
+    Node& node = nodes_[NodeIndex(address)];
+    CHECK(node.executor == nullptr)
+        << "A node with address " << address << " was already added.";
+    using Impl = detail::SimulatedExecutorImpl<Clock, Executor>;
+    auto impl = std::make_unique<Impl>(std::move(executor));
+    Executor* const ptr = impl->Get();
+    node.executor = std::move(impl);
+    return ptr;
+  }
+
+  // Simulate every event up to and including virtual time `end`, and then
+  // advance virtual time to `end`.
+  WARN_UNUSED Status RunUntil(Time end) {
+    RETURN_IF_ERROR(Bootstrap());
+    while (!events_.empty() && events_.front().time <= end) {
+      RETURN_IF_ERROR(Step());
+    }
+    if (Clock::now() < end) {
+      Clock::Advance(end - Clock::now());
+    }
+    return Status::OK;
+  }
+
+  template <typename Rep, typename Period>
+  WARN_UNUSED Status RunFor(const std::chrono::duration<Rep, Period>& d) {
+    return RunUntil(Clock::now() + d);
+  }
+
+  const SimulationStats& Stats() const { return stats_; }
+
+ private:
+  // The transport of a single node. It sends messages from the node's address.
+  class SimulatedTransport : public zmq_util::Transport {
+   public:
+    SimulatedTransport(Simulation* simulation, std::size_t node)
+        : simulation_(simulation), node_(node) {}
+
+    void Send(const std::string& address,
+              std::vector<zmq::message_t> msgs) override {
+      simulation_->Send(node_, address, msgs);
+    }
+
+   private:
+    Simulation* const simulation_;
+    const std::size_t node_;
+  };
+
+  struct Node {
+    std::string address;
+    std::unique_ptr<SimulatedTransport> endpoint;
+
+    // `executor` is null until the node is added with `AddNode`.
+    std::unique_ptr<detail::SimulatedExecutor<Clock>> executor;
+    bool bootstrapped = false;
+
+    // The messages that have arrived since the node's last round.
+    std::vector<std::vector<std::string>> inbox;
+
+    // Whether the node has an event at the current virtual time. See `Step`.
+    bool ready = false;
+
+    // If `has_wakeup` is true, an event is scheduled at `wakeup` to trigger
+    // the node's next periodic. See `ScheduleWakeup`.
+    bool has_wakeup = false;
+    Time wakeup;
+  };
+
+  // The state of the link from one node to another. The next message sent
+  // over the link can't start being transmitted before `idle` or arrive
+  // before `last_arrival`.
+  struct LinkState {
+    Time idle;
+    Time last_arrival;
+  };
+
+  // An event at virtual time `time`: either the arrival of `message` at node
+  // `node` or, if `wakeup` is true, the deadline of one of its periodics.
+  // `id` orders events with the same time by when they were scheduled.
+  struct Event {
+    Time time;
+    std::size_t id;
+    std::size_t node;
+    bool wakeup;
+    std::vector<std::string> message;
+  };
+
+  // `events_` is a min-heap ordered by `EventAfter`.
+  struct EventAfter {
+    bool operator()(const Event& a, const Event& b) const {
+      return std::tie(a.time, a.id) > std::tie(b.time, b.id);
+    }
+  };
+
+  // Return the index of the node at address `address`, creating it if needed.
+  std::size_t NodeIndex(const std::string& address) {
+    auto iter = node_indices_.find(address);
+    if (iter != node_indices_.end()) {
+      return iter->second;
+    }
+    const std::size_t index = nodes_.size();
+    nodes_.emplace_back();
+    nodes_.back().address = address;
+    nodes_.back().endpoint = std::make_unique<SimulatedTransport>(this, index);
+    node_indices_.emplace(address, index);
+    return index;
+  }
+
+  // Run the bootstrap rules of every node added since the last call.
+  WARN_UNUSED Status Bootstrap() {
+    for (std::size_t i = 0; i < nodes_.size(); ++i) {
+      Node& node = nodes_[i];
+      if (node.executor != nullptr && !node.bootstrapped) {
+        node.bootstrapped = true;
+        RETURN_IF_ERROR(node.executor->BootstrapTick());
+        ScheduleWakeup(i);
+      }
+    }
+    return Status::OK;
+  }
+
+  // Advance virtual time to the earliest event, and run a round of every
+  // node with an event at that time.
+  WARN_UNUSED Status Step() {
+    const Time now = events_.front().time;
+    if (Clock::now() < now) {
+      Clock::Advance(now - Clock::now());
+    }
+
+    std::vector<std::size_t> ready;
+    while (!events_.empty() && events_.front().time == now) {
+      std::pop_heap(events_.begin(), events_.end(), EventAfter());
+      Event event = std::move(events_.back());
+      events_.pop_back();
+
+      Node& node = nodes_[event.node];
+      if (event.wakeup) {
+        if (node.has_wakeup && node.wakeup == now) {
+          node.has_wakeup = false;
+        }
+      } else if (node.executor == nullptr) {
+        stats_.messages_dropped++;
+        continue;
+      } else {
+        node.inbox.push_back(std::move(event.message));
+      }
+
+      if (!node.ready) {
+        node.ready = true;
+        ready.push_back(event.node);
+      }
+    }
+
+    for (const std::size_t i : ready) {
+      nodes_[i].ready = false;
+      RETURN_IF_ERROR(RunRound(i, now));
+    }
+    return Status::OK;
+  }
+
+  // Run a round of node `i` at virtual time `now`, unless it has no messages
+  // to receive and no periodics to trigger (e.g. because its wakeup was made
+  // stale by an earlier round).
+  WARN_UNUSED Status RunRound(std::size_t i, Time now) {
+    Node& node = nodes_[i];
+    Time deadline;
+    const bool periodic_ready =
+        node.executor->NextPeriodicDeadline(&deadline) && deadline <= now;
+    if (node.inbox.empty() && !periodic_ready) {
+      return Status::OK;
+    }
+
+    std::vector<std::vector<std::string>> inbox;
+    inbox.swap(node.inbox);
+    stats_.messages_delivered += inbox.size();
+    stats_.rounds++;
+    RETURN_IF_ERROR(node.executor->ReceiveMessages(inbox));
+    RETURN_IF_ERROR(node.executor->Tick());
+    ScheduleWakeup(i);
+    return Status::OK;
+  }
+
+  // Schedule an event for the next periodic deadline of node `i`, if it has
+  // one and it isn't already scheduled.
+  void ScheduleWakeup(std::size_t i) {
+    Node& node = nodes_[i];
+    Time deadline;
+    if (!node.executor->NextPeriodicDeadline(&deadline)) {
+      return;
+    }
+    deadline = std::max(deadline, Clock::now());
+    if (node.has_wakeup && node.wakeup == deadline) {
+      return;
+    }
+    node.has_wakeup = true;
+    node.wakeup = deadline;
+    Push(Event{deadline, next_event_id_++, i, true, {}});
+  }
+
+  // Send the message `msgs` from node `from` to the node at address `to`. See
+  // `SimulatedLink`.
+  void Send(std::size_t from, const std::string& to,
+            const std::vector<zmq::message_t>& msgs) {
+    std::vector<std::string> message;
+    message.reserve(msgs.size());
+    std::size_t num_bytes = 0;
+    for (const zmq::message_t& msg : msgs) {
+      message.push_back(zmq_util::message_to_string(msg));
+      num_bytes += msg.size();
+    }
+    stats_.messages_sent++;
+    stats_.bytes_sent += num_bytes;
+
+    auto iter = node_indices_.find(to);
+    if (iter == node_indices_.end()) {
+      VLOG(1) << nodes_[from].address << " sent a message to " << to
+              << ", but there is no node at that address.";
+      stats_.messages_dropped++;
+      return;
+    }
+
+    const SimulatedLink link = link_model_(nodes_[from].address, to);
+    LinkState& state = links_[std::make_pair(from, iter->second)];
+    const Time start = std::max(Clock::now(), state.idle);
+    typename Clock::duration transmission = Clock::duration::zero();
+    if (link.bytes_per_second > 0) {
+      transmission = std::chrono::duration_cast<typename Clock::duration>(
+          std::chrono::duration<double>(num_bytes / link.bytes_per_second));
+    }
+    state.idle = start + transmission;
+    const Time arrival = std::max(
+        state.idle +
+            std::chrono::duration_cast<typename Clock::duration>(link.latency),
+        state.last_arrival);
+    state.last_arrival = arrival;
+    Push(Event{arrival, next_event_id_++, iter->second, false,
+               std::move(message)});
+  }
+
+  void Push(Event event) {
+    events_.push_back(std::move(event));
+    std::push_heap(events_.begin(), events_.end(), EventAfter());
+  }
+
+  LinkModel link_model_;
+  std::vector<Node> nodes_;
+  std::unordered_map<std::string, std::size_t> node_indices_;
+  std::map<std::pair<std::size_t, std::size_t>, LinkState> links_;
+  std::vector<Event> events_;
+  std::size_t next_event_id_ = 0;
+  SimulationStats stats_;
+};
+
+}  // namespace fluent
+
+#endif  // FLUENT_SIMULATION_H_
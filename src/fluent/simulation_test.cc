@@ -0,0 +1,239 @@
+#include "fluent/simulation.h"
+
+#include <cstddef>
+
+#include <chrono>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+#include "collections/table.h"
+#include "common/mock_pickler.h"
+#include "common/status.h"
+#include "fluent/fluent_builder.h"
+#include "fluent/infix.h"
+#include "lineagedb/connection_config.h"
+#include "lineagedb/noop_client.h"
+#include "ra/logical/all.h"
+#include "testing/mock_clock.h"
+
+namespace ldb = fluent::lineagedb;
+namespace lra = fluent::ra::logical;
+
+namespace fluent {
+
+namespace {
+
+using Time = std::chrono::time_point<MockClock>;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+
+auto simfluent(Simulation<MockClock>* sim, const std::string& name,
+               const std::string& address) {
+  ldb::ConnectionConfig connection_config;
+  return fluent<ldb::NoopClient, Hash, ldb::ToSql, MockPickler, MockClock>(
+             name, address, sim->Endpoint(address), connection_config)
+      .ConsumeValueOrDie();
+}
+
+// `Send(address)` maps a tuple (_, x) to (address, x).
+auto Send(const std::string& address) {
+  return [address](const std::tuple<std::string, int>& t) {
+    return std::make_tuple(address, std::get<1>(t));
+  };
+}
+
+// `Record()` maps a tuple (_, x) to (x).
+auto Record() {
+  return [](const std::tuple<std::string, int>& t) {
+    return std::make_tuple(std::get<1>(t));
+  };
+}
+
+// The tuples in `t`.
+std::set<std::tuple<int>> Keys(const Table<int>& t) {
+  std::set<std::tuple<int>> keys;
+  for (const auto& pair : t.Get()) {
+    keys.insert(pair.first);
+  }
+  return keys;
+}
+
+}  // namespace
+
+TEST(Simulation, LatencyDelaysMessages) {
+  MockClock::Reset();
+  Simulation<MockClock> sim;
+  sim.SetLinkModel([](const std::string&, const std::string&) {
+    return SimulatedLink{milliseconds(100), 0};
+  });
+
+  auto* ping = sim.AddNode(
+      "inproc://ping",
+      simfluent(&sim, "ping", "inproc://ping")
+          .channel<std::string, int>("c", {{"addr", "x"}})
+          .table<int>("t", {{"x"}})
+          .periodic("p", seconds(1))
+          .RegisterRules([](auto& c, auto& t, auto& p) {
+            using namespace fluent::infix;
+            return std::make_tuple(
+                c <= (lra::make_collection(&p) | lra::map([](const auto&) {
+                        return std::make_tuple(std::string("inproc://pong"),
+                                               42);
+                      })),
+                t <= (lra::make_collection(&c) | lra::map(Record())));
+          })
+          .ConsumeValueOrDie());
+  auto* pong = sim.AddNode(
+      "inproc://pong",
+      simfluent(&sim, "pong", "inproc://pong")
+          .channel<std::string, int>("c", {{"addr", "x"}})
+          .table<int>("t", {{"x"}})
+          .RegisterRules([](auto& c, auto& t) {
+            using namespace fluent::infix;
+            return std::make_tuple(
+                c <= (lra::make_collection(&c) |
+                      lra::map(Send("inproc://ping"))),
+                t <= (lra::make_collection(&c) | lra::map(Record())));
+          })
+          .ConsumeValueOrDie());
+
+  // The periodic is triggered at 1s, the ping arrives at 1.1s, and the pong
+  // arrives at 1.2s.
+  const std::set<std::tuple<int>> empty = {};
+  const std::set<std::tuple<int>> pinged = {std::make_tuple(42)};
+  ASSERT_EQ(Status::OK, sim.RunUntil(Time(milliseconds(1099))));
+  EXPECT_EQ(MockClock::now(), Time(milliseconds(1099)));
+  EXPECT_EQ(Keys(pong->Get<1>()), empty);
+  ASSERT_EQ(Status::OK, sim.RunUntil(Time(milliseconds(1100))));
+  EXPECT_EQ(Keys(pong->Get<1>()), pinged);
+  EXPECT_EQ(Keys(ping->Get<1>()), empty);
+  ASSERT_EQ(Status::OK, sim.RunUntil(Time(milliseconds(1200))));
+  EXPECT_EQ(Keys(ping->Get<1>()), pinged);
+
+  // Node ping ran a round for its periodic at 1s and for the pong at 1.2s,
+  // and node pong ran a round for the ping at 1.1s.
+  EXPECT_EQ(sim.Stats().messages_sent, static_cast<std::size_t>(2));
+  EXPECT_EQ(sim.Stats().messages_delivered, static_cast<std::size_t>(2));
+  EXPECT_EQ(sim.Stats().messages_dropped, static_cast<std::size_t>(0));
+  EXPECT_EQ(sim.Stats().rounds, static_cast<std::size_t>(3));
+}
+
+TEST(Simulation, BandwidthDelaysMessages) {
+  MockClock::Reset();
+  Simulation<MockClock> sim;
+  sim.SetLinkModel([](const std::string&, const std::string&) {
+    return SimulatedLink{milliseconds(0), 1000};
+  });
+
+  std::set<std::tuple<std::string, int>> xs = {{"inproc://b", 1}};
+  sim.AddNode("inproc://a",
+              simfluent(&sim, "a", "inproc://a")
+                  .channel<std::string, int>("c", {{"addr", "x"}})
+                  .RegisterBootstrapRules([&xs](auto& c) {
+                    using namespace fluent::infix;
+                    return std::make_tuple(c <= lra::make_iterable(&xs));
+                  })
+                  .RegisterRules([](auto&) { return std::tuple<>(); })
+                  .ConsumeValueOrDie());
+  auto* b = sim.AddNode(
+      "inproc://b",
+      simfluent(&sim, "b", "inproc://b")
+          .channel<std::string, int>("c", {{"addr", "x"}})
+          .table<int>("t", {{"x"}})
+          .RegisterRules([](auto& c, auto& t) {
+            using namespace fluent::infix;
+            return std::make_tuple(
+                t <= (lra::make_collection(&c) | lra::map(Record())));
+          })
+          .ConsumeValueOrDie());
+
+  // The message is sent at time 0 and takes a millisecond per byte to arrive.
+  ASSERT_EQ(Status::OK, sim.RunUntil(Time()));
+  const std::size_t num_bytes = sim.Stats().bytes_sent;
+  ASSERT_GT(num_bytes, static_cast<std::size_t>(0));
+  const Time arrival = Time(milliseconds(num_bytes));
+
+  const std::set<std::tuple<int>> empty = {};
+  const std::set<std::tuple<int>> received = {std::make_tuple(1)};
+  ASSERT_EQ(Status::OK, sim.RunUntil(arrival - milliseconds(1)));
+  EXPECT_EQ(Keys(b->Get<1>()), empty);
+  ASSERT_EQ(Status::OK, sim.RunUntil(arrival));
+  EXPECT_EQ(Keys(b->Get<1>()), received);
+}
+
+// A thousand nodes form a binary tree, and node 0 broadcasts a value down the
+// tree. Node i forwards the value to nodes 2i + 1 and 2i + 2, whether or not
+// they exist.
+TEST(Simulation, ThousandNodeBroadcast) {
+  MockClock::Reset();
+  Simulation<MockClock> sim;
+  sim.SetLinkModel([](const std::string&, const std::string&) {
+    return SimulatedLink{milliseconds(10), 0};
+  });
+
+  const std::size_t num_nodes = 1000;
+  auto address = [](std::size_t i) {
+    return "inproc://" + std::to_string(i);
+  };
+
+  std::set<std::tuple<std::string, int>> xs = {{address(1), 7},
+                                               {address(2), 7}};
+  std::vector<const Table<int>*> tables;
+  for (std::size_t i = 0; i < num_nodes; ++i) {
+    auto fb = simfluent(&sim, "node" + std::to_string(i), address(i))
+                  .channel<std::string, int>("c", {{"addr", "x"}})
+                  .table<int>("t", {{"x"}});
+    const std::string left = address(2 * i + 1);
+    const std::string right = address(2 * i + 2);
+    auto rules = [left, right](auto& c, auto& t) {
+      using namespace fluent::infix;
+      return std::make_tuple(
+          t <= (lra::make_collection(&c) | lra::map(Record())),
+          c <= (lra::make_collection(&c) | lra::map(Send(left))),
+          c <= (lra::make_collection(&c) | lra::map(Send(right))));
+    };
+    if (i == 0) {
+      auto* node = sim.AddNode(
+          address(i),
+          std::move(fb)
+              .RegisterBootstrapRules([&xs](auto& c, auto&) {
+                using namespace fluent::infix;
+                return std::make_tuple(c <= lra::make_iterable(&xs));
+              })
+              .RegisterRules(rules)
+              .ConsumeValueOrDie());
+      tables.push_back(&node->template Get<1>());
+    } else {
+      auto* node = sim.AddNode(
+          address(i), std::move(fb).RegisterRules(rules).ConsumeValueOrDie());
+      tables.push_back(&node->template Get<1>());
+    }
+  }
+
+  // Node 999 is 9 hops from node 0.
+  ASSERT_EQ(Status::OK, sim.RunUntil(Time(milliseconds(89))));
+  EXPECT_EQ(Keys(*tables[999]).size(), static_cast<std::size_t>(0));
+  ASSERT_EQ(Status::OK, sim.RunUntil(Time(milliseconds(90))));
+  const std::set<std::tuple<int>> received = {std::make_tuple(7)};
+  for (std::size_t i = 1; i < num_nodes; ++i) {
+    EXPECT_EQ(Keys(*tables[i]), received) << "node " << i;
+  }
+
+  EXPECT_EQ(sim.Stats().messages_sent, 2 * num_nodes);
+  EXPECT_EQ(sim.Stats().messages_delivered, num_nodes - 1);
+  EXPECT_EQ(sim.Stats().messages_dropped, num_nodes + 1);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -8,9 +8,11 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "common/macros.h"
 #include "common/status.h"
+#include "common/status_macros.h"
 #include "common/status_or.h"
 #include "common/tuple_util.h"
 #include "common/type_list.h"
@@ -73,11 +75,13 @@ class MockClient {
     return Status::OK;
   }
 
+  WARN_UNUSED Status CommitSchema() { return Status::OK; }
+
   template <typename... Ts>
   WARN_UNUSED Status
   InsertTuple(const std::string& collection_name, int time_inserted,
               const std::chrono::time_point<Clock>& physical_time_inserted,
-              const std::tuple<Ts...>& t) {
+              std::size_t, const std::tuple<Ts...>& t) {
     auto strings_tuple = TupleMap(t, [](const auto& x) {
       return ToSql<typename std::decay<decltype(x)>::type>().Value(x);
     });
@@ -89,11 +93,25 @@ class MockClient {
     return Status::OK;
   }
 
+  // Records every tuple as if it were inserted by `InsertTuple`.
+  template <typename... Ts>
+  WARN_UNUSED Status InsertTuples(
+      const std::string& collection_name, int time_inserted,
+      const std::chrono::time_point<Clock>& physical_time_inserted,
+      const std::vector<std::pair<std::tuple<Ts...>, std::size_t>>& ts) {
+    for (const auto& pair : ts) {
+      RETURN_IF_ERROR(InsertTuple(collection_name, time_inserted,
+                                  physical_time_inserted, pair.second,
+                                  pair.first));
+    }
+    return Status::OK;
+  }
+
   template <typename... Ts>
   WARN_UNUSED Status
   DeleteTuple(const std::string& collection_name, int time_deleted,
               const std::chrono::time_point<Clock>& physical_time_deleted,
-              const std::tuple<Ts...>& t) {
+              std::size_t, const std::tuple<Ts...>& t) {
     auto strings_tuple = TupleMap(t, [](const auto& x) {
       return ToSql<typename std::decay<decltype(x)>::type>().Value(x);
     });
@@ -82,11 +82,11 @@ TEST(MockClient, InsertTuple) {
   ASSERT_EQ(Status::OK, client_or.status());
   std::unique_ptr<Client> client = client_or.ConsumeValueOrDie();
   ASSERT_EQ(Status::OK,
-            (client->InsertTuple("a", 0, zero_sec, std::tuple<>{})));
+            (client->InsertTuple("a", 0, zero_sec, 0, std::tuple<>{})));
   ASSERT_EQ(Status::OK,
-            (client->InsertTuple("b", 1, one_sec, std::tuple<int>{10})));
+            (client->InsertTuple("b", 1, one_sec, 1, std::tuple<int>{10})));
   ASSERT_EQ(Status::OK,
-            (client->InsertTuple("c", 2, two_sec,
+            (client->InsertTuple("c", 2, two_sec, 2,
                                  std::tuple<int, char, bool>{42, 'x', false})));
 
   using Tuple = MockClient<Hash, MockToSql, MockClock>::InsertTupleTuple;
@@ -97,6 +97,25 @@ TEST(MockClient, InsertTuple) {
             Tuple("c", 2, two_sec, {"42", "x", "false"}));
 }
 
+TEST(MockClient, InsertTuples) {
+  using Client = MockClient<Hash, MockToSql, MockClock>;
+  using time_point = std::chrono::time_point<MockClock>;
+
+  time_point zero_sec = time_point(std::chrono::seconds(0));
+
+  StatusOr<std::unique_ptr<Client>> client_or =
+      Client::Make("", 42, "", ConnectionConfig());
+  ASSERT_EQ(Status::OK, client_or.status());
+  std::unique_ptr<Client> client = client_or.ConsumeValueOrDie();
+  ASSERT_EQ(Status::OK, (client->InsertTuples<int, char>(
+                            "a", 0, zero_sec, {{{1, 'x'}, 1}, {{2, 'y'}, 2}})));
+
+  using Tuple = MockClient<Hash, MockToSql, MockClock>::InsertTupleTuple;
+  ASSERT_EQ(client->GetInsertTuple().size(), static_cast<std::size_t>(2));
+  EXPECT_EQ(client->GetInsertTuple()[0], Tuple("a", 0, zero_sec, {"1", "x"}));
+  EXPECT_EQ(client->GetInsertTuple()[1], Tuple("a", 0, zero_sec, {"2", "y"}));
+}
+
 TEST(MockClient, DeleteTuple) {
   using Client = MockClient<Hash, MockToSql, MockClock>;
   using time_point = std::chrono::time_point<MockClock>;
@@ -110,11 +129,11 @@ TEST(MockClient, DeleteTuple) {
   ASSERT_EQ(Status::OK, client_or.status());
   std::unique_ptr<Client> client = client_or.ConsumeValueOrDie();
   ASSERT_EQ(Status::OK,
-            (client->DeleteTuple("a", 0, zero_sec, std::tuple<>{})));
+            (client->DeleteTuple("a", 0, zero_sec, 0, std::tuple<>{})));
   ASSERT_EQ(Status::OK,
-            (client->DeleteTuple("b", 1, one_sec, std::tuple<int>{10})));
+            (client->DeleteTuple("b", 1, one_sec, 1, std::tuple<int>{10})));
   ASSERT_EQ(Status::OK,
-            (client->DeleteTuple("c", 2, two_sec,
+            (client->DeleteTuple("c", 2, two_sec, 2,
                                  std::tuple<int, char, bool>{42, 'x', false})));
 
   using Tuple = MockClient<Hash, MockToSql, MockClock>::DeleteTupleTuple;
@@ -5,6 +5,8 @@
 
 #include <string>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include "fmt/format.h"
 #include "glog/logging.h"
@@ -24,6 +26,54 @@
 namespace fluent {
 namespace lineagedb {
 
+namespace {
+
+// The schema queries buffered by `Make("name", 9001, "127.0.0.1", ...)`.
+const char kInitQuery[] = R"(
+    INSERT INTO Nodes (id, name, address, python_lineage_script)
+    VALUES (9001, 'name', '127.0.0.1', NULL)
+    ON CONFLICT (id) DO UPDATE
+    SET name = EXCLUDED.name, address = EXCLUDED.address;
+    DELETE FROM Collections WHERE node_id = 9001;
+    DELETE FROM Rules WHERE node_id = 9001;
+
+    CREATE TABLE IF NOT EXISTS name_lineage (
+      dep_node_id bigint NOT NULL,
+      dep_collection_name text NOT NULL,
+      dep_tuple_hash bigint NOT NULL,
+      dep_time bigint NOT NULL,
+      rule_number integer,
+      inserted boolean NOT NULL,
+      physical_time timestamp with time zone,
+      collection_name text NOT NULL,
+      tuple_hash bigint NOT NULL,
+      time integer NOT NULL
+    );
+    DO $$
+    BEGIN
+      IF ARRAY(SELECT attname::text FROM pg_attribute
+               WHERE attrelid = 'name_lineage'::regclass AND attnum > 0
+                 AND NOT attisdropped
+               ORDER BY attnum)
+         <> ARRAY['dep_node_id', 'dep_collection_name', 'dep_tuple_hash',
+                  'dep_time', 'rule_number', 'inserted', 'physical_time',
+                  'collection_name', 'tuple_hash', 'time']::text[]
+         OR ARRAY(SELECT atttypid::regtype FROM pg_attribute
+                  WHERE attrelid = 'name_lineage'::regclass AND attnum > 0
+                    AND NOT attisdropped
+                  ORDER BY attnum)
+         <> ARRAY['bigint', 'text', 'bigint', 'bigint', 'integer', 'boolean',
+                  'timestamp with time zone', 'text', 'bigint',
+                  'integer']::regtype[] THEN
+        RAISE EXCEPTION
+          'Table name_lineage already exists with a different schema.';
+      END IF;
+    END
+    $$;
+)";
+
+}  // namespace
+
 TEST(MockPqxxClient, Init) {
   using Client = MockPqxxClient<Hash, ToSql, MockClock>;
 
@@ -33,26 +83,16 @@ TEST(MockPqxxClient, Init) {
   ASSERT_EQ(Status::OK, client_or.status());
   std::unique_ptr<Client> client = client_or.ConsumeValueOrDie();
 
+  // Schema queries are buffered until they're committed.
+  EXPECT_EQ(client->Queries().size(), static_cast<std::size_t>(0));
+  ASSERT_EQ(Status::OK, client->CommitSchema());
   std::vector<std::pair<std::string, std::string>> queries = client->Queries();
-  ASSERT_EQ(queries.size(), static_cast<std::size_t>(2));
-  ExpectStringsEqualIgnoreWhiteSpace(queries[0].second, R"(
-    INSERT INTO Nodes (id, name, address, python_lineage_script)
-    VALUES (9001, 'name', '127.0.0.1', NULL);
-  )");
-  ExpectStringsEqualIgnoreWhiteSpace(queries[1].second, R"(
-    CREATE TABLE name_lineage (
-      dep_node_id          bigint                    NOT NULL,
-      dep_collection_name  text                      NOT NULL,
-      dep_tuple_hash       bigint                    NOT NULL,
-      dep_time             bigint                    NOT NULL,
-      rule_number          integer,
-      inserted             boolean                   NOT NULL,
-      physical_time        timestamp with time zone,
-      collection_name      text                      NOT NULL,
-      tuple_hash           bigint                    NOT NULL,
-      time                 integer                   NOT NULL
-    );
-  )");
+  ASSERT_EQ(queries.size(), static_cast<std::size_t>(1));
+  ExpectStringsEqualIgnoreWhiteSpace(queries[0].second, kInitQuery);
+
+  // Committing again issues nothing.
+  ASSERT_EQ(Status::OK, client->CommitSchema());
+  EXPECT_EQ(client->Queries().size(), static_cast<std::size_t>(1));
 }
 
 TEST(MockPqxxClient, AddCollection) {
@@ -64,27 +104,48 @@ TEST(MockPqxxClient, AddCollection) {
   ASSERT_EQ(Status::OK, client_or.status());
   std::unique_ptr<Client> client = client_or.ConsumeValueOrDie();
   ASSERT_EQ(Status::OK, (client->AddCollection<int, char, bool>(
-                            "t", "Table", {{"x", "c", "b"}})));
+                            "t", "Table", {{"x", "C", "b"}})));
+  ASSERT_EQ(Status::OK, client->CommitSchema());
 
   std::vector<std::pair<std::string, std::string>> queries = client->Queries();
-  ASSERT_EQ(queries.size(), static_cast<std::size_t>(4));
-  ExpectStringsEqualIgnoreWhiteSpace(queries[2].second, R"(
+  ASSERT_EQ(queries.size(), static_cast<std::size_t>(1));
+  ExpectStringsEqualIgnoreWhiteSpace(queries[0].second,
+                                     std::string(kInitQuery) + R"(
     INSERT INTO Collections (node_id, collection_name, collection_type,
                              column_names, lineage_type, python_lineage_method)
-    VALUES (9001, 't', 'Table', ARRAY['x', 'c', 'b'], 'regular', NULL);
-  )");
-  ExpectStringsEqualIgnoreWhiteSpace(queries[3].second, R"(
-    CREATE TABLE name_t (
-      hash bigint  NOT NULL,
+    VALUES (9001, 't', 'Table', ARRAY['x', 'C', 'b'], 'regular', NULL);
+
+    CREATE TABLE IF NOT EXISTS name_t (
+      hash bigint NOT NULL,
       time_inserted integer NOT NULL,
       time_deleted integer,
       physical_time_inserted timestamp with time zone NOT NULL,
       physical_time_deleted timestamp with time zone,
       x integer NOT NULL,
-      c char(1) NOT NULL,
+      C char(1) NOT NULL,
       b boolean NOT NULL,
       PRIMARY KEY (hash, time_inserted)
     );
+    DO $$
+    BEGIN
+      IF ARRAY(SELECT attname::text FROM pg_attribute
+               WHERE attrelid = 'name_t'::regclass AND attnum > 0
+                 AND NOT attisdropped
+               ORDER BY attnum)
+         <> ARRAY['hash', 'time_inserted', 'time_deleted',
+                  'physical_time_inserted', 'physical_time_deleted', 'x', 'c',
+                  'b']::text[]
+         OR ARRAY(SELECT atttypid::regtype FROM pg_attribute
+                  WHERE attrelid = 'name_t'::regclass AND attnum > 0
+                    AND NOT attisdropped
+                  ORDER BY attnum)
+         <> ARRAY['bigint', 'integer', 'integer', 'timestamp with time zone',
+                  'timestamp with time zone', 'integer', 'char(1)',
+                  'boolean']::regtype[] THEN
+        RAISE EXCEPTION 'Table name_t already exists with a different schema.';
+      END IF;
+    END
+    $$;
   )");
 }
 
@@ -97,12 +158,17 @@ TEST(MockPqxxClient, AddRule) {
   ASSERT_EQ(Status::OK, client_or.status());
   std::unique_ptr<Client> client = client_or.ConsumeValueOrDie();
   ASSERT_EQ(Status::OK, client->AddRule(0, true, "foo"));
+  ASSERT_EQ(Status::OK, client->AddRule(0, false, "bar"));
+  ASSERT_EQ(Status::OK, client->CommitSchema());
 
   std::vector<std::pair<std::string, std::string>> queries = client->Queries();
-  ASSERT_EQ(queries.size(), static_cast<std::size_t>(3));
-  ExpectStringsEqualIgnoreWhiteSpace(queries[2].second, R"(
+  ASSERT_EQ(queries.size(), static_cast<std::size_t>(1));
+  ExpectStringsEqualIgnoreWhiteSpace(queries[0].second,
+                                     std::string(kInitQuery) + R"(
     INSERT INTO Rules (node_id, rule_number, is_bootstrap, rule)
     VALUES (9001, 0, true, 'foo');
+    INSERT INTO Rules (node_id, rule_number, is_bootstrap, rule)
+    VALUES (9001, 0, false, 'bar');
   )");
 }
 
@@ -118,21 +184,130 @@ TEST(MockPqxxClient, InsertTuple) {
       Client::Make("name", 9001, "127.0.0.1", c);
   ASSERT_EQ(Status::OK, client_or.status());
   std::unique_ptr<Client> client = client_or.ConsumeValueOrDie();
-  ASSERT_EQ(
-      Status::OK,
-      client->InsertTuple("t", 42, time_point(std::chrono::seconds(43)), t));
+  const std::size_t tuple_hash = Hash<tuple_t>()(t);
+  ASSERT_EQ(Status::OK,
+            client->InsertTuple("t", 42, time_point(std::chrono::seconds(43)),
+                                tuple_hash, t));
 
   std::vector<std::pair<std::string, std::string>> queries = client->Queries();
-  std::int64_t hash = detail::size_t_to_int64(Hash<tuple_t>()(t));
+  std::int64_t hash = detail::size_t_to_int64(tuple_hash);
 
-  ASSERT_EQ(queries.size(), static_cast<std::size_t>(3));
-  ExpectStringsEqualIgnoreWhiteSpace(queries[2].second, fmt::format(R"(
+  ASSERT_EQ(queries.size(), static_cast<std::size_t>(1));
+  ExpectStringsEqualIgnoreWhiteSpace(queries[0].second, fmt::format(R"(
     INSERT INTO name_t
-    VALUES ({}, 42, NULL, epoch + 43 seconds, NULL, 1, true, a);
+    VALUES ({}, 42, NULL, epoch + 43 seconds, NULL, 1, true, a)
+    ON CONFLICT DO NOTHING;
   )",
                                                                     hash));
 }
 
+TEST(MockPqxxClient, InsertTuples) {
+  using Client = MockPqxxClient<Hash, MockToSql, MockClock>;
+  using time_point = std::chrono::time_point<MockClock>;
+  using tuple_t = std::tuple<int, bool, char>;
+
+  ConnectionConfig c;
+  tuple_t t1 = {1, true, 'a'};
+  tuple_t t2 = {2, false, 'b'};
+  const std::size_t hash1 = Hash<tuple_t>()(t1);
+  const std::size_t hash2 = Hash<tuple_t>()(t2);
+
+  StatusOr<std::unique_ptr<Client>> client_or =
+      Client::Make("name", 9001, "127.0.0.1", c);
+  ASSERT_EQ(Status::OK, client_or.status());
+  std::unique_ptr<Client> client = client_or.ConsumeValueOrDie();
+  ASSERT_EQ(Status::OK, (client->InsertTuples<int, bool, char>(
+                            "t", 42, time_point(std::chrono::seconds(43)),
+                            {{t1, hash1}, {t2, hash2}})));
+
+  std::vector<std::pair<std::string, std::string>> queries = client->Queries();
+  ASSERT_EQ(queries.size(), static_cast<std::size_t>(1));
+  ExpectStringsEqualIgnoreWhiteSpace(
+      queries[0].second, fmt::format(R"(
+    INSERT INTO name_t
+    VALUES ({}, 42, NULL, epoch + 43 seconds, NULL, 1, true, a),
+           ({}, 42, NULL, epoch + 43 seconds, NULL, 2, false, b)
+    ON CONFLICT DO NOTHING;
+  )",
+                                     detail::size_t_to_int64(hash1),
+                                     detail::size_t_to_int64(hash2)));
+}
+
+TEST(MockPqxxClient, InsertTuplesInBatches) {
+  using Client = MockPqxxClient<Hash, MockToSql, MockClock>;
+  using time_point = std::chrono::time_point<MockClock>;
+  using tuple_t = std::tuple<int>;
+
+  ConnectionConfig c;
+  std::vector<std::pair<tuple_t, std::size_t>> ts;
+  for (std::size_t i = 0; i < 2 * detail::kInsertTuplesBatchSize + 1; ++i) {
+    tuple_t t(static_cast<int>(i));
+    ts.push_back({t, Hash<tuple_t>()(t)});
+  }
+
+  StatusOr<std::unique_ptr<Client>> client_or =
+      Client::Make("name", 9001, "127.0.0.1", c);
+  ASSERT_EQ(Status::OK, client_or.status());
+  std::unique_ptr<Client> client = client_or.ConsumeValueOrDie();
+  ASSERT_EQ(Status::OK,
+            client->InsertTuples("t", 42, time_point(std::chrono::seconds(43)),
+                                 ts));
+
+  std::vector<std::pair<std::string, std::string>> queries = client->Queries();
+  ASSERT_EQ(queries.size(), static_cast<std::size_t>(3));
+  ExpectStringsEqualIgnoreWhiteSpace(
+      queries[2].second, fmt::format(R"(
+    INSERT INTO name_t
+    VALUES ({}, 42, NULL, epoch + 43 seconds, NULL, {})
+    ON CONFLICT DO NOTHING;
+  )",
+                                     detail::size_t_to_int64(ts.back().second),
+                                     ts.size() - 1));
+}
+
+// A node restarted against the same database issues the same queries as
+// before, and every one of them can be issued again: the schema setup reuses
+// what's already there, and inserting a tuple that's already there does
+// nothing.
+TEST(MockPqxxClient, RestartIsIdempotent) {
+  using Client = MockPqxxClient<Hash, MockToSql, MockClock>;
+  using time_point = std::chrono::time_point<MockClock>;
+  using tuple_t = std::tuple<int>;
+
+  ConnectionConfig c;
+  const tuple_t t = {1};
+  const std::size_t tuple_hash = Hash<tuple_t>()(t);
+  auto run = [&]() {
+    StatusOr<std::unique_ptr<Client>> client_or =
+        Client::Make("name", 9001, "127.0.0.1", c);
+    CHECK_EQ(Status::OK, client_or.status());
+    std::unique_ptr<Client> client = client_or.ConsumeValueOrDie();
+    CHECK_EQ(Status::OK, client->AddCollection<int>("t", "Table", {{"x"}}));
+    CHECK_EQ(Status::OK, client->CommitSchema());
+    CHECK_EQ(Status::OK,
+             client->InsertTuple("t", 42, time_point(std::chrono::seconds(43)),
+                                 tuple_hash, t));
+    return client->Queries();
+  };
+
+  const std::vector<std::pair<std::string, std::string>> first = run();
+  const std::vector<std::pair<std::string, std::string>> second = run();
+  EXPECT_EQ(first, second);
+  ASSERT_EQ(second.size(), static_cast<std::size_t>(2));
+
+  // The python lineage script of the node is kept.
+  EXPECT_EQ(second[0].second.find("python_lineage_script ="),
+            std::string::npos);
+  ExpectStringsEqualIgnoreWhiteSpace(
+      second[1].second,
+      fmt::format(R"(
+    INSERT INTO name_t
+    VALUES ({}, 42, NULL, epoch + 43 seconds, NULL, 1)
+    ON CONFLICT DO NOTHING;
+  )",
+                  detail::size_t_to_int64(tuple_hash)));
+}
+
 TEST(MockPqxxClient, DeleteTuple) {
   using Client = MockPqxxClient<Hash, MockToSql, MockClock>;
   using time_point = std::chrono::time_point<MockClock>;
@@ -145,15 +320,16 @@ TEST(MockPqxxClient, DeleteTuple) {
       Client::Make("name", 9001, "127.0.0.1", c);
   ASSERT_EQ(Status::OK, client_or.status());
   std::unique_ptr<Client> client = client_or.ConsumeValueOrDie();
-  ASSERT_EQ(
-      Status::OK,
-      client->DeleteTuple("t", 42, time_point(std::chrono::seconds(43)), t));
+  const std::size_t tuple_hash = Hash<tuple_t>()(t);
+  ASSERT_EQ(Status::OK,
+            client->DeleteTuple("t", 42, time_point(std::chrono::seconds(43)),
+                                tuple_hash, t));
 
   std::vector<std::pair<std::string, std::string>> queries = client->Queries();
-  std::int64_t hash = detail::size_t_to_int64(Hash<tuple_t>()(t));
+  std::int64_t hash = detail::size_t_to_int64(tuple_hash);
 
-  ASSERT_EQ(queries.size(), static_cast<std::size_t>(3));
-  ExpectStringsEqualIgnoreWhiteSpace(queries[2].second, fmt::format(R"(
+  ASSERT_EQ(queries.size(), static_cast<std::size_t>(1));
+  ExpectStringsEqualIgnoreWhiteSpace(queries[0].second, fmt::format(R"(
     UPDATE name_t
     SET time_deleted = 42, physical_time_deleted = epoch + 43 seconds
     WHERE hash = {} AND time_deleted IS NULL;
@@ -173,8 +349,8 @@ TEST(MockPqxxClient, AddNetworkedLineage) {
 
   std::vector<std::pair<std::string, std::string>> queries = client->Queries();
 
-  ASSERT_EQ(queries.size(), static_cast<std::size_t>(3));
-  ExpectStringsEqualIgnoreWhiteSpace(queries[2].second, fmt::format(R"(
+  ASSERT_EQ(queries.size(), static_cast<std::size_t>(1));
+  ExpectStringsEqualIgnoreWhiteSpace(queries[0].second, fmt::format(R"(
     INSERT INTO name_lineage (dep_node_id, dep_collection_name, dep_tuple_hash,
                               dep_time, rule_number, inserted, collection_name,
                               tuple_hash, time)
@@ -197,8 +373,8 @@ TEST(MockPqxxClient, AddDerivedLineage) {
 
   std::vector<std::pair<std::string, std::string>> queries = client->Queries();
 
-  ASSERT_EQ(queries.size(), static_cast<std::size_t>(3));
-  ExpectStringsEqualIgnoreWhiteSpace(queries[2].second, fmt::format(R"(
+  ASSERT_EQ(queries.size(), static_cast<std::size_t>(1));
+  ExpectStringsEqualIgnoreWhiteSpace(queries[0].second, fmt::format(R"(
     INSERT INTO name_lineage (dep_node_id, dep_collection_name, dep_tuple_hash,
                               dep_time, rule_number, inserted, physical_time,
                               collection_name, tuple_hash, time)
@@ -223,25 +399,25 @@ TEST(MockPqxxClient, RegisterBlackBoxLineage) {
                 "zardoz", std::vector<std::string>{"query2", "query3"}));
   std::vector<std::pair<std::string, std::string>> queries = client->Queries();
 
-  ASSERT_EQ(queries.size(), static_cast<std::size_t>(8));
-  ExpectStringsEqualIgnoreWhiteSpace(queries[2].second, R"(
+  ASSERT_EQ(queries.size(), static_cast<std::size_t>(6));
+  ExpectStringsEqualIgnoreWhiteSpace(queries[0].second, R"(
     UPDATE Collections
     SET lineage_type = 'sql'
     WHERE node_id = 9001 AND collection_name = bar;
   )");
-  ExpectStringsEqualIgnoreWhiteSpace(queries[3].second, R"(
+  ExpectStringsEqualIgnoreWhiteSpace(queries[1].second, R"(
     UPDATE Collections
     SET lineage_type = 'sql'
     WHERE node_id = 9001 AND collection_name = baz;
   )");
-  ExpectStringsEqualIgnoreWhiteSpace(queries[4].second, "query1");
-  ExpectStringsEqualIgnoreWhiteSpace(queries[5].second, R"(
+  ExpectStringsEqualIgnoreWhiteSpace(queries[2].second, "query1");
+  ExpectStringsEqualIgnoreWhiteSpace(queries[3].second, R"(
     UPDATE Collections
     SET lineage_type = 'sql'
     WHERE node_id = 9001 AND collection_name = zardoz;
   )");
-  ExpectStringsEqualIgnoreWhiteSpace(queries[6].second, "query2");
-  ExpectStringsEqualIgnoreWhiteSpace(queries[7].second, "query3");
+  ExpectStringsEqualIgnoreWhiteSpace(queries[4].second, "query2");
+  ExpectStringsEqualIgnoreWhiteSpace(queries[5].second, "query3");
 }
 
 TEST(MockPqxxClient, RegisterBlackBoxPythonLineageScript) {
@@ -258,15 +434,15 @@ TEST(MockPqxxClient, RegisterBlackBoxPythonLineageScript) {
       client->RegisterBlackBoxPythonLineageScript("beevis\nand\nbutthead"));
   std::vector<std::pair<std::string, std::string>> queries = client->Queries();
 
-  ASSERT_EQ(queries.size(), static_cast<std::size_t>(4));
-  ExpectStringsEqualIgnoreWhiteSpace(queries[2].second,
+  ASSERT_EQ(queries.size(), static_cast<std::size_t>(2));
+  ExpectStringsEqualIgnoreWhiteSpace(queries[0].second,
                                      fmt::format(R"(
     UPDATE Nodes
     SET python_lineage_script = E{}
     WHERE id = 9001;
   )",
                                                  "rick\nand\nmorty"));
-  ExpectStringsEqualIgnoreWhiteSpace(queries[3].second,
+  ExpectStringsEqualIgnoreWhiteSpace(queries[1].second,
                                      fmt::format(R"(
     UPDATE Nodes
     SET python_lineage_script = E{}
@@ -286,13 +462,13 @@ TEST(MockPqxxClient, RegisterBlackBoxPythonLineage) {
   ASSERT_EQ(Status::OK, client->RegisterBlackBoxPythonLineage("bar", "set"));
   std::vector<std::pair<std::string, std::string>> queries = client->Queries();
 
-  ASSERT_EQ(queries.size(), static_cast<std::size_t>(4));
-  ExpectStringsEqualIgnoreWhiteSpace(queries[2].second, R"(
+  ASSERT_EQ(queries.size(), static_cast<std::size_t>(2));
+  ExpectStringsEqualIgnoreWhiteSpace(queries[0].second, R"(
     UPDATE Collections
     SET lineage_type = 'python', python_lineage_method = get
     WHERE node_id = 9001 AND collection_name = foo;
   )");
-  ExpectStringsEqualIgnoreWhiteSpace(queries[3].second, R"(
+  ExpectStringsEqualIgnoreWhiteSpace(queries[1].second, R"(
     UPDATE Collections
     SET lineage_type = 'python', python_lineage_method = set
     WHERE node_id = 9001 AND collection_name = bar;
@@ -6,6 +6,8 @@
 #include <array>
 #include <chrono>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/macros.h"
 #include "common/status.h"
@@ -43,17 +45,26 @@ class NoopClient {
     return Status::OK;
   }
 
+  WARN_UNUSED Status CommitSchema() { return Status::OK; }
+
   template <typename... Ts>
   WARN_UNUSED Status InsertTuple(const std::string&, int,
                                  const std::chrono::time_point<Clock>&,
-                                 const std::tuple<Ts...>&) {
+                                 std::size_t, const std::tuple<Ts...>&) {
+    return Status::OK;
+  }
+
+  template <typename... Ts>
+  WARN_UNUSED Status InsertTuples(
+      const std::string&, int, const std::chrono::time_point<Clock>&,
+      const std::vector<std::pair<std::tuple<Ts...>, std::size_t>>&) {
     return Status::OK;
   }
 
   template <typename... Ts>
   WARN_UNUSED Status DeleteTuple(const std::string&, int,
                                  const std::chrono::time_point<Clock>&,
-                                 const std::tuple<Ts...>&) {
+                                 std::size_t, const std::tuple<Ts...>&) {
     return Status::OK;
   }
 
@@ -1,10 +1,16 @@
 #ifndef LINEAGEDB_PQXX_CLIENT_H_
 #define LINEAGEDB_PQXX_CLIENT_H_
 
+#include <cctype>
+#include <cstddef>
 #include <cstdint>
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "fmt/format.h"
 #include "glog/logging.h"
@@ -29,6 +35,61 @@ inline std::int64_t size_t_to_int64(std::size_t hash) {
   return static_cast<std::int64_t>(hash);
 }
 
+// The maximum number of rows inserted by a single query of `InsertTuples`.
+constexpr std::size_t kInsertTuplesBatchSize = 1000;
+
+struct SqlColumn {
+  std::string name;
+  std::string type;
+  bool not_null;
+};
+
+// `CreateTableQuery(table, columns, constraints)` returns a query that creates
+// the table `table` with columns `columns` and table constraints
+// `constraints` (e.g. "PRIMARY KEY (x)"), unless it already exists. If it
+// does, the query checks that its columns have the same names and types as
+// `columns`, in order, and fails if they don't.
+inline std::string CreateTableQuery(const std::string& table,
+                                    const std::vector<SqlColumn>& columns,
+                                    const std::string& constraints) {
+  std::vector<std::string> definitions;
+  std::vector<std::string> names;
+  std::vector<std::string> types;
+  for (const SqlColumn& column : columns) {
+    definitions.push_back(fmt::format("{} {}{}", column.name, column.type,
+                                      column.not_null ? " NOT NULL" : ""));
+    // Unquoted identifiers are folded to lower case.
+    std::string name = column.name;
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    names.push_back(fmt::format("'{}'", name));
+    types.push_back(fmt::format("'{}'", column.type));
+  }
+  if (!constraints.empty()) {
+    definitions.push_back(constraints);
+  }
+
+  return fmt::format(R"(
+      CREATE TABLE IF NOT EXISTS {0} (
+        {1}
+      );
+      DO $$
+      BEGIN
+        IF ARRAY(SELECT attname::text FROM pg_attribute
+                 WHERE attrelid = '{0}'::regclass AND attnum > 0
+                   AND NOT attisdropped
+                 ORDER BY attnum) <> ARRAY[{2}]::text[]
+           OR ARRAY(SELECT atttypid::regtype FROM pg_attribute
+                    WHERE attrelid = '{0}'::regclass AND attnum > 0
+                      AND NOT attisdropped
+                    ORDER BY attnum) <> ARRAY[{3}]::regtype[] THEN
+          RAISE EXCEPTION 'Table {0} already exists with a different schema.';
+        END IF;
+      END
+      $$;
+    )",
+                     table, Join(definitions), Join(names), Join(types));
+}
+
 }  // namespace detail
 
 // # Overview
@@ -75,10 +136,16 @@ inline std::int64_t size_t_to_int64(std::size_t hash) {
 //   client.AddRule(0, false, t += c.Iterable());
 //   client.AddRule(1, false, t -= (c.Iterable() | ra::filter(f)));
 //
-//   // Add and delete some tuples.
-//   client.InsertTuple("t", 0, system_clock::now(), make_tuple("hi",  42.0));
-//   client.InsertTuple("t", 1, system_clock::now(), make_tuple("bye", 14.0));
-//   client.DeleteTuple("t", 2, system_clock::now(), make_tuple("bye", 14.0));
+//   // Create the tables of the node, collections, and rules added above.
+//   client.CommitSchema();
+//
+//   // Add and delete some tuples. The hash of every tuple is passed in,
+//   // since the caller has always already computed it.
+//   auto hi = make_tuple("hi", 42.0);
+//   auto bye = make_tuple("bye", 14.0);
+//   client.InsertTuple("t", 0, system_clock::now(), Hash<...>()(hi), hi);
+//   client.InsertTuple("t", 1, system_clock::now(), Hash<...>()(bye), bye);
+//   client.DeleteTuple("t", 2, system_clock::now(), Hash<...>()(bye), bye);
 //
 // Cool! But what about those Connection and Work template arguments? And why
 // is it called InjectablePqxxClient? In short, InjectablePqxxClient is a
@@ -96,6 +163,16 @@ inline std::int64_t size_t_to_int64(std::size_t hash) {
 // schema of) the tables used to store a node's history and lineage. This class
 // issues SQL queries to create and populate those tables.
 //
+// The queries that set up a node's schema (registering the node, its
+// collections, and its rules, and creating its tables) are buffered by `Make`,
+// `AddCollection`, and `AddRule` and issued together by `CommitSchema`, in a
+// single transaction and round trip, so a node with many collections starts
+// quickly. Schema setup is idempotent, so a node can be restarted against the
+// same database: existing tables are reused if their columns match, and
+// `CommitSchema` fails if they don't. A restarted node may insert a tuple that
+// it already inserted before it restarted (e.g. while it recovers from a
+// checkpoint), so inserting a tuple that's already there does nothing.
+//
 // TODO(mwhittaker): Document these functions better.
 template <typename Connection, typename Work, template <typename> class Hash,
           template <typename> class ToSql, typename Clock>
@@ -132,76 +209,114 @@ class InjectablePqxxClient {
                     "Lineage is a reserved collection name.");
     }
 
-    RETURN_IF_ERROR(ExecuteQuery(
-        "AddCollection",
-        fmt::format(
-            R"(
+    AddSchemaQuery(fmt::format(
+        R"(
       INSERT INTO Collections (node_id, collection_name, collection_type,
                                column_names, lineage_type,
                                python_lineage_method)
       VALUES ({}, 'regular', NULL);
     )",
-            Join(SqlValues(std::make_tuple(id_, collection_name,
-                                           collection_type, column_names))))));
-
+        Join(SqlValues(std::make_tuple(id_, collection_name, collection_type,
+                                       column_names)))));
+
+    std::vector<detail::SqlColumn> columns = {
+        {"hash", "bigint", true},
+        {"time_inserted", "integer", true},
+        {"time_deleted", "integer", false},
+        {"physical_time_inserted", "timestamp with time zone", true},
+        {"physical_time_deleted", "timestamp with time zone", false},
+    };
     std::vector<std::string> types = SqlTypes<Ts...>();
-    std::vector<std::string> columns;
     for (std::size_t i = 0; i < types.size(); ++i) {
-      columns.push_back(
-          fmt::format("{} {} NOT NULL", column_names[i], types[i]));
+      columns.push_back({column_names[i], types[i], true});
     }
-    return ExecuteQuery("AddCollectionTable",
-                        fmt::format(R"(
-      CREATE TABLE {}_{} (
-        hash                   bigint                   NOT NULL,
-        time_inserted          integer                  NOT NULL,
-        time_deleted           integer,
-        physical_time_inserted timestamp with time zone NOT NULL,
-        physical_time_deleted  timestamp with time zone,
-        {},
-        PRIMARY KEY (hash, time_inserted)
-      );
-    )",
-                                    name_, collection_name, Join(columns)));
+    AddSchemaQuery(detail::CreateTableQuery(
+        fmt::format("{}_{}", name_, collection_name), columns,
+        "PRIMARY KEY (hash, time_inserted)"));
+    return Status::OK;
   }
 
   WARN_UNUSED Status AddRule(std::size_t rule_number, bool is_bootstrap,
                              const std::string& rule_string) {
-    return ExecuteQuery(
-        "AddRule",
-        fmt::format(R"(
+    AddSchemaQuery(fmt::format(R"(
       INSERT INTO Rules (node_id, rule_number, is_bootstrap, rule)
       VALUES ({});
     )",
-                    Join(SqlValues(std::make_tuple(
-                        id_, rule_number, is_bootstrap, rule_string)))));
+                               Join(SqlValues(std::make_tuple(
+                                   id_, rule_number, is_bootstrap,
+                                   rule_string)))));
+    return Status::OK;
+  }
+
+  // Issue every query buffered by `Make`, `AddCollection`, and `AddRule` in a
+  // single transaction. See the class comment above.
+  WARN_UNUSED Status CommitSchema() {
+    if (schema_.empty()) {
+      return Status::OK;
+    }
+    std::string schema;
+    schema.swap(schema_);
+    return ExecuteQuery("CommitSchema", schema);
   }
 
   template <typename... Ts>
   WARN_UNUSED Status
   InsertTuple(const std::string& collection_name, int time_inserted,
               const std::chrono::time_point<Clock>& physical_time_inserted,
-              const std::tuple<Ts...>& t) {
+              std::size_t tuple_hash, const std::tuple<Ts...>& t) {
     static_assert(sizeof...(Ts) > 0, "Collections should have >=1 column.");
-    std::int64_t hash = detail::size_t_to_int64(Hash<std::tuple<Ts...>>()(t));
+    std::int64_t hash = detail::size_t_to_int64(tuple_hash);
     return ExecuteQuery(
         "InsertTuple",
         fmt::format(R"(
       INSERT INTO {}_{}
-      VALUES ({}, {}, NULL, {}, NULL, {});
+      VALUES ({}, {}, NULL, {}, NULL, {})
+      ON CONFLICT DO NOTHING;
     )",
                     name_, collection_name, SqlValue(hash),
                     SqlValue(time_inserted), SqlValue(physical_time_inserted),
                     Join(SqlValues(t))));
   }
 
+  // Insert every tuple `t` of the `(t, hash)` pairs `ts`, like `InsertTuple`.
+  // The tuples are inserted by multi-row INSERTs of up to
+  // `detail::kInsertTuplesBatchSize` rows each, so bulk loading a collection
+  // takes a handful of queries rather than one per tuple.
+  template <typename... Ts>
+  WARN_UNUSED Status InsertTuples(
+      const std::string& collection_name, int time_inserted,
+      const std::chrono::time_point<Clock>& physical_time_inserted,
+      const std::vector<std::pair<std::tuple<Ts...>, std::size_t>>& ts) {
+    static_assert(sizeof...(Ts) > 0, "Collections should have >=1 column.");
+    const std::size_t batch_size = detail::kInsertTuplesBatchSize;
+    const std::string time = SqlValue(time_inserted);
+    const std::string physical_time = SqlValue(physical_time_inserted);
+    for (std::size_t i = 0; i < ts.size(); i += batch_size) {
+      std::vector<std::string> rows;
+      for (std::size_t j = i; j < std::min(ts.size(), i + batch_size); ++j) {
+        const std::int64_t hash = detail::size_t_to_int64(ts[j].second);
+        rows.push_back(fmt::format("({}, {}, NULL, {}, NULL, {})",
+                                   SqlValue(hash), time, physical_time,
+                                   Join(SqlValues(ts[j].first))));
+      }
+      RETURN_IF_ERROR(ExecuteQuery(
+          "InsertTuples", fmt::format(R"(
+      INSERT INTO {}_{}
+      VALUES {}
+      ON CONFLICT DO NOTHING;
+    )",
+                                      name_, collection_name, Join(rows))));
+    }
+    return Status::OK;
+  }
+
   template <typename... Ts>
   WARN_UNUSED Status
   DeleteTuple(const std::string& collection_name, int time_deleted,
               const std::chrono::time_point<Clock>& physical_time_deleted,
-              const std::tuple<Ts...>& t) {
+              std::size_t tuple_hash, const std::tuple<Ts...>&) {
     static_assert(sizeof...(Ts) > 0, "Collections should have >=1 column.");
-    std::int64_t hash = detail::size_t_to_int64(Hash<std::tuple<Ts...>>()(t));
+    std::int64_t hash = detail::size_t_to_int64(tuple_hash);
     return ExecuteQuery(
         "DeleteTuple",
         fmt::format(R"(
@@ -316,33 +431,48 @@ class InjectablePqxxClient {
         << connection_config.ToString();
   }
 
+  // Buffer the queries that register this node and create its lineage table.
+  // The collections and rules of a previous run of this node are forgotten,
+  // since `AddCollection` and `AddRule` register them again. The node's
+  // python lineage script is kept until `RegisterBlackBoxPythonLineageScript`
+  // replaces it.
+  //
   // TODO(mwhittaker): Handle hash collisions.
   WARN_UNUSED Status Init() {
-    RETURN_IF_ERROR(ExecuteQuery(
-        "Init",
-        fmt::format(R"(
+    const std::string id = SqlValue(id_);
+    AddSchemaQuery(fmt::format(
+        R"(
       INSERT INTO Nodes (id, name, address, python_lineage_script)
-      VALUES ({}, NULL);
+      VALUES ({}, NULL)
+      ON CONFLICT (id) DO UPDATE
+      SET name = EXCLUDED.name, address = EXCLUDED.address;
+      DELETE FROM Collections WHERE node_id = {};
+      DELETE FROM Rules WHERE node_id = {};
     )",
-                    Join(SqlValues(std::make_tuple(id_, name_, address_))))));
-
-    return ExecuteQuery("CreateLineageTable", fmt::format(R"(
-      CREATE TABLE {}_lineage (
-        dep_node_id          bigint                    NOT NULL,
-        dep_collection_name  text                      NOT NULL,
-        dep_tuple_hash       bigint                    NOT NULL,
-        dep_time             bigint                    NOT NULL,
-        rule_number          integer,
-        inserted             boolean                   NOT NULL,
-        physical_time        timestamp with time zone,
-        collection_name      text                      NOT NULL,
-        tuple_hash           bigint                    NOT NULL,
-        time                 integer                   NOT NULL
-      );
-    )",
-                                                          name_));
+        Join(SqlValues(std::make_tuple(id_, name_, address_))), id, id));
+
+    AddSchemaQuery(
+        detail::CreateTableQuery(fmt::format("{}_lineage", name_),
+                                 {
+                                     {"dep_node_id", "bigint", true},
+                                     {"dep_collection_name", "text", true},
+                                     {"dep_tuple_hash", "bigint", true},
+                                     {"dep_time", "bigint", true},
+                                     {"rule_number", "integer", false},
+                                     {"inserted", "boolean", true},
+                                     {"physical_time",
+                                      "timestamp with time zone", false},
+                                     {"collection_name", "text", true},
+                                     {"tuple_hash", "bigint", true},
+                                     {"time", "integer", true},
+                                 },
+                                 ""));
+    return Status::OK;
   }
 
+  // Buffer a schema query until `CommitSchema`.
+  void AddSchemaQuery(const std::string& query) { schema_ += query; }
+
   // Transactionally execute the query `query` named `name`.
   virtual WARN_UNUSED Status ExecuteQuery(const std::string& name,
                                           const std::string& query) {
@@ -398,6 +528,9 @@ class InjectablePqxxClient {
 
   // The address of the fluent program that owns this client.
   const std::string address_;
+
+  // The schema queries buffered until `CommitSchema`.
+  std::string schema_;
 };
 
 // See InjectablePqxxClient documentation above.
@@ -38,6 +38,7 @@ namespace agg {
 //   class AggregateImpl<SizetList<Is...>, TypeList<Ts...>> {
 //    public:
 //     void Update(const std::tuple<Ts...>& x) { ... }
+//     void Merge(const AggregateImpl& other) { ... }
 //     U Get() const { ... }
 //   };
 //
@@ -57,7 +58,10 @@ namespace agg {
 //
 // The aggregate implementation (e.g. SumImpl, AvgImpl) has a method Update
 // which takes in values of the column, and a method `Get` which returns the
-// final aggregate. The return type of Get is arbitrary.
+// final aggregate. The return type of Get is arbitrary. `a.Merge(b)` updates
+// `a` as if it had also been passed every value passed to `b`, which lets an
+// aggregate be computed over disjoint pieces of its input and then combined
+// (e.g. the panes of a Window; see ra/physical/window.h).
 struct Aggregate {
   virtual ~Aggregate() {}
 };
@@ -79,6 +83,7 @@ class SumImpl<SizetList<Is...>, TypeList<T, Ts...>> : public AggregateImpl {
   void Update(const std::tuple<T, Ts...>& t) {
     TupleIter(t, [this](const T& x) { sum_ += x; });
   }
+  void Merge(const SumImpl& other) { sum_ += other.sum_; }
   T Get() const { return sum_; }
 
  private:
@@ -103,6 +108,7 @@ template <std::size_t... Is, typename... Ts>
 class CountImpl<SizetList<Is...>, TypeList<Ts...>> : public AggregateImpl {
  public:
   void Update(const std::tuple<Ts...>&) { count_++; }
+  void Merge(const CountImpl& other) { count_ += other.count_; }
   std::size_t Get() const { return count_; }
 
  private:
@@ -135,6 +141,11 @@ class AvgImpl<SizetList<Is...>, TypeList<T, Ts...>> : public AggregateImpl {
     });
   }
 
+  void Merge(const AvgImpl& other) {
+    sum_ += other.sum_;
+    count_ += other.count_;
+  }
+
   double Get() const { return sum_ / count_; }
 
  private:
@@ -167,6 +178,9 @@ class UnionImpl<SizetList<Is...>, TypeList<std::set<T>, std::set<Ts>...>>
     TupleIter(t,
               [this](const std::set<T>& x) { xs_.insert(x.begin(), x.end()); });
   }
+  void Merge(const UnionImpl& other) {
+    xs_.insert(other.xs_.begin(), other.xs_.end());
+  }
   std::set<T> Get() const { return xs_; }
 
  private:
@@ -0,0 +1,419 @@
+#ifndef RA_CARDINALITY_H_
+#define RA_CARDINALITY_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/static_assert.h"
+#include "common/type_list.h"
+#include "ra/logical/all.h"
+#include "ra/logical/logical_ra.h"
+
+namespace lra = fluent::ra::logical;
+
+namespace fluent {
+namespace ra {
+
+// The estimated size of the relation computed by a logical plan.
+struct Cardinality {
+  // The estimated number of tuples in the relation.
+  double num_rows = 0;
+
+  // The estimated number of distinct values in every column of the relation.
+  // Every estimate is at most `num_rows`.
+  std::vector<double> num_distinct;
+
+  // The estimated number of tuples produced by every Cross and HashJoin in
+  // the plan, including this one. Every operator scans its children once, so
+  // the tuples produced by intermediate joins dominate the cost of a plan.
+  double cost = 0;
+};
+
+// `EstimateCardinality(ra)` estimates the size of the relation computed by the
+// logical plan `ra` using the statistics that collections keep about their
+// tuples (see collections/collection_stats.h). The estimates follow the
+// textbook System R rules [1]:
+//
+//   - |Filter(R, columns_eq<i, j>())| = |R| / max(d(R, i), d(R, j)), where
+//     d(R, i) is the number of distinct values in column i of R;
+//   - |Filter(R, f)| = |R| / 3 for any other predicate f;
+//   - |Cross(R, S)| = |R| * |S|;
+//   - |HashJoin<LeftKeys<l>, RightKeys<r>>(R, S)|
+//       = |R| * |S| / max(d(R, l), d(S, r)), and every extra key divides the
+//     result again;
+//   - |SemiJoin<LeftKeys<l>, RightKeys<r>>(R, S)|
+//       = |R| * min(1, d(S, r) / d(R, l)), assuming that the keys of the
+//     relation with fewer distinct keys are contained in the keys of the
+//     other, and every extra key multiplies the result again;
+//   - |AntiJoin(R, S)| = |R| - |SemiJoin(R, S)|;
+//   - |GroupBy<Keys<k1, ..., kn>>(R)| = min(|R|, d(R, k1) * ... * d(R, kn));
+//   - |TopK<Keys<k1, ..., kn>, o, K>(R)|
+//       = min(|R|, K * d(R, k1) * ... * d(R, kn)); and
+//   - |Window<Keys<k1, ..., kn>>(R, P)| = |GroupBy<Keys<k1, ..., kn>>(R)|,
+//     assuming that P closes one window at a time.
+//
+// The estimates are crude, but they are good enough to tell a plan that joins
+// two small relations first from a plan that joins two large relations first.
+//
+// [1]: https://people.eecs.berkeley.edu/~brewer/cs262/3-selinger79.pdf
+template <typename Ra, typename RaDecayed = typename std::decay<Ra>::type>
+Cardinality EstimateCardinality(const Ra& ra);
+
+// `EstimateCost(ra)` is `EstimateCardinality(ra).cost`.
+template <typename Ra>
+double EstimateCost(const Ra& ra) {
+  return EstimateCardinality(ra).cost;
+}
+
+namespace detail {
+
+template <typename... Ras, std::size_t... Is>
+std::vector<Cardinality> EstimateAlternatives(
+    const lra::Alternatives<Ras...>& alternatives,
+    std::index_sequence<Is...>) {
+  return {EstimateCardinality(std::get<Is>(alternatives.alternatives))...};
+}
+
+// The index of the cheapest of `cs`. Ties go to the earliest.
+inline std::size_t Cheapest(const std::vector<Cardinality>& cs) {
+  auto cheaper = [](const Cardinality& lhs, const Cardinality& rhs) {
+    return lhs.cost < rhs.cost;
+  };
+  return static_cast<std::size_t>(
+      std::min_element(cs.begin(), cs.end(), cheaper) - cs.begin());
+}
+
+}  // namespace detail
+
+// `EstimateAlternatives(alternatives)` estimates the cardinality of every
+// alternative plan in `alternatives`.
+template <typename... Ras>
+std::vector<Cardinality> EstimateAlternatives(
+    const lra::Alternatives<Ras...>& alternatives) {
+  return detail::EstimateAlternatives(alternatives,
+                                      std::index_sequence_for<Ras...>());
+}
+
+// `CheapestAlternative(alternatives)` returns the index of the alternative
+// with the smallest estimated cost. Ties go to the earliest alternative.
+template <typename... Ras>
+std::size_t CheapestAlternative(const lra::Alternatives<Ras...>& alternatives) {
+  return detail::Cheapest(EstimateAlternatives(alternatives));
+}
+
+namespace detail {
+
+// The number of columns of the logical plan `Ra`.
+template <typename Ra>
+struct NumColumns : public TypeListLen<typename Ra::column_types>::type {};
+
+// Clamp the distinct value estimates of `c` to [0, c->num_rows].
+inline void ClampNumDistinct(Cardinality* c) {
+  for (double& d : c->num_distinct) {
+    d = std::min(d, c->num_rows);
+  }
+}
+
+// The denominator for a selection or join on two columns with `lhs` and `rhs`
+// distinct values.
+inline double EqualitySelectivityDenominator(double lhs, double rhs) {
+  return std::max(1.0, std::max(lhs, rhs));
+}
+
+// The fraction of the tuples of R that a SemiJoin of R and S keeps, given the
+// numbers of distinct values `left` and `right` of a key column of R and S.
+inline double SemiJoinSelectivity(double left, double right) {
+  return left <= 0 ? 1.0 : std::min(1.0, right / left);
+}
+
+// A relation with `num_rows` rows and `num_columns` columns, each with
+// `num_rows` distinct values.
+inline Cardinality UniqueColumns(double num_rows, std::size_t num_columns) {
+  Cardinality c;
+  c.num_rows = num_rows;
+  c.num_distinct.resize(num_columns, num_rows);
+  return c;
+}
+
+// The default selectivity of a predicate we know nothing about.
+constexpr double kOpaqueFilterSelectivity = 1.0 / 3.0;
+
+template <typename Ra, typename F>
+struct FilterCardinality {
+  Cardinality operator()(Cardinality child, const F&) {
+    child.num_rows *= kOpaqueFilterSelectivity;
+    ClampNumDistinct(&child);
+    return child;
+  }
+};
+
+template <typename Ra, std::size_t I, std::size_t J>
+struct FilterCardinality<Ra, lra::ColumnsEq<I, J>> {
+  Cardinality operator()(Cardinality child, const lra::ColumnsEq<I, J>&) {
+    const double di = child.num_distinct[I];
+    const double dj = child.num_distinct[J];
+    child.num_rows /= EqualitySelectivityDenominator(di, dj);
+    child.num_distinct[I] = child.num_distinct[J] = std::min(di, dj);
+    ClampNumDistinct(&child);
+    return child;
+  }
+};
+
+}  // namespace detail
+
+template <typename LogicalRa>
+struct CardinalityImpl;
+
+template <typename C>
+struct CardinalityImpl<lra::Collection<C>> {
+  Cardinality operator()(const lra::Collection<C>& collection) {
+    // A collection only estimates its distinct values once it is asked to
+    // track them (see collections/collection_stats.h). Until then, its
+    // columns are assumed to be unique.
+    const auto& stats = collection.collection->Stats();
+    Cardinality c;
+    c.num_rows = stats.NumRows();
+    for (std::size_t i = 0; i < detail::NumColumns<lra::Collection<C>>::value;
+         ++i) {
+      c.num_distinct.push_back(stats.NumDistinct(i));
+    }
+    return c;
+  }
+};
+
+template <typename C>
+struct CardinalityImpl<lra::MetaCollection<C>> {
+  Cardinality operator()(const lra::MetaCollection<C>& meta_collection) {
+    // A tuple inserted more than once appears once per insertion, but most
+    // tuples are inserted once.
+    return detail::UniqueColumns(
+        meta_collection.collection->Stats().NumRows(), 2);
+  }
+};
+
+template <typename Container>
+struct CardinalityImpl<lra::Iterable<Container>> {
+  Cardinality operator()(const lra::Iterable<Container>& iterable) {
+    using num_columns = detail::NumColumns<lra::Iterable<Container>>;
+    return detail::UniqueColumns(iterable.container->size(),
+                                 num_columns::value);
+  }
+};
+
+template <typename Ra, typename F>
+struct CardinalityImpl<lra::Map<Ra, F>> {
+  Cardinality operator()(const lra::Map<Ra, F>& map) {
+    using num_columns = detail::NumColumns<lra::Map<Ra, F>>;
+    Cardinality child = EstimateCardinality(map.child);
+    Cardinality c = detail::UniqueColumns(child.num_rows, num_columns::value);
+    c.cost = child.cost;
+    return c;
+  }
+};
+
+template <typename Ra, typename F>
+struct CardinalityImpl<lra::Filter<Ra, F>> {
+  Cardinality operator()(const lra::Filter<Ra, F>& filter) {
+    return detail::FilterCardinality<Ra, F>()(
+        EstimateCardinality(filter.child), filter.f);
+  }
+};
+
+template <typename Ra, std::size_t... Is>
+struct CardinalityImpl<lra::Project<Ra, Is...>> {
+  Cardinality operator()(const lra::Project<Ra, Is...>& project) {
+    Cardinality child = EstimateCardinality(project.child);
+    Cardinality c;
+    c.num_rows = child.num_rows;
+    c.num_distinct = {child.num_distinct[Is]...};
+    c.cost = child.cost;
+    return c;
+  }
+};
+
+template <typename Left, typename Right>
+struct CardinalityImpl<lra::Cross<Left, Right>> {
+  Cardinality operator()(const lra::Cross<Left, Right>& cross) {
+    Cardinality left = EstimateCardinality(cross.left);
+    Cardinality right = EstimateCardinality(cross.right);
+    Cardinality c;
+    c.num_rows = left.num_rows * right.num_rows;
+    c.num_distinct = std::move(left.num_distinct);
+    c.num_distinct.insert(c.num_distinct.end(), right.num_distinct.begin(),
+                          right.num_distinct.end());
+    c.cost = left.cost + right.cost + c.num_rows;
+    return c;
+  }
+};
+
+template <typename Left, std::size_t... LeftKs,  //
+          typename Right, std::size_t... RightKs>
+struct CardinalityImpl<lra::HashJoin<Left, LeftKeys<LeftKs...>,  //
+                                     Right, RightKeys<RightKs...>>> {
+  Cardinality operator()(
+      const lra::HashJoin<Left, LeftKeys<LeftKs...>,  //
+                          Right, RightKeys<RightKs...>>& hash_join) {
+    Cardinality left = EstimateCardinality(hash_join.left);
+    Cardinality right = EstimateCardinality(hash_join.right);
+    const std::vector<double> denominators = {
+        detail::EqualitySelectivityDenominator(left.num_distinct[LeftKs],
+                                               right.num_distinct[RightKs])...};
+
+    Cardinality c;
+    c.num_rows = left.num_rows * right.num_rows;
+    for (double denominator : denominators) {
+      c.num_rows /= denominator;
+    }
+    c.num_distinct = std::move(left.num_distinct);
+    c.num_distinct.insert(c.num_distinct.end(), right.num_distinct.begin(),
+                          right.num_distinct.end());
+    detail::ClampNumDistinct(&c);
+    c.cost = left.cost + right.cost + c.num_rows;
+    return c;
+  }
+};
+
+namespace detail {
+
+// `SemiJoinCardinality<Anti>()(left, right, selectivities)` estimates the
+// cardinality of a SemiJoin (or, if `Anti` is true, an AntiJoin) of relations
+// with cardinalities `left` and `right`, where `selectivities` are the
+// `SemiJoinSelectivity` of each pair of key columns. Only the tuples produced
+// by Crosses and HashJoins contribute to the cost of a plan, so the cost is
+// the cost of the two sides.
+template <bool Anti>
+struct SemiJoinCardinality {
+  Cardinality operator()(Cardinality left, const Cardinality& right,
+                         const std::vector<double>& selectivities) {
+    double selectivity = 1.0;
+    for (double s : selectivities) {
+      selectivity *= s;
+    }
+    left.num_rows *= Anti ? 1.0 - selectivity : selectivity;
+    ClampNumDistinct(&left);
+    left.cost += right.cost;
+    return left;
+  }
+};
+
+}  // namespace detail
+
+template <typename Left, std::size_t... LeftKs,  //
+          typename Right, std::size_t... RightKs>
+struct CardinalityImpl<lra::SemiJoin<Left, LeftKeys<LeftKs...>,  //
+                                     Right, RightKeys<RightKs...>>> {
+  Cardinality operator()(
+      const lra::SemiJoin<Left, LeftKeys<LeftKs...>,  //
+                          Right, RightKeys<RightKs...>>& semi_join) {
+    Cardinality left = EstimateCardinality(semi_join.left);
+    Cardinality right = EstimateCardinality(semi_join.right);
+    const std::vector<double> selectivities = {detail::SemiJoinSelectivity(
+        left.num_distinct[LeftKs], right.num_distinct[RightKs])...};
+    return detail::SemiJoinCardinality<false>()(std::move(left), right,
+                                              selectivities);
+  }
+};
+
+template <typename Left, std::size_t... LeftKs,  //
+          typename Right, std::size_t... RightKs>
+struct CardinalityImpl<lra::AntiJoin<Left, LeftKeys<LeftKs...>,  //
+                                     Right, RightKeys<RightKs...>>> {
+  Cardinality operator()(
+      const lra::AntiJoin<Left, LeftKeys<LeftKs...>,  //
+                          Right, RightKeys<RightKs...>>& anti_join) {
+    Cardinality left = EstimateCardinality(anti_join.left);
+    Cardinality right = EstimateCardinality(anti_join.right);
+    const std::vector<double> selectivities = {detail::SemiJoinSelectivity(
+        left.num_distinct[LeftKs], right.num_distinct[RightKs])...};
+    return detail::SemiJoinCardinality<true>()(std::move(left), right,
+                                              selectivities);
+  }
+};
+
+template <typename Ra, std::size_t... Ks, typename... Aggregates>
+struct CardinalityImpl<lra::GroupBy<Ra, Keys<Ks...>, Aggregates...>> {
+  Cardinality operator()(
+      const lra::GroupBy<Ra, Keys<Ks...>, Aggregates...>& group_by) {
+    Cardinality child = EstimateCardinality(group_by.child);
+    const std::vector<double> key_num_distinct = {child.num_distinct[Ks]...};
+
+    double num_groups = child.num_rows == 0 ? 0 : 1;
+    for (double d : key_num_distinct) {
+      num_groups *= d;
+    }
+    Cardinality c = detail::UniqueColumns(
+        std::min(num_groups, child.num_rows),
+        key_num_distinct.size() + sizeof...(Aggregates));
+    std::copy(key_num_distinct.begin(), key_num_distinct.end(),
+              c.num_distinct.begin());
+    detail::ClampNumDistinct(&c);
+    c.cost = child.cost;
+    return c;
+  }
+};
+
+template <typename Ra, std::size_t... Ks, std::size_t O, std::size_t K>
+struct CardinalityImpl<lra::TopK<Ra, Keys<Ks...>, O, K>> {
+  Cardinality operator()(const lra::TopK<Ra, Keys<Ks...>, O, K>& top_k) {
+    Cardinality child = EstimateCardinality(top_k.child);
+    const std::vector<double> key_num_distinct = {child.num_distinct[Ks]...};
+
+    double num_rows = child.num_rows == 0 ? 0 : K;
+    for (double d : key_num_distinct) {
+      num_rows *= d;
+    }
+    child.num_rows = std::min(num_rows, child.num_rows);
+    detail::ClampNumDistinct(&child);
+    return child;
+  }
+};
+
+template <typename Ra, typename Trigger, std::size_t... Ks, std::size_t T,
+          typename... Aggregates>
+struct CardinalityImpl<
+    lra::Window<Ra, Trigger, Keys<Ks...>, T, Aggregates...>> {
+  Cardinality operator()(
+      const lra::Window<Ra, Trigger, Keys<Ks...>, T, Aggregates...>& window) {
+    Cardinality child = EstimateCardinality(window.child);
+    const std::vector<double> key_num_distinct = {child.num_distinct[Ks]...};
+
+    double num_groups = child.num_rows == 0 ? 0 : 1;
+    for (double d : key_num_distinct) {
+      num_groups *= d;
+    }
+    Cardinality c = detail::UniqueColumns(
+        std::min(num_groups, child.num_rows),
+        key_num_distinct.size() + 1 + sizeof...(Aggregates));
+    std::copy(key_num_distinct.begin(), key_num_distinct.end(),
+              c.num_distinct.begin());
+    c.num_distinct[key_num_distinct.size()] = c.num_rows == 0 ? 0 : 1;
+    detail::ClampNumDistinct(&c);
+    c.cost = child.cost + EstimateCardinality(window.trigger).cost;
+    return c;
+  }
+};
+
+template <typename... Ras>
+struct CardinalityImpl<lra::Alternatives<Ras...>> {
+  Cardinality operator()(const lra::Alternatives<Ras...>& alternatives) {
+    std::vector<Cardinality> cs = EstimateAlternatives(alternatives);
+    return std::move(cs[detail::Cheapest(cs)]);
+  }
+};
+
+template <typename Ra, typename RaDecayed>
+Cardinality EstimateCardinality(const Ra& ra) {
+  static_assert(
+      StaticAssert<std::is_base_of<lra::LogicalRa, RaDecayed>>::value, "");
+  return CardinalityImpl<RaDecayed>()(ra);
+}
+
+}  // namespace ra
+}  // namespace fluent
+
+#endif  // RA_CARDINALITY_H_
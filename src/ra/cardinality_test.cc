@@ -0,0 +1,197 @@
+#include "ra/cardinality.h"
+
+#include <chrono>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+#include "collections/periodic.h"
+#include "collections/table.h"
+#include "ra/keys.h"
+#include "ra/logical/all.h"
+#include "ra/logical/rewrite.h"
+
+namespace ra = fluent::ra;
+namespace lra = fluent::ra::logical;
+
+namespace fluent {
+namespace {
+
+// Fill `t` with the tuples `(i, i % num_distinct)` for `i` in [0, num_rows),
+// estimating its distinct values.
+void Fill(Table<int, int>* t, int num_rows, int num_distinct) {
+  t->TrackDistinct();
+  for (int i = 0; i < num_rows; ++i) {
+    t->Merge({i, i % num_distinct}, i, 0);
+  }
+}
+
+}  // namespace
+
+TEST(Cardinality, Collection) {
+  Table<int, int> t("t", {{"x", "y"}});
+  Fill(&t, 100, 10);
+  const ra::Cardinality c = ra::EstimateCardinality(lra::make_collection(&t));
+  EXPECT_EQ(c.num_rows, 100);
+  ASSERT_EQ(c.num_distinct.size(), 2u);
+  EXPECT_NEAR(c.num_distinct[0], 100, 5);
+  EXPECT_NEAR(c.num_distinct[1], 10, 1);
+  EXPECT_EQ(c.cost, 0);
+}
+
+TEST(Cardinality, CollectionWithoutDistinctValues) {
+  Table<int, int> t("t", {{"x", "y"}});
+  for (int i = 0; i < 100; ++i) {
+    t.Merge({i, i % 10}, i, 0);
+  }
+  const ra::Cardinality c = ra::EstimateCardinality(lra::make_collection(&t));
+  EXPECT_FALSE(t.Stats().TracksDistinct());
+  EXPECT_EQ(c.num_rows, 100);
+  EXPECT_EQ(c.num_distinct, std::vector<double>({100, 100}));
+}
+
+TEST(Cardinality, Iterable) {
+  std::set<std::tuple<int, int, int>> xs = {{1, 1, 1}, {2, 2, 2}};
+  const ra::Cardinality c = ra::EstimateCardinality(lra::make_iterable(&xs));
+  EXPECT_EQ(c.num_rows, 2);
+  EXPECT_EQ(c.num_distinct, std::vector<double>({2, 2, 2}));
+}
+
+TEST(Cardinality, Filter) {
+  Table<int, int> t("t", {{"x", "y"}});
+  Fill(&t, 90, 10);
+  auto opaque = [](const auto&) { return true; };
+  const ra::Cardinality c =
+      ra::EstimateCardinality(lra::make_collection(&t) | lra::filter(opaque));
+  EXPECT_NEAR(c.num_rows, 30, 0.01);
+  EXPECT_NEAR(c.num_distinct[1], 10, 1);
+
+  const ra::Cardinality eq = ra::EstimateCardinality(
+      lra::make_collection(&t) | lra::filter(lra::columns_eq<0, 1>()));
+  EXPECT_NEAR(eq.num_rows, 1, 0.1);
+}
+
+TEST(Cardinality, ProjectAndCross) {
+  Table<int, int> t("t", {{"x", "y"}});
+  Fill(&t, 20, 4);
+  auto cross = lra::make_cross(lra::make_collection(&t),
+                               lra::make_collection(&t) | lra::project<1>());
+  const ra::Cardinality c = ra::EstimateCardinality(cross);
+  EXPECT_EQ(c.num_rows, 400);
+  ASSERT_EQ(c.num_distinct.size(), 3u);
+  EXPECT_NEAR(c.num_distinct[2], 4, 0.5);
+  EXPECT_EQ(c.cost, 400);
+}
+
+TEST(Cardinality, HashJoin) {
+  Table<int, int> t("t", {{"x", "y"}});
+  Table<int, int> s("s", {{"x", "y"}});
+  Fill(&t, 100, 10);
+  Fill(&s, 50, 50);
+  auto join = lra::make_hash_join<ra::LeftKeys<1>, ra::RightKeys<1>>(
+      lra::make_collection(&t), lra::make_collection(&s));
+  const ra::Cardinality c = ra::EstimateCardinality(join);
+  // 100 * 50 / max(10, 50)
+  EXPECT_NEAR(c.num_rows, 100, 5);
+  EXPECT_NEAR(c.cost, 100, 5);
+}
+
+TEST(Cardinality, SemiJoinAndAntiJoin) {
+  Table<int, int> t("t", {{"x", "y"}});
+  Table<int, int> s("s", {{"x", "y"}});
+  Fill(&t, 100, 10);
+  Fill(&s, 4, 4);
+  auto semi_join = lra::make_semi_join<ra::LeftKeys<1>, ra::RightKeys<1>>(
+      lra::make_collection(&t), lra::make_collection(&s));
+  auto anti_join = lra::make_anti_join<ra::LeftKeys<1>, ra::RightKeys<1>>(
+      lra::make_collection(&t), lra::make_collection(&s));
+  const ra::Cardinality semi = ra::EstimateCardinality(semi_join);
+  const ra::Cardinality anti = ra::EstimateCardinality(anti_join);
+  // 100 * min(1, 4 / 10)
+  EXPECT_NEAR(semi.num_rows, 40, 5);
+  EXPECT_NEAR(anti.num_rows, 60, 5);
+  ASSERT_EQ(semi.num_distinct.size(), 2u);
+  EXPECT_EQ(semi.cost, 0);
+}
+
+TEST(Cardinality, GroupBy) {
+  Table<int, int> t("t", {{"x", "y"}});
+  Fill(&t, 100, 10);
+  auto group_by = lra::make_collection(&t) |
+                  lra::group_by<ra::Keys<1>, ra::agg::Count<0>>();
+  const ra::Cardinality c = ra::EstimateCardinality(group_by);
+  EXPECT_NEAR(c.num_rows, 10, 1);
+  ASSERT_EQ(c.num_distinct.size(), 2u);
+}
+
+TEST(Cardinality, TopK) {
+  Table<int, int> t("t", {{"x", "y"}});
+  Fill(&t, 100, 10);
+  auto top_k = lra::make_collection(&t) | lra::top_k<ra::Keys<1>, 0, 3>();
+  const ra::Cardinality c = ra::EstimateCardinality(top_k);
+  EXPECT_NEAR(c.num_rows, 30, 3);
+  ASSERT_EQ(c.num_distinct.size(), 2u);
+  EXPECT_NEAR(c.num_distinct[0], 30, 3);
+  EXPECT_NEAR(c.num_distinct[1], 10, 1);
+
+  // Every group has fewer than 20 tuples.
+  auto top_20 = lra::make_collection(&t) | lra::top_k<ra::Keys<1>, 0, 20>();
+  EXPECT_EQ(ra::EstimateCardinality(top_20).num_rows, 100);
+}
+
+TEST(Cardinality, Window) {
+  using Clock = std::chrono::system_clock;
+  using Time = std::chrono::time_point<Clock>;
+  Table<int, Time> t("t", {{"x", "time"}});
+  t.TrackDistinct();
+  for (int i = 0; i < 100; ++i) {
+    t.Merge({i % 10, Time(std::chrono::seconds(i))}, i, 0);
+  }
+  Periodic<Clock> p("p", std::chrono::seconds(1));
+  auto window = lra::make_collection(&t) |
+                lra::tumbling_window<ra::Keys<0>, 1, ra::agg::Count<0>>(
+                    lra::make_collection(&p), std::chrono::seconds(10));
+  const ra::Cardinality c = ra::EstimateCardinality(window);
+  EXPECT_NEAR(c.num_rows, 10, 1);
+  ASSERT_EQ(c.num_distinct.size(), 3u);
+  EXPECT_NEAR(c.num_distinct[0], 10, 1);
+  EXPECT_EQ(c.num_distinct[1], 1);
+  EXPECT_NEAR(c.num_distinct[2], 10, 1);
+}
+
+TEST(Cardinality, CheapestJoinOrder) {
+  // a has a lot of tuples that join with b and few that join with c, so
+  // joining a with c first is cheaper.
+  Table<int, int> a("a", {{"x", "y"}});
+  Table<int, int> b("b", {{"x", "y"}});
+  Table<int, int> c("c", {{"x", "y"}});
+  Fill(&a, 1000, 1);
+  Fill(&b, 1000, 1);
+  Fill(&c, 10, 10);
+  auto ab = lra::make_hash_join<ra::LeftKeys<1>, ra::RightKeys<1>>(
+      lra::make_collection(&a), lra::make_collection(&b));
+  auto abc = lra::make_hash_join<ra::LeftKeys<0>, ra::RightKeys<0>>(
+      ab, lra::make_collection(&c));
+  const auto alternatives = lra::Rewrite(abc);
+  EXPECT_EQ(ra::CheapestAlternative(alternatives), 1u);
+
+  // With a tiny b, the original order is cheapest.
+  Table<int, int> tiny("tiny", {{"x", "y"}});
+  Fill(&tiny, 1, 1);
+  auto tiny_abc = lra::make_hash_join<ra::LeftKeys<0>, ra::RightKeys<0>>(
+      lra::make_hash_join<ra::LeftKeys<0>, ra::RightKeys<0>>(
+          lra::make_collection(&a), lra::make_collection(&tiny)),
+      lra::make_collection(&a));
+  EXPECT_EQ(ra::CheapestAlternative(lra::Rewrite(tiny_abc)), 0u);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,113 @@
+#ifndef RA_COMPILED_PLAN_H_
+#define RA_COMPILED_PLAN_H_
+
+#include <cstddef>
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "common/arena.h"
+#include "common/macros.h"
+#include "common/status.h"
+#include "ra/cardinality.h"
+#include "ra/logical/alternatives.h"
+#include "ra/logical_to_physical.h"
+
+namespace fluent {
+namespace ra {
+
+// A CompiledPlan is a logical plan that has been converted into a physical
+// plan once so that it can be run over and over again (e.g. once every tick)
+// without rebuilding its physical operators, copying its lambdas, or
+// reallocating the buffers of its HashJoins and GroupBys.
+//
+//   Arena arena;
+//   CompiledPlan<decltype(logical)> plan(logical, &arena);
+//   while (true) {
+//     Status status = plan.Run([](auto* physical) {
+//       for (const auto& t : physical->ToRange()) { ... }
+//       return Status::OK;
+//     });
+//     arena.Reset();
+//   }
+//
+// `Run(f)` calls `f(&physical)` and then resets `physical`, releasing the
+// tuples it buffered back to the arena (see `PhysicalRa`). A CompiledPlan
+// must not outlive its arena or the collections its logical plan reads.
+template <typename Logical>
+class CompiledPlan {
+  using physical_type = decltype(LogicalToPhysical(
+      std::declval<const Logical&>(), std::declval<Arena*>()));
+
+ public:
+  CompiledPlan(const Logical& logical, Arena* arena)
+      : physical_(LogicalToPhysical(logical, arena)) {}
+  DISALLOW_COPY_AND_ASSIGN(CompiledPlan);
+  DEFAULT_MOVE_AND_ASSIGN(CompiledPlan);
+
+  template <typename F>
+  WARN_UNUSED Status Run(F& f) {
+    Status status = f(&physical_);
+    physical_.Reset();
+    return status;
+  }
+
+ private:
+  physical_type physical_;
+};
+
+// Every alternative of an Alternatives is compiled, and `Run` runs the
+// alternative with the smallest estimated cost given the current contents of
+// the collections. See ra/cardinality.h.
+template <typename... Logicals>
+class CompiledPlan<lra::Alternatives<Logicals...>> {
+  using alternatives_type = lra::Alternatives<Logicals...>;
+  using plans_type = std::tuple<CompiledPlan<Logicals>...>;
+
+ public:
+  CompiledPlan(const alternatives_type& alternatives, Arena* arena)
+      : alternatives_(alternatives),
+        plans_(Compile(alternatives, arena,
+                       std::index_sequence_for<Logicals...>())) {}
+  DISALLOW_COPY_AND_ASSIGN(CompiledPlan);
+  DEFAULT_MOVE_AND_ASSIGN(CompiledPlan);
+
+  template <typename F>
+  WARN_UNUSED Status Run(F& f) {
+    return RunAlternative<0>(CheapestAlternative(alternatives_), f);
+  }
+
+ private:
+  template <std::size_t... Is>
+  static plans_type Compile(const alternatives_type& alternatives,
+                            Arena* arena, std::index_sequence<Is...>) {
+    return plans_type(CompiledPlan<Logicals>(
+        std::get<Is>(alternatives.alternatives), arena)...);
+  }
+
+  // Run the `i`th alternative.
+  template <std::size_t I, typename F>
+  typename std::enable_if<I == sizeof...(Logicals), Status>::type
+  RunAlternative(std::size_t, F&) {
+    return Status::OK;
+  }
+
+  template <std::size_t I, typename F>
+  typename std::enable_if<I != sizeof...(Logicals), Status>::type
+  RunAlternative(std::size_t i, F& f) {
+    if (I == i) {
+      return std::get<I>(plans_).Run(f);
+    }
+    return RunAlternative<I + 1>(i, f);
+  }
+
+  // The logical alternatives are kept to estimate their costs.
+  alternatives_type alternatives_;
+  plans_type plans_;
+};
+
+}  // namespace ra
+}  // namespace fluent
+
+#endif  // RA_COMPILED_PLAN_H_
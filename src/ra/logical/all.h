@@ -1,6 +1,8 @@
 #ifndef RA_LOGICAL_ALL_H_
 #define RA_LOGICAL_ALL_H_
 
+#include "ra/logical/alternatives.h"
+#include "ra/logical/anti_join.h"
 #include "ra/logical/collection.h"
 #include "ra/logical/cross.h"
 #include "ra/logical/filter.h"
@@ -9,6 +11,10 @@
 #include "ra/logical/iterable.h"
 #include "ra/logical/map.h"
 #include "ra/logical/meta_collection.h"
+#include "ra/logical/predicates.h"
 #include "ra/logical/project.h"
+#include "ra/logical/semi_join.h"
+#include "ra/logical/top_k.h"
+#include "ra/logical/window.h"
 
 #endif  // RA_LOGICAL_ALL_H_
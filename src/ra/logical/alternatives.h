@@ -0,0 +1,49 @@
+#ifndef RA_LOGICAL_ALTERNATIVES_H_
+#define RA_LOGICAL_ALTERNATIVES_H_
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "common/static_assert.h"
+#include "common/type_traits.h"
+#include "ra/logical/logical_ra.h"
+
+namespace fluent {
+namespace ra {
+namespace logical {
+
+// An Alternatives<Ra, Ras...> is a set of logical plans that all compute the
+// same relation with the same columns (e.g. the same three-way join evaluated
+// in two different orders). Alternatives are produced by `Rewrite` (see
+// ra/logical/rewrite.h), and an executor evaluates exactly one of them: the
+// one with the smallest estimated cost (see ra/cardinality.h).
+template <typename Ra, typename... Ras>
+struct Alternatives : public LogicalRa {
+  static_assert(StaticAssert<std::is_base_of<LogicalRa, Ra>>::value, "");
+  static_assert(
+      StaticAssert<All<std::is_base_of<LogicalRa, Ras>...>>::value, "");
+  static_assert(StaticAssert<All<std::is_same<
+                    typename Ra::column_types,
+                    typename Ras::column_types>...>>::value,
+                "");
+
+  using column_types = typename Ra::column_types;
+  explicit Alternatives(std::tuple<Ra, Ras...> alternatives_)
+      : alternatives(std::move(alternatives_)) {}
+  std::tuple<Ra, Ras...> alternatives;
+};
+
+template <typename Ra, typename... Ras,
+          typename RaDecayed = typename std::decay<Ra>::type>
+Alternatives<RaDecayed, typename std::decay<Ras>::type...> make_alternatives(
+    Ra&& ra, Ras&&... ras) {
+  return Alternatives<RaDecayed, typename std::decay<Ras>::type...>(
+      std::make_tuple(std::forward<Ra>(ra), std::forward<Ras>(ras)...));
+}
+
+}  // namespace logical
+}  // namespace ra
+}  // namespace fluent
+
+#endif  // RA_LOGICAL_ALTERNATIVES_H_
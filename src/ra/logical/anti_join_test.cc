@@ -0,0 +1,40 @@
+#include "ra/logical/anti_join.h"
+
+#include <set>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+#include "ra/logical/iterable.h"
+
+namespace ra = fluent::ra;
+namespace lra = fluent::ra::logical;
+
+namespace fluent {
+
+TEST(AntiJoin, SimpleCompileCheck) {
+  std::set<std::tuple<int, std::string>> xs;
+  std::set<std::tuple<int>> ys;
+  auto ixs = lra::make_iterable(&xs);
+  auto iys = lra::make_iterable(&ys);
+  using leftks = ra::LeftKeys<0>;
+  using rightks = ra::RightKeys<0>;
+  using type = lra::AntiJoin<decltype(ixs), leftks,  //
+                             decltype(iys), rightks>;
+  type anti_join = lra::make_anti_join<leftks, rightks>(ixs, iys);
+
+  using actual = decltype(anti_join)::column_types;
+  using expected = TypeList<int, std::string>;
+  static_assert(StaticAssert<std::is_same<actual, expected>>::value, "");
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
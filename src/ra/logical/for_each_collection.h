@@ -0,0 +1,143 @@
+#ifndef RA_LOGICAL_FOR_EACH_COLLECTION_H_
+#define RA_LOGICAL_FOR_EACH_COLLECTION_H_
+
+#include <cstddef>
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "common/static_assert.h"
+#include "common/tuple_util.h"
+#include "ra/logical/all.h"
+
+namespace fluent {
+namespace ra {
+namespace logical {
+
+// `ForEachCollection(ra, f)` calls `f(c)` with the `const C*` of every
+// `Collection<C>` leaf of the logical plan `ra`, from left to right. A
+// collection that appears in more than one leaf is passed to `f` once per
+// leaf. MetaCollections and Iterables are skipped.
+//
+//   Table<int> t("t", {{"x"}});
+//   Scratch<int> s("s", {{"x"}});
+//   auto plan = make_cross(make_collection(&t), make_collection(&s));
+//   ForEachCollection(plan, [](const auto* c) { LOG(INFO) << c->Name(); });
+//   // logs "t", then "s"
+template <typename Ra, typename F,
+          typename RaDecayed = typename std::decay<Ra>::type>
+void ForEachCollection(const Ra& ra, F&& f);
+
+template <typename LogicalRa>
+struct ForEachCollectionImpl;
+
+template <typename C>
+struct ForEachCollectionImpl<Collection<C>> {
+  template <typename F>
+  void operator()(const Collection<C>& collection, F&& f) {
+    f(collection.collection);
+  }
+};
+
+template <typename C>
+struct ForEachCollectionImpl<MetaCollection<C>> {
+  template <typename F>
+  void operator()(const MetaCollection<C>&, F&&) {}
+};
+
+template <typename Container>
+struct ForEachCollectionImpl<Iterable<Container>> {
+  template <typename F>
+  void operator()(const Iterable<Container>&, F&&) {}
+};
+
+// The operators with a single child.
+template <typename Op>
+struct ForEachCollectionUnary {
+  template <typename F>
+  void operator()(const Op& op, F&& f) {
+    ForEachCollection(op.child, f);
+  }
+};
+
+template <typename Ra, typename F>
+struct ForEachCollectionImpl<Map<Ra, F>>
+    : public ForEachCollectionUnary<Map<Ra, F>> {};
+
+template <typename Ra, typename F>
+struct ForEachCollectionImpl<Filter<Ra, F>>
+    : public ForEachCollectionUnary<Filter<Ra, F>> {};
+
+template <typename Ra, std::size_t... Is>
+struct ForEachCollectionImpl<Project<Ra, Is...>>
+    : public ForEachCollectionUnary<Project<Ra, Is...>> {};
+
+template <typename Ra, typename Keys, typename... Aggregates>
+struct ForEachCollectionImpl<GroupBy<Ra, Keys, Aggregates...>>
+    : public ForEachCollectionUnary<GroupBy<Ra, Keys, Aggregates...>> {};
+
+template <typename Ra, typename Keys, std::size_t O, std::size_t K>
+struct ForEachCollectionImpl<TopK<Ra, Keys, O, K>>
+    : public ForEachCollectionUnary<TopK<Ra, Keys, O, K>> {};
+
+// The operators with a left and a right child.
+template <typename Op>
+struct ForEachCollectionBinary {
+  template <typename F>
+  void operator()(const Op& op, F&& f) {
+    ForEachCollection(op.left, f);
+    ForEachCollection(op.right, f);
+  }
+};
+
+template <typename Left, typename Right>
+struct ForEachCollectionImpl<Cross<Left, Right>>
+    : public ForEachCollectionBinary<Cross<Left, Right>> {};
+
+template <typename Left, typename LeftKs, typename Right, typename RightKs>
+struct ForEachCollectionImpl<HashJoin<Left, LeftKs, Right, RightKs>>
+    : public ForEachCollectionBinary<HashJoin<Left, LeftKs, Right, RightKs>> {
+};
+
+template <typename Left, typename LeftKs, typename Right, typename RightKs>
+struct ForEachCollectionImpl<SemiJoin<Left, LeftKs, Right, RightKs>>
+    : public ForEachCollectionBinary<SemiJoin<Left, LeftKs, Right, RightKs>> {
+};
+
+template <typename Left, typename LeftKs, typename Right, typename RightKs>
+struct ForEachCollectionImpl<AntiJoin<Left, LeftKs, Right, RightKs>>
+    : public ForEachCollectionBinary<AntiJoin<Left, LeftKs, Right, RightKs>> {
+};
+
+template <typename Ra, typename Trigger, typename Keys, std::size_t T,
+          typename... Aggregates>
+struct ForEachCollectionImpl<Window<Ra, Trigger, Keys, T, Aggregates...>> {
+  template <typename F>
+  void operator()(const Window<Ra, Trigger, Keys, T, Aggregates...>& window,
+                  F&& f) {
+    ForEachCollection(window.child, f);
+    ForEachCollection(window.trigger, f);
+  }
+};
+
+template <typename... Ras>
+struct ForEachCollectionImpl<Alternatives<Ras...>> {
+  template <typename F>
+  void operator()(const Alternatives<Ras...>& alternatives, F&& f) {
+    TupleIter(alternatives.alternatives,
+              [&f](const auto& ra) { ForEachCollection(ra, f); });
+  }
+};
+
+template <typename Ra, typename F, typename RaDecayed>
+void ForEachCollection(const Ra& ra, F&& f) {
+  static_assert(StaticAssert<std::is_base_of<LogicalRa, RaDecayed>>::value, "");
+  ForEachCollectionImpl<RaDecayed>()(ra, std::forward<F>(f));
+}
+
+}  // namespace logical
+}  // namespace ra
+}  // namespace fluent
+
+#endif  // RA_LOGICAL_FOR_EACH_COLLECTION_H_
@@ -0,0 +1,105 @@
+#include "ra/logical/for_each_collection.h"
+
+#include <chrono>
+#include <cstddef>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+#include "collections/scratch.h"
+#include "collections/table.h"
+#include "ra/aggregates.h"
+#include "ra/keys.h"
+#include "ra/logical/all.h"
+
+namespace lra = fluent::ra::logical;
+
+namespace fluent {
+namespace {
+
+// The names of the collections of `ra`, in the order ForEachCollection visits
+// them.
+template <typename Ra>
+std::vector<std::string> Names(const Ra& ra) {
+  std::vector<std::string> names;
+  lra::ForEachCollection(
+      ra, [&names](const auto* c) { names.push_back(c->Name()); });
+  return names;
+}
+
+}  // namespace
+
+TEST(ForEachCollection, Leaves) {
+  Table<int> t("t", {{"x"}});
+  std::set<std::tuple<int>> xs;
+  EXPECT_EQ(Names(lra::make_collection(&t)), std::vector<std::string>{"t"});
+  EXPECT_EQ(Names(lra::make_meta_collection(&t)), std::vector<std::string>{});
+  EXPECT_EQ(Names(lra::make_iterable(&xs)), std::vector<std::string>{});
+}
+
+TEST(ForEachCollection, UnaryOperators) {
+  Table<int, int> t("t", {{"x", "y"}});
+  const auto c = lra::make_collection(&t);
+  const std::vector<std::string> expected = {"t"};
+  EXPECT_EQ(Names(c | lra::map([](const auto& x) { return x; })), expected);
+  EXPECT_EQ(Names(c | lra::filter([](const auto&) { return true; })),
+            expected);
+  EXPECT_EQ(Names(c | lra::project<1>()), expected);
+  EXPECT_EQ(Names(c | lra::group_by<ra::Keys<0>, ra::agg::Count<1>>()),
+            expected);
+  EXPECT_EQ(Names(c | lra::top_k<ra::Keys<0>, 1, 2>()), expected);
+}
+
+TEST(ForEachCollection, BinaryOperators) {
+  Table<int, bool> t("t", {{"x", "y"}});
+  Scratch<bool, int> s("s", {{"x", "y"}});
+  const auto ct = lra::make_collection(&t);
+  const auto cs = lra::make_collection(&s);
+  using left_keys = ra::LeftKeys<0>;
+  using right_keys = ra::RightKeys<1>;
+  const std::vector<std::string> expected = {"t", "s"};
+  EXPECT_EQ(Names(lra::make_cross(ct, cs)), expected);
+  EXPECT_EQ(Names(lra::make_hash_join<left_keys, right_keys>(ct, cs)),
+            expected);
+  EXPECT_EQ(Names(lra::make_semi_join<left_keys, right_keys>(ct, cs)),
+            expected);
+  EXPECT_EQ(Names(lra::make_anti_join<left_keys, right_keys>(ct, cs)),
+            expected);
+  EXPECT_EQ(Names(lra::make_cross(ct, ct)),
+            (std::vector<std::string>{"t", "t"}));
+}
+
+TEST(ForEachCollection, Window) {
+  using Time = std::chrono::time_point<std::chrono::system_clock>;
+  Table<int, Time> t("t", {{"x", "time"}});
+  Table<std::size_t, Time> p("p", {{"id", "time"}});
+  const auto window =
+      lra::make_collection(&t) |
+      lra::sliding_window<ra::Keys<0>, 1, ra::agg::Count<0>>(
+          lra::make_collection(&p), std::chrono::seconds(2),
+          std::chrono::seconds(1));
+  EXPECT_EQ(Names(window), (std::vector<std::string>{"t", "p"}));
+}
+
+TEST(ForEachCollection, Alternatives) {
+  Table<int> t("t", {{"x"}});
+  Table<int> u("u", {{"x"}});
+  const auto alternatives = lra::make_alternatives(
+      lra::make_cross(lra::make_collection(&t), lra::make_collection(&u)),
+      lra::make_cross(lra::make_collection(&u), lra::make_collection(&t)) |
+          lra::project<1, 0>());
+  EXPECT_EQ(Names(alternatives),
+            (std::vector<std::string>{"t", "u", "u", "t"}));
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,146 @@
+#ifndef RA_LOGICAL_PREDICATES_H_
+#define RA_LOGICAL_PREDICATES_H_
+
+#include <cstddef>
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "common/sizet_list.h"
+#include "common/type_traits.h"
+
+namespace fluent {
+namespace ra {
+namespace logical {
+
+// A Filter can be passed any predicate, but an arbitrary lambda is opaque: we
+// can't tell which columns it reads, so we can't push it below a Cross or
+// HashJoin or turn it into a join key (see ra/logical/rewrite.h). A typed
+// predicate is a predicate that records the columns it reads in its type.
+//
+//   // Keep the tuples whose 0th and 2nd columns are equal.
+//   make_collection(&t) | filter(columns_eq<0, 2>())
+//
+//   // Keep the tuples whose 1st column is positive.
+//   make_collection(&t) | filter(make_column_predicate<1>(
+//     [](int x) { return x > 0; }))
+
+// `ColumnsEq<I, J>()(t)` is `std::get<I>(t) == std::get<J>(t)`.
+template <std::size_t I, std::size_t J>
+struct ColumnsEq {
+  template <typename Tuple>
+  bool operator()(const Tuple& t) const {
+    return std::get<I>(t) == std::get<J>(t);
+  }
+};
+
+template <std::size_t I, std::size_t J>
+ColumnsEq<I, J> columns_eq() {
+  return {};
+}
+
+// `ColumnPredicate<SizetList<Is...>, F>{f}(t)` is `f(std::get<Is>(t)...)`.
+template <typename Columns, typename F>
+struct ColumnPredicate;
+
+template <std::size_t... Is, typename F>
+struct ColumnPredicate<SizetList<Is...>, F> {
+  template <typename Tuple>
+  bool operator()(const Tuple& t) const {
+    return f(std::get<Is>(t)...);
+  }
+
+  F f;
+};
+
+template <std::size_t... Is, typename F,
+          typename FDecayed = typename std::decay<F>::type>
+ColumnPredicate<SizetList<Is...>, FDecayed> make_column_predicate(F&& f) {
+  return {std::forward<F>(f)};
+}
+
+// IsTypedPredicate
+template <typename P>
+struct IsTypedPredicate : public std::false_type {};
+
+template <std::size_t I, std::size_t J>
+struct IsTypedPredicate<ColumnsEq<I, J>> : public std::true_type {};
+
+template <typename Columns, typename F>
+struct IsTypedPredicate<ColumnPredicate<Columns, F>> : public std::true_type {
+};
+
+// PredicateColumns<P>::type is the SizetList of columns read by the typed
+// predicate P.
+template <typename P>
+struct PredicateColumns;
+
+template <std::size_t I, std::size_t J>
+struct PredicateColumns<ColumnsEq<I, J>> {
+  using type = SizetList<I, J>;
+};
+
+template <typename Columns, typename F>
+struct PredicateColumns<ColumnPredicate<Columns, F>> {
+  using type = Columns;
+};
+
+// `PredicateColumnsInRange<P, Low, High>` is true if every column read by P
+// is in the range [Low, High).
+template <typename P, std::size_t Low, std::size_t High,
+          typename Columns = typename PredicateColumns<P>::type>
+struct PredicateColumnsInRange;
+
+template <typename P, std::size_t Low, std::size_t High, std::size_t... Is>
+struct PredicateColumnsInRange<P, Low, High, SizetList<Is...>>
+    : public All<InRange<Is, Low, High>...> {};
+
+// `ShiftPredicate<P, N>::type` is the typed predicate P with every column
+// shifted down by N. It is used to move a predicate over the columns of a
+// join into a predicate over the columns of the join's right child.
+template <typename P, std::size_t N>
+struct ShiftPredicate;
+
+template <std::size_t I, std::size_t J, std::size_t N>
+struct ShiftPredicate<ColumnsEq<I, J>, N> {
+  using type = ColumnsEq<I - N, J - N>;
+  static type Shift(const ColumnsEq<I, J>&) { return {}; }
+};
+
+template <std::size_t... Is, typename F, std::size_t N>
+struct ShiftPredicate<ColumnPredicate<SizetList<Is...>, F>, N> {
+  using type = ColumnPredicate<SizetList<(Is - N)...>, F>;
+  static type Shift(const ColumnPredicate<SizetList<Is...>, F>& p) {
+    return {p.f};
+  }
+};
+
+// `RemapPredicate<P, SizetList<Ms...>>::type` is the typed predicate P with
+// every column `i` replaced by the `i`th element of `Ms`. It is used to move a
+// predicate over the columns of a Project into a predicate over the columns of
+// the Project's child.
+template <typename P, typename Mapping>
+struct RemapPredicate;
+
+template <std::size_t I, std::size_t J, typename Mapping>
+struct RemapPredicate<ColumnsEq<I, J>, Mapping> {
+  using type = ColumnsEq<SizetListGet<Mapping, I>::value,
+                         SizetListGet<Mapping, J>::value>;
+  static type Remap(const ColumnsEq<I, J>&) { return {}; }
+};
+
+template <std::size_t... Is, typename F, typename Mapping>
+struct RemapPredicate<ColumnPredicate<SizetList<Is...>, F>, Mapping> {
+  using type =
+      ColumnPredicate<SizetList<SizetListGet<Mapping, Is>::value...>, F>;
+  static type Remap(const ColumnPredicate<SizetList<Is...>, F>& p) {
+    return {p.f};
+  }
+};
+
+}  // namespace logical
+}  // namespace ra
+}  // namespace fluent
+
+#endif  // RA_LOGICAL_PREDICATES_H_
@@ -0,0 +1,82 @@
+#include "ra/logical/predicates.h"
+
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+#include "common/sizet_list.h"
+#include "common/static_assert.h"
+
+namespace lra = fluent::ra::logical;
+
+namespace fluent {
+
+TEST(Predicates, ColumnsEq) {
+  const auto p = lra::columns_eq<0, 2>();
+  EXPECT_TRUE(p(std::make_tuple(1, 'a', 1)));
+  EXPECT_FALSE(p(std::make_tuple(1, 'a', 2)));
+}
+
+TEST(Predicates, ColumnPredicate) {
+  auto p = lra::make_column_predicate<1, 0>(
+      [](const std::string& s, int x) { return s.size() == std::size_t(x); });
+  EXPECT_TRUE(p(std::make_tuple(2, std::string("ab"))));
+  EXPECT_FALSE(p(std::make_tuple(3, std::string("ab"))));
+}
+
+TEST(Predicates, PredicateColumns) {
+  auto f = [](int) { return true; };
+  using eq = lra::ColumnsEq<3, 1>;
+  using p = lra::ColumnPredicate<SizetList<2, 4>, decltype(f)>;
+
+  static_assert(lra::IsTypedPredicate<eq>::value, "");
+  static_assert(lra::IsTypedPredicate<p>::value, "");
+  static_assert(!lra::IsTypedPredicate<decltype(f)>::value, "");
+
+  using eq_columns = lra::PredicateColumns<eq>::type;
+  using p_columns = lra::PredicateColumns<p>::type;
+  static_assert(
+      StaticAssert<std::is_same<eq_columns, SizetList<3, 1>>>::value, "");
+  static_assert(StaticAssert<std::is_same<p_columns, SizetList<2, 4>>>::value,
+                "");
+
+  static_assert(lra::PredicateColumnsInRange<eq, 1, 4>::value, "");
+  static_assert(!lra::PredicateColumnsInRange<eq, 2, 4>::value, "");
+  static_assert(lra::PredicateColumnsInRange<p, 2, 5>::value, "");
+  static_assert(!lra::PredicateColumnsInRange<p, 0, 4>::value, "");
+}
+
+TEST(Predicates, ShiftPredicate) {
+  using shifted = lra::ShiftPredicate<lra::ColumnsEq<3, 5>, 2>::type;
+  static_assert(
+      StaticAssert<std::is_same<shifted, lra::ColumnsEq<1, 3>>>::value, "");
+
+  auto p = lra::make_column_predicate<2, 3>(
+      [](int x, int y) { return x < y; });
+  const auto q = lra::ShiftPredicate<decltype(p), 2>::Shift(p);
+  EXPECT_TRUE(q(std::make_tuple(1, 2)));
+  EXPECT_FALSE(q(std::make_tuple(2, 1)));
+}
+
+TEST(Predicates, RemapPredicate) {
+  using mapping = SizetList<4, 0, 2>;
+  using remapped = lra::RemapPredicate<lra::ColumnsEq<0, 2>, mapping>::type;
+  static_assert(
+      StaticAssert<std::is_same<remapped, lra::ColumnsEq<4, 2>>>::value, "");
+
+  auto p = lra::make_column_predicate<1>([](int x) { return x == 7; });
+  const auto q = lra::RemapPredicate<decltype(p), mapping>::Remap(p);
+  EXPECT_TRUE(q(std::make_tuple(7, 0, 0)));
+  EXPECT_FALSE(q(std::make_tuple(0, 7, 0)));
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,596 @@
+#ifndef RA_LOGICAL_REWRITE_H_
+#define RA_LOGICAL_REWRITE_H_
+
+#include <cstddef>
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "common/sizet_list.h"
+#include "common/static_assert.h"
+#include "common/type_list.h"
+#include "common/type_traits.h"
+#include "ra/keys.h"
+#include "ra/logical/all.h"
+#include "ra/logical/logical_ra.h"
+
+namespace fluent {
+namespace ra {
+namespace logical {
+
+// `Rewrite(ra)` rewrites the logical plan `ra` into an equivalent plan that is
+// usually cheaper to evaluate. Rules are evaluated exactly in the order the
+// user wrote them, so a rule like
+//
+//   make_collection(&a)
+//     | cross(make_collection(&b))
+//     | filter(columns_eq<0, 2>())
+//
+// would otherwise compute the full cross product of `a` and `b` before
+// filtering it. Rewrite applies the following rewrites:
+//
+//   1. Typed predicates (see ra/logical/predicates.h) are pushed below Filters,
+//      Projects, Crosses, HashJoins, SemiJoins, and AntiJoins as far as they
+//      go. A predicate that only reads the columns of one side of a Cross or
+//      HashJoin is pushed into that side. The columns of a SemiJoin or
+//      AntiJoin are the columns of its left side, so a predicate is always
+//      pushed into the left side. Opaque predicates (e.g. lambdas) are left
+//      where they are.
+//   2. A `columns_eq<i, j>` predicate that compares a column of the left side
+//      of a Cross with a column of the same type on the right side turns the
+//      Cross into a HashJoin on those columns. On a HashJoin, it adds a key.
+//   3. A three-way join `(A join B) join C` is paired with an alternative join
+//      order: `(A join C) join B` if C is only joined with A, or
+//      `A join (B join C)` if C is only joined with B. The two plans are
+//      returned as an Alternatives, and the plan with the smallest estimated
+//      cost is picked when the rule is executed (see ra/cardinality.h).
+//
+// The rewritten plan has the same columns as `ra`.
+template <typename Ra>
+auto Rewrite(const Ra& ra);
+
+namespace detail {
+
+// `PushFilter<Ra, P>::Push(ra, p)` is equivalent to `make_filter(ra, p)`, with
+// the typed predicate `p` pushed as far into `ra` as possible.
+template <typename Ra, typename P>
+struct PushFilter {
+  using type = Filter<Ra, P>;
+  static type Push(Ra ra, P p) { return type(std::move(ra), std::move(p)); }
+};
+
+// Filters commute, so we push `p` past an existing filter.
+template <typename Ra, typename F, typename P>
+struct PushFilter<Filter<Ra, F>, P> {
+  using child_push = PushFilter<Ra, P>;
+  using type = Filter<typename child_push::type, F>;
+  static type Push(Filter<Ra, F> filter, P p) {
+    return type(child_push::Push(std::move(filter.child), std::move(p)),
+                std::move(filter.f));
+  }
+};
+
+// Filtering column `i` of a Project is filtering column `Is[i]` of its child.
+template <typename Ra, std::size_t... Is, typename P>
+struct PushFilter<Project<Ra, Is...>, P> {
+  using remap = RemapPredicate<P, SizetList<Is...>>;
+  using child_push = PushFilter<Ra, typename remap::type>;
+  using type = Project<typename child_push::type, Is...>;
+  static type Push(Project<Ra, Is...> project, P p) {
+    return type(child_push::Push(std::move(project.child), remap::Remap(p)));
+  }
+};
+
+// The columns of a Cross or HashJoin that a typed predicate reads.
+enum class PredicateSide {
+  LEFT,      // Only columns of the left child.
+  RIGHT,     // Only columns of the right child.
+  JOIN_KEY,  // A ColumnsEq of a left and a right column of the same type.
+  BOTH,      // Anything else.
+};
+
+// `JoinKey<P, LeftTypes, RightTypes>` is true if P is a ColumnsEq that can be
+// used as a join key between children with columns `LeftTypes` and
+// `RightTypes`. If it is, `left` and `right` are the indexes of the compared
+// columns in the left and right child.
+template <typename P, typename LeftTypes, typename RightTypes,
+          typename Enable = void>
+struct JoinKey : public std::false_type {};
+
+template <std::size_t I, std::size_t J, typename LeftTypes,
+          typename RightTypes>
+struct JoinKey<ColumnsEq<I, J>, LeftTypes, RightTypes,
+               typename std::enable_if<
+                   (std::min(I, J) < TypeListLen<LeftTypes>::value) &&
+                   (std::max(I, J) >= TypeListLen<LeftTypes>::value) &&
+                   (std::max(I, J) < TypeListLen<LeftTypes>::value +
+                                         TypeListLen<RightTypes>::value)>::type>
+    : public std::is_same<
+          typename TypeListGet<LeftTypes, std::min(I, J)>::type,
+          typename TypeListGet<RightTypes, std::max(I, J) -
+                                               TypeListLen<LeftTypes>::value>::
+              type> {
+  static constexpr std::size_t left = std::min(I, J);
+  static constexpr std::size_t right =
+      std::max(I, J) - TypeListLen<LeftTypes>::value;
+};
+
+template <typename P, typename LeftTypes, typename RightTypes>
+struct PredicateSideOf
+    : public std::integral_constant<
+          PredicateSide,
+          PredicateColumnsInRange<P, 0, TypeListLen<LeftTypes>::value>::value
+              ? PredicateSide::LEFT
+              : PredicateColumnsInRange<
+                    P, TypeListLen<LeftTypes>::value,
+                    TypeListLen<LeftTypes>::value +
+                        TypeListLen<RightTypes>::value>::value
+                    ? PredicateSide::RIGHT
+                    : JoinKey<P, LeftTypes, RightTypes>::value
+                          ? PredicateSide::JOIN_KEY
+                          : PredicateSide::BOTH> {};
+
+// Cross
+template <typename Left, typename Right, typename P,
+          PredicateSide Side = PredicateSideOf<P, typename Left::column_types,
+                                               typename Right::column_types>::
+              value>
+struct PushFilterCross {
+  using type = Filter<Cross<Left, Right>, P>;
+  static type Push(Cross<Left, Right> cross, P p) {
+    return type(std::move(cross), std::move(p));
+  }
+};
+
+template <typename Left, typename Right, typename P>
+struct PushFilterCross<Left, Right, P, PredicateSide::LEFT> {
+  using left_push = PushFilter<Left, P>;
+  using type = Cross<typename left_push::type, Right>;
+  static type Push(Cross<Left, Right> cross, P p) {
+    return type(left_push::Push(std::move(cross.left), std::move(p)),
+                std::move(cross.right));
+  }
+};
+
+template <typename Left, typename Right, typename P>
+struct PushFilterCross<Left, Right, P, PredicateSide::RIGHT> {
+  using shift = ShiftPredicate<
+      P, TypeListLen<typename Left::column_types>::value>;
+  using right_push = PushFilter<Right, typename shift::type>;
+  using type = Cross<Left, typename right_push::type>;
+  static type Push(Cross<Left, Right> cross, P p) {
+    return type(std::move(cross.left),
+                right_push::Push(std::move(cross.right), shift::Shift(p)));
+  }
+};
+
+template <typename Left, typename Right, typename P>
+struct PushFilterCross<Left, Right, P, PredicateSide::JOIN_KEY> {
+  using key = JoinKey<P, typename Left::column_types,
+                      typename Right::column_types>;
+  using type =
+      HashJoin<Left, LeftKeys<key::left>, Right, RightKeys<key::right>>;
+  static type Push(Cross<Left, Right> cross, P) {
+    return type(std::move(cross.left), std::move(cross.right));
+  }
+};
+
+template <typename Left, typename Right, typename P>
+struct PushFilter<Cross<Left, Right>, P>
+    : public PushFilterCross<Left, Right, P> {};
+
+// HashJoin
+template <typename Left, typename LeftKs, typename Right, typename RightKs,
+          typename P,
+          PredicateSide Side = PredicateSideOf<P, typename Left::column_types,
+                                               typename Right::column_types>::
+              value>
+struct PushFilterHashJoin {
+  using join_type = HashJoin<Left, LeftKs, Right, RightKs>;
+  using type = Filter<join_type, P>;
+  static type Push(join_type join, P p) {
+    return type(std::move(join), std::move(p));
+  }
+};
+
+template <typename Left, typename LeftKs, typename Right, typename RightKs,
+          typename P>
+struct PushFilterHashJoin<Left, LeftKs, Right, RightKs, P,
+                          PredicateSide::LEFT> {
+  using join_type = HashJoin<Left, LeftKs, Right, RightKs>;
+  using left_push = PushFilter<Left, P>;
+  using type = HashJoin<typename left_push::type, LeftKs, Right, RightKs>;
+  static type Push(join_type join, P p) {
+    return type(left_push::Push(std::move(join.left), std::move(p)),
+                std::move(join.right));
+  }
+};
+
+template <typename Left, typename LeftKs, typename Right, typename RightKs,
+          typename P>
+struct PushFilterHashJoin<Left, LeftKs, Right, RightKs, P,
+                          PredicateSide::RIGHT> {
+  using join_type = HashJoin<Left, LeftKs, Right, RightKs>;
+  using shift = ShiftPredicate<
+      P, TypeListLen<typename Left::column_types>::value>;
+  using right_push = PushFilter<Right, typename shift::type>;
+  using type = HashJoin<Left, LeftKs, typename right_push::type, RightKs>;
+  static type Push(join_type join, P p) {
+    return type(std::move(join.left),
+                right_push::Push(std::move(join.right), shift::Shift(p)));
+  }
+};
+
+template <typename Left, std::size_t... LeftKs, typename Right,
+          std::size_t... RightKs, typename P>
+struct PushFilterHashJoin<Left, LeftKeys<LeftKs...>, Right,
+                          RightKeys<RightKs...>, P, PredicateSide::JOIN_KEY> {
+  using join_type =
+      HashJoin<Left, LeftKeys<LeftKs...>, Right, RightKeys<RightKs...>>;
+  using key = JoinKey<P, typename Left::column_types,
+                      typename Right::column_types>;
+  using type = HashJoin<Left, LeftKeys<LeftKs..., key::left>, Right,
+                        RightKeys<RightKs..., key::right>>;
+  static type Push(join_type join, P) {
+    return type(std::move(join.left), std::move(join.right));
+  }
+};
+
+template <typename Left, typename LeftKs, typename Right, typename RightKs,
+          typename P>
+struct PushFilter<HashJoin<Left, LeftKs, Right, RightKs>, P>
+    : public PushFilterHashJoin<Left, LeftKs, Right, RightKs, P> {};
+
+// SemiJoin and AntiJoin
+template <template <typename, typename, typename, typename> class Join,
+          typename Left, typename LeftKs, typename Right, typename RightKs,
+          typename P>
+struct PushFilterLeftJoin {
+  using left_push = PushFilter<Left, P>;
+  using type = Join<typename left_push::type, LeftKs, Right, RightKs>;
+  static type Push(Join<Left, LeftKs, Right, RightKs> join, P p) {
+    return type(left_push::Push(std::move(join.left), std::move(p)),
+                std::move(join.right));
+  }
+};
+
+template <typename Left, typename LeftKs, typename Right, typename RightKs,
+          typename P>
+struct PushFilter<SemiJoin<Left, LeftKs, Right, RightKs>, P>
+    : public PushFilterLeftJoin<SemiJoin, Left, LeftKs, Right, RightKs, P> {};
+
+template <typename Left, typename LeftKs, typename Right, typename RightKs,
+          typename P>
+struct PushFilter<AntiJoin<Left, LeftKs, Right, RightKs>, P>
+    : public PushFilterLeftJoin<AntiJoin, Left, LeftKs, Right, RightKs, P> {};
+
+// `PushDown<Ra>::Apply(ra)` pushes every typed predicate in `ra` down as far
+// as it goes. See rewrites 1 and 2 above.
+template <typename Ra>
+struct PushDown {
+  using type = Ra;
+  static type Apply(const Ra& ra) { return ra; }
+};
+
+template <typename Ra, typename F>
+struct PushDown<Map<Ra, F>> {
+  using type = Map<typename PushDown<Ra>::type, F>;
+  static type Apply(const Map<Ra, F>& map) {
+    return type(PushDown<Ra>::Apply(map.child), map.f);
+  }
+};
+
+template <typename Ra, typename F,
+          bool IsTyped = IsTypedPredicate<F>::value>
+struct PushDownFilter {
+  using type = Filter<typename PushDown<Ra>::type, F>;
+  static type Apply(const Filter<Ra, F>& filter) {
+    return type(PushDown<Ra>::Apply(filter.child), filter.f);
+  }
+};
+
+template <typename Ra, typename F>
+struct PushDownFilter<Ra, F, true> {
+  using child_push = PushFilter<typename PushDown<Ra>::type, F>;
+  using type = typename child_push::type;
+  static type Apply(const Filter<Ra, F>& filter) {
+    return child_push::Push(PushDown<Ra>::Apply(filter.child), filter.f);
+  }
+};
+
+template <typename Ra, typename F>
+struct PushDown<Filter<Ra, F>> : public PushDownFilter<Ra, F> {};
+
+template <typename Ra, std::size_t... Is>
+struct PushDown<Project<Ra, Is...>> {
+  using type = Project<typename PushDown<Ra>::type, Is...>;
+  static type Apply(const Project<Ra, Is...>& project) {
+    return type(PushDown<Ra>::Apply(project.child));
+  }
+};
+
+template <typename Left, typename Right>
+struct PushDown<Cross<Left, Right>> {
+  using type =
+      Cross<typename PushDown<Left>::type, typename PushDown<Right>::type>;
+  static type Apply(const Cross<Left, Right>& cross) {
+    return type(PushDown<Left>::Apply(cross.left),
+                PushDown<Right>::Apply(cross.right));
+  }
+};
+
+template <typename Left, typename LeftKs, typename Right, typename RightKs>
+struct PushDown<HashJoin<Left, LeftKs, Right, RightKs>> {
+  using type = HashJoin<typename PushDown<Left>::type, LeftKs,
+                        typename PushDown<Right>::type, RightKs>;
+  static type Apply(const HashJoin<Left, LeftKs, Right, RightKs>& join) {
+    return type(PushDown<Left>::Apply(join.left),
+                PushDown<Right>::Apply(join.right));
+  }
+};
+
+template <template <typename, typename, typename, typename> class Join,
+          typename Left, typename LeftKs, typename Right, typename RightKs>
+struct PushDownBinaryJoin {
+  using type = Join<typename PushDown<Left>::type, LeftKs,
+                    typename PushDown<Right>::type, RightKs>;
+  static type Apply(const Join<Left, LeftKs, Right, RightKs>& join) {
+    return type(PushDown<Left>::Apply(join.left),
+                PushDown<Right>::Apply(join.right));
+  }
+};
+
+template <typename Left, typename LeftKs, typename Right, typename RightKs>
+struct PushDown<SemiJoin<Left, LeftKs, Right, RightKs>>
+    : public PushDownBinaryJoin<SemiJoin, Left, LeftKs, Right, RightKs> {};
+
+template <typename Left, typename LeftKs, typename Right, typename RightKs>
+struct PushDown<AntiJoin<Left, LeftKs, Right, RightKs>>
+    : public PushDownBinaryJoin<AntiJoin, Left, LeftKs, Right, RightKs> {};
+
+template <typename Ra, typename Keys, typename... Aggregates>
+struct PushDown<GroupBy<Ra, Keys, Aggregates...>> {
+  using type = GroupBy<typename PushDown<Ra>::type, Keys, Aggregates...>;
+  static type Apply(const GroupBy<Ra, Keys, Aggregates...>& group_by) {
+    return type(PushDown<Ra>::Apply(group_by.child));
+  }
+};
+
+// A TopK keeps or drops a tuple depending on the other tuples of its group,
+// so predicates aren't pushed past it.
+template <typename Ra, typename Keys, std::size_t O, std::size_t K>
+struct PushDown<TopK<Ra, Keys, O, K>> {
+  using type = TopK<typename PushDown<Ra>::type, Keys, O, K>;
+  static type Apply(const TopK<Ra, Keys, O, K>& top_k) {
+    return type(PushDown<Ra>::Apply(top_k.child));
+  }
+};
+
+// A Window aggregates its events over time, so predicates aren't pushed past
+// it either.
+template <typename Ra, typename Trigger, typename Keys, std::size_t T,
+          typename... Aggregates>
+struct PushDown<Window<Ra, Trigger, Keys, T, Aggregates...>> {
+  using type = Window<typename PushDown<Ra>::type,
+                      typename PushDown<Trigger>::type, Keys, T, Aggregates...>;
+  static type Apply(const Window<Ra, Trigger, Keys, T, Aggregates...>& w) {
+    return type(PushDown<Ra>::Apply(w.child),
+                PushDown<Trigger>::Apply(w.trigger), w.size, w.slide);
+  }
+};
+
+// `JoinOrders<Ra>::Apply(ra)` returns a tuple of plans equivalent to `ra`,
+// the first of which is `ra` itself. See rewrite 3 above. Only the topmost
+// join of a plan (below any unary operators) is reordered.
+template <typename Ra>
+struct JoinOrders {
+  using type = std::tuple<Ra>;
+  static type Apply(const Ra& ra) { return type(ra); }
+};
+
+// `WithChild<Op>::Make(op, child)` is the unary operator `op` with its child
+// replaced by `child`.
+template <typename Op>
+struct WithChild;
+
+template <typename Ra, typename F>
+struct WithChild<Map<Ra, F>> {
+  template <typename Child>
+  static Map<Child, F> Make(const Map<Ra, F>& map, Child child) {
+    return Map<Child, F>(std::move(child), map.f);
+  }
+};
+
+template <typename Ra, typename F>
+struct WithChild<Filter<Ra, F>> {
+  template <typename Child>
+  static Filter<Child, F> Make(const Filter<Ra, F>& filter, Child child) {
+    return Filter<Child, F>(std::move(child), filter.f);
+  }
+};
+
+template <typename Ra, std::size_t... Is>
+struct WithChild<Project<Ra, Is...>> {
+  template <typename Child>
+  static Project<Child, Is...> Make(const Project<Ra, Is...>&, Child child) {
+    return Project<Child, Is...>(std::move(child));
+  }
+};
+
+template <typename Ra, typename Keys, typename... Aggregates>
+struct WithChild<GroupBy<Ra, Keys, Aggregates...>> {
+  template <typename Child>
+  static GroupBy<Child, Keys, Aggregates...> Make(
+      const GroupBy<Ra, Keys, Aggregates...>&, Child child) {
+    return GroupBy<Child, Keys, Aggregates...>(std::move(child));
+  }
+};
+
+template <typename Ra, typename Keys, std::size_t O, std::size_t K>
+struct WithChild<TopK<Ra, Keys, O, K>> {
+  template <typename Child>
+  static TopK<Child, Keys, O, K> Make(const TopK<Ra, Keys, O, K>&,
+                                      Child child) {
+    return TopK<Child, Keys, O, K>(std::move(child));
+  }
+};
+
+// The join orders of a unary operator are the join orders of its child.
+template <typename Op, typename Ra>
+struct UnaryJoinOrders {
+  template <typename ChildOrders, std::size_t... Is>
+  static auto Apply(const Op& op, ChildOrders child_orders,
+                    std::index_sequence<Is...>) {
+    return std::make_tuple(WithChild<Op>::Make(
+        op, std::get<Is>(std::move(child_orders)))...);
+  }
+
+  static auto Apply(const Op& op) {
+    using child_orders = typename JoinOrders<Ra>::type;
+    return Apply(op, JoinOrders<Ra>::Apply(op.child),
+                 std::make_index_sequence<
+                     std::tuple_size<child_orders>::value>());
+  }
+
+  using type = decltype(Apply(std::declval<const Op&>()));
+};
+
+template <typename Ra, typename F>
+struct JoinOrders<Map<Ra, F>> : public UnaryJoinOrders<Map<Ra, F>, Ra> {};
+
+template <typename Ra, typename F>
+struct JoinOrders<Filter<Ra, F>> : public UnaryJoinOrders<Filter<Ra, F>, Ra> {
+};
+
+template <typename Ra, std::size_t... Is>
+struct JoinOrders<Project<Ra, Is...>>
+    : public UnaryJoinOrders<Project<Ra, Is...>, Ra> {};
+
+template <typename Ra, typename Keys, typename... Aggregates>
+struct JoinOrders<GroupBy<Ra, Keys, Aggregates...>>
+    : public UnaryJoinOrders<GroupBy<Ra, Keys, Aggregates...>, Ra> {};
+
+template <typename Ra, typename Keys, std::size_t O, std::size_t K>
+struct JoinOrders<TopK<Ra, Keys, O, K>>
+    : public UnaryJoinOrders<TopK<Ra, Keys, O, K>, Ra> {};
+
+// Consider the join `(A join B) join C`, where A, B, and C have `NumA`, `NumB`,
+// and `NumC` columns. If the outer join's left keys are all columns of A, then
+// C can be joined with A first:
+//
+//   Project<A, B, C>((A join C) join B)
+//
+// If the outer join's left keys are all columns of B, then C can be joined
+// with B first:
+//
+//   A join (B join C)
+enum class ThreeWayJoinOrder { JOIN_A_AND_C, JOIN_B_AND_C, NONE };
+
+template <typename A, std::size_t... LeftKs1, typename B,
+          std::size_t... RightKs1, std::size_t... LeftKs2, typename C,
+          std::size_t... RightKs2>
+struct JoinOrders<
+    HashJoin<HashJoin<A, LeftKeys<LeftKs1...>, B, RightKeys<RightKs1...>>,
+             LeftKeys<LeftKs2...>, C, RightKeys<RightKs2...>>> {
+  using ab_type =
+      HashJoin<A, LeftKeys<LeftKs1...>, B, RightKeys<RightKs1...>>;
+  using join_type =
+      HashJoin<ab_type, LeftKeys<LeftKs2...>, C, RightKeys<RightKs2...>>;
+  static constexpr std::size_t num_a =
+      TypeListLen<typename A::column_types>::value;
+  static constexpr std::size_t num_b =
+      TypeListLen<typename B::column_types>::value;
+  static constexpr std::size_t num_c =
+      TypeListLen<typename C::column_types>::value;
+
+  static constexpr ThreeWayJoinOrder order =
+      All<InRange<LeftKs2, 0, num_a>...>::value
+          ? ThreeWayJoinOrder::JOIN_A_AND_C
+          : All<InRange<LeftKs2, num_a, num_a + num_b>...>::value
+                ? ThreeWayJoinOrder::JOIN_B_AND_C
+                : ThreeWayJoinOrder::NONE;
+
+  // The columns of (A join C) join B are A, C, B.
+  using ac_b_columns = typename SizetListConcat<
+      typename SizetListRange<0, num_a>::type,
+      typename SizetListRange<num_a + num_c, num_a + num_c + num_b>::type,
+      typename SizetListRange<num_a, num_a + num_c>::type>::type;
+
+  template <std::size_t... Is>
+  static auto JoinAAndC(const join_type& join, SizetList<Is...>) {
+    auto ac = make_hash_join<LeftKeys<LeftKs2...>, RightKeys<RightKs2...>>(
+        join.left.left, join.right);
+    auto ac_b = make_hash_join<LeftKeys<LeftKs1...>, RightKeys<RightKs1...>>(
+        std::move(ac), join.left.right);
+    return make_project<Is...>(std::move(ac_b));
+  }
+
+  static auto JoinBAndC(const join_type& join) {
+    auto bc = make_hash_join<LeftKeys<(LeftKs2 - num_a)...>,
+                             RightKeys<RightKs2...>>(join.left.right,
+                                                     join.right);
+    return make_hash_join<LeftKeys<LeftKs1...>, RightKeys<RightKs1...>>(
+        join.left.left, std::move(bc));
+  }
+
+  static auto Apply(const join_type& join,
+                    std::integral_constant<ThreeWayJoinOrder,
+                                           ThreeWayJoinOrder::JOIN_A_AND_C>) {
+    return std::make_tuple(join, JoinAAndC(join, ac_b_columns()));
+  }
+
+  static auto Apply(const join_type& join,
+                    std::integral_constant<ThreeWayJoinOrder,
+                                           ThreeWayJoinOrder::JOIN_B_AND_C>) {
+    return std::make_tuple(join, JoinBAndC(join));
+  }
+
+  static auto Apply(
+      const join_type& join,
+      std::integral_constant<ThreeWayJoinOrder, ThreeWayJoinOrder::NONE>) {
+    return std::make_tuple(join);
+  }
+
+  static auto Apply(const join_type& join) {
+    return Apply(join,
+                 std::integral_constant<ThreeWayJoinOrder, order>());
+  }
+
+  using type = decltype(Apply(std::declval<const join_type&>()));
+};
+
+// `MakeAlternatives(t)` is the only element of `t` if `t` has one element and
+// an Alternatives of the elements of `t` otherwise.
+template <typename Ra>
+Ra MakeAlternatives(std::tuple<Ra> t) {
+  return std::get<0>(std::move(t));
+}
+
+template <typename Ra1, typename Ra2, typename... Ras>
+Alternatives<Ra1, Ra2, Ras...> MakeAlternatives(
+    std::tuple<Ra1, Ra2, Ras...> t) {
+  return Alternatives<Ra1, Ra2, Ras...>(std::move(t));
+}
+
+}  // namespace detail
+
+template <typename Ra>
+auto Rewrite(const Ra& ra) {
+  static_assert(StaticAssert<std::is_base_of<LogicalRa, Ra>>::value, "");
+  using pushed_type = typename detail::PushDown<Ra>::type;
+  return detail::MakeAlternatives(
+      detail::JoinOrders<pushed_type>::Apply(detail::PushDown<Ra>::Apply(ra)));
+}
+
+// `Rewritten<Ra>::type` is the type of `Rewrite(ra)`.
+template <typename Ra>
+struct Rewritten {
+  using type = decltype(Rewrite(std::declval<const Ra&>()));
+};
+
+}  // namespace logical
+}  // namespace ra
+}  // namespace fluent
+
+#endif  // RA_LOGICAL_REWRITE_H_
@@ -0,0 +1,212 @@
+#include "ra/logical/rewrite.h"
+
+#include <chrono>
+#include <cstddef>
+#include <set>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+#include "common/static_assert.h"
+#include "ra/keys.h"
+#include "ra/logical/all.h"
+#include "ra/logical/to_debug_string.h"
+
+namespace ra = fluent::ra;
+namespace lra = fluent::ra::logical;
+
+namespace fluent {
+namespace {
+
+template <typename Actual, typename Expected>
+void ExpectSameType() {
+  static_assert(StaticAssert<std::is_same<Actual, Expected>>::value, "");
+}
+
+using ints = std::set<std::tuple<int, int>>;
+using iterable = lra::Iterable<ints>;
+
+}  // namespace
+
+TEST(Rewrite, LeavesOpaqueFiltersAlone) {
+  ints xs;
+  auto f = [](const auto&) { return true; };
+  auto plan =
+      lra::make_cross(lra::make_iterable(&xs), lra::make_iterable(&xs)) |
+      lra::filter(f);
+  auto rewritten = lra::Rewrite(plan);
+  ExpectSameType<decltype(rewritten), decltype(plan)>();
+}
+
+TEST(Rewrite, PushFilterIntoCross) {
+  ints xs;
+  auto plan =
+      lra::make_cross(lra::make_iterable(&xs), lra::make_iterable(&xs)) |
+      lra::filter(lra::columns_eq<0, 1>()) |
+      lra::filter(lra::columns_eq<3, 2>());
+  auto rewritten = lra::Rewrite(plan);
+  using left = lra::Filter<iterable, lra::ColumnsEq<0, 1>>;
+  using right = lra::Filter<iterable, lra::ColumnsEq<1, 0>>;
+  ExpectSameType<decltype(rewritten), lra::Cross<left, right>>();
+  EXPECT_EQ(lra::ToDebugString(rewritten),
+            "Cross(Filter(Iterable), Filter(Iterable))");
+}
+
+TEST(Rewrite, CrossToHashJoin) {
+  ints xs;
+  auto plan =
+      lra::make_cross(lra::make_iterable(&xs), lra::make_iterable(&xs)) |
+      lra::filter(lra::columns_eq<3, 0>()) |
+      lra::filter(lra::columns_eq<1, 2>());
+  auto rewritten = lra::Rewrite(plan);
+  using expected = lra::HashJoin<iterable, ra::LeftKeys<0, 1>,  //
+                                 iterable, ra::RightKeys<1, 0>>;
+  ExpectSameType<decltype(rewritten), expected>();
+}
+
+TEST(Rewrite, CrossToHashJoinRequiresSameTypes) {
+  std::set<std::tuple<int>> xs;
+  std::set<std::tuple<long>> ys;
+  auto plan =
+      lra::make_cross(lra::make_iterable(&xs), lra::make_iterable(&ys)) |
+      lra::filter(lra::columns_eq<0, 1>());
+  auto rewritten = lra::Rewrite(plan);
+  ExpectSameType<decltype(rewritten), decltype(plan)>();
+}
+
+TEST(Rewrite, PushFilterThroughProjectAndOpaqueFilter) {
+  ints xs;
+  auto f = [](const auto&) { return true; };
+  auto plan =
+      lra::make_cross(lra::make_iterable(&xs), lra::make_iterable(&xs)) |
+      lra::project<3, 0>() | lra::filter(f) |
+      lra::filter(lra::make_column_predicate<0>([](int x) { return x > 0; }));
+  auto rewritten = lra::Rewrite(plan);
+  EXPECT_EQ(lra::ToDebugString(rewritten),
+            "Filter(Project<3, 0>(Cross(Iterable, Filter(Iterable))))");
+}
+
+TEST(Rewrite, PushFilterIntoLeftOfSemiJoinAndAntiJoin) {
+  ints xs;
+  auto semi = lra::make_semi_join<ra::LeftKeys<0>, ra::RightKeys<0>>(
+      lra::make_iterable(&xs),
+      lra::make_cross(lra::make_iterable(&xs), lra::make_iterable(&xs)) |
+          lra::filter(lra::columns_eq<0, 2>()));
+  auto anti = lra::make_anti_join<ra::LeftKeys<0>, ra::RightKeys<0>>(
+      semi, lra::make_iterable(&xs));
+  auto plan = anti | lra::filter(lra::columns_eq<0, 1>());
+  EXPECT_EQ(lra::ToDebugString(lra::Rewrite(plan)),
+            "AntiJoin<LeftKeys<0>, RightKeys<0>>("
+            "SemiJoin<LeftKeys<0>, RightKeys<0>>(Filter(Iterable), "
+            "HashJoin<LeftKeys<0>, RightKeys<0>>(Iterable, Iterable)), "
+            "Iterable)");
+}
+
+TEST(Rewrite, DoesntPushFiltersPastTopK) {
+  ints xs;
+  auto plan = lra::make_iterable(&xs) |
+              lra::filter(lra::columns_eq<0, 1>()) |
+              lra::top_k<ra::Keys<0>, 1, 2>() |
+              lra::filter(lra::columns_eq<0, 1>());
+  EXPECT_EQ(lra::ToDebugString(lra::Rewrite(plan)),
+            "Filter(TopK<Keys<0>, 1, 2>(Filter(Iterable)))");
+}
+
+TEST(Rewrite, DoesntPushFiltersPastWindow) {
+  using Time = std::chrono::time_point<std::chrono::system_clock>;
+  std::set<std::tuple<int, int, Time>> xs;
+  std::set<std::tuple<std::size_t, Time>> ps;
+  auto plan = lra::make_iterable(&xs) |
+              lra::filter(lra::columns_eq<0, 1>()) |
+              lra::tumbling_window<ra::Keys<0>, 2, ra::agg::Count<1>>(
+                  lra::make_iterable(&ps), std::chrono::seconds(1)) |
+              lra::filter(lra::make_column_predicate<0>(
+                  [](int x) { return x == 1; }));
+  EXPECT_EQ(lra::ToDebugString(lra::Rewrite(plan)),
+            "Filter(Window<Keys<0>, 2, Count<1>>(Filter(Iterable), Iterable, "
+            "1000000us, 1000000us))");
+}
+
+TEST(Rewrite, ReorderJoinAAndC) {
+  ints a;
+  std::set<std::tuple<int>> b;
+  std::set<std::tuple<int, int, int>> c;
+  auto ab = lra::make_hash_join<ra::LeftKeys<0>, ra::RightKeys<0>>(
+      lra::make_iterable(&a), lra::make_iterable(&b));
+  auto abc = lra::make_hash_join<ra::LeftKeys<1>, ra::RightKeys<2>>(
+      ab, lra::make_iterable(&c));
+  auto rewritten = lra::Rewrite(abc);
+
+  using alternatives = decltype(rewritten);
+  ExpectSameType<alternatives::column_types, decltype(abc)::column_types>();
+  EXPECT_EQ(lra::ToDebugString(rewritten),
+            "Alternatives("
+            "HashJoin<LeftKeys<1>, RightKeys<2>>("
+            "HashJoin<LeftKeys<0>, RightKeys<0>>(Iterable, Iterable), "
+            "Iterable), "
+            "Project<0, 1, 5, 2, 3, 4>(HashJoin<LeftKeys<0>, RightKeys<0>>("
+            "HashJoin<LeftKeys<1>, RightKeys<2>>(Iterable, Iterable), "
+            "Iterable)))");
+}
+
+TEST(Rewrite, ReorderJoinBAndC) {
+  ints a;
+  ints b;
+  std::set<std::tuple<int>> c;
+  auto ab = lra::make_hash_join<ra::LeftKeys<0>, ra::RightKeys<0>>(
+      lra::make_iterable(&a), lra::make_iterable(&b));
+  auto abc = lra::make_hash_join<ra::LeftKeys<3>, ra::RightKeys<0>>(
+      ab, lra::make_iterable(&c));
+  auto rewritten = lra::Rewrite(abc | lra::project<0, 4>());
+
+  ExpectSameType<decltype(rewritten)::column_types, TypeList<int, int>>();
+  EXPECT_EQ(lra::ToDebugString(rewritten),
+            "Alternatives("
+            "Project<0, 4>(HashJoin<LeftKeys<3>, RightKeys<0>>("
+            "HashJoin<LeftKeys<0>, RightKeys<0>>(Iterable, Iterable), "
+            "Iterable)), "
+            "Project<0, 4>(HashJoin<LeftKeys<0>, RightKeys<0>>(Iterable, "
+            "HashJoin<LeftKeys<1>, RightKeys<0>>(Iterable, Iterable))))");
+}
+
+TEST(Rewrite, NoReorderWhenCJoinsBothAAndB) {
+  ints a;
+  ints b;
+  ints c;
+  auto ab = lra::make_hash_join<ra::LeftKeys<0>, ra::RightKeys<0>>(
+      lra::make_iterable(&a), lra::make_iterable(&b));
+  auto abc = lra::make_hash_join<ra::LeftKeys<1, 3>, ra::RightKeys<0, 1>>(
+      ab, lra::make_iterable(&c));
+  auto rewritten = lra::Rewrite(abc);
+  ExpectSameType<decltype(rewritten), decltype(abc)>();
+}
+
+TEST(Rewrite, CrossesToReorderedJoins) {
+  ints a;
+  ints b;
+  ints c;
+  auto ab = lra::make_cross(lra::make_iterable(&a), lra::make_iterable(&b));
+  auto plan = lra::make_cross(ab, lra::make_iterable(&c)) |
+              lra::filter(lra::columns_eq<1, 2>()) |
+              lra::filter(lra::columns_eq<0, 4>());
+  auto rewritten = lra::Rewrite(plan);
+  EXPECT_EQ(lra::ToDebugString(rewritten),
+            "Alternatives("
+            "HashJoin<LeftKeys<0>, RightKeys<0>>("
+            "HashJoin<LeftKeys<1>, RightKeys<0>>(Iterable, Iterable), "
+            "Iterable), "
+            "Project<0, 1, 4, 5, 2, 3>(HashJoin<LeftKeys<1>, RightKeys<0>>("
+            "HashJoin<LeftKeys<0>, RightKeys<0>>(Iterable, Iterable), "
+            "Iterable)))");
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
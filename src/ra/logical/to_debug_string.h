@@ -4,7 +4,10 @@
 #include <cstddef>
 
 #include <string>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "fmt/format.h"
 
@@ -89,6 +92,38 @@ struct ToDebugStringImpl<HashJoin<Left, LeftKeys<LeftKs...>,  //
   }
 };
 
+template <typename Left, std::size_t... LeftKs,  //
+          typename Right, std::size_t... RightKs>
+struct ToDebugStringImpl<SemiJoin<Left, LeftKeys<LeftKs...>,  //
+                                  Right, RightKeys<RightKs...>>> {
+  std::string operator()(
+      const SemiJoin<Left, LeftKeys<LeftKs...>,  //
+                     Right, RightKeys<RightKs...>>& semi_join) {
+    const std::string left = ToDebugString(semi_join.left);
+    const std::string left_keys = Join(LeftKs...);
+    const std::string right = ToDebugString(semi_join.right);
+    const std::string right_keys = Join(RightKs...);
+    return fmt::format("SemiJoin<LeftKeys<{}>, RightKeys<{}>>({}, {})",  //
+                       left_keys, right_keys, left, right);
+  }
+};
+
+template <typename Left, std::size_t... LeftKs,  //
+          typename Right, std::size_t... RightKs>
+struct ToDebugStringImpl<AntiJoin<Left, LeftKeys<LeftKs...>,  //
+                                  Right, RightKeys<RightKs...>>> {
+  std::string operator()(
+      const AntiJoin<Left, LeftKeys<LeftKs...>,  //
+                     Right, RightKeys<RightKs...>>& anti_join) {
+    const std::string left = ToDebugString(anti_join.left);
+    const std::string left_keys = Join(LeftKs...);
+    const std::string right = ToDebugString(anti_join.right);
+    const std::string right_keys = Join(RightKs...);
+    return fmt::format("AntiJoin<LeftKeys<{}>, RightKeys<{}>>({}, {})",  //
+                       left_keys, right_keys, left, right);
+  }
+};
+
 template <typename Ra, std::size_t... Ks, typename... Aggregates>
 struct ToDebugStringImpl<GroupBy<Ra, Keys<Ks...>, Aggregates...>> {
   std::string operator()(
@@ -100,6 +135,45 @@ struct ToDebugStringImpl<GroupBy<Ra, Keys<Ks...>, Aggregates...>> {
   }
 };
 
+template <typename Ra, std::size_t... Ks, std::size_t O, std::size_t K>
+struct ToDebugStringImpl<TopK<Ra, Keys<Ks...>, O, K>> {
+  std::string operator()(const TopK<Ra, Keys<Ks...>, O, K>& top_k) {
+    const std::string columns = Join(Ks...);
+    const std::string child = ToDebugString(top_k.child);
+    return fmt::format("TopK<Keys<{}>, {}, {}>({})", columns, O, K, child);
+  }
+};
+
+template <typename Ra, typename Trigger, std::size_t... Ks, std::size_t T,
+          typename... Aggregates>
+struct ToDebugStringImpl<Window<Ra, Trigger, Keys<Ks...>, T, Aggregates...>> {
+  std::string operator()(
+      const Window<Ra, Trigger, Keys<Ks...>, T, Aggregates...>& window) {
+    const std::string columns = Join(Ks...);
+    const std::string aggregates = Join(Aggregates::ToDebugString()...);
+    const std::string child = ToDebugString(window.child);
+    const std::string trigger = ToDebugString(window.trigger);
+    return fmt::format("Window<Keys<{}>, {}, {}>({}, {}, {}us, {}us)", columns,
+                       T, aggregates, child, trigger, window.size.count(),
+                       window.slide.count());
+  }
+};
+
+template <typename... Ras>
+struct ToDebugStringImpl<Alternatives<Ras...>> {
+  std::string operator()(const Alternatives<Ras...>& alternatives) {
+    return Impl(alternatives, std::index_sequence_for<Ras...>());
+  }
+
+  template <std::size_t... Is>
+  std::string Impl(const Alternatives<Ras...>& alternatives,
+                   std::index_sequence<Is...>) {
+    const std::vector<std::string> children = {
+        ToDebugString(std::get<Is>(alternatives.alternatives))...};
+    return fmt::format("Alternatives({})", Join(children));
+  }
+};
+
 template <typename Ra, typename RaDecayed>
 std::string ToDebugString(const Ra& ra) {
   static_assert(StaticAssert<std::is_base_of<LogicalRa, RaDecayed>>::value, "");
@@ -1,5 +1,7 @@
 #include "ra/logical/to_debug_string.h"
 
+#include <chrono>
+#include <cstddef>
 #include <set>
 #include <tuple>
 #include <type_traits>
@@ -89,6 +91,21 @@ TEST(ToDebugString, HashJoin) {
   EXPECT_EQ(actual, expected);
 }
 
+TEST(ToDebugString, SemiJoinAndAntiJoin) {
+  std::set<std::tuple<int, bool>> xs;
+  std::set<std::tuple<bool, int>> ys;
+  const auto ixs = lra::make_iterable(&xs);
+  const auto iys = lra::make_iterable(&ys);
+  using left_keys = ra::LeftKeys<0>;
+  using right_keys = ra::RightKeys<1>;
+  const auto semi_join = lra::make_semi_join<left_keys, right_keys>(ixs, iys);
+  const auto anti_join = lra::make_anti_join<left_keys, right_keys>(ixs, iys);
+  EXPECT_EQ(lra::ToDebugString(semi_join),
+            "SemiJoin<LeftKeys<0>, RightKeys<1>>(Iterable, Iterable)");
+  EXPECT_EQ(lra::ToDebugString(anti_join),
+            "AntiJoin<LeftKeys<0>, RightKeys<1>>(Iterable, Iterable)");
+}
+
 TEST(ToDebugString, GroupBy) {
   std::set<std::tuple<int, bool>> xs;
   const auto group_by =
@@ -98,6 +115,40 @@ TEST(ToDebugString, GroupBy) {
   EXPECT_EQ(actual, expected);
 }
 
+TEST(ToDebugString, TopK) {
+  std::set<std::tuple<int, bool, float>> xs;
+  const auto top_k =
+      lra::make_iterable(&xs) | lra::top_k<ra::Keys<0, 1>, 2, 10>();
+  const std::string actual = lra::ToDebugString(top_k);
+  const std::string expected = "TopK<Keys<0, 1>, 2, 10>(Iterable)";
+  EXPECT_EQ(actual, expected);
+}
+
+TEST(ToDebugString, Window) {
+  using Time = std::chrono::time_point<std::chrono::system_clock>;
+  std::set<std::tuple<int, Time>> xs;
+  std::set<std::tuple<std::size_t, Time>> ps;
+  const auto window =
+      lra::make_iterable(&xs) |
+      lra::sliding_window<ra::Keys<0>, 1, ra::agg::Count<0>>(
+          lra::make_iterable(&ps), std::chrono::seconds(2),
+          std::chrono::seconds(1));
+  const std::string actual = lra::ToDebugString(window);
+  const std::string expected =
+      "Window<Keys<0>, 1, Count<0>>(Iterable, Iterable, 2000000us, 1000000us)";
+  EXPECT_EQ(actual, expected);
+}
+
+TEST(ToDebugString, Alternatives) {
+  std::set<std::tuple<int>> xs;
+  const auto iter = lra::make_iterable(&xs);
+  const auto alternatives =
+      lra::make_alternatives(iter, iter | lra::project<0>());
+  const std::string actual = lra::ToDebugString(alternatives);
+  const std::string expected = "Alternatives(Iterable, Project<0>(Iterable))";
+  EXPECT_EQ(actual, expected);
+}
+
 }  // namespace fluent
 
 int main(int argc, char** argv) {
@@ -0,0 +1,61 @@
+#ifndef RA_LOGICAL_TOP_K_H_
+#define RA_LOGICAL_TOP_K_H_
+
+#include <cstddef>
+
+#include <type_traits>
+#include <utility>
+
+#include "common/static_assert.h"
+#include "common/type_list.h"
+#include "common/type_traits.h"
+#include "ra/keys.h"
+#include "ra/logical/logical_ra.h"
+
+namespace fluent {
+namespace ra {
+namespace logical {
+
+// A TopK groups the tuples of its child by the key columns `Ks` and produces
+// the `K` tuples of every group with the largest values in column `O`. Ties
+// are broken by comparing whole tuples, so the output is deterministic. The
+// tuples are produced as they are, in no particular order.
+//
+//   make_collection(&scores) | top_k<Keys<0>, 2, 10>()
+template <typename Ra, typename Keys, std::size_t O, std::size_t K>
+struct TopK;
+
+template <typename Ra, std::size_t... Ks, std::size_t O, std::size_t K>
+struct TopK<Ra, Keys<Ks...>, O, K> : public LogicalRa {
+  static_assert(StaticAssert<std::is_base_of<LogicalRa, Ra>>::value, "");
+  using child_column_types = typename Ra::column_types;
+  using child_len_t = typename TypeListLen<child_column_types>::type;
+  static constexpr std::size_t child_len = child_len_t::value;
+  static_assert(StaticAssert<All<InRange<Ks, 0, child_len>...>>::value, "");
+  static_assert(StaticAssert<InRange<O, 0, child_len>>::value, "");
+  static_assert(K > 0, "A TopK must keep at least one tuple per group.");
+  using key_types = typename TypeListProject<child_column_types, Ks...>::type;
+
+  using column_types = child_column_types;
+  explicit TopK(Ra child_) : child(std::move(child_)) {}
+  Ra child;
+};
+
+template <typename Keys, std::size_t O, std::size_t K>
+struct top_k;
+
+template <std::size_t... Ks, std::size_t O, std::size_t K>
+struct top_k<Keys<Ks...>, O, K> {};
+
+template <typename Ra, std::size_t... Ks, std::size_t O, std::size_t K,
+          typename RaDecayed = typename std::decay<Ra>::type>
+TopK<RaDecayed, Keys<Ks...>, O, K> operator|(Ra&& child,
+                                             top_k<Keys<Ks...>, O, K>) {
+  return TopK<RaDecayed, Keys<Ks...>, O, K>(std::forward<Ra>(child));
+}
+
+}  // namespace logical
+}  // namespace ra
+}  // namespace fluent
+
+#endif  // RA_LOGICAL_TOP_K_H_
@@ -0,0 +1,61 @@
+#include "ra/logical/top_k.h"
+
+#include <set>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+#include "common/macros.h"
+#include "ra/keys.h"
+#include "ra/logical/iterable.h"
+
+namespace ra = fluent::ra;
+namespace lra = fluent::ra::logical;
+
+namespace fluent {
+
+TEST(TopK, SimpleCompileCheck) {
+  std::set<std::tuple<std::string, int, float>> xs;
+  lra::Iterable<std::set<std::tuple<std::string, int, float>>> i =
+      lra::make_iterable(&xs);
+  lra::TopK<decltype(i), ra::Keys<0>, 2, 3> top_k =
+      i | lra::top_k<ra::Keys<0>, 2, 3>();
+  UNUSED(top_k);
+
+  using actual = decltype(top_k)::column_types;
+  using expected = TypeList<std::string, int, float>;
+  static_assert(StaticAssert<std::is_same<actual, expected>>::value, "");
+}
+
+TEST(TopK, NoKeys) {
+  std::set<std::tuple<int>> xs;
+  auto top_k = lra::make_iterable(&xs) | lra::top_k<ra::Keys<>, 0, 1>();
+  UNUSED(top_k);
+
+  using actual = decltype(top_k)::column_types;
+  using expected = TypeList<int>;
+  static_assert(StaticAssert<std::is_same<actual, expected>>::value, "");
+}
+
+// This code should NOT compile.
+TEST(TopK, OrderColumnOutOfRange) {
+  // std::set<std::tuple<int, float>> xs;
+  // auto top_k = lra::make_iterable(&xs) | lra::top_k<ra::Keys<0>, 2, 1>();
+}
+
+// This code should NOT compile.
+TEST(TopK, ZeroK) {
+  // std::set<std::tuple<int, float>> xs;
+  // auto top_k = lra::make_iterable(&xs) | lra::top_k<ra::Keys<0>, 1, 0>();
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
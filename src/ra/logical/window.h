@@ -0,0 +1,136 @@
+#ifndef RA_LOGICAL_WINDOW_H_
+#define RA_LOGICAL_WINDOW_H_
+
+#include <cstddef>
+
+#include <chrono>
+#include <type_traits>
+#include <utility>
+
+#include "common/sizet_list.h"
+#include "common/static_assert.h"
+#include "common/type_list.h"
+#include "common/type_traits.h"
+#include "ra/aggregates.h"
+#include "ra/keys.h"
+#include "ra/logical/group_by.h"
+#include "ra/logical/logical_ra.h"
+
+namespace fluent {
+namespace ra {
+namespace logical {
+
+// A Window groups the tuples of its child (the events) by the key columns
+// `Ks` and by time, and aggregates every group over sliding windows of time.
+// Column `T` of the child is the time of an event, and the windows are closed
+// by the tuples of `trigger`, whose second column is a time of the same type
+// (e.g. the `(id, time)` tuples of a Periodic).
+//
+// Windows are `size` long and start every `slide`, aligned to the clock's
+// epoch. A window with `size == slide` is a tumbling window. When `trigger`
+// produces a tuple with time `t`, every window that ended by `t` and hasn't
+// been produced yet is produced. A Window produces the tuple
+// `(k1, ..., kn, end, a1, ..., am)` for every group `(k1, ..., kn)` with an
+// event in the window that ends at `end`.
+//
+// Unlike the other operators, a Window remembers the events of its child
+// across evaluations, so its child should produce every event exactly once
+// (e.g. a Channel, a Scratch, or Stdin).
+//
+//   make_collection(&requests)
+//     | sliding_window<Keys<0>, 1, agg::Count<0>>(make_collection(&p),
+//                                                 minutes(5), minutes(1))
+template <typename Ra, typename Trigger, typename Keys, std::size_t T,
+          typename... Aggregates>
+struct Window;
+
+template <typename Ra, typename Trigger, std::size_t... Ks, std::size_t T,
+          typename... Aggregates>
+struct Window<Ra, Trigger, Keys<Ks...>, T, Aggregates...> : public LogicalRa {
+  static_assert(StaticAssert<std::is_base_of<LogicalRa, Ra>>::value, "");
+  static_assert(StaticAssert<std::is_base_of<LogicalRa, Trigger>>::value, "");
+  using child_column_types = typename Ra::column_types;
+  using child_len_t = typename TypeListLen<child_column_types>::type;
+  static constexpr std::size_t child_len = child_len_t::value;
+  static_assert(StaticAssert<All<InRange<Ks, 0, child_len>...>>::value, "");
+  static_assert(StaticAssert<InRange<T, 0, child_len>>::value, "");
+  static_assert(
+      StaticAssert<All<std::is_base_of<agg::Aggregate, Aggregates>...>>::value,
+      "");
+
+  using trigger_column_types = typename Trigger::column_types;
+  using trigger_len_t = typename TypeListLen<trigger_column_types>::type;
+  static_assert(trigger_len_t::value == 2, "A trigger has columns (id, time).");
+  using time_type = typename TypeListGet<child_column_types, T>::type;
+  using trigger_time_type = typename TypeListGet<trigger_column_types, 1>::type;
+  static_assert(
+      StaticAssert<std::is_same<time_type, trigger_time_type>>::value, "");
+
+  using key_types = typename TypeListProject<child_column_types, Ks...>::type;
+  using aggregate_impl_types = TypeList<  //
+      typename Aggregates::template type<
+          typename detail::TypeListProjectBySizetList<
+              child_column_types,
+              typename SizetListFrom<Aggregates>::type>::type>...  //
+      >;
+  using aggregate_types =
+      typename TypeListMap<aggregate_impl_types, detail::TypeOfGet>::type;
+
+  using column_types = typename TypeListConcat<
+      typename TypeListConcat<key_types, TypeList<time_type>>::type,
+      aggregate_types>::type;
+  Window(Ra child_, Trigger trigger_, std::chrono::microseconds size_,
+         std::chrono::microseconds slide_)
+      : child(std::move(child_)),
+        trigger(std::move(trigger_)),
+        size(size_),
+        slide(slide_) {}
+  Ra child;
+  Trigger trigger;
+  std::chrono::microseconds size;
+  std::chrono::microseconds slide;
+};
+
+template <typename Trigger, typename Keys, std::size_t T,
+          typename... Aggregates>
+struct window;
+
+template <typename Trigger, std::size_t... Ks, std::size_t T,
+          typename... Aggregates>
+struct window<Trigger, Keys<Ks...>, T, Aggregates...> {
+  Trigger trigger;
+  std::chrono::microseconds size;
+  std::chrono::microseconds slide;
+};
+
+template <typename Keys, std::size_t T, typename... Aggregates,
+          typename Trigger,
+          typename TriggerDecayed = typename std::decay<Trigger>::type>
+window<TriggerDecayed, Keys, T, Aggregates...> sliding_window(
+    Trigger&& trigger, std::chrono::microseconds size,
+    std::chrono::microseconds slide) {
+  return {std::forward<Trigger>(trigger), size, slide};
+}
+
+template <typename Keys, std::size_t T, typename... Aggregates,
+          typename Trigger,
+          typename TriggerDecayed = typename std::decay<Trigger>::type>
+window<TriggerDecayed, Keys, T, Aggregates...> tumbling_window(
+    Trigger&& trigger, std::chrono::microseconds size) {
+  return {std::forward<Trigger>(trigger), size, size};
+}
+
+template <typename Ra, typename Trigger, std::size_t... Ks, std::size_t T,
+          typename... Aggregates,
+          typename RaDecayed = typename std::decay<Ra>::type>
+Window<RaDecayed, Trigger, Keys<Ks...>, T, Aggregates...> operator|(
+    Ra&& child, window<Trigger, Keys<Ks...>, T, Aggregates...> w) {
+  return Window<RaDecayed, Trigger, Keys<Ks...>, T, Aggregates...>(
+      std::forward<Ra>(child), std::move(w.trigger), w.size, w.slide);
+}
+
+}  // namespace logical
+}  // namespace ra
+}  // namespace fluent
+
+#endif  // RA_LOGICAL_WINDOW_H_
@@ -0,0 +1,81 @@
+#include "ra/logical/window.h"
+
+#include <chrono>
+#include <cstddef>
+#include <set>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+#include "common/macros.h"
+#include "ra/aggregates.h"
+#include "ra/keys.h"
+#include "ra/logical/iterable.h"
+
+namespace ra = fluent::ra;
+namespace lra = fluent::ra::logical;
+
+namespace fluent {
+
+using Time = std::chrono::time_point<std::chrono::system_clock>;
+
+TEST(Window, SimpleCompileCheck) {
+  std::set<std::tuple<std::string, Time, int>> xs;
+  std::set<std::tuple<std::size_t, Time>> ps;
+  auto i = lra::make_iterable(&xs);
+  auto p = lra::make_iterable(&ps);
+  lra::Window<decltype(i), decltype(p), ra::Keys<0>, 1, ra::agg::Sum<2>,
+              ra::agg::Count<2>>
+      window = i | lra::sliding_window<ra::Keys<0>, 1, ra::agg::Sum<2>,
+                                       ra::agg::Count<2>>(
+                       p, std::chrono::seconds(10), std::chrono::seconds(5));
+  EXPECT_EQ(window.size, std::chrono::seconds(10));
+  EXPECT_EQ(window.slide, std::chrono::seconds(5));
+
+  using actual = decltype(window)::column_types;
+  using expected = TypeList<std::string, Time, int, std::size_t>;
+  static_assert(StaticAssert<std::is_same<actual, expected>>::value, "");
+}
+
+TEST(Window, Tumbling) {
+  std::set<std::tuple<Time, int>> xs;
+  std::set<std::tuple<std::size_t, Time>> ps;
+  auto window =
+      lra::make_iterable(&xs) |
+      lra::tumbling_window<ra::Keys<>, 0, ra::agg::Avg<1>>(
+          lra::make_iterable(&ps), std::chrono::seconds(1));
+  EXPECT_EQ(window.size, window.slide);
+
+  using actual = decltype(window)::column_types;
+  using expected = TypeList<Time, double>;
+  static_assert(StaticAssert<std::is_same<actual, expected>>::value, "");
+}
+
+// This code should NOT compile.
+TEST(Window, TimeColumnOutOfRange) {
+  // std::set<std::tuple<Time, int>> xs;
+  // std::set<std::tuple<std::size_t, Time>> ps;
+  // auto window = lra::make_iterable(&xs) |
+  //               lra::tumbling_window<ra::Keys<>, 2, ra::agg::Sum<1>>(
+  //                   lra::make_iterable(&ps), std::chrono::seconds(1));
+}
+
+// This code should NOT compile.
+TEST(Window, TimeColumnTypeMismatch) {
+  // std::set<std::tuple<Time, int>> xs;
+  // std::set<std::tuple<std::size_t, Time>> ps;
+  // auto window = lra::make_iterable(&xs) |
+  //               lra::tumbling_window<ra::Keys<>, 1, ra::agg::Sum<1>>(
+  //                   lra::make_iterable(&ps), std::chrono::seconds(1));
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -3,14 +3,19 @@
 
 #include <cstddef>
 
+#include <set>
 #include <string>
 #include <tuple>
 #include <type_traits>
 #include <utility>
 
+#include "range/v3/all.hpp"
+
 #include "collections/collection_tuple_ids.h"
+#include "common/arena.h"
 #include "common/static_assert.h"
 #include "common/tuple_util.h"
+#include "fluent/lineage_view.h"
 #include "fluent/local_tuple_id.h"
 #include "ra/aggregates.h"
 #include "ra/logical/all.h"
@@ -24,92 +29,95 @@ namespace pra = fluent::ra::physical;
 namespace fluent {
 namespace ra {
 
+// `LogicalToPhysical(ra, arena)` converts a logical relational algebra
+// expression into a physical one. Physical operators that buffer tuples (e.g.
+// HashJoin, SemiJoin, and GroupBy) allocate their buffers from `arena`, or
+// from the heap if `arena` is null. See common/arena.h.
 template <typename Logical>
-auto LogicalToPhysical(const Logical& ra);
+auto LogicalToPhysical(const Logical& ra, Arena* arena = nullptr);
 
 template <typename Logical>
 struct LogicalToPhysicalImpl;
 
+// `Flatten(p)` converts every `(t, lineage)` pair produced by `p` into the
+// tuple `(lineage, t[0], ..., t[n - 1])`, where the columns of `t` are a tuple
+// view. See `TupleView` in common/tuple_util.h.
 template <typename Physical>
 auto Flatten(Physical p) {
-  return pra::make_map(std::move(p), [](const auto& pair) {
-    const auto& t = std::get<0>(pair);
-    const std::set<LocalTupleId>& lineage = std::get<1>(pair);
-    return tuple_cat(std::make_tuple(lineage), t);
-  });
-}
-
-template <typename Physical>
-auto UnFlatten(Physical p) {
-  return pra::make_map(std::move(p), [](const auto& t) {
-    const std::set<LocalTupleId>& lineage = std::get<0>(t);
-    const auto t_ = TupleDrop<1>(t);
-    return std::make_tuple(t_, lineage);
+  return pra::make_map(std::move(p), [](auto&& pair) {
+    using pair_type = decltype(pair);
+    std::set<LocalTupleId> lineage = std::get<1>(std::forward<pair_type>(pair));
+    return std::tuple_cat(
+        std::make_tuple(std::move(lineage)),
+        TupleView(std::get<0>(std::forward<pair_type>(pair))));
   });
 }
 
+// Scanning a collection yields, for every tuple `t` in the collection, a
+// `(const T& t, LineageView lineage)` pair that refers to `t` and its
+// CollectionTupleIds in the collection's storage. Nothing is copied or
+// allocated per tuple.
 template <typename Collection>
 struct LogicalToPhysicalImpl<lra::Collection<Collection>> {
-  auto operator()(const lra::Collection<Collection>& collection) {
+  auto operator()(const lra::Collection<Collection>& collection, Arena*) {
+    const std::string* collection_name = &collection.collection->Name();
     auto iterable = pra::make_iterable(&collection.collection->Get());
-    return pra::make_map(std::move(iterable), [&collection](const auto& pair) {
-      const auto& t = pair.first;
+    auto f = [collection_name](const auto& pair) {
+      using tuple_type = typename std::decay<decltype(pair.first)>::type;
       const CollectionTupleIds& ids = pair.second;
-      const std::string& collection_name = collection.collection->Name();
-
-      std::set<LocalTupleId> lineage;
-      for (int logical_time_inserted : ids.logical_times_inserted) {
-        LocalTupleId id{collection_name, ids.hash, logical_time_inserted};
-        lineage.insert(id);
-      }
-
-      return std::make_tuple(t, lineage);
-    });
+      LineageView lineage(collection_name, ids.hash,
+                          &ids.logical_times_inserted);
+      return std::tuple<const tuple_type&, LineageView>(pair.first, lineage);
+    };
+    return pra::make_map(std::move(iterable), std::move(f));
   }
 };
 
+// Scanning a meta collection yields, for every tuple `t` in the collection and
+// every logical time `time` at which `t` was inserted, the pair
+// `((const T& t, id), LineageView(id))` where `id` is the LocalTupleId of `t`
+// at `time`. The logical times of a tuple are iterated in place.
 template <typename Collection>
 struct LogicalToPhysicalImpl<lra::MetaCollection<Collection>> {
-  auto operator()(const lra::MetaCollection<Collection>& meta_collection) {
-    using column_types = typename lra::MetaCollection<Collection>::column_types;
-    using column_tuple = typename TypeListToTuple<column_types>::type;
-    using lineage_type = std::set<LocalTupleId>;
-    using ret_type = std::vector<std::tuple<column_tuple, lineage_type>>;
-
+  auto operator()(const lra::MetaCollection<Collection>& meta_collection,
+                  Arena*) {
+    const std::string* collection_name = &meta_collection.collection->Name();
     auto iterable = pra::make_iterable(&meta_collection.collection->Get());
-    return pra::make_flat_map<ret_type>(
-        std::move(iterable), [&meta_collection](const auto& pair) {
-          const auto& t = pair.first;
-          const CollectionTupleIds& ids = pair.second;
-          const Collection* collection = meta_collection.collection;
-          const std::string& collection_name = collection->Name();
-
-          ret_type ret;
-          for (int logical_time_inserted : ids.logical_times_inserted) {
-            LocalTupleId id{collection_name, ids.hash, logical_time_inserted};
-            std::set<LocalTupleId> lineage{id};
-            ret.push_back(std::make_tuple(std::make_tuple(t, id), lineage));
-          }
-          return ret;
+    return pra::make_flat_map_view(
+        std::move(iterable), [collection_name](const auto& pair) {
+          using tuple_type = typename std::decay<decltype(pair.first)>::type;
+          using column_tuple = std::tuple<const tuple_type&, LocalTupleId>;
+          const tuple_type* t = &pair.first;
+          const std::size_t hash = pair.second.hash;
+          return ranges::view::transform(
+              pair.second.logical_times_inserted,
+              [collection_name, t, hash](int logical_time_inserted) {
+                LocalTupleId id{*collection_name, hash, logical_time_inserted};
+                LineageView lineage(collection_name, hash,
+                                    logical_time_inserted);
+                return std::make_tuple(column_tuple(*t, std::move(id)),
+                                       lineage);
+              });
         });
   }
 };
 
 template <typename Container>
 struct LogicalToPhysicalImpl<lra::Iterable<Container>> {
-  auto operator()(const lra::Iterable<Container>& iterable) const {
+  auto operator()(const lra::Iterable<Container>& iterable, Arena*) const {
     auto iterable_ = pra::make_iterable(iterable.container);
     return pra::make_map(std::move(iterable_), [](const auto& t) {
-      return std::make_tuple(t, std::set<LocalTupleId>{});
+      using tuple_type = typename std::decay<decltype(t)>::type;
+      return std::tuple<const tuple_type&, LineageView>(t, LineageView());
     });
   }
 };
 
 template <typename Logical, typename F>
 struct LogicalToPhysicalImpl<lra::Map<Logical, F>> {
-  auto operator()(const lra::Map<Logical, F>& map) {
+  auto operator()(const lra::Map<Logical, F>& map, Arena* arena) {
     auto f = map.f;
-    auto child = LogicalToPhysical(map.child);
+    auto child = LogicalToPhysical(map.child, arena);
     return pra::make_map(std::move(child), [f](const auto& pair) {
       const auto& t = std::get<0>(pair);
       const auto& lineage = std::get<1>(pair);
@@ -120,9 +128,9 @@ struct LogicalToPhysicalImpl<lra::Map<Logical, F>> {
 
 template <typename Logical, typename F>
 struct LogicalToPhysicalImpl<lra::Filter<Logical, F>> {
-  auto operator()(const lra::Filter<Logical, F>& filter) {
+  auto operator()(const lra::Filter<Logical, F>& filter, Arena* arena) {
     auto f = filter.f;
-    auto child = LogicalToPhysical(filter.child);
+    auto child = LogicalToPhysical(filter.child, arena);
     return pra::make_filter(std::move(child), [f](const auto& pair) {
       return f(std::get<0>(pair));
     });
@@ -131,63 +139,160 @@ struct LogicalToPhysicalImpl<lra::Filter<Logical, F>> {
 
 template <typename Logical, std::size_t... Is>
 struct LogicalToPhysicalImpl<lra::Project<Logical, Is...>> {
-  auto operator()(const lra::Project<Logical, Is...>& project) {
-    auto child = Flatten(LogicalToPhysical(project.child));
-    auto projected = pra::make_project<0, 1 + Is...>(std::move(child));
-    return UnFlatten(std::move(projected));
+  auto operator()(const lra::Project<Logical, Is...>& project, Arena* arena) {
+    auto child = LogicalToPhysical(project.child, arena);
+    return pra::make_map(std::move(child), [](auto&& pair) {
+      using pair_type = decltype(pair);
+      return std::make_tuple(
+          TupleProjectView<Is...>(std::get<0>(std::forward<pair_type>(pair))),
+          std::get<1>(std::forward<pair_type>(pair)));
+    });
   }
 };
 
 template <typename Left, typename Right>
 struct LogicalToPhysicalImpl<lra::Cross<Left, Right>> {
-  auto operator()(const lra::Cross<Left, Right>& cross) {
-    auto left = LogicalToPhysical(cross.left);
-    auto right = LogicalToPhysical(cross.right);
+  auto operator()(const lra::Cross<Left, Right>& cross, Arena* arena) {
+    auto left = LogicalToPhysical(cross.left, arena);
+    auto right = LogicalToPhysical(cross.right, arena);
     auto cross_ = pra::make_cross(std::move(left), std::move(right));
-    return pra::make_map(std::move(cross_), [](const auto& t) {
-      const auto& left_t = std::get<0>(t);
+    return pra::make_map(std::move(cross_), [](auto&& t) {
+      using tuple_type = decltype(t);
       const std::set<LocalTupleId>& left_lineage = std::get<1>(t);
-      const auto& right_t = std::get<2>(t);
       const std::set<LocalTupleId>& right_lineage = std::get<3>(t);
-
       std::set<LocalTupleId> lineage;
       lineage.insert(left_lineage.begin(), left_lineage.end());
       lineage.insert(right_lineage.begin(), right_lineage.end());
-      return std::make_tuple(std::tuple_cat(left_t, right_t), lineage);
+
+      auto crossed = TupleCatView(std::get<0>(std::forward<tuple_type>(t)),
+                                  std::get<2>(std::forward<tuple_type>(t)));
+      return std::make_tuple(std::move(crossed), std::move(lineage));
     });
   }
 };
 
+// The physical join algorithms that LogicalToPhysical chooses between.
+struct HashJoinTag {};
+struct MergeJoinTag {};
+struct IndexNestedLoopJoinTag {};
+
+template <typename Logical>
+struct IsCollectionScan : public std::false_type {};
+
+template <typename C>
+struct IsCollectionScan<lra::Collection<C>> : public std::true_type {};
+
+// `CollectionScanIndex<lra::Collection<C>>::type` is the type of the sorted
+// index (i.e. the std::map) in which `C` stores its tuples.
+template <typename Logical>
+struct CollectionScanIndex;
+
+template <typename C>
+struct CollectionScanIndex<lra::Collection<C>> {
+  using type =
+      typename std::decay<decltype(std::declval<const C&>().Get())>::type;
+};
+
+// Whether `Logical` scans a collection whose index can be searched for the
+// keys `Ks...` (see `IsIndexPrefix` and `IsSeekableIndex`).
+template <typename Logical, typename Ks>
+struct IsSeekableCollectionScan : public std::false_type {};
+
+template <typename C, std::size_t... Ks>
+struct IsSeekableCollectionScan<lra::Collection<C>, SizetList<Ks...>>
+    : public std::conditional<
+          pra::IsIndexPrefix<SizetList<Ks...>>::value,
+          pra::IsSeekableIndex<
+              typename CollectionScanIndex<lra::Collection<C>>::type,
+              sizeof...(Ks)>,
+          std::false_type>::type {};
+
+// `JoinTag<Left, LeftKeys, Right, RightKeys>::type` is the physical join
+// algorithm that LogicalToPhysical uses to evaluate an lra::HashJoin:
+//
+//   - If both sides scan a collection and both sides are joined on a prefix of
+//     their columns, the collections' indexes are already sorted by the join
+//     keys, so we use a MergeJoin. The MergeJoin decides between stepping
+//     through and seeking into the right index based on the current sizes of
+//     the two collections (see `MergeJoinStrategy`).
+//   - Otherwise, if the right side scans a collection that can be searched for
+//     the join keys, we use an IndexNestedLoopJoin, which looks up every left
+//     tuple in the right collection's index instead of building a hash table.
+//   - Otherwise, we use a HashJoin.
+//
+// The key columns of both sides must have the same types for us to use a
+// MergeJoin or an IndexNestedLoopJoin.
+template <typename Left, typename LeftKs, typename Right, typename RightKs>
+struct JoinTag;
+
+template <typename Left, std::size_t... LeftKs,  //
+          typename Right, std::size_t... RightKs>
+struct JoinTag<Left, LeftKeys<LeftKs...>, Right, RightKeys<RightKs...>> {
+  using left_key_types =
+      typename TypeListProject<typename Left::column_types, LeftKs...>::type;
+  using right_key_types =
+      typename TypeListProject<typename Right::column_types, RightKs...>::type;
+  static constexpr bool same_key_types =
+      std::is_same<left_key_types, right_key_types>::value;
+  static constexpr bool left_is_sorted =
+      IsCollectionScan<Left>::value &&
+      pra::IsIndexPrefix<SizetList<LeftKs...>>::value;
+  static constexpr bool right_is_sorted =
+      IsCollectionScan<Right>::value &&
+      pra::IsIndexPrefix<SizetList<RightKs...>>::value;
+  static constexpr bool right_is_seekable =
+      IsSeekableCollectionScan<Right, SizetList<RightKs...>>::value;
+
+  using type = typename std::conditional<
+      same_key_types && left_is_sorted && right_is_sorted, MergeJoinTag,
+      typename std::conditional<same_key_types && right_is_seekable,
+                                IndexNestedLoopJoinTag,
+                                HashJoinTag>::type>::type;
+};
+
 template <typename Left, std::size_t... LeftKs,  //
           typename Right, std::size_t... RightKs>
 struct LogicalToPhysicalImpl<lra::HashJoin<Left, LeftKeys<LeftKs...>,  //
                                            Right, RightKeys<RightKs...>>> {
-  auto operator()(
-      const lra::HashJoin<Left, LeftKeys<LeftKs...>,  //
-                          Right, RightKeys<RightKs...>>& hash_join) {
-    using left_column_types = typename Left::column_types;
+  using join_type = lra::HashJoin<Left, LeftKeys<LeftKs...>,  //
+                                  Right, RightKeys<RightKs...>>;
+  using left_column_types = typename Left::column_types;
+  static constexpr std::size_t left_num_columns =
+      TypeListLen<left_column_types>::value;
+  static constexpr std::size_t right_num_columns =
+      TypeListLen<typename Right::column_types>::value;
+
+  auto operator()(const join_type& join, Arena* arena) {
+    using tag = typename JoinTag<Left, LeftKeys<LeftKs...>,  //
+                                 Right, RightKeys<RightKs...>>::type;
+    return Join(join, arena, tag());
+  }
+
+ private:
+  auto Join(const join_type& hash_join, Arena* arena, HashJoinTag) {
     using left_column_types_lineaged =
         typename TypeListCons<std::set<LocalTupleId>, left_column_types>::type;
     using left_column_tuple_lineaged =
         typename TypeListToTuple<left_column_types_lineaged>::type;
-    static constexpr std::size_t left_num_columns =
-        TypeListLen<left_column_types>::value;
+    // The offset of the right columns in a joined tuple.
+    static constexpr std::size_t right_offset = 1 + left_num_columns + 1;
 
     using left_key_column_types =
         typename TypeListProject<left_column_types, LeftKs...>::type;
     using left_key_column_tuple =
         typename TypeListToTuple<left_key_column_types>::type;
 
-    auto left = Flatten(LogicalToPhysical(hash_join.left));
-    auto right = Flatten(LogicalToPhysical(hash_join.right));
+    auto left = Flatten(LogicalToPhysical(hash_join.left, arena));
+    auto right = Flatten(LogicalToPhysical(hash_join.right, arena));
     using left_keys = LeftKeys<1 + LeftKs...>;
     using right_keys = RightKeys<1 + RightKs...>;
 
     auto joined =
         pra::make_hash_join<left_keys, right_keys, left_column_tuple_lineaged,
-                            left_key_column_tuple>(std::move(left),
-                                                   std::move(right));
-    return pra::make_map(std::move(joined), [](const auto& t) {
+                            left_key_column_tuple>(
+            std::move(left), std::move(right), arena);
+    return pra::make_map(std::move(joined), [](auto&& t) {
+      using tuple_type = decltype(t);
       const std::set<LocalTupleId>& left_lineage = std::get<0>(t);
       const std::set<LocalTupleId>& right_lineage =
           std::get<1 + left_num_columns>(t);
@@ -197,13 +302,148 @@ struct LogicalToPhysicalImpl<lra::HashJoin<Left, LeftKeys<LeftKs...>,  //
 
       using left_indexes =
           typename SizetListRange<1, 1 + left_num_columns>::type;
-      auto left_t = TupleProjectBySizetList<left_indexes>(t);
-      auto right_t = TupleDrop<1 + left_num_columns + 1>(t);
-      return std::make_tuple(std::tuple_cat(left_t, right_t), lineage);
+      using right_indexes =
+          typename SizetListRange<right_offset,
+                                  right_offset + right_num_columns>::type;
+      auto joined_t = std::tuple_cat(
+          TupleProjectViewBySizetList<left_indexes>(
+              std::forward<tuple_type>(t)),
+          TupleProjectViewBySizetList<right_indexes>(
+              std::forward<tuple_type>(t)));
+      return std::make_tuple(std::move(joined_t), std::move(lineage));
+    });
+  }
+
+  auto Join(const join_type& merge_join, Arena*, MergeJoinTag) {
+    const auto* left = merge_join.left.collection;
+    const auto* right = merge_join.right.collection;
+    const std::string* left_name = &left->Name();
+    const std::string* right_name = &right->Name();
+    auto joined = pra::make_merge_join<sizeof...(LeftKs)>(&left->Get(),
+                                                         &right->Get());
+
+    // The offset of the right columns in a joined tuple.
+    static constexpr std::size_t right_offset = left_num_columns + 1;
+    return pra::make_map(std::move(joined), [left_name, right_name](auto&& t) {
+      using tuple_type = decltype(t);
+      const CollectionTupleIds& left_ids = std::get<left_num_columns>(t);
+      const CollectionTupleIds& right_ids =
+          std::get<right_offset + right_num_columns>(t);
+      std::set<LocalTupleId> lineage = LineageView(
+          left_name, left_ids.hash, &left_ids.logical_times_inserted);
+      std::set<LocalTupleId> right_lineage = LineageView(
+          right_name, right_ids.hash, &right_ids.logical_times_inserted);
+      lineage.insert(right_lineage.begin(), right_lineage.end());
+
+      using left_indexes = typename SizetListRange<0, left_num_columns>::type;
+      using right_indexes =
+          typename SizetListRange<right_offset,
+                                  right_offset + right_num_columns>::type;
+      auto joined_t = std::tuple_cat(
+          TupleProjectViewBySizetList<left_indexes>(
+              std::forward<tuple_type>(t)),
+          TupleProjectViewBySizetList<right_indexes>(
+              std::forward<tuple_type>(t)));
+      return std::make_tuple(std::move(joined_t), std::move(lineage));
+    });
+  }
+
+  auto Join(const join_type& index_join, Arena* arena,
+            IndexNestedLoopJoinTag) {
+    const auto* right = index_join.right.collection;
+    const std::string* right_name = &right->Name();
+    auto left = Flatten(LogicalToPhysical(index_join.left, arena));
+    auto joined = pra::make_index_nested_loop_join<LeftKeys<1 + LeftKs...>>(
+        std::move(left), &right->Get());
+
+    return pra::make_map(std::move(joined), [right_name](auto&& t) {
+      using tuple_type = decltype(t);
+      const CollectionTupleIds& right_ids =
+          std::get<1 + left_num_columns + right_num_columns>(t);
+      std::set<LocalTupleId> lineage = std::get<0>(t);
+      std::set<LocalTupleId> right_lineage = LineageView(
+          right_name, right_ids.hash, &right_ids.logical_times_inserted);
+      lineage.insert(right_lineage.begin(), right_lineage.end());
+
+      using indexes = typename SizetListRange<
+          1, 1 + left_num_columns + right_num_columns>::type;
+      auto joined_t =
+          TupleProjectViewBySizetList<indexes>(std::forward<tuple_type>(t));
+      return std::make_tuple(std::move(joined_t), std::move(lineage));
+    });
+  }
+};
+
+// A SemiJoin or AntiJoin produces the left tuples it keeps as they are, with
+// their lineage. Like the predicate of a Filter, the right tuples only decide
+// whether a left tuple is produced, so they aren't part of its lineage, and
+// only the key columns of the right tuples are buffered.
+template <bool Anti, typename Left, typename LeftKs, typename Right,
+          typename RightKs>
+struct SemiJoinToPhysical;
+
+template <bool Anti, typename Left, std::size_t... LeftKs,  //
+          typename Right, std::size_t... RightKs>
+struct SemiJoinToPhysical<Anti, Left, LeftKeys<LeftKs...>,  //
+                          Right, RightKeys<RightKs...>> {
+  static constexpr std::size_t left_num_columns =
+      TypeListLen<typename Left::column_types>::value;
+
+  auto operator()(const Left& left_ra, const Right& right_ra, Arena* arena) {
+    using key_column_types =
+        typename TypeListProject<typename Right::column_types,
+                                 RightKs...>::type;
+    using key_column_tuple = typename TypeListToTuple<key_column_types>::type;
+
+    auto left = Flatten(LogicalToPhysical(left_ra, arena));
+    auto right = pra::make_map(LogicalToPhysical(right_ra, arena),
+                               [](auto&& pair) {
+                                 using pair_type = decltype(pair);
+                                 return TupleView(std::get<0>(
+                                     std::forward<pair_type>(pair)));
+                               });
+    using joined_type =
+        pra::SemiJoin<decltype(left), LeftKeys<1 + LeftKs...>,
+                      decltype(right), RightKeys<RightKs...>,
+                      key_column_tuple, Anti>;
+    joined_type joined(std::move(left), std::move(right), arena);
+    return pra::make_map(std::move(joined), [](auto&& t) {
+      using tuple_type = decltype(t);
+      using indexes = typename SizetListRange<1, 1 + left_num_columns>::type;
+      std::set<LocalTupleId> lineage = std::move(std::get<0>(t));
+      auto left_t =
+          TupleProjectViewBySizetList<indexes>(std::forward<tuple_type>(t));
+      return std::make_tuple(std::move(left_t), std::move(lineage));
     });
   }
 };
 
+template <typename Left, std::size_t... LeftKs,  //
+          typename Right, std::size_t... RightKs>
+struct LogicalToPhysicalImpl<lra::SemiJoin<Left, LeftKeys<LeftKs...>,  //
+                                           Right, RightKeys<RightKs...>>> {
+  auto operator()(const lra::SemiJoin<Left, LeftKeys<LeftKs...>,  //
+                                      Right, RightKeys<RightKs...>>& semi_join,
+                  Arena* arena) {
+    return SemiJoinToPhysical<false, Left, LeftKeys<LeftKs...>,  //
+                              Right, RightKeys<RightKs...>>()(
+        semi_join.left, semi_join.right, arena);
+  }
+};
+
+template <typename Left, std::size_t... LeftKs,  //
+          typename Right, std::size_t... RightKs>
+struct LogicalToPhysicalImpl<lra::AntiJoin<Left, LeftKeys<LeftKs...>,  //
+                                           Right, RightKeys<RightKs...>>> {
+  auto operator()(const lra::AntiJoin<Left, LeftKeys<LeftKs...>,  //
+                                      Right, RightKeys<RightKs...>>& anti_join,
+                  Arena* arena) {
+    return SemiJoinToPhysical<true, Left, LeftKeys<LeftKs...>,  //
+                              Right, RightKeys<RightKs...>>()(
+        anti_join.left, anti_join.right, arena);
+  }
+};
+
 template <typename AggregateImpl>
 struct IncrementAggregateImpl;
 
@@ -228,7 +468,8 @@ template <typename Logical, std::size_t... Ks, typename... Aggregates>
 struct LogicalToPhysicalImpl<
     lra::GroupBy<Logical, Keys<Ks...>, Aggregates...>> {
   auto operator()(
-      const lra::GroupBy<Logical, Keys<Ks...>, Aggregates...>& group_by) {
+      const lra::GroupBy<Logical, Keys<Ks...>, Aggregates...>& group_by,
+      Arena* arena) {
     using group = lra::GroupBy<Logical, Keys<Ks...>, Aggregates...>;
 
     using keys = Keys<1 + Ks...>;
@@ -244,9 +485,9 @@ struct LogicalToPhysicalImpl<
         typename TypeListCons<union_, incr_agg_impl_types>::type;
     using agg_impl_tuple = typename TypeListToTuple<union_agg_impl_types>::type;
 
-    auto child = Flatten(LogicalToPhysical(group_by.child));
-    auto grouped =
-        pra::make_group_by<keys, key_tuple, agg_impl_tuple>(std::move(child));
+    auto child = Flatten(LogicalToPhysical(group_by.child, arena));
+    auto grouped = pra::make_group_by<keys, key_tuple, agg_impl_tuple>(
+        std::move(child), arena);
     return pra::make_map(std::move(grouped), [](const auto& t) {
       auto keys = TupleTake<sizeof...(Ks)>(t);
       auto lineage = std::get<sizeof...(Ks)>(t);
@@ -256,13 +497,120 @@ struct LogicalToPhysicalImpl<
   }
 };
 
+// The physical TopK algorithms that LogicalToPhysical chooses between. If the
+// child of a TopK scans a collection, we use an IncrementalTopK, which keeps
+// its heaps across ticks and produces the collection's entries in place.
+// Otherwise, we use a TopK, which buffers `(t, lineage)` as the tuple
+// `(t[0], ..., t[n - 1], lineage)`, so that ties are broken by the columns of
+// `t` before its lineage.
+struct TopKTag {};
+struct IncrementalTopKTag {};
+
+template <typename Logical, std::size_t... Ks, std::size_t O, std::size_t K>
+struct LogicalToPhysicalImpl<lra::TopK<Logical, Keys<Ks...>, O, K>> {
+  using top_k_type = lra::TopK<Logical, Keys<Ks...>, O, K>;
+  using column_types = typename top_k_type::column_types;
+  using key_tuple = typename TypeListToTuple<
+      typename top_k_type::key_types>::type;
+  static constexpr std::size_t num_columns = TypeListLen<column_types>::value;
+
+  auto operator()(const top_k_type& top_k, Arena* arena) {
+    using tag = typename std::conditional<IsCollectionScan<Logical>::value,
+                                          IncrementalTopKTag, TopKTag>::type;
+    return TopK(top_k, arena, tag());
+  }
+
+ private:
+  auto TopK(const top_k_type& top_k, Arena* arena, TopKTag) {
+    using column_types_lineaged =
+        typename TypeListConcat<column_types,
+                                TypeList<std::set<LocalTupleId>>>::type;
+    using column_tuple_lineaged =
+        typename TypeListToTuple<column_types_lineaged>::type;
+
+    auto child = pra::make_map(
+        LogicalToPhysical(top_k.child, arena), [](auto&& pair) {
+          using pair_type = decltype(pair);
+          std::set<LocalTupleId> lineage =
+              std::get<1>(std::forward<pair_type>(pair));
+          return std::tuple_cat(
+              TupleView(std::get<0>(std::forward<pair_type>(pair))),
+              std::make_tuple(std::move(lineage)));
+        });
+    auto top = pra::make_top_k<Keys<Ks...>, O, K, key_tuple,
+                               column_tuple_lineaged>(std::move(child), arena);
+    return pra::make_map(std::move(top), [](const auto& t) {
+      using indexes = typename SizetListRange<0, num_columns>::type;
+      std::set<LocalTupleId> lineage = std::get<num_columns>(t);
+      return std::make_tuple(TupleProjectViewBySizetList<indexes>(t),
+                             std::move(lineage));
+    });
+  }
+
+  auto TopK(const top_k_type& top_k, Arena*, IncrementalTopKTag) {
+    const auto* collection = top_k.child.collection;
+    const std::string* collection_name = &collection->Name();
+    auto top = pra::make_incremental_top_k<Keys<Ks...>, O, K, key_tuple>(
+        &collection->Get(), &collection->Stats());
+    return pra::make_map(std::move(top), [collection_name](const auto* pair) {
+      using tuple_type = typename std::decay<decltype(pair->first)>::type;
+      const CollectionTupleIds& ids = pair->second;
+      LineageView lineage(collection_name, ids.hash,
+                          &ids.logical_times_inserted);
+      return std::tuple<const tuple_type&, LineageView>(pair->first, lineage);
+    });
+  }
+};
+
+// A Window's events are scanned in place, and its triggers are converted to
+// `(lineage, time)`. The lineage of every tuple a Window produces is the
+// lineage of the trigger that closed its window: the events of a window are
+// folded into its panes as they arrive and aren't remembered.
+template <typename Logical, typename Trigger, std::size_t... Ks, std::size_t T,
+          typename... Aggregates>
+struct LogicalToPhysicalImpl<
+    lra::Window<Logical, Trigger, Keys<Ks...>, T, Aggregates...>> {
+  using window_type =
+      lra::Window<Logical, Trigger, Keys<Ks...>, T, Aggregates...>;
+  using key_tuple =
+      typename TypeListToTuple<typename window_type::key_types>::type;
+  using agg_impl_tuple = typename TypeListToTuple<
+      typename window_type::aggregate_impl_types>::type;
+  using trigger_tuple = std::tuple<std::set<LocalTupleId>,
+                                   typename window_type::time_type>;
+  static constexpr std::size_t num_columns =
+      TypeListLen<typename window_type::column_types>::value;
+
+  auto operator()(const window_type& window, Arena* arena) {
+    auto events = pra::make_map(
+        LogicalToPhysical(window.child, arena), [](auto&& pair) {
+          using pair_type = decltype(pair);
+          return TupleView(std::get<0>(std::forward<pair_type>(pair)));
+        });
+    auto triggers = pra::make_map(
+        LogicalToPhysical(window.trigger, arena), [](auto&& pair) {
+          std::set<LocalTupleId> lineage = std::get<1>(pair);
+          return trigger_tuple(std::move(lineage),
+                               std::get<1>(std::get<0>(pair)));
+        });
+    auto windowed =
+        pra::make_window<Keys<Ks...>, T, 1, key_tuple, agg_impl_tuple,
+                         trigger_tuple>(std::move(events), std::move(triggers),
+                                        window.size, window.slide, arena);
+    return pra::make_map(std::move(windowed), [](const auto& t) {
+      std::set<LocalTupleId> lineage = std::get<0>(std::get<num_columns>(t));
+      return std::make_tuple(TupleTake<num_columns>(t), std::move(lineage));
+    });
+  }
+};
+
 template <typename Logical>
-auto LogicalToPhysical(const Logical& l) {
+auto LogicalToPhysical(const Logical& l, Arena* arena) {
   using logical_decayed = typename std::decay<Logical>::type;
   using is_logical = std::is_base_of<lra::LogicalRa, logical_decayed>;
   static_assert(StaticAssert<is_logical>::value, "");
 
-  auto p = LogicalToPhysicalImpl<logical_decayed>()(l);
+  auto p = LogicalToPhysicalImpl<logical_decayed>()(l, arena);
 
   using physical = decltype(p);
   using is_physical = std::is_base_of<pra::PhysicalRa, physical>;
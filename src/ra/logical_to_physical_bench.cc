@@ -0,0 +1,157 @@
+#include "ra/logical_to_physical.h"
+
+#include <cstddef>
+
+#include <map>
+#include <tuple>
+
+#include "benchmark/benchmark.h"
+#include "glog/logging.h"
+#include "range/v3/all.hpp"
+
+#include "collections/collection_tuple_ids.h"
+#include "collections/table.h"
+#include "ra/keys.h"
+#include "ra/logical/all.h"
+
+namespace lra = fluent::ra::logical;
+
+namespace fluent {
+namespace {
+
+using TableType = Table<std::size_t, std::size_t>;
+using TupleType = std::tuple<std::size_t, std::size_t>;
+
+// Every tuple is inserted at `num_times` logical times.
+void FillTable(std::size_t num_tuples, int num_times, TableType* t) {
+  for (std::size_t i = 0; i < num_tuples; ++i) {
+    for (int time = 0; time < num_times; ++time) {
+      t->Merge(TupleType(i, i), i, time);
+    }
+  }
+}
+
+}  // namespace
+
+// Scanning a collection's storage by hand, without any lineage.
+void CollectionScanBaselineBench(benchmark::State& state) {
+  TableType t("t", {{"x", "y"}});
+  FillTable(state.range(0), 1, &t);
+
+  while (state.KeepRunning()) {
+    for (const auto& pair : t.Get()) {
+      benchmark::DoNotOptimize(pair.first);
+      benchmark::DoNotOptimize(pair.second);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(CollectionScanBaselineBench)->Arg(10 << 10);
+
+void CollectionScanBench(benchmark::State& state) {
+  TableType t("t", {{"x", "y"}});
+  FillTable(state.range(0), 1, &t);
+
+  while (state.KeepRunning()) {
+    auto physical = ra::LogicalToPhysical(lra::make_collection(&t));
+    ranges::for_each(physical.ToRange(), [](const auto& tuple_and_lineage) {
+      benchmark::DoNotOptimize(std::get<0>(tuple_and_lineage));
+      benchmark::DoNotOptimize(std::get<1>(tuple_and_lineage));
+    });
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(CollectionScanBench)->Arg(10 << 10);
+
+// Scanning a meta collection by hand, yielding one tuple per logical time.
+void MetaCollectionScanBaselineBench(benchmark::State& state) {
+  TableType t("t", {{"x", "y"}});
+  FillTable(state.range(0), state.range(1), &t);
+
+  while (state.KeepRunning()) {
+    for (const auto& pair : t.Get()) {
+      for (int time : pair.second.logical_times_inserted) {
+        benchmark::DoNotOptimize(pair.first);
+        benchmark::DoNotOptimize(time);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          state.range(1));
+}
+BENCHMARK(MetaCollectionScanBaselineBench)->Args({10 << 10, 1});
+BENCHMARK(MetaCollectionScanBaselineBench)->Args({10 << 10, 4});
+
+void MetaCollectionScanBench(benchmark::State& state) {
+  TableType t("t", {{"x", "y"}});
+  FillTable(state.range(0), state.range(1), &t);
+
+  while (state.KeepRunning()) {
+    auto physical = ra::LogicalToPhysical(lra::make_meta_collection(&t));
+    ranges::for_each(physical.ToRange(), [](const auto& tuple_and_lineage) {
+      benchmark::DoNotOptimize(std::get<0>(tuple_and_lineage));
+      benchmark::DoNotOptimize(std::get<1>(tuple_and_lineage));
+    });
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          state.range(1));
+}
+BENCHMARK(MetaCollectionScanBench)->Args({10 << 10, 1});
+BENCHMARK(MetaCollectionScanBench)->Args({10 << 10, 4});
+
+// The join benchmarks below join a table `l` of `state.range(0)` tuples with a
+// table `r` of `state.range(1)` tuples. Every tuple `(i, i)` of `l` joins with
+// the tuple `(i, i)` of `r`, no matter which columns we join on, but the
+// columns we join on determine which physical join LogicalToPhysical picks.
+template <typename LeftKeys, typename RightKeys>
+void TableJoinBench(benchmark::State& state) {
+  TableType l("l", {{"x", "y"}});
+  TableType r("r", {{"x", "y"}});
+  FillTable(state.range(0), 1, &l);
+  FillTable(state.range(1), 1, &r);
+
+  while (state.KeepRunning()) {
+    auto logical = lra::make_hash_join<LeftKeys, RightKeys>(
+        lra::make_collection(&l), lra::make_collection(&r));
+    auto physical = ra::LogicalToPhysical(logical);
+    ranges::for_each(physical.ToRange(), [](const auto& tuple_and_lineage) {
+      benchmark::DoNotOptimize(std::get<0>(tuple_and_lineage));
+    });
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          (state.range(0) + state.range(1)));
+}
+
+// Both tables are sorted by `x`, so this is a MergeJoin.
+void MergeJoinSelectionBench(benchmark::State& state) {
+  TableJoinBench<ra::LeftKeys<0>, ra::RightKeys<0>>(state);
+}
+BENCHMARK(MergeJoinSelectionBench)
+    ->Args({1 << 4, 1 << 14})
+    ->Args({1 << 14, 1 << 14});
+
+// `r` isn't sorted by `y`, so this is a HashJoin.
+void HashJoinSelectionBench(benchmark::State& state) {
+  TableJoinBench<ra::LeftKeys<0>, ra::RightKeys<1>>(state);
+}
+BENCHMARK(HashJoinSelectionBench)
+    ->Args({1 << 4, 1 << 14})
+    ->Args({1 << 14, 1 << 14});
+
+// `l` isn't sorted by `y` but `r` is sorted by `x`, so this is an
+// IndexNestedLoopJoin.
+void IndexNestedLoopJoinSelectionBench(benchmark::State& state) {
+  TableJoinBench<ra::LeftKeys<1>, ra::RightKeys<0>>(state);
+}
+BENCHMARK(IndexNestedLoopJoinSelectionBench)
+    ->Args({1 << 4, 1 << 14})
+    ->Args({1 << 14, 1 << 14});
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -1,12 +1,18 @@
 #include "ra/logical_to_physical.h"
 
+#include <chrono>
 #include <set>
+#include <string>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
+#include "range/v3/all.hpp"
 
+#include "collections/periodic.h"
+#include "collections/scratch.h"
 #include "collections/table.h"
 #include "ra/logical/all.h"
 #include "ra/physical/all.h"
@@ -40,6 +46,25 @@ TEST(LogicalToPhysical, Collection) {
   ExpectRngsUnorderedEqual(physical.ToRange(), expected);
 }
 
+TEST(LogicalToPhysical, CollectionScanDoesNotCopy) {
+  Table<int> t("t", {{"x"}});
+  t.Merge({1}, 1, 42);
+  t.Merge({1}, 1, 43);
+  auto physical = ra::LogicalToPhysical(lra::make_collection(&t));
+  auto rng = physical.ToRange();
+  auto tuple_and_lineage = *ranges::begin(rng);
+  EXPECT_EQ(&t.Get().begin()->first, &std::get<0>(tuple_and_lineage));
+
+  auto meta_physical = ra::LogicalToPhysical(lra::make_meta_collection(&t));
+  int num_tuples = 0;
+  ranges::for_each(meta_physical.ToRange(), [&](const auto& tuple_and_id) {
+    const auto& t_and_id = std::get<0>(tuple_and_id);
+    EXPECT_EQ(&t.Get().begin()->first, &std::get<0>(t_and_id));
+    num_tuples++;
+  });
+  EXPECT_EQ(2, num_tuples);
+}
+
 TEST(LogicalToPhysical, MetaCollection) {
   Table<int> t("t", {{"x"}});
   t.Merge({1}, 1, 42);
@@ -191,6 +216,149 @@ TEST(LogicalToPhysical, HashJoin) {
   ExpectRngsUnorderedEqual(physical.ToRange(), expected);
 }
 
+TEST(LogicalToPhysical, SemiJoinAndAntiJoin) {
+  Table<int, std::string> t("t", {{"x", "y"}});
+  t.Merge({1, "a"}, 1, 42);
+  t.Merge({2, "b"}, 2, 42);
+  t.Merge({3, "c"}, 3, 42);
+
+  Table<int> r("r", {{"x"}});
+  r.Merge({1}, 10, 9001);
+  r.Merge({2}, 20, 9001);
+
+  // The right side of a join isn't part of the lineage of its output, so the
+  // right side can be any plan, not just a collection.
+  auto right = lra::make_collection(&r) | lra::map([](const auto& t) {
+                 return std::make_tuple(std::get<0>(t) + 1);
+               });
+  auto semi_join = lra::make_semi_join<ra::LeftKeys<0>, ra::RightKeys<0>>(
+      lra::make_collection(&t), right);
+  auto anti_join = lra::make_anti_join<ra::LeftKeys<0>, ra::RightKeys<0>>(
+      lra::make_collection(&t), right);
+  auto semi_physical = ra::LogicalToPhysical(semi_join);
+  auto anti_physical = ra::LogicalToPhysical(anti_join);
+  std::set<LocalTupleId> tups2 = {LocalTupleId{"t", std::size_t(2), 42}};
+  std::set<LocalTupleId> tups1 = {LocalTupleId{"t", std::size_t(1), 42}};
+  std::set<LocalTupleId> tups3 = {LocalTupleId{"t", std::size_t(3), 42}};
+  std::set<Lineaged<std::tuple<int, std::string>>> semi_expected = {
+      std::make_tuple(std::make_tuple(2, "b"), tups2),
+      std::make_tuple(std::make_tuple(3, "c"), tups3)};
+  std::set<Lineaged<std::tuple<int, std::string>>> anti_expected = {
+      std::make_tuple(std::make_tuple(1, "a"), tups1)};
+  ExpectRngsUnorderedEqual(semi_physical.ToRange(), semi_expected);
+  ExpectRngsUnorderedEqual(anti_physical.ToRange(), anti_expected);
+}
+
+TEST(LogicalToPhysical, JoinSelection) {
+  using t = lra::Collection<Table<int, std::string>>;
+  using r = lra::Collection<Table<int, char, float>>;
+  using s = lra::Collection<Table<std::string, int>>;
+  using i = lra::Iterable<std::vector<std::tuple<int>>>;
+  using l0 = ra::LeftKeys<0>;
+  using l1 = ra::LeftKeys<1>;
+  using r0 = ra::RightKeys<0>;
+  using r1 = ra::RightKeys<1>;
+
+  // Both sides are sorted by their keys.
+  EXPECT_TRUE((std::is_same<ra::JoinTag<t, l0, r, r0>::type,
+                            ra::MergeJoinTag>::value));
+  EXPECT_TRUE((std::is_same<ra::JoinTag<r, ra::LeftKeys<0, 1>, r,
+                                        ra::RightKeys<0, 1>>::type,
+                            ra::MergeJoinTag>::value));
+
+  // Only the right side is sorted by its keys.
+  EXPECT_TRUE((std::is_same<ra::JoinTag<i, l0, r, r0>::type,
+                            ra::IndexNestedLoopJoinTag>::value));
+  EXPECT_TRUE((std::is_same<ra::JoinTag<s, l1, r, r0>::type,
+                            ra::IndexNestedLoopJoinTag>::value));
+
+  // The right side isn't sorted by its keys.
+  EXPECT_TRUE((std::is_same<ra::JoinTag<t, l0, i, r0>::type,
+                            ra::HashJoinTag>::value));
+  EXPECT_TRUE((std::is_same<ra::JoinTag<t, l0, s, r1>::type,
+                            ra::HashJoinTag>::value));
+
+  // The key columns have different types.
+  EXPECT_TRUE((std::is_same<ra::JoinTag<t, l0, s, r0>::type,
+                            ra::HashJoinTag>::value));
+}
+
+TEST(LogicalToPhysical, MergeJoin) {
+  Table<int, int> t("t", {{"x", "y"}});
+  t.Merge({1, 1}, 1, 42);
+  t.Merge({1, 2}, 2, 42);
+  t.Merge({2, 3}, 3, 42);
+
+  Table<int, char> r("r", {{"x", "c"}});
+  r.Merge({0, 'a'}, 10, 9001);
+  r.Merge({1, 'b'}, 20, 9001);
+  r.Merge({1, 'c'}, 30, 9001);
+  r.Merge({1, 'c'}, 30, 9002);
+
+  auto logical = lra::make_hash_join<ra::LeftKeys<0>, ra::RightKeys<0>>(
+      lra::make_collection(&t), lra::make_collection(&r));
+  auto physical = ra::LogicalToPhysical(logical);
+  LocalTupleId tup1 = {"t", std::size_t(1), 42};
+  LocalTupleId tup2 = {"t", std::size_t(2), 42};
+  LocalTupleId tup3 = {"r", std::size_t(20), 9001};
+  LocalTupleId tup4 = {"r", std::size_t(30), 9001};
+  LocalTupleId tup5 = {"r", std::size_t(30), 9002};
+  std::set<LocalTupleId> tups1 = {tup1, tup3};
+  std::set<LocalTupleId> tups2 = {tup1, tup4, tup5};
+  std::set<LocalTupleId> tups3 = {tup2, tup3};
+  std::set<LocalTupleId> tups4 = {tup2, tup4, tup5};
+  std::set<Lineaged<std::tuple<int, int, int, char>>> expected = {
+      std::make_tuple(std::make_tuple(1, 1, 1, 'b'), tups1),
+      std::make_tuple(std::make_tuple(1, 1, 1, 'c'), tups2),
+      std::make_tuple(std::make_tuple(1, 2, 1, 'b'), tups3),
+      std::make_tuple(std::make_tuple(1, 2, 1, 'c'), tups4)};
+  ExpectRngsUnorderedEqual(physical.ToRange(), expected);
+}
+
+TEST(LogicalToPhysical, IndexNestedLoopJoin) {
+  std::vector<std::tuple<char, int>> xs = {{'a', 1}, {'b', 2}, {'c', 1}};
+
+  Table<int, float> r("r", {{"x", "y"}});
+  r.Merge({1, 1.0}, 10, 9001);
+  r.Merge({1, 2.0}, 20, 9001);
+  r.Merge({3, 3.0}, 30, 9001);
+
+  auto logical = lra::make_hash_join<ra::LeftKeys<1>, ra::RightKeys<0>>(
+      lra::make_iterable(&xs), lra::make_collection(&r));
+  auto physical = ra::LogicalToPhysical(logical);
+  std::set<LocalTupleId> tups1 = {{"r", std::size_t(10), 9001}};
+  std::set<LocalTupleId> tups2 = {{"r", std::size_t(20), 9001}};
+  std::set<Lineaged<std::tuple<char, int, int, float>>> expected = {
+      std::make_tuple(std::make_tuple('a', 1, 1, 1.0), tups1),
+      std::make_tuple(std::make_tuple('a', 1, 1, 2.0), tups2),
+      std::make_tuple(std::make_tuple('c', 1, 1, 1.0), tups1),
+      std::make_tuple(std::make_tuple('c', 1, 1, 2.0), tups2)};
+  ExpectRngsUnorderedEqual(physical.ToRange(), expected);
+}
+
+TEST(LogicalToPhysical, HashJoinOnUnsortedKeys) {
+  Table<int, int> t("t", {{"x", "y"}});
+  t.Merge({1, 10}, 1, 42);
+  t.Merge({2, 20}, 2, 42);
+
+  Table<int, int> r("r", {{"x", "y"}});
+  r.Merge({10, 1}, 10, 9001);
+  r.Merge({30, 2}, 20, 9001);
+
+  // `r` isn't sorted by its second column.
+  auto logical = lra::make_hash_join<ra::LeftKeys<0>, ra::RightKeys<1>>(
+      lra::make_collection(&t), lra::make_collection(&r));
+  auto physical = ra::LogicalToPhysical(logical);
+  std::set<LocalTupleId> tups1 = {{"t", std::size_t(1), 42},
+                                  {"r", std::size_t(10), 9001}};
+  std::set<LocalTupleId> tups2 = {{"t", std::size_t(2), 42},
+                                  {"r", std::size_t(20), 9001}};
+  std::set<Lineaged<std::tuple<int, int, int, int>>> expected = {
+      std::make_tuple(std::make_tuple(1, 10, 10, 1), tups1),
+      std::make_tuple(std::make_tuple(2, 20, 30, 2), tups2)};
+  ExpectRngsUnorderedEqual(physical.ToRange(), expected);
+}
+
 TEST(LogicalToPhysical, GroupBy) {
   Table<int, int> t("t", {{"x", "y"}});
   t.Merge({1, 10}, 100, 42);
@@ -219,6 +387,70 @@ TEST(LogicalToPhysical, GroupBy) {
   ExpectRngsUnorderedEqual(physical.ToRange(), expected);
 }
 
+TEST(LogicalToPhysical, TopK) {
+  Table<int, int> t("t", {{"x", "y"}});
+  t.Merge({1, 10}, 100, 42);
+  t.Merge({1, 20}, 200, 42);
+  t.Merge({1, 30}, 300, 42);
+  t.Merge({2, 40}, 400, 42);
+
+  // A TopK of a collection is incremental, and a TopK of anything else isn't.
+  // Both produce the same tuples with the same lineage.
+  auto incremental = ra::LogicalToPhysical(
+      lra::make_collection(&t) | lra::top_k<ra::Keys<0>, 1, 2>());
+  auto batch = ra::LogicalToPhysical(
+      lra::make_collection(&t) | lra::project<0, 1>() |
+      lra::top_k<ra::Keys<0>, 1, 2>());
+  std::set<LocalTupleId> tups2 = {LocalTupleId{"t", std::size_t(200), 42}};
+  std::set<LocalTupleId> tups3 = {LocalTupleId{"t", std::size_t(300), 42}};
+  std::set<LocalTupleId> tups4 = {LocalTupleId{"t", std::size_t(400), 42}};
+  std::set<Lineaged<std::tuple<int, int>>> expected = {
+      std::make_tuple(std::make_tuple(1, 20), tups2),
+      std::make_tuple(std::make_tuple(1, 30), tups3),
+      std::make_tuple(std::make_tuple(2, 40), tups4)};
+  ExpectRngsUnorderedEqual(incremental.ToRange(), expected);
+  ExpectRngsUnorderedEqual(batch.ToRange(), expected);
+  batch.Reset();
+
+  std::set<LocalTupleId> tups5 = {LocalTupleId{"t", std::size_t(500), 43}};
+  t.Merge({1, 50}, 500, 43);
+  expected = {std::make_tuple(std::make_tuple(1, 30), tups3),
+              std::make_tuple(std::make_tuple(1, 50), tups5),
+              std::make_tuple(std::make_tuple(2, 40), tups4)};
+  ExpectRngsUnorderedEqual(incremental.ToRange(), expected);
+  ExpectRngsUnorderedEqual(batch.ToRange(), expected);
+}
+
+TEST(LogicalToPhysical, Window) {
+  using Clock = std::chrono::system_clock;
+  using Time = std::chrono::time_point<Clock>;
+  Scratch<std::string, Time, int> events("events", {{"k", "time", "x"}});
+  Periodic<Clock> p("p", std::chrono::seconds(10));
+  auto physical = ra::LogicalToPhysical(
+      lra::make_collection(&events) |
+      lra::tumbling_window<ra::Keys<0>, 1, ra::agg::Sum<2>>(
+          lra::make_collection(&p), std::chrono::seconds(10)));
+
+  // Events are folded into the window as they arrive, and the window is
+  // produced once the periodic reaches its end.
+  events.Merge({"a", Time(std::chrono::seconds(1)), 1}, 1, 42);
+  events.Merge({"b", Time(std::chrono::seconds(2)), 2}, 2, 42);
+  ExpectRngsUnorderedEqual(physical.ToRange(),
+                           std::set<Lineaged<std::tuple<std::string, Time,
+                                                        int>>>{});
+  physical.Reset();
+  events.Tick();
+
+  events.Merge({"a", Time(std::chrono::seconds(3)), 4}, 3, 43);
+  p.Merge({0, Time(std::chrono::seconds(10))}, 100, 43);
+  const Time end(std::chrono::seconds(10));
+  std::set<LocalTupleId> tups = {LocalTupleId{"p", std::size_t(100), 43}};
+  std::set<Lineaged<std::tuple<std::string, Time, int>>> expected = {
+      std::make_tuple(std::make_tuple("a", end, 5), tups),
+      std::make_tuple(std::make_tuple("b", end, 2), tups)};
+  ExpectRngsUnorderedEqual(physical.ToRange(), expected);
+}
+
 }  // namespace fluent
 
 int main(int argc, char** argv) {
@@ -4,10 +4,16 @@
 #include "ra/physical/cross.h"
 #include "ra/physical/filter.h"
 #include "ra/physical/flat_map.h"
+#include "ra/physical/flat_map_view.h"
 #include "ra/physical/group_by.h"
 #include "ra/physical/hash_join.h"
+#include "ra/physical/index_nested_loop_join.h"
 #include "ra/physical/iterable.h"
 #include "ra/physical/map.h"
+#include "ra/physical/merge_join.h"
 #include "ra/physical/project.h"
+#include "ra/physical/semi_join.h"
+#include "ra/physical/top_k.h"
+#include "ra/physical/window.h"
 
 #endif  // RA_PHYSICAL_ALL_H_
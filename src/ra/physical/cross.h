@@ -3,11 +3,13 @@
 
 #include <tuple>
 #include <type_traits>
+#include <utility>
 
 #include "range/v3/all.hpp"
 
 #include "common/macros.h"
 #include "common/static_assert.h"
+#include "common/tuple_util.h"
 #include "ra/physical/physical_ra.h"
 
 namespace fluent {
@@ -25,13 +27,22 @@ class Cross : public PhysicalRa {
   DISALLOW_COPY_AND_ASSIGN(Cross);
   DEFAULT_MOVE_AND_ASSIGN(Cross);
 
+  // Crossed tuples are tuple views of the left and right tuples. See
+  // `TupleCatView` in common/tuple_util.h.
   auto ToRange() {
     return ranges::view::cartesian_product(left_.ToRange(), right_.ToRange()) |
-           ranges::view::transform([](const auto& t) {
-             return std::tuple_cat(std::get<0>(t), std::get<1>(t));
+           ranges::view::transform([](auto&& t) {
+             using pair = decltype(t);
+             return TupleCatView(std::get<0>(std::forward<pair>(t)),
+                                 std::get<1>(std::forward<pair>(t)));
            });
   }
 
+  void Reset() {
+    left_.Reset();
+    right_.Reset();
+  }
+
  private:
   Left left_;
   Right right_;
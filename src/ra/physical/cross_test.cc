@@ -1,6 +1,7 @@
 #include "ra/physical/cross.h"
 
 #include <set>
+#include <string>
 #include <tuple>
 
 #include "glog/logging.h"
@@ -36,6 +37,18 @@ TEST(Cross, NonEmptyCross) {
   ExpectRngsUnorderedEqual(cross.ToRange(), expected);
 }
 
+TEST(Cross, CrossDoesNotCopy) {
+  std::set<std::tuple<std::string>> xs = {{"a"}};
+  std::set<std::tuple<std::string>> ys = {{"b"}};
+  auto iterable_xs = pra::make_iterable(&xs);
+  auto iterable_ys = pra::make_iterable(&ys);
+  auto cross = pra::make_cross(std::move(iterable_xs), std::move(iterable_ys));
+  ranges::for_each(cross.ToRange(), [&xs, &ys](const auto& t) {
+    EXPECT_EQ(&std::get<0>(t), &std::get<0>(*xs.begin()));
+    EXPECT_EQ(&std::get<1>(t), &std::get<0>(*ys.begin()));
+  });
+}
+
 }  // namespace fluent
 
 int main(int argc, char** argv) {
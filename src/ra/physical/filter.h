@@ -24,6 +24,8 @@ class Filter : public PhysicalRa {
 
   auto ToRange() { return child_.ToRange() | ranges::view::filter(f_); }
 
+  void Reset() { child_.Reset(); }
+
  private:
   Ra child_;
   F f_;
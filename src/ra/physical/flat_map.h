@@ -30,6 +30,8 @@ class FlatMap : public PhysicalRa {
              });
   }
 
+  void Reset() { child_.Reset(); }
+
  private:
   Ra child_;
   F f_;
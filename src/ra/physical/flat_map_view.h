@@ -0,0 +1,64 @@
+#ifndef RA_PHYSICAL_FLAT_MAP_VIEW_H_
+#define RA_PHYSICAL_FLAT_MAP_VIEW_H_
+
+#include <type_traits>
+
+#include "range/v3/all.hpp"
+
+#include "common/macros.h"
+#include "common/static_assert.h"
+#include "ra/physical/physical_ra.h"
+
+namespace fluent {
+namespace ra {
+namespace physical {
+
+// A FlatMapView is a FlatMap whose function returns a range-v3 view instead of
+// a container. FlatMap stores the container returned for every tuple and then
+// iterates over it; a FlatMapView iterates over the returned view directly, so
+// nothing is buffered or allocated per tuple. The view returned by `f(t)` must
+// not refer to `t` or to any other temporary; it should refer to storage that
+// outlives the FlatMapView (e.g. the storage of a collection).
+//
+//   std::vector<std::tuple<std::vector<int>>> xs = {{{1, 2}}, {{3}}};
+//   auto iterable = make_iterable(&xs);
+//   auto flat_map = make_flat_map_view(std::move(iterable), [](const auto& t) {
+//     return ranges::view::all(std::get<0>(t));
+//   });
+//   flat_map.ToRange(); // 1, 2, 3
+template <typename Ra, typename F>
+class FlatMapView : public PhysicalRa {
+  static_assert(StaticAssert<std::is_base_of<PhysicalRa, Ra>>::value, "");
+
+ public:
+  FlatMapView(Ra child, F f) : child_(std::move(child)), f_(std::move(f)) {}
+  DISALLOW_COPY_AND_ASSIGN(FlatMapView);
+  DEFAULT_MOVE_AND_ASSIGN(FlatMapView);
+
+  auto ToRange() {
+    return child_.ToRange()  //
+           | ranges::view::for_each([this](const auto& t) {
+               return ranges::yield_from(f_(t));
+             });
+  }
+
+  void Reset() { child_.Reset(); }
+
+ private:
+  Ra child_;
+  F f_;
+};
+
+template <typename Ra, typename F,
+          typename RaDecayed = typename std::decay<Ra>::type,
+          typename FDecayed = typename std::decay<F>::type>
+FlatMapView<RaDecayed, FDecayed> make_flat_map_view(Ra&& child, F&& f) {
+  return FlatMapView<RaDecayed, FDecayed>(std::forward<Ra>(child),
+                                          std::forward<F>(f));
+}
+
+}  // namespace physical
+}  // namespace ra
+}  // namespace fluent
+
+#endif  // RA_PHYSICAL_FLAT_MAP_VIEW_H_
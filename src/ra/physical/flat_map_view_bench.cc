@@ -0,0 +1,84 @@
+#include "ra/physical/flat_map_view.h"
+
+#include <cstddef>
+
+#include <tuple>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "glog/logging.h"
+#include "range/v3/all.hpp"
+
+#include "ra/physical/flat_map.h"
+#include "ra/physical/iterable.h"
+
+namespace pra = fluent::ra::physical;
+
+namespace fluent {
+namespace {
+
+using Ints = std::vector<std::tuple<std::size_t>>;
+
+std::vector<std::tuple<Ints>> MakeTuples(std::size_t n) {
+  std::vector<std::tuple<Ints>> ts(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t j = 0; j < i % 4; ++j) {
+      std::get<0>(ts[i]).push_back(std::tuple<std::size_t>(j));
+    }
+  }
+  return ts;
+}
+
+}  // namespace
+
+void FlatMapViewBaselineBench(benchmark::State& state) {
+  const std::vector<std::tuple<Ints>> ts = MakeTuples(state.range(0));
+  while (state.KeepRunning()) {
+    for (const std::tuple<Ints>& t : ts) {
+      for (const std::tuple<std::size_t>& x : std::get<0>(t)) {
+        benchmark::DoNotOptimize(x);
+      }
+    }
+  }
+}
+BENCHMARK(FlatMapViewBaselineBench)->Arg(10 << 10);
+
+void FlatMapViewBench(benchmark::State& state) {
+  const std::vector<std::tuple<Ints>> ts = MakeTuples(state.range(0));
+  while (state.KeepRunning()) {
+    auto iter = pra::make_iterable(&ts);
+    auto f = [](const std::tuple<Ints>& t) {
+      return ranges::view::all(std::get<0>(t));
+    };
+    auto flat_map = pra::make_flat_map_view(std::move(iter), f);
+    auto rng = flat_map.ToRange();
+    ranges::for_each(rng, [](const std::tuple<std::size_t>& t) {
+      benchmark::DoNotOptimize(t);
+    });
+  }
+}
+BENCHMARK(FlatMapViewBench)->Arg(10 << 10);
+
+// The same flat map using FlatMap, which copies every returned vector.
+void FlatMapCopyBench(benchmark::State& state) {
+  const std::vector<std::tuple<Ints>> ts = MakeTuples(state.range(0));
+  while (state.KeepRunning()) {
+    auto iter = pra::make_iterable(&ts);
+    auto f = [](const std::tuple<Ints>& t) { return std::get<0>(t); };
+    auto flat_map = pra::make_flat_map<Ints>(std::move(iter), f);
+    auto rng = flat_map.ToRange();
+    ranges::for_each(rng, [](const std::tuple<std::size_t>& t) {
+      benchmark::DoNotOptimize(t);
+    });
+  }
+}
+BENCHMARK(FlatMapCopyBench)->Arg(10 << 10);
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
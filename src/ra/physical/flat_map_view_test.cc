@@ -0,0 +1,65 @@
+#include "ra/physical/flat_map_view.h"
+
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "range/v3/all.hpp"
+
+#include "ra/physical/iterable.h"
+#include "testing/test_util.h"
+
+namespace pra = fluent::ra::physical;
+
+namespace fluent {
+namespace {
+
+using Ints = std::vector<std::tuple<int>>;
+
+auto ints_view = [](const std::tuple<Ints>& t) {
+  return ranges::view::all(std::get<0>(t));
+};
+
+}  // namespace
+
+TEST(FlatMapView, EmptyFlatMapViewSource) {
+  std::vector<std::tuple<Ints>> xs;
+  auto iterable = pra::make_iterable(&xs);
+  auto flat_map = pra::make_flat_map_view(std::move(iterable), ints_view);
+  std::multiset<std::tuple<int>> expected;
+  ExpectRngsUnorderedEqual(flat_map.ToRange(), expected);
+}
+
+TEST(FlatMapView, EmptyFlatMapViewReturn) {
+  std::vector<std::tuple<Ints>> xs = {Ints{}, Ints{}, Ints{}};
+  auto iterable = pra::make_iterable(&xs);
+  auto flat_map = pra::make_flat_map_view(std::move(iterable), ints_view);
+  std::multiset<std::tuple<int>> expected;
+  ExpectRngsUnorderedEqual(flat_map.ToRange(), expected);
+}
+
+TEST(FlatMapView, NonEmptyFlatMapView) {
+  std::vector<std::tuple<Ints>> xs = {Ints{{0}, {0}}, Ints{}, Ints{{1}, {2}}};
+  auto iterable = pra::make_iterable(&xs);
+  auto flat_map = pra::make_flat_map_view(std::move(iterable), ints_view);
+  std::multiset<std::tuple<int>> expected = {{0}, {0}, {1}, {2}};
+  ExpectRngsUnorderedEqual(flat_map.ToRange(), expected);
+}
+
+TEST(FlatMapView, YieldsReferencesIntoSource) {
+  std::vector<std::tuple<Ints>> xs = {Ints{{0}, {1}}};
+  auto iterable = pra::make_iterable(&xs);
+  auto flat_map = pra::make_flat_map_view(std::move(iterable), ints_view);
+  auto rng = flat_map.ToRange();
+  EXPECT_EQ(&*ranges::begin(rng), &std::get<0>(xs[0])[0]);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,11 +1,14 @@
 #ifndef RA_PHYSICAL_GROUP_BY_H_
 #define RA_PHYSICAL_GROUP_BY_H_
 
+#include <functional>
 #include <map>
 #include <type_traits>
+#include <utility>
 
 #include "range/v3/all.hpp"
 
+#include "common/arena.h"
 #include "common/macros.h"
 #include "common/static_assert.h"
 #include "common/tuple_util.h"
@@ -29,7 +32,11 @@ class GroupBy<Ra, Keys<Ks...>, KeyColumnTuple, AggregateImplTuple>
   static_assert(StaticAssert<IsTuple<AggregateImplTuple>>::value, "");
 
  public:
-  explicit GroupBy(Ra child) : child_(std::move(child)) {}
+  // `groups_` is allocated from `arena`, or from the heap if `arena` is null.
+  // See common/arena.h.
+  explicit GroupBy(Ra child, Arena* arena = nullptr)
+      : child_(std::move(child)),
+        groups_(ArenaAllocator<typename Groups::value_type>(arena)) {}
   DISALLOW_COPY_AND_ASSIGN(GroupBy);
   DEFAULT_MOVE_AND_ASSIGN(GroupBy);
 
@@ -50,6 +57,14 @@ class GroupBy<Ra, Keys<Ks...>, KeyColumnTuple, AggregateImplTuple>
            });
   }
 
+  // Release the groups built by the last call to `ToRange`. The groups are
+  // released back to the arena, so `Reset` must be called before the arena is
+  // reset.
+  void Reset() {
+    groups_.clear();
+    child_.Reset();
+  }
+
  private:
   template <template <typename, typename> class AggregateImpl,  //
             typename Columns, typename Ts, typename... Us>
@@ -57,16 +72,21 @@ class GroupBy<Ra, Keys<Ks...>, KeyColumnTuple, AggregateImplTuple>
     agg->Update(TupleProjectBySizetList<Columns>(t));
   }
 
+  using Groups =
+      std::map<KeyColumnTuple, AggregateImplTuple, std::less<KeyColumnTuple>,
+               ArenaAllocator<std::pair<const KeyColumnTuple,
+                                        AggregateImplTuple>>>;
+
   Ra child_;
-  std::map<KeyColumnTuple, AggregateImplTuple> groups_;
+  Groups groups_;
 };
 
 template <typename Keys, typename KeyColumnTuple, typename AggregateImplTuple,
           typename Ra, typename RaDecayed = typename std::decay<Ra>::type>
 GroupBy<RaDecayed, Keys, KeyColumnTuple, AggregateImplTuple> make_group_by(
-    Ra&& ra) {
+    Ra&& ra, Arena* arena = nullptr) {
   return GroupBy<RaDecayed, Keys, KeyColumnTuple, AggregateImplTuple>(
-      std::forward<Ra>(ra));
+      std::forward<Ra>(ra), arena);
 }
 
 }  // namespace physical
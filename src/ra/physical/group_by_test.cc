@@ -7,6 +7,7 @@
 #include "gtest/gtest.h"
 #include "range/v3/all.hpp"
 
+#include "common/arena.h"
 #include "common/sizet_list.h"
 #include "common/type_list.h"
 #include "ra/aggregates.h"
@@ -191,6 +192,25 @@ TEST(GroupBy, EmptyChildNoKeys) {
   ExpectRngsUnorderedEqual(group_by.ToRange(), expected);
 }
 
+TEST(GroupBy, ResetAndReuse) {
+  Arena arena;
+  std::set<std::tuple<int, int>> xs = {{1, 1}, {1, 2}, {2, 3}};
+  auto it = pra::make_iterable(&xs);
+  using keys = ra::Keys<0>;
+  using key_tuple = std::tuple<int>;
+  using agg_impls = std::tuple<ra::agg::CountImpl<SizetList<1>, TypeList<int>>>;
+  auto group_by =
+      pra::make_group_by<keys, key_tuple, agg_impls>(std::move(it), &arena);
+  std::set<std::tuple<int, std::size_t>> expected = {{1, 2}, {2, 1}};
+  ExpectRngsUnorderedEqual(group_by.ToRange(), expected);
+  group_by.Reset();
+  arena.Reset();
+
+  xs.erase({1, 1});
+  expected = {{1, 1}, {2, 1}};
+  ExpectRngsUnorderedEqual(group_by.ToRange(), expected);
+}
+
 }  // namespace fluent
 
 int main(int argc, char** argv) {
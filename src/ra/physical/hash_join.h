@@ -1,12 +1,15 @@
 #ifndef RA_PHYSICAL_HASH_JOIN_H_
 #define RA_PHYSICAL_HASH_JOIN_H_
 
+#include <functional>
 #include <map>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "range/v3/all.hpp"
 
+#include "common/arena.h"
 #include "common/macros.h"
 #include "common/static_assert.h"
 #include "common/tuple_util.h"
@@ -32,8 +35,12 @@ class HashJoin<Left, LeftKeys<LeftKs...>, Right, RightKeys<RightKs...>,
   static_assert(StaticAssert<IsTuple<LeftKeyColumnTuple>>::value, "");
 
  public:
-  HashJoin(Left left, Right right)
-      : left_(std::move(left)), right_(std::move(right)) {}
+  // `left_hash_` is allocated from `arena`, or from the heap if `arena` is
+  // null. See common/arena.h.
+  HashJoin(Left left, Right right, Arena* arena = nullptr)
+      : left_(std::move(left)),
+        right_(std::move(right)),
+        left_hash_(ArenaAllocator<typename LeftHash::value_type>(arena)) {}
   DISALLOW_COPY_AND_ASSIGN(HashJoin);
   DEFAULT_MOVE_AND_ASSIGN(HashJoin);
 
@@ -48,22 +55,51 @@ class HashJoin<Left, LeftKeys<LeftKs...>, Right, RightKeys<RightKs...>,
       using key_matches = std::is_convertible<key, LeftKeyColumnTuple>;
       static_assert(StaticAssert<column_matches>::value, "");
       static_assert(StaticAssert<key_matches>::value, "");
-      left_hash_[std::move(keys)].push_back(t);
+      auto it = left_hash_.find(keys);
+      if (it == left_hash_.end()) {
+        LeftTuples lefts(left_hash_.get_allocator());
+        it = left_hash_.emplace(std::move(keys), std::move(lefts)).first;
+      }
+      it->second.push_back(t);
     });
 
-    return ranges::view::for_each(right_.ToRange(), [this](const auto& right) {
+    // Joined tuples are tuple views of the buffered left tuple and the right
+    // tuple. See `TupleCatView` in common/tuple_util.h.
+    return ranges::view::for_each(right_.ToRange(), [this](auto&& right) {
+      auto it = left_hash_.find(TupleProject<RightKs...>(right));
+      const LeftTuples& lefts = it == left_hash_.end() ? empty_ : it->second;
+      auto right_view = TupleView(std::forward<decltype(right)>(right));
+      using right_view_type = decltype(right_view);
       return ranges::yield_from(
-          ranges::view::all(left_hash_[TupleProject<RightKs...>(right)]) |
-          ranges::view::transform([right](const auto& left) {
-            return std::tuple_cat(left, right);
+          ranges::view::all(lefts) |
+          ranges::view::transform([right_view](const auto& left) {
+            // We pass a copy of `right_view` so that the joined tuple doesn't
+            // refer to this lambda.
+            return TupleCatView(left, right_view_type(right_view));
           }));
     });
   }
 
+  // Release the left tuples buffered by the last call to `ToRange`. The
+  // tuples are released back to the arena, so `Reset` must be called before
+  // the arena is reset.
+  void Reset() {
+    left_hash_.clear();
+    left_.Reset();
+    right_.Reset();
+  }
+
  private:
+  using LeftTuples =
+      std::vector<LeftColumnTuple, ArenaAllocator<LeftColumnTuple>>;
+  using LeftHash =
+      std::map<LeftKeyColumnTuple, LeftTuples, std::less<LeftKeyColumnTuple>,
+               ArenaAllocator<std::pair<const LeftKeyColumnTuple, LeftTuples>>>;
+
   Left left_;
   Right right_;
-  std::map<LeftKeyColumnTuple, std::vector<LeftColumnTuple>> left_hash_;
+  LeftHash left_hash_;
+  LeftTuples empty_;
 };
 
 template <typename LeftKeys, typename RightKeys, typename LeftColumnTuple,
@@ -72,10 +108,10 @@ template <typename LeftKeys, typename RightKeys, typename LeftColumnTuple,
           typename RightDecayed = typename std::decay<Right>::type>
 HashJoin<LeftDecayed, LeftKeys, RightDecayed, RightKeys, LeftColumnTuple,
          LeftKeyColumnTuple>
-make_hash_join(Left&& left, Right&& right) {
+make_hash_join(Left&& left, Right&& right, Arena* arena = nullptr) {
   return HashJoin<LeftDecayed, LeftKeys, RightDecayed, RightKeys,
                   LeftColumnTuple, LeftKeyColumnTuple>(
-      std::forward<Left>(left), std::forward<Right>(right));
+      std::forward<Left>(left), std::forward<Right>(right), arena);
 }
 
 }  // namespace physical
@@ -1,12 +1,14 @@
 #include "ra/physical/hash_join.h"
 
 #include <set>
+#include <string>
 #include <tuple>
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
 #include "range/v3/all.hpp"
 
+#include "common/arena.h"
 #include "ra/physical/iterable.h"
 #include "testing/test_util.h"
 
@@ -105,6 +107,47 @@ TEST(HashJoin, RepeatedColumnJoin) {
   ExpectRngsUnorderedEqual(hash_join.ToRange(), expected);
 }
 
+TEST(HashJoin, JoinDoesNotCopyRight) {
+  std::set<std::tuple<int>> left = {{1}};
+  std::set<std::tuple<int, std::string>> right = {{1, "a"}};
+  auto left_iterable = pra::make_iterable(&left);
+  auto right_iterable = pra::make_iterable(&right);
+  using left_keys = ra::LeftKeys<0>;
+  using right_keys = ra::RightKeys<0>;
+  using left_column_tuple = std::tuple<int>;
+  using left_key_column_tuple = std::tuple<int>;
+  auto hash_join = pra::make_hash_join<left_keys, right_keys, left_column_tuple,
+                                       left_key_column_tuple>(
+      std::move(left_iterable), std::move(right_iterable));
+  int num_joined = 0;
+  ranges::for_each(hash_join.ToRange(), [&right, &num_joined](const auto& t) {
+    EXPECT_EQ(&std::get<2>(t), &std::get<1>(*right.begin()));
+    num_joined++;
+  });
+  EXPECT_EQ(1, num_joined);
+}
+
+TEST(HashJoin, ResetAndReuse) {
+  Arena arena;
+  std::set<std::tuple<int>> left = {{1}, {2}};
+  std::set<std::tuple<int>> right = {{2}, {3}};
+  using left_keys = ra::LeftKeys<0>;
+  using right_keys = ra::RightKeys<0>;
+  using left_column_tuple = std::tuple<int>;
+  auto hash_join = pra::make_hash_join<left_keys, right_keys, left_column_tuple,
+                                       left_column_tuple>(
+      pra::make_iterable(&left), pra::make_iterable(&right), &arena);
+  std::set<std::tuple<int, int>> expected = {{2, 2}};
+  ExpectRngsUnorderedEqual(hash_join.ToRange(), expected);
+  hash_join.Reset();
+  arena.Reset();
+
+  // The join sees the new contents of its inputs.
+  left.insert({3});
+  expected = {{2, 2}, {3, 3}};
+  ExpectRngsUnorderedEqual(hash_join.ToRange(), expected);
+}
+
 }  // namespace fluent
 
 int main(int argc, char** argv) {
@@ -0,0 +1,86 @@
+#ifndef RA_PHYSICAL_INDEX_NESTED_LOOP_JOIN_H_
+#define RA_PHYSICAL_INDEX_NESTED_LOOP_JOIN_H_
+
+#include <cstddef>
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "range/v3/all.hpp"
+
+#include "common/macros.h"
+#include "common/static_assert.h"
+#include "common/tuple_util.h"
+#include "ra/keys.h"
+#include "ra/physical/index_util.h"
+#include "ra/physical/physical_ra.h"
+
+namespace fluent {
+namespace ra {
+namespace physical {
+
+// An IndexNestedLoopJoin joins the tuples of `left` with the entries of a
+// sorted index `right` (e.g. the std::map in which a collection stores its
+// tuples). The columns `LeftKs...` of a left tuple are joined with the first
+// `sizeof...(LeftKs)` columns of the keys of `right`. For every left tuple `l`
+// and every matching entry `r` in `right`, it produces the tuple view
+//
+//   (l[0], ..., l[n - 1], r.first[0], ..., r.first[m - 1], r.second)
+//
+// The matches of every left tuple are looked up in `right` (see
+// `IndexEqualRange`), so the join takes O(|left| log |right|) time and, unlike
+// a HashJoin, doesn't buffer anything.
+template <typename Left, typename LeftKeys, typename RightIndex>
+class IndexNestedLoopJoin;
+
+template <typename Left, std::size_t... LeftKs, typename RightIndex>
+class IndexNestedLoopJoin<Left, LeftKeys<LeftKs...>, RightIndex>
+    : public PhysicalRa {
+  static_assert(StaticAssert<std::is_base_of<PhysicalRa, Left>>::value, "");
+  static_assert(
+      StaticAssert<IsSeekableIndex<RightIndex, sizeof...(LeftKs)>>::value, "");
+
+ public:
+  IndexNestedLoopJoin(Left left, const RightIndex* right)
+      : left_(std::move(left)), right_(right) {}
+  DISALLOW_COPY_AND_ASSIGN(IndexNestedLoopJoin);
+  DEFAULT_MOVE_AND_ASSIGN(IndexNestedLoopJoin);
+
+  auto ToRange() {
+    return left_.ToRange() | ranges::view::for_each([this](auto&& left) {
+             auto left_view = TupleView(std::forward<decltype(left)>(left));
+             using left_view_type = decltype(left_view);
+             const auto matches = IndexEqualRange<sizeof...(LeftKs)>(
+                 *right_, TupleProjectView<LeftKs...>(left_view));
+             return ranges::yield_from(
+                 ranges::make_iterator_range(matches.first, matches.second) |
+                 ranges::view::transform([left_view](const auto& right) {
+                   // We pass a copy of `left_view` so that the joined tuple
+                   // doesn't refer to this lambda.
+                   return TupleCatView(left_view_type(left_view), right.first,
+                                       std::tie(right.second));
+                 }));
+           });
+  }
+
+  void Reset() { left_.Reset(); }
+
+ private:
+  Left left_;
+  const RightIndex* right_;
+};
+
+template <typename LeftKeys, typename Left, typename RightIndex,
+          typename LeftDecayed = typename std::decay<Left>::type>
+IndexNestedLoopJoin<LeftDecayed, LeftKeys, RightIndex>
+make_index_nested_loop_join(Left&& left, const RightIndex* right) {
+  return IndexNestedLoopJoin<LeftDecayed, LeftKeys, RightIndex>(
+      std::forward<Left>(left), right);
+}
+
+}  // namespace physical
+}  // namespace ra
+}  // namespace fluent
+
+#endif  // RA_PHYSICAL_INDEX_NESTED_LOOP_JOIN_H_
@@ -0,0 +1,87 @@
+#include "ra/physical/index_nested_loop_join.h"
+
+#include <cstddef>
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "glog/logging.h"
+#include "range/v3/all.hpp"
+
+#include "ra/keys.h"
+#include "ra/physical/hash_join.h"
+#include "ra/physical/iterable.h"
+
+namespace pra = fluent::ra::physical;
+namespace ra = fluent::ra;
+
+namespace fluent {
+
+// The outer relation has `state.range(0)` tuples and the inner relation has
+// `state.range(1)` tuples. Every outer tuple joins with one inner tuple.
+std::vector<std::tuple<std::size_t>> MakeOuter(std::size_t n,
+                                               std::size_t inner_size) {
+  std::vector<std::tuple<std::size_t>> outer(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    outer[i] = std::tuple<std::size_t>((i * 7919) % inner_size);
+  }
+  return outer;
+}
+
+void IndexNestedLoopJoinBench(benchmark::State& state) {
+  const std::vector<std::tuple<std::size_t>> outer =
+      MakeOuter(state.range(0), state.range(1));
+  std::map<std::tuple<std::size_t>, std::size_t> inner;
+  for (std::size_t i = 0; i < static_cast<std::size_t>(state.range(1)); ++i) {
+    inner[std::tuple<std::size_t>(i)] = i;
+  }
+
+  while (state.KeepRunning()) {
+    auto join = pra::make_index_nested_loop_join<ra::LeftKeys<0>>(
+        pra::make_iterable(&outer), &inner);
+    ranges::for_each(join.ToRange(),
+                     [](const auto& t) { benchmark::DoNotOptimize(t); });
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(IndexNestedLoopJoinBench)
+    ->Args({1 << 4, 1 << 16})
+    ->Args({1 << 10, 1 << 16})
+    ->Args({1 << 16, 1 << 16});
+
+// The same join as IndexNestedLoopJoinBench, computed by a HashJoin that has
+// to hash the inner relation every time.
+void IndexNestedLoopJoinHashJoinBench(benchmark::State& state) {
+  const std::vector<std::tuple<std::size_t>> outer =
+      MakeOuter(state.range(0), state.range(1));
+  std::vector<std::tuple<std::size_t, std::size_t>> inner(state.range(1));
+  for (std::size_t i = 0; i < inner.size(); ++i) {
+    inner[i] = std::tuple<std::size_t, std::size_t>(i, i);
+  }
+
+  while (state.KeepRunning()) {
+    using cols = std::tuple<std::size_t, std::size_t>;
+    using keys = std::tuple<std::size_t>;
+    auto join = pra::make_hash_join<ra::LeftKeys<0>, ra::RightKeys<0>, cols,
+                                    keys>(pra::make_iterable(&inner),
+                                          pra::make_iterable(&outer));
+    ranges::for_each(join.ToRange(),
+                     [](const auto& t) { benchmark::DoNotOptimize(t); });
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(IndexNestedLoopJoinHashJoinBench)
+    ->Args({1 << 4, 1 << 16})
+    ->Args({1 << 10, 1 << 16})
+    ->Args({1 << 16, 1 << 16});
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,85 @@
+#include "ra/physical/index_nested_loop_join.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "range/v3/all.hpp"
+
+#include "ra/keys.h"
+#include "ra/physical/iterable.h"
+#include "testing/test_util.h"
+
+namespace pra = fluent::ra::physical;
+
+namespace fluent {
+
+using Index = std::map<std::tuple<int, char>, int>;
+
+TEST(IndexNestedLoopJoin, EmptyEmptyJoin) {
+  std::vector<std::tuple<int>> left;
+  Index right;
+  auto join = pra::make_index_nested_loop_join<ra::LeftKeys<0>>(
+      pra::make_iterable(&left), &right);
+  std::vector<std::tuple<int, int, char, int>> expected;
+  ExpectRngsEqual(join.ToRange(), expected);
+}
+
+TEST(IndexNestedLoopJoin, RightEmptyJoin) {
+  std::vector<std::tuple<int>> left = {{1}, {2}};
+  Index right;
+  auto join = pra::make_index_nested_loop_join<ra::LeftKeys<0>>(
+      pra::make_iterable(&left), &right);
+  std::vector<std::tuple<int, int, char, int>> expected;
+  ExpectRngsEqual(join.ToRange(), expected);
+}
+
+TEST(IndexNestedLoopJoin, NonEmptyJoin) {
+  std::vector<std::tuple<float, int>> left = {
+      {1.0, 1}, {2.0, 3}, {3.0, 1}, {4.0, 5}};
+  Index right = {{{0, 'a'}, 10}, {{1, 'b'}, 11}, {{1, 'c'}, 12},
+                 {{3, 'd'}, 13}, {{4, 'e'}, 14}};
+  auto join = pra::make_index_nested_loop_join<ra::LeftKeys<1>>(
+      pra::make_iterable(&left), &right);
+  std::vector<std::tuple<float, int, int, char, int>> expected = {
+      {1.0, 1, 1, 'b', 11}, {1.0, 1, 1, 'c', 12}, {2.0, 3, 3, 'd', 13},
+      {3.0, 1, 1, 'b', 11}, {3.0, 1, 1, 'c', 12}};
+  ExpectRngsEqual(join.ToRange(), expected);
+}
+
+TEST(IndexNestedLoopJoin, MultiColumnJoin) {
+  std::vector<std::tuple<char, int>> left = {{'a', 1}, {'b', 1}, {'a', 2}};
+  Index right = {{{1, 'a'}, 10}, {{1, 'c'}, 11}, {{2, 'a'}, 12}};
+  auto join = pra::make_index_nested_loop_join<ra::LeftKeys<1, 0>>(
+      pra::make_iterable(&left), &right);
+  std::vector<std::tuple<char, int, int, char, int>> expected = {
+      {'a', 1, 1, 'a', 10}, {'a', 2, 2, 'a', 12}};
+  ExpectRngsEqual(join.ToRange(), expected);
+}
+
+TEST(IndexNestedLoopJoin, JoinDoesNotCopy) {
+  std::vector<std::tuple<int, std::string>> left = {{1, "a"}};
+  std::map<std::tuple<int>, std::string> right = {{{1}, "b"}};
+  auto join = pra::make_index_nested_loop_join<ra::LeftKeys<0>>(
+      pra::make_iterable(&left), &right);
+  int num_joined = 0;
+  ranges::for_each(join.ToRange(),
+                   [&left, &right, &num_joined](const auto& t) {
+                     EXPECT_EQ(&std::get<1>(t), &std::get<1>(left[0]));
+                     EXPECT_EQ(&std::get<3>(t), &right.begin()->second);
+                     num_joined++;
+                   });
+  EXPECT_EQ(num_joined, 1);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
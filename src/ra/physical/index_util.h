@@ -0,0 +1,135 @@
+#ifndef RA_PHYSICAL_INDEX_UTIL_H_
+#define RA_PHYSICAL_INDEX_UTIL_H_
+
+#include <cstddef>
+
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "common/sizet_list.h"
+#include "common/tuple_util.h"
+#include "common/type_list.h"
+
+// Collections store their tuples in a std::map ordered by the whole tuple, so
+// a collection is also a sorted index on every prefix of its columns: all the
+// tuples whose first `k` columns are equal to some key are adjacent in the
+// map. MergeJoin and IndexNestedLoopJoin use collections as indexes like this.
+// The helpers in this file find the tuples with a given key prefix.
+
+namespace fluent {
+namespace ra {
+namespace physical {
+
+namespace detail {
+
+template <typename T, typename Enable = void>
+struct ColumnLowerBoundImpl : public std::false_type {};
+
+template <typename T>
+struct ColumnLowerBoundImpl<
+    T, typename std::enable_if<std::is_integral<T>::value>::type>
+    : public std::true_type {
+  T operator()() const { return std::numeric_limits<T>::lowest(); }
+};
+
+template <typename T>
+struct ColumnLowerBoundImpl<
+    T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+    : public std::true_type {
+  T operator()() const { return -std::numeric_limits<T>::infinity(); }
+};
+
+template <>
+struct ColumnLowerBoundImpl<std::string> : public std::true_type {
+  std::string operator()() const { return ""; }
+};
+
+}  // namespace detail
+
+// `ColumnLowerBound<T>()()` returns the smallest value of type `T`.
+// `ColumnLowerBound<T>::value` is false for the types without one that we know
+// of. Looking up a key prefix in an index requires a lower bound for each of
+// the index's remaining columns. See `IndexEqualRange`.
+template <typename T>
+struct ColumnLowerBound : public detail::ColumnLowerBoundImpl<T> {};
+
+// `IsIndexPrefix<Keys<Ks...>>::value` is true if `Ks...` is `0, 1, ..., k-1`.
+template <typename Keys>
+struct IsIndexPrefix;
+
+template <std::size_t... Ks>
+struct IsIndexPrefix<SizetList<Ks...>>
+    : public std::is_same<
+          SizetList<Ks...>,
+          typename SizetListRange<0, sizeof...(Ks)>::type> {};
+
+// `IsSeekableIndex<Index, NumKeys>::value` is true if `IndexEqualRange` can
+// look up key prefixes of `NumKeys` columns in `Index`.
+template <typename Index, std::size_t NumKeys>
+struct IndexSuffixTypes {
+  using column_types =
+      typename TupleToTypeList<typename Index::key_type>::type;
+  using type = typename TypeListDrop<column_types, NumKeys>::type;
+};
+
+template <typename Index, std::size_t NumKeys>
+struct IsSeekableIndex
+    : public std::integral_constant<
+          bool, TypeListAll<typename IndexSuffixTypes<Index, NumKeys>::type,
+                            ColumnLowerBound>::value> {};
+
+// `IndexPrefix<NumKeys>(t)` is a tuple view of the first `NumKeys` columns of
+// `t`.
+template <std::size_t NumKeys, typename... Ts>
+auto IndexPrefix(const std::tuple<Ts...>& t) {
+  using prefix = typename SizetListRange<0, NumKeys>::type;
+  return TupleProjectViewBySizetList<prefix>(t);
+}
+
+// `IndexGroupEnd<NumKeys>(first, last, keys)` returns the first iterator in
+// [first, last) whose key prefix isn't `keys`.
+template <std::size_t NumKeys, typename Iterator, typename Keys>
+Iterator IndexGroupEnd(Iterator first, Iterator last, const Keys& keys) {
+  while (first != last && IndexPrefix<NumKeys>(first->first) == keys) {
+    ++first;
+  }
+  return first;
+}
+
+// `IndexEqualRange<NumKeys>(index, keys)` returns the range of entries in
+// `index` whose first `NumKeys` columns are equal to `keys`. It takes
+// O(log(n) + m) time where `n` is the size of the index and `m` is the size
+// of the range.
+template <std::size_t NumKeys, typename Index, typename Keys>
+std::pair<typename Index::const_iterator, typename Index::const_iterator>
+IndexEqualRange(const Index& index, const Keys& keys) {
+  static_assert(IsSeekableIndex<Index, NumKeys>::value,
+                "The columns of an index after its key prefix must have a "
+                "ColumnLowerBound.");
+  using key_type = typename Index::key_type;
+  using suffix_types = typename IndexSuffixTypes<Index, NumKeys>::type;
+  const key_type lower_bound(std::tuple_cat(
+      TupleView(keys), TypeListMapToTuple<suffix_types, ColumnLowerBound>()()));
+  auto first = index.lower_bound(lower_bound);
+  return {first, IndexGroupEnd<NumKeys>(first, index.end(), keys)};
+}
+
+// Whether looking up `num_lookups` keys in an index of size `index_size` with
+// `IndexEqualRange`, which costs roughly log2(index_size) comparisons per
+// lookup, is cheaper than scanning the whole index.
+inline bool ShouldSeek(std::size_t num_lookups, std::size_t index_size) {
+  std::size_t log2_index_size = 1;
+  while ((static_cast<std::size_t>(1) << log2_index_size) < index_size) {
+    log2_index_size++;
+  }
+  return num_lookups * log2_index_size < index_size;
+}
+
+}  // namespace physical
+}  // namespace ra
+}  // namespace fluent
+
+#endif  // RA_PHYSICAL_INDEX_UTIL_H_
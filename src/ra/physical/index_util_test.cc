@@ -0,0 +1,96 @@
+#include "ra/physical/index_util.h"
+
+#include <limits>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+namespace pra = fluent::ra::physical;
+
+namespace fluent {
+namespace {
+
+using Index = std::map<std::tuple<int, std::string, double>, int>;
+
+Index MakeIndex() {
+  return {{std::make_tuple(1, "a", -1.0), 0},
+          {std::make_tuple(1, "a", 1.0), 1},
+          {std::make_tuple(1, "b", 0.0), 2},
+          {std::make_tuple(2, "", 0.0), 3},
+          {std::make_tuple(2, "a", 0.0), 4},
+          {std::make_tuple(4, "a", 0.0), 5}};
+}
+
+template <typename Iterator>
+std::vector<int> Values(std::pair<Iterator, Iterator> range) {
+  std::vector<int> values;
+  for (auto it = range.first; it != range.second; ++it) {
+    values.push_back(it->second);
+  }
+  return values;
+}
+
+}  // namespace
+
+TEST(IndexUtil, ColumnLowerBound) {
+  EXPECT_EQ(std::numeric_limits<int>::lowest(), pra::ColumnLowerBound<int>()());
+  EXPECT_EQ(false, pra::ColumnLowerBound<bool>()());
+  EXPECT_EQ(-std::numeric_limits<double>::infinity(),
+            pra::ColumnLowerBound<double>()());
+  EXPECT_EQ("", pra::ColumnLowerBound<std::string>()());
+  EXPECT_FALSE(pra::ColumnLowerBound<std::vector<int>>::value);
+}
+
+TEST(IndexUtil, IsIndexPrefix) {
+  EXPECT_TRUE(pra::IsIndexPrefix<SizetList<>>::value);
+  EXPECT_TRUE(pra::IsIndexPrefix<SizetList<0>>::value);
+  EXPECT_TRUE((pra::IsIndexPrefix<SizetList<0, 1>>::value));
+  EXPECT_FALSE(pra::IsIndexPrefix<SizetList<1>>::value);
+  EXPECT_FALSE((pra::IsIndexPrefix<SizetList<1, 0>>::value));
+  EXPECT_FALSE((pra::IsIndexPrefix<SizetList<0, 2>>::value));
+}
+
+TEST(IndexUtil, IsSeekableIndex) {
+  EXPECT_TRUE((pra::IsSeekableIndex<Index, 0>::value));
+  EXPECT_TRUE((pra::IsSeekableIndex<Index, 3>::value));
+  using VectorIndex = std::map<std::tuple<int, std::vector<int>>, int>;
+  EXPECT_FALSE((pra::IsSeekableIndex<VectorIndex, 1>::value));
+  EXPECT_TRUE((pra::IsSeekableIndex<VectorIndex, 2>::value));
+}
+
+TEST(IndexUtil, IndexEqualRange) {
+  const Index index = MakeIndex();
+  using Ints = std::vector<int>;
+  EXPECT_EQ((Ints{0, 1, 2}),
+            Values(pra::IndexEqualRange<1>(index, std::make_tuple(1))));
+  EXPECT_EQ((Ints{3, 4}),
+            Values(pra::IndexEqualRange<1>(index, std::make_tuple(2))));
+  EXPECT_EQ(Ints{},
+            Values(pra::IndexEqualRange<1>(index, std::make_tuple(3))));
+  EXPECT_EQ((Ints{0, 1}), Values(pra::IndexEqualRange<2>(
+                              index, std::make_tuple(1, std::string("a")))));
+  EXPECT_EQ((Ints{3}), Values(pra::IndexEqualRange<2>(
+                           index, std::make_tuple(2, std::string("")))));
+  EXPECT_EQ((Ints{0, 1, 2, 3, 4, 5}),
+            Values(pra::IndexEqualRange<0>(index, std::make_tuple())));
+}
+
+TEST(IndexUtil, ShouldSeek) {
+  EXPECT_TRUE(pra::ShouldSeek(0, 1024));
+  EXPECT_TRUE(pra::ShouldSeek(1, 1024));
+  EXPECT_TRUE(pra::ShouldSeek(10, 1024));
+  EXPECT_FALSE(pra::ShouldSeek(1024, 1024));
+  EXPECT_FALSE(pra::ShouldSeek(1, 1));
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
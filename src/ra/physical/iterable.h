@@ -20,6 +20,8 @@ class Iterable : public PhysicalRa {
 
   auto ToRange() { return ranges::view::all(*container_); }
 
+  void Reset() {}
+
  private:
   const Container* container_;
 };
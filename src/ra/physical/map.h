@@ -24,6 +24,8 @@ class Map : public PhysicalRa {
 
   auto ToRange() { return child_.ToRange() | ranges::view::transform(f_); }
 
+  void Reset() { child_.Reset(); }
+
  private:
   Ra child_;
   F f_;
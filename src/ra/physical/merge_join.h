@@ -0,0 +1,144 @@
+#ifndef RA_PHYSICAL_MERGE_JOIN_H_
+#define RA_PHYSICAL_MERGE_JOIN_H_
+
+#include <cstddef>
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "range/v3/all.hpp"
+
+#include "common/macros.h"
+#include "common/tuple_util.h"
+#include "ra/physical/index_util.h"
+#include "ra/physical/physical_ra.h"
+
+namespace fluent {
+namespace ra {
+namespace physical {
+
+// A MergeJoin (see below) scans `left` once, and finds the matches of every key
+// of `left` in `right` using one of two strategies:
+//
+//   - STEP steps a cursor through `right`, so the join takes
+//     O(|left| + |right|) time.
+//   - SEEK looks up every key of `left` in `right` (see `IndexEqualRange`), so
+//     the join takes O(|left| log |right|) time. This is much faster when
+//     `left` is much smaller than `right`. SEEK is treated as STEP if `right`
+//     isn't seekable (see `IsSeekableIndex`).
+//
+// ADAPTIVE picks one of the two every time `ToRange` is called, based on the
+// current sizes of the indexes (see `ShouldSeek`).
+enum class MergeJoinStrategy { STEP, SEEK, ADAPTIVE };
+
+// A MergeJoin joins two sorted indexes (e.g. the std::maps in which
+// collections store their tuples) on the first `NumKeys` columns of their
+// keys. For every pair of entries `l` in `left` and `r` in `right` with equal
+// key prefixes, it produces the tuple view
+//
+//   (l.first[0], ..., l.first[n - 1], l.second,
+//    r.first[0], ..., r.first[m - 1], r.second)
+//
+// Both indexes are already sorted by their key prefixes, so unlike a HashJoin,
+// a MergeJoin doesn't have to build anything. See MergeJoinStrategy.
+template <typename LeftIndex, typename RightIndex, std::size_t NumKeys>
+class MergeJoin : public PhysicalRa {
+ public:
+  MergeJoin(const LeftIndex* left, const RightIndex* right,
+            MergeJoinStrategy strategy = MergeJoinStrategy::ADAPTIVE)
+      : left_(left), right_(right), strategy_(strategy), seek_(false) {}
+  DISALLOW_COPY_AND_ASSIGN(MergeJoin);
+  DEFAULT_MOVE_AND_ASSIGN(MergeJoin);
+
+  auto ToRange() {
+    seek_ = strategy_ == MergeJoinStrategy::SEEK ||
+            (strategy_ == MergeJoinStrategy::ADAPTIVE &&
+             ShouldSeek(left_->size(), right_->size()));
+    right_cursor_ = right_->begin();
+    group_left_ = nullptr;
+
+    return ranges::view::all(*left_) |
+           ranges::view::for_each([this](const LeftEntry& left) {
+             const RightRange matches = Matches(left);
+             const LeftEntry* l = &left;
+             return ranges::yield_from(
+                 ranges::make_iterator_range(matches.first, matches.second) |
+                 ranges::view::transform([l](const RightEntry& right) {
+                   return TupleCatView(l->first, std::tie(l->second),
+                                       right.first, std::tie(right.second));
+                 }));
+           });
+  }
+
+  void Reset() {}
+
+ private:
+  using LeftEntry = typename LeftIndex::value_type;
+  using RightEntry = typename RightIndex::value_type;
+  using RightIterator = typename RightIndex::const_iterator;
+  using RightRange = std::pair<RightIterator, RightIterator>;
+  using is_seekable = IsSeekableIndex<RightIndex, NumKeys>;
+
+  // The entries of `right` whose key prefix is equal to the key prefix of
+  // `left`. `Matches` must be called with the entries of `left` in order.
+  RightRange Matches(const LeftEntry& left) {
+    const auto keys = IndexPrefix<NumKeys>(left.first);
+
+    // Adjacent entries of `left` often have the same key prefix, in which case
+    // they have the same matches.
+    if (group_left_ != nullptr &&
+        IndexPrefix<NumKeys>(group_left_->first) == keys) {
+      return group_;
+    }
+
+    group_left_ = &left;
+    group_ = FindMatches(keys, is_seekable());
+    return group_;
+  }
+
+  template <typename Keys>
+  RightRange FindMatches(const Keys& keys, std::true_type /*is_seekable*/) {
+    if (seek_) {
+      return IndexEqualRange<NumKeys>(*right_, keys);
+    }
+    return FindMatches(keys, std::false_type());
+  }
+
+  template <typename Keys>
+  RightRange FindMatches(const Keys& keys, std::false_type /*is_seekable*/) {
+    while (right_cursor_ != right_->end() &&
+           IndexPrefix<NumKeys>(right_cursor_->first) < keys) {
+      ++right_cursor_;
+    }
+    return {right_cursor_,
+            IndexGroupEnd<NumKeys>(right_cursor_, right_->end(), keys)};
+  }
+
+  const LeftIndex* left_;
+  const RightIndex* right_;
+  MergeJoinStrategy strategy_;
+  bool seek_;
+
+  // When not seeking, `right_cursor_` points to the first entry of `right_`
+  // whose key prefix is not smaller than the last key prefix of `left_` that
+  // we looked up.
+  RightIterator right_cursor_;
+
+  // The matches of the last entry of `left_` that we looked up.
+  const LeftEntry* group_left_ = nullptr;
+  RightRange group_;
+};
+
+template <std::size_t NumKeys, typename LeftIndex, typename RightIndex>
+MergeJoin<LeftIndex, RightIndex, NumKeys> make_merge_join(
+    const LeftIndex* left, const RightIndex* right,
+    MergeJoinStrategy strategy = MergeJoinStrategy::ADAPTIVE) {
+  return MergeJoin<LeftIndex, RightIndex, NumKeys>(left, right, strategy);
+}
+
+}  // namespace physical
+}  // namespace ra
+}  // namespace fluent
+
+#endif  // RA_PHYSICAL_MERGE_JOIN_H_
@@ -0,0 +1,82 @@
+#include "ra/physical/merge_join.h"
+
+#include <cstddef>
+
+#include <map>
+#include <tuple>
+
+#include "benchmark/benchmark.h"
+#include "glog/logging.h"
+#include "range/v3/all.hpp"
+
+namespace pra = fluent::ra::physical;
+
+namespace fluent {
+
+using Index = std::map<std::tuple<std::size_t, std::size_t>, int>;
+
+// An index with `n` entries whose first columns are `0, stride, 2 * stride,
+// ..., (n - 1) * stride`.
+Index MakeIndex(std::size_t n, std::size_t stride) {
+  Index index;
+  for (std::size_t i = 0; i < n; ++i) {
+    index[std::tuple<std::size_t, std::size_t>(i * stride, i)] = 0;
+  }
+  return index;
+}
+
+// Merge join a left index of size `state.range(0)` with a right index of size
+// `state.range(1)`. The keys of the smaller index are spread evenly over the
+// keys of the larger one.
+void MergeJoinBench(benchmark::State& state,
+                    pra::MergeJoinStrategy strategy) {
+  const std::size_t left_size = state.range(0);
+  const std::size_t right_size = state.range(1);
+  const Index left = MakeIndex(
+      left_size, left_size < right_size ? right_size / left_size : 1);
+  const Index right = MakeIndex(
+      right_size, right_size < left_size ? left_size / right_size : 1);
+
+  while (state.KeepRunning()) {
+    auto merge_join = pra::make_merge_join<1>(&left, &right, strategy);
+    ranges::for_each(merge_join.ToRange(),
+                     [](const auto& t) { benchmark::DoNotOptimize(t); });
+  }
+  state.SetItemsProcessed(state.iterations() * (left_size + right_size));
+}
+
+void MergeJoinStepBench(benchmark::State& state) {
+  MergeJoinBench(state, pra::MergeJoinStrategy::STEP);
+}
+BENCHMARK(MergeJoinStepBench)
+    ->Args({1 << 4, 1 << 16})
+    ->Args({1 << 10, 1 << 16})
+    ->Args({1 << 16, 1 << 16})
+    ->Args({1 << 16, 1 << 4});
+
+void MergeJoinSeekBench(benchmark::State& state) {
+  MergeJoinBench(state, pra::MergeJoinStrategy::SEEK);
+}
+BENCHMARK(MergeJoinSeekBench)
+    ->Args({1 << 4, 1 << 16})
+    ->Args({1 << 10, 1 << 16})
+    ->Args({1 << 16, 1 << 16})
+    ->Args({1 << 16, 1 << 4});
+
+void MergeJoinAdaptiveBench(benchmark::State& state) {
+  MergeJoinBench(state, pra::MergeJoinStrategy::ADAPTIVE);
+}
+BENCHMARK(MergeJoinAdaptiveBench)
+    ->Args({1 << 4, 1 << 16})
+    ->Args({1 << 10, 1 << 16})
+    ->Args({1 << 16, 1 << 16})
+    ->Args({1 << 16, 1 << 4});
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
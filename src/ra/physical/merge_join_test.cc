@@ -0,0 +1,100 @@
+#include "ra/physical/merge_join.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "range/v3/all.hpp"
+
+#include "testing/test_util.h"
+
+namespace pra = fluent::ra::physical;
+
+namespace fluent {
+
+using Index = std::map<std::tuple<int, char>, int>;
+using Joined = std::tuple<int, char, int, int, char, int>;
+
+void ExpectMergeJoin(const Index& left, const Index& right,
+                     const std::set<Joined>& expected) {
+  // Every strategy must produce the same tuples in the same order.
+  for (pra::MergeJoinStrategy strategy :
+       {pra::MergeJoinStrategy::STEP, pra::MergeJoinStrategy::SEEK,
+        pra::MergeJoinStrategy::ADAPTIVE}) {
+    auto merge_join = pra::make_merge_join<1>(&left, &right, strategy);
+    ExpectRngsEqual(merge_join.ToRange(), expected);
+  }
+}
+
+TEST(MergeJoin, EmptyEmptyJoin) {
+  Index left;
+  Index right;
+  ExpectMergeJoin(left, right, {});
+}
+
+TEST(MergeJoin, LeftEmptyJoin) {
+  Index left;
+  Index right = {{{1, 'a'}, 1}, {{2, 'b'}, 2}};
+  ExpectMergeJoin(left, right, {});
+}
+
+TEST(MergeJoin, RightEmptyJoin) {
+  Index left = {{{1, 'a'}, 1}, {{2, 'b'}, 2}};
+  Index right;
+  ExpectMergeJoin(left, right, {});
+}
+
+TEST(MergeJoin, NonEmptyJoin) {
+  Index left = {{{1, 'a'}, 10}, {{1, 'b'}, 11}, {{2, 'c'}, 12},
+                {{4, 'd'}, 13}, {{6, 'e'}, 14}, {{6, 'f'}, 15}};
+  Index right = {{{0, 'z'}, 20}, {{1, 'y'}, 21}, {{1, 'x'}, 22},
+                 {{3, 'w'}, 23}, {{4, 'v'}, 24}, {{7, 'u'}, 25}};
+  std::set<Joined> expected = {
+      {1, 'a', 10, 1, 'x', 22}, {1, 'a', 10, 1, 'y', 21},
+      {1, 'b', 11, 1, 'x', 22}, {1, 'b', 11, 1, 'y', 21},
+      {4, 'd', 13, 4, 'v', 24},
+  };
+  ExpectMergeJoin(left, right, expected);
+}
+
+TEST(MergeJoin, MultiColumnJoin) {
+  Index left = {{{1, 'a'}, 10}, {{1, 'b'}, 11}, {{2, 'a'}, 12}};
+  Index right = {{{1, 'a'}, 20}, {{1, 'c'}, 21}, {{2, 'a'}, 22}};
+  auto merge_join = pra::make_merge_join<2>(&left, &right);
+  std::set<Joined> expected = {{1, 'a', 10, 1, 'a', 20},
+                               {2, 'a', 12, 2, 'a', 22}};
+  ExpectRngsEqual(merge_join.ToRange(), expected);
+}
+
+TEST(MergeJoin, RepeatedToRange) {
+  Index left = {{{1, 'a'}, 10}, {{2, 'b'}, 11}};
+  Index right = {{{1, 'c'}, 20}, {{2, 'd'}, 21}};
+  auto merge_join = pra::make_merge_join<1>(&left, &right);
+  std::set<Joined> expected = {{1, 'a', 10, 1, 'c', 20},
+                               {2, 'b', 11, 2, 'd', 21}};
+  ExpectRngsEqual(merge_join.ToRange(), expected);
+  ExpectRngsEqual(merge_join.ToRange(), expected);
+}
+
+TEST(MergeJoin, JoinDoesNotCopy) {
+  Index left = {{{1, 'a'}, 10}};
+  Index right = {{{1, 'b'}, 20}};
+  auto merge_join = pra::make_merge_join<1>(&left, &right);
+  auto rng = merge_join.ToRange();
+  auto joined = *ranges::begin(rng);
+  EXPECT_EQ(&std::get<0>(joined), &std::get<0>(left.begin()->first));
+  EXPECT_EQ(&std::get<2>(joined), &left.begin()->second);
+  EXPECT_EQ(&std::get<3>(joined), &std::get<0>(right.begin()->first));
+  EXPECT_EQ(&std::get<5>(joined), &right.begin()->second);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -5,6 +5,17 @@ namespace fluent {
 namespace ra {
 namespace physical {
 
+// Every physical operator has two methods:
+//
+//   - `ToRange()` returns a range-v3 range of the operator's output. It can be
+//     called any number of times, and every call reflects the current contents
+//     of the operator's inputs.
+//   - `Reset()` releases everything that the operator and its children
+//     buffered during the last call to `ToRange()` (e.g. the hash table of a
+//     HashJoin), keeping the operator ready for the next call to `ToRange()`.
+//
+// This lets an executor convert a logical plan into a physical plan once and
+// then run it on every tick.
 struct PhysicalRa {
   virtual ~PhysicalRa() {}
 };
@@ -2,6 +2,7 @@
 #define RA_PHYSICAL_PROJECT_H_
 
 #include <type_traits>
+#include <utility>
 
 #include "range/v3/all.hpp"
 
@@ -23,12 +24,16 @@ class Project : public PhysicalRa {
   DISALLOW_COPY_AND_ASSIGN(Project);
   DEFAULT_MOVE_AND_ASSIGN(Project);
 
+  // Projected tuples are tuple views of the child's tuples. See
+  // `TupleProjectView` in common/tuple_util.h.
   auto ToRange() {
-    return child_.ToRange() | ranges::view::transform([](const auto& t) {
-             return TupleProject<Is...>(t);
+    return child_.ToRange() | ranges::view::transform([](auto&& t) {
+             return TupleProjectView<Is...>(std::forward<decltype(t)>(t));
            });
   }
 
+  void Reset() { child_.Reset(); }
+
  private:
   Ra child_;
 };
@@ -1,6 +1,7 @@
 #include "ra/physical/project.h"
 
 #include <set>
+#include <string>
 #include <tuple>
 
 #include "glog/logging.h"
@@ -47,6 +48,15 @@ TEST(Project, RepeatedColumnsProject) {
   ExpectRngsUnorderedEqual(project.ToRange(), expected);
 }
 
+TEST(Project, ProjectDoesNotCopy) {
+  std::set<std::tuple<int, std::string>> xs = {{1, "a"}};
+  auto iterable = pra::make_iterable(&xs);
+  auto project = pra::make_project<1>(std::move(iterable));
+  ranges::for_each(project.ToRange(), [&xs](const auto& t) {
+    EXPECT_EQ(&std::get<0>(t), &std::get<1>(*xs.begin()));
+  });
+}
+
 }  // namespace fluent
 
 int main(int argc, char** argv) {
@@ -0,0 +1,141 @@
+#ifndef RA_PHYSICAL_SEMI_JOIN_H_
+#define RA_PHYSICAL_SEMI_JOIN_H_
+
+#include <cstddef>
+
+#include <functional>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+
+#include "range/v3/all.hpp"
+
+#include "common/arena.h"
+#include "common/hash_util.h"
+#include "common/macros.h"
+#include "common/static_assert.h"
+#include "common/tuple_util.h"
+#include "ra/keys.h"
+#include "ra/physical/physical_ra.h"
+
+namespace fluent {
+namespace ra {
+namespace physical {
+
+// A SemiJoin produces every tuple of `left` whose key columns `LeftKs` are
+// equal to the key columns `RightKs` of some tuple of `right`. If `Anti` is
+// true, it instead produces every tuple of `left` whose keys don't match the
+// keys of any tuple of `right` (i.e. it is an anti-join).
+//
+// The keys of the right tuples are buffered in a hash set and the left tuples
+// are streamed through it, so a SemiJoin takes time linear in the sizes of
+// its inputs and buffers only one `KeyColumnTuple` per distinct right key.
+// Every left tuple is produced at most once, as is.
+template <typename Left, typename LeftKeys, typename Right, typename RightKeys,
+          typename KeyColumnTuple, bool Anti>
+class SemiJoin;
+
+template <typename Left, std::size_t... LeftKs, typename Right,
+          std::size_t... RightKs, typename KeyColumnTuple, bool Anti>
+class SemiJoin<Left, LeftKeys<LeftKs...>, Right, RightKeys<RightKs...>,
+               KeyColumnTuple, Anti> : public PhysicalRa {
+  static_assert(StaticAssert<std::is_base_of<PhysicalRa, Left>>::value, "");
+  static_assert(StaticAssert<std::is_base_of<PhysicalRa, Right>>::value, "");
+  static_assert(StaticAssert<IsTuple<KeyColumnTuple>>::value, "");
+
+ public:
+  // `right_keys_` is allocated from `arena`, or from the heap if `arena` is
+  // null. See common/arena.h.
+  SemiJoin(Left left, Right right, Arena* arena = nullptr)
+      : left_(std::move(left)),
+        right_(std::move(right)),
+        right_keys_(MakeKeySet(arena)) {}
+  DISALLOW_COPY_AND_ASSIGN(SemiJoin);
+  DEFAULT_MOVE_AND_ASSIGN(SemiJoin);
+
+  auto ToRange() {
+    right_keys_.clear();
+    ranges::for_each(right_.ToRange(), [this](const auto& t) {
+      auto keys = TupleProject<RightKs...>(t);
+      using key = typename std::decay<decltype(keys)>::type;
+      using key_matches = std::is_convertible<key, KeyColumnTuple>;
+      static_assert(StaticAssert<key_matches>::value, "");
+      right_keys_.insert(KeyColumnTuple(std::move(keys)));
+    });
+
+    return left_.ToRange() |
+           ranges::view::filter([this](const auto& t) {
+             auto keys = TupleProject<LeftKs...>(t);
+             using key = typename std::decay<decltype(keys)>::type;
+             using key_matches = std::is_convertible<key, KeyColumnTuple>;
+             static_assert(StaticAssert<key_matches>::value, "");
+             const bool found =
+                 right_keys_.count(KeyColumnTuple(std::move(keys))) > 0;
+             return found != Anti;
+           });
+  }
+
+  // Release the right keys buffered by the last call to `ToRange`. The keys
+  // are released back to the arena, so `Reset` must be called before the
+  // arena is reset.
+  void Reset() {
+    // `clear` would keep the set's buckets, which are allocated from the
+    // arena too, so we replace the set with an empty one.
+    right_keys_ = MakeKeySet(right_keys_.get_allocator().arena());
+    left_.Reset();
+    right_.Reset();
+  }
+
+ private:
+  struct KeyHash {
+    std::size_t operator()(const KeyColumnTuple& keys) const {
+      return Hash<KeyColumnTuple>()(keys);
+    }
+  };
+
+  using KeySet =
+      std::unordered_set<KeyColumnTuple, KeyHash, std::equal_to<KeyColumnTuple>,
+                         ArenaAllocator<KeyColumnTuple>>;
+
+  static KeySet MakeKeySet(Arena* arena) {
+    return KeySet(0, KeyHash(), std::equal_to<KeyColumnTuple>(),
+                  ArenaAllocator<KeyColumnTuple>(arena));
+  }
+
+  Left left_;
+  Right right_;
+  KeySet right_keys_;
+};
+
+template <typename Left, typename LeftKeys, typename Right, typename RightKeys,
+          typename KeyColumnTuple>
+using AntiJoin =
+    SemiJoin<Left, LeftKeys, Right, RightKeys, KeyColumnTuple, true>;
+
+template <typename LeftKeys, typename RightKeys, typename KeyColumnTuple,
+          typename Left, typename Right,
+          typename LeftDecayed = typename std::decay<Left>::type,
+          typename RightDecayed = typename std::decay<Right>::type>
+SemiJoin<LeftDecayed, LeftKeys, RightDecayed, RightKeys, KeyColumnTuple, false>
+make_semi_join(Left&& left, Right&& right, Arena* arena = nullptr) {
+  return SemiJoin<LeftDecayed, LeftKeys, RightDecayed, RightKeys,
+                  KeyColumnTuple, false>(std::forward<Left>(left),
+                                         std::forward<Right>(right), arena);
+}
+
+template <typename LeftKeys, typename RightKeys, typename KeyColumnTuple,
+          typename Left, typename Right,
+          typename LeftDecayed = typename std::decay<Left>::type,
+          typename RightDecayed = typename std::decay<Right>::type>
+AntiJoin<LeftDecayed, LeftKeys, RightDecayed, RightKeys, KeyColumnTuple>
+make_anti_join(Left&& left, Right&& right, Arena* arena = nullptr) {
+  return AntiJoin<LeftDecayed, LeftKeys, RightDecayed, RightKeys,
+                  KeyColumnTuple>(std::forward<Left>(left),
+                                  std::forward<Right>(right), arena);
+}
+
+}  // namespace physical
+}  // namespace ra
+}  // namespace fluent
+
+#endif  // RA_PHYSICAL_SEMI_JOIN_H_
@@ -0,0 +1,136 @@
+#include "ra/physical/semi_join.h"
+
+#include <cstddef>
+
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "glog/logging.h"
+#include "range/v3/all.hpp"
+
+#include "ra/physical/cross.h"
+#include "ra/physical/filter.h"
+#include "ra/physical/iterable.h"
+
+namespace pra = fluent::ra::physical;
+namespace ra = fluent::ra;
+
+namespace fluent {
+namespace {
+
+using left_tuple = std::tuple<std::size_t, std::size_t>;
+using right_tuple = std::tuple<std::size_t>;
+
+// `n` left tuples (i, i) and `n / 2` right tuples (2i), so that half of the
+// left tuples have a match.
+void MakeInputs(std::size_t n, std::vector<left_tuple>* left,
+                std::vector<right_tuple>* right) {
+  for (std::size_t i = 0; i < n; ++i) {
+    left->push_back(left_tuple(i, i));
+  }
+  for (std::size_t i = 0; i < n / 2; ++i) {
+    right->push_back(right_tuple(2 * i));
+  }
+}
+
+}  // namespace
+
+// An anti-join written as a cross product and a filter, which is how an
+// anti-join had to be written before there was an AntiJoin: every left tuple
+// is compared with every right tuple.
+void CrossFilterAntiJoinBench(benchmark::State& state) {
+  std::vector<left_tuple> left;
+  std::vector<right_tuple> right;
+  MakeInputs(state.range(0), &left, &right);
+
+  while (state.KeepRunning()) {
+    auto cross = pra::make_cross(pra::make_iterable(&left),
+                                 pra::make_iterable(&right));
+    std::set<left_tuple> matched;
+    ranges::for_each(cross.ToRange(), [&matched](const auto& t) {
+      if (std::get<0>(t) == std::get<2>(t)) {
+        matched.insert(left_tuple(std::get<0>(t), std::get<1>(t)));
+      }
+    });
+    auto anti_join =
+        pra::make_filter(pra::make_iterable(&left), [&matched](const auto& t) {
+          return matched.count(t) == 0;
+        });
+    ranges::for_each(anti_join.ToRange(),
+                     [](const left_tuple& t) { benchmark::DoNotOptimize(t); });
+  }
+  state.SetItemsProcessed(state.iterations() * left.size());
+}
+BENCHMARK(CrossFilterAntiJoinBench)->Range(8, 8 << 8);
+
+// An anti-join written as a filter with a lambda that captures a std::set of
+// the right keys. This is fast, but invisible to the optimizer and lineage.
+void SetFilterAntiJoinBench(benchmark::State& state) {
+  std::vector<left_tuple> left;
+  std::vector<right_tuple> right;
+  MakeInputs(state.range(0), &left, &right);
+
+  while (state.KeepRunning()) {
+    std::set<std::size_t> keys;
+    for (const right_tuple& t : right) {
+      keys.insert(std::get<0>(t));
+    }
+    auto anti_join =
+        pra::make_filter(pra::make_iterable(&left), [&keys](const auto& t) {
+          return keys.count(std::get<0>(t)) == 0;
+        });
+    ranges::for_each(anti_join.ToRange(),
+                     [](const left_tuple& t) { benchmark::DoNotOptimize(t); });
+  }
+  state.SetItemsProcessed(state.iterations() * left.size());
+}
+BENCHMARK(SetFilterAntiJoinBench)->Range(8, 8 << 8);
+
+void SemiJoinBench(benchmark::State& state) {
+  std::vector<left_tuple> left;
+  std::vector<right_tuple> right;
+  MakeInputs(state.range(0), &left, &right);
+  using left_keys = ra::LeftKeys<0>;
+  using right_keys = ra::RightKeys<0>;
+  using keys = std::tuple<std::size_t>;
+  auto semi_join = pra::make_semi_join<left_keys, right_keys, keys>(
+      pra::make_iterable(&left), pra::make_iterable(&right));
+
+  while (state.KeepRunning()) {
+    ranges::for_each(semi_join.ToRange(),
+                     [](const left_tuple& t) { benchmark::DoNotOptimize(t); });
+    semi_join.Reset();
+  }
+  state.SetItemsProcessed(state.iterations() * left.size());
+}
+BENCHMARK(SemiJoinBench)->Range(8, 8 << 8);
+
+void AntiJoinBench(benchmark::State& state) {
+  std::vector<left_tuple> left;
+  std::vector<right_tuple> right;
+  MakeInputs(state.range(0), &left, &right);
+  using left_keys = ra::LeftKeys<0>;
+  using right_keys = ra::RightKeys<0>;
+  using keys = std::tuple<std::size_t>;
+  auto anti_join = pra::make_anti_join<left_keys, right_keys, keys>(
+      pra::make_iterable(&left), pra::make_iterable(&right));
+
+  while (state.KeepRunning()) {
+    ranges::for_each(anti_join.ToRange(),
+                     [](const left_tuple& t) { benchmark::DoNotOptimize(t); });
+    anti_join.Reset();
+  }
+  state.SetItemsProcessed(state.iterations() * left.size());
+}
+BENCHMARK(AntiJoinBench)->Range(8, 8 << 8);
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
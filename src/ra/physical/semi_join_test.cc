@@ -0,0 +1,116 @@
+#include "ra/physical/semi_join.h"
+
+#include <set>
+#include <string>
+#include <tuple>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "range/v3/all.hpp"
+
+#include "common/arena.h"
+#include "ra/physical/iterable.h"
+#include "testing/test_util.h"
+
+namespace pra = fluent::ra::physical;
+
+namespace fluent {
+
+void IntIntSemiJoin(const std::set<std::tuple<int>>& left,
+                    const std::set<std::tuple<int>>& right,
+                    const std::set<std::tuple<int>>& expected_semi,
+                    const std::set<std::tuple<int>>& expected_anti) {
+  using left_keys = ra::LeftKeys<0>;
+  using right_keys = ra::RightKeys<0>;
+  using key_column_tuple = std::tuple<int>;
+  auto semi_join =
+      pra::make_semi_join<left_keys, right_keys, key_column_tuple>(
+          pra::make_iterable(&left), pra::make_iterable(&right));
+  auto anti_join =
+      pra::make_anti_join<left_keys, right_keys, key_column_tuple>(
+          pra::make_iterable(&left), pra::make_iterable(&right));
+  ExpectRngsUnorderedEqual(semi_join.ToRange(), expected_semi);
+  ExpectRngsUnorderedEqual(anti_join.ToRange(), expected_anti);
+}
+
+TEST(SemiJoin, EmptyEmptyJoin) {
+  IntIntSemiJoin({}, {}, {}, {});
+}
+
+TEST(SemiJoin, RightEmptyJoin) {
+  IntIntSemiJoin({{1}, {2}, {3}}, {}, {}, {{1}, {2}, {3}});
+}
+
+TEST(SemiJoin, LeftEmptyJoin) {
+  IntIntSemiJoin({}, {{1}, {2}, {3}}, {}, {});
+}
+
+TEST(SemiJoin, NonEmptyJoin) {
+  IntIntSemiJoin({{1}, {2}, {3}, {4}}, {{2}, {4}, {6}}, {{2}, {4}},
+                 {{1}, {3}});
+}
+
+TEST(SemiJoin, ProducesEveryLeftTupleOnce) {
+  std::set<std::tuple<int, float>> left = {{1, 1.0}, {1, 2.0}, {2, 3.0},
+                                           {3, 4.0}};
+  std::set<std::tuple<int, char>> right = {{1, 'a'}, {1, 'b'}, {1, 'c'},
+                                           {2, 'd'}};
+  using left_keys = ra::LeftKeys<0>;
+  using right_keys = ra::RightKeys<0>;
+  using key_column_tuple = std::tuple<int>;
+  auto semi_join =
+      pra::make_semi_join<left_keys, right_keys, key_column_tuple>(
+          pra::make_iterable(&left), pra::make_iterable(&right));
+  std::multiset<std::tuple<int, float>> expected = {
+      {1, 1.0}, {1, 2.0}, {2, 3.0}};
+  ExpectRngsUnorderedEqual(semi_join.ToRange(), expected);
+}
+
+TEST(SemiJoin, MultiColumnJoin) {
+  std::set<std::tuple<int, std::string>> left = {
+      {1, "a"}, {2, "b"}, {3, "c"}};
+  std::set<std::tuple<std::string, int>> right = {{"a", 1}, {"b", 3}};
+  using left_keys = ra::LeftKeys<0, 1>;
+  using right_keys = ra::RightKeys<1, 0>;
+  using key_column_tuple = std::tuple<int, std::string>;
+  auto semi_join =
+      pra::make_semi_join<left_keys, right_keys, key_column_tuple>(
+          pra::make_iterable(&left), pra::make_iterable(&right));
+  auto anti_join =
+      pra::make_anti_join<left_keys, right_keys, key_column_tuple>(
+          pra::make_iterable(&left), pra::make_iterable(&right));
+  std::set<std::tuple<int, std::string>> expected_semi = {{1, "a"}};
+  std::set<std::tuple<int, std::string>> expected_anti = {{2, "b"},
+                                                          {3, "c"}};
+  ExpectRngsUnorderedEqual(semi_join.ToRange(), expected_semi);
+  ExpectRngsUnorderedEqual(anti_join.ToRange(), expected_anti);
+}
+
+TEST(SemiJoin, ResetAndReuse) {
+  Arena arena;
+  std::set<std::tuple<int>> left = {{1}, {2}, {3}};
+  std::set<std::tuple<int>> right = {{2}};
+  using left_keys = ra::LeftKeys<0>;
+  using right_keys = ra::RightKeys<0>;
+  using key_column_tuple = std::tuple<int>;
+  auto anti_join =
+      pra::make_anti_join<left_keys, right_keys, key_column_tuple>(
+          pra::make_iterable(&left), pra::make_iterable(&right), &arena);
+  std::set<std::tuple<int>> expected = {{1}, {3}};
+  ExpectRngsUnorderedEqual(anti_join.ToRange(), expected);
+  anti_join.Reset();
+  arena.Reset();
+
+  // The join sees the new contents of its inputs.
+  right.insert({3});
+  expected = {{1}};
+  ExpectRngsUnorderedEqual(anti_join.ToRange(), expected);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
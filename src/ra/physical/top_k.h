@@ -0,0 +1,297 @@
+#ifndef RA_PHYSICAL_TOP_K_H_
+#define RA_PHYSICAL_TOP_K_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "range/v3/all.hpp"
+
+#include "common/arena.h"
+#include "common/macros.h"
+#include "common/static_assert.h"
+#include "common/tuple_util.h"
+#include "common/type_traits.h"
+#include "ra/keys.h"
+#include "ra/physical/physical_ra.h"
+
+namespace fluent {
+namespace ra {
+namespace physical {
+namespace detail {
+
+// `TopKBefore<O>()(a, b)` is true if the tuple `a` ranks before the tuple `b`
+// in a TopK ordered by column `O`: if `a[O] > b[O]`, or if `a[O] == b[O]` and
+// `a > b`. A heap ordered by `TopKBefore` has the lowest ranked tuple at its
+// front.
+template <std::size_t O>
+struct TopKBefore {
+  template <typename T, typename U>
+  bool operator()(const T& a, const U& b) const {
+    const auto& a_o = std::get<O>(a);
+    const auto& b_o = std::get<O>(b);
+    if (b_o < a_o) {
+      return true;
+    }
+    if (a_o < b_o) {
+      return false;
+    }
+    return b < a;
+  }
+};
+
+}  // namespace detail
+
+// A TopK groups the tuples of its child by the key columns `Ks` and produces
+// the `K` tuples of every group that rank first when ordered by column `O`
+// (see `detail::TopKBefore`).
+//
+// Every group keeps a heap of at most `K` tuples whose front is the lowest
+// ranked tuple kept so far, so a TopK takes O(n log K) time and buffers at
+// most `K` tuples per group. A tuple that ranks below the front of a full heap
+// is dropped without being copied. Tuples are converted to `ColumnTuple`
+// before they are buffered. The tuples of a group are produced in no
+// particular order.
+template <typename Ra, typename Keys, std::size_t O, std::size_t K,
+          typename KeyColumnTuple, typename ColumnTuple>
+class TopK;
+
+template <typename Ra, std::size_t... Ks, std::size_t O, std::size_t K,
+          typename KeyColumnTuple, typename ColumnTuple>
+class TopK<Ra, Keys<Ks...>, O, K, KeyColumnTuple, ColumnTuple>
+    : public PhysicalRa {
+  static_assert(StaticAssert<std::is_base_of<PhysicalRa, Ra>>::value, "");
+  static_assert(StaticAssert<IsTuple<KeyColumnTuple>>::value, "");
+  static_assert(StaticAssert<IsTuple<ColumnTuple>>::value, "");
+  static_assert(K > 0, "");
+
+ public:
+  // `heaps_` is allocated from `arena`, or from the heap if `arena` is null.
+  // See common/arena.h.
+  explicit TopK(Ra child, Arena* arena = nullptr)
+      : child_(std::move(child)),
+        heaps_(ArenaAllocator<typename Heaps::value_type>(arena)) {}
+  DISALLOW_COPY_AND_ASSIGN(TopK);
+  DEFAULT_MOVE_AND_ASSIGN(TopK);
+
+  auto ToRange() {
+    heaps_.clear();
+
+    ranges::for_each(child_.ToRange(), [this](auto&& t) {
+      using tuple_type = decltype(t);
+      Heap* heap = FindOrInsertHeap(KeyColumnTuple(TupleProject<Ks...>(t)));
+      detail::TopKBefore<O> before;
+      if (heap->size() == K) {
+        if (!before(t, heap->front())) {
+          return;
+        }
+        std::pop_heap(heap->begin(), heap->end(), before);
+        heap->back() = ColumnTuple(std::forward<tuple_type>(t));
+      } else {
+        heap->push_back(ColumnTuple(std::forward<tuple_type>(t)));
+      }
+      std::push_heap(heap->begin(), heap->end(), before);
+    });
+
+    return ranges::view::for_each(heaps_, [](const auto& pair) {
+      return ranges::yield_from(ranges::view::all(pair.second));
+    });
+  }
+
+  // Release the heaps built by the last call to `ToRange`. The heaps are
+  // released back to the arena, so `Reset` must be called before the arena is
+  // reset.
+  void Reset() {
+    heaps_.clear();
+    child_.Reset();
+  }
+
+ private:
+  using Heap = std::vector<ColumnTuple, ArenaAllocator<ColumnTuple>>;
+  using Heaps =
+      std::map<KeyColumnTuple, Heap, std::less<KeyColumnTuple>,
+               ArenaAllocator<std::pair<const KeyColumnTuple, Heap>>>;
+
+  Heap* FindOrInsertHeap(KeyColumnTuple keys) {
+    auto iter = heaps_.find(keys);
+    if (iter == heaps_.end()) {
+      Heap heap(ArenaAllocator<ColumnTuple>(heaps_.get_allocator().arena()));
+      heap.reserve(K);
+      iter = heaps_.emplace(std::move(keys), std::move(heap)).first;
+    }
+    return &iter->second;
+  }
+
+  Ra child_;
+  Heaps heaps_;
+};
+
+template <typename Keys, std::size_t O, std::size_t K, typename KeyColumnTuple,
+          typename ColumnTuple, typename Ra,
+          typename RaDecayed = typename std::decay<Ra>::type>
+TopK<RaDecayed, Keys, O, K, KeyColumnTuple, ColumnTuple> make_top_k(
+    Ra&& ra, Arena* arena = nullptr) {
+  return TopK<RaDecayed, Keys, O, K, KeyColumnTuple, ColumnTuple>(
+      std::forward<Ra>(ra), arena);
+}
+
+// An IncrementalTopK is a TopK over a sorted index (e.g. the std::map in which
+// a collection stores its tuples) whose heaps are kept across calls to
+// `ToRange`, so that a rule that runs every tick doesn't rank the whole index
+// every tick. It produces pointers to the entries (i.e. the
+// `(tuple, CollectionTupleIds)` pairs) of `index` whose tuples a TopK would
+// produce.
+//
+// The heaps hold pointers to the entries of `index`, which stay valid for as
+// long as the entries aren't erased. Every call to `ToRange` checks whether
+// `index` has changed since the last call:
+//
+//   - If no tuple has been deleted (see `CollectionStats::NumDeletedTotal`) or
+//     inserted, the heaps are reused as they are.
+//   - If no tuple has been deleted, only the entries inserted at a logical
+//     time later than every entry seen before are pushed into the heaps. If
+//     that doesn't account for every new entry (e.g. a tuple merged at the
+//     end of a tick with an earlier logical time), the heaps are rebuilt.
+//   - If a tuple has been deleted, the heaps are rebuilt from scratch.
+//
+// Finding the new entries is a scan of the index that compares one int per
+// entry, which is much cheaper than ranking every tuple again. The heaps are
+// allocated from the heap, not from an arena, and `Reset` doesn't release
+// them.
+template <typename Index, typename Stats, typename Keys, std::size_t O,
+          std::size_t K, typename KeyColumnTuple>
+class IncrementalTopK;
+
+template <typename Index, typename Stats, std::size_t... Ks, std::size_t O,
+          std::size_t K, typename KeyColumnTuple>
+class IncrementalTopK<Index, Stats, Keys<Ks...>, O, K, KeyColumnTuple>
+    : public PhysicalRa {
+  static_assert(StaticAssert<IsTuple<KeyColumnTuple>>::value, "");
+  static_assert(K > 0, "");
+
+ public:
+  IncrementalTopK(const Index* index, const Stats* stats)
+      : index_(index),
+        stats_(stats),
+        built_(false),
+        num_entries_(0),
+        num_deleted_(0),
+        watermark_(std::numeric_limits<int>::min()) {}
+  DISALLOW_COPY_AND_ASSIGN(IncrementalTopK);
+  DEFAULT_MOVE_AND_ASSIGN(IncrementalTopK);
+
+  auto ToRange() {
+    Update();
+    return ranges::view::for_each(heaps_, [](const auto& pair) {
+      return ranges::yield_from(ranges::view::all(pair.second));
+    });
+  }
+
+  // The heaps are kept across calls to `ToRange`, so there's nothing to do.
+  void Reset() {}
+
+ private:
+  using Entry = typename Index::value_type;
+  using Heap = std::vector<const Entry*>;
+
+  struct EntryBefore {
+    bool operator()(const Entry* a, const Entry* b) const {
+      return detail::TopKBefore<O>()(a->first, b->first);
+    }
+  };
+
+  static int FirstLogicalTime(const Entry& entry) {
+    const auto& times = entry.second.logical_times_inserted;
+    CHECK(!times.empty());
+    return *times.begin();
+  }
+
+  void Update() {
+    const std::size_t num_deleted = stats_->NumDeletedTotal();
+    if (!built_ || num_deleted != num_deleted_) {
+      Rebuild();
+      return;
+    }
+    if (index_->size() == num_entries_) {
+      return;
+    }
+
+    std::size_t num_new = 0;
+    int watermark = watermark_;
+    for (const Entry& entry : *index_) {
+      const int time = FirstLogicalTime(entry);
+      if (time > watermark_) {
+        Push(&entry);
+        num_new++;
+      }
+      watermark = std::max(watermark, time);
+    }
+    if (num_entries_ + num_new != index_->size()) {
+      Rebuild();
+      return;
+    }
+    num_entries_ = index_->size();
+    watermark_ = watermark;
+  }
+
+  void Rebuild() {
+    heaps_.clear();
+    watermark_ = std::numeric_limits<int>::min();
+    for (const Entry& entry : *index_) {
+      Push(&entry);
+      watermark_ = std::max(watermark_, FirstLogicalTime(entry));
+    }
+    built_ = true;
+    num_entries_ = index_->size();
+    num_deleted_ = stats_->NumDeletedTotal();
+  }
+
+  void Push(const Entry* entry) {
+    Heap& heap = heaps_[KeyColumnTuple(TupleProject<Ks...>(entry->first))];
+    EntryBefore before;
+    if (heap.size() == K) {
+      if (!before(entry, heap.front())) {
+        return;
+      }
+      std::pop_heap(heap.begin(), heap.end(), before);
+      heap.back() = entry;
+    } else {
+      heap.push_back(entry);
+    }
+    std::push_heap(heap.begin(), heap.end(), before);
+  }
+
+  const Index* index_;
+  const Stats* stats_;
+  std::map<KeyColumnTuple, Heap> heaps_;
+
+  // Whether `heaps_` has been built, and the size of `index_`, the value of
+  // `stats_->NumDeletedTotal()`, and the latest first logical time of the
+  // entries of `index_` when it was last updated.
+  bool built_;
+  std::size_t num_entries_;
+  std::size_t num_deleted_;
+  int watermark_;
+};
+
+template <typename Keys, std::size_t O, std::size_t K, typename KeyColumnTuple,
+          typename Index, typename Stats>
+IncrementalTopK<Index, Stats, Keys, O, K, KeyColumnTuple>
+make_incremental_top_k(const Index* index, const Stats* stats) {
+  return IncrementalTopK<Index, Stats, Keys, O, K, KeyColumnTuple>(index,
+                                                                  stats);
+}
+
+}  // namespace physical
+}  // namespace ra
+}  // namespace fluent
+
+#endif  // RA_PHYSICAL_TOP_K_H_
@@ -0,0 +1,140 @@
+#include "ra/physical/top_k.h"
+
+#include <cstddef>
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "glog/logging.h"
+#include "range/v3/all.hpp"
+
+#include "collections/collection_stats.h"
+#include "collections/collection_tuple_ids.h"
+#include "ra/physical/iterable.h"
+
+namespace pra = fluent::ra::physical;
+namespace ra = fluent::ra;
+
+// These benchmarks compute the 10 tuples with the largest second column in
+// each of 16 groups of `state.range(0)` tuples `(group, score)`.
+
+namespace fluent {
+namespace {
+
+using Tuple = std::tuple<int, int>;
+using Index = std::map<Tuple, CollectionTupleIds>;
+using Stats = CollectionStats<int, int>;
+using KeyTuple = std::tuple<int>;
+using Keys = ra::Keys<0>;
+constexpr std::size_t kNumGroups = 16;
+constexpr std::size_t kK = 10;
+
+std::vector<Tuple> MakeTuples(std::size_t n) {
+  std::vector<Tuple> ts;
+  for (std::size_t i = 0; i < n; ++i) {
+    const int score = static_cast<int>((i * 2654435761u) % 100000);
+    ts.push_back(Tuple(static_cast<int>(i % kNumGroups), score));
+  }
+  return ts;
+}
+
+void Fill(const std::vector<Tuple>& ts, Index* index, Stats* stats) {
+  for (const Tuple& t : ts) {
+    auto pair = index->insert({t, CollectionTupleIds{0, {0}}});
+    stats->RecordMerge(t, pair.second);
+  }
+  stats->Tick(*index);
+}
+
+}  // namespace
+
+// Sort every tuple by group and score and keep the first `kK` of every group,
+// which is how a top-k had to be computed before there was a TopK.
+void SortBench(benchmark::State& state) {
+  const std::vector<Tuple> ts = MakeTuples(state.range(0));
+  while (state.KeepRunning()) {
+    std::vector<Tuple> sorted = ts;
+    std::sort(sorted.begin(), sorted.end(), [](const Tuple& a, const Tuple& b) {
+      return std::get<0>(a) != std::get<0>(b)
+                 ? std::get<0>(a) < std::get<0>(b)
+                 : std::get<1>(a) > std::get<1>(b);
+    });
+    std::size_t rank = 0;
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+      rank = (i > 0 && std::get<0>(sorted[i]) == std::get<0>(sorted[i - 1]))
+                 ? rank + 1
+                 : 0;
+      if (rank < kK) {
+        benchmark::DoNotOptimize(sorted[i]);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * ts.size());
+}
+BENCHMARK(SortBench)->Range(64, 64 << 8);
+
+void TopKBench(benchmark::State& state) {
+  const std::vector<Tuple> ts = MakeTuples(state.range(0));
+  auto top_k = pra::make_top_k<Keys, 1, kK, KeyTuple, Tuple>(
+      pra::make_iterable(&ts));
+  while (state.KeepRunning()) {
+    ranges::for_each(top_k.ToRange(),
+                     [](const Tuple& t) { benchmark::DoNotOptimize(t); });
+    top_k.Reset();
+  }
+  state.SetItemsProcessed(state.iterations() * ts.size());
+}
+BENCHMARK(TopKBench)->Range(64, 64 << 8);
+
+// An IncrementalTopK over an index that doesn't change between iterations, as
+// when a rule runs every tick over a table that rarely changes.
+void IncrementalTopKBench(benchmark::State& state) {
+  Index index;
+  Stats stats;
+  Fill(MakeTuples(state.range(0)), &index, &stats);
+  auto top_k = pra::make_incremental_top_k<Keys, 1, kK, KeyTuple>(&index,
+                                                                  &stats);
+  while (state.KeepRunning()) {
+    ranges::for_each(top_k.ToRange(), [](const auto* entry) {
+      benchmark::DoNotOptimize(entry);
+    });
+    top_k.Reset();
+  }
+  state.SetItemsProcessed(state.iterations() * index.size());
+}
+BENCHMARK(IncrementalTopKBench)->Range(64, 64 << 8);
+
+// An IncrementalTopK over an index into which one tuple is inserted, at a
+// later logical time, every iteration. The index grows as the benchmark runs.
+void IncrementalTopKInsertBench(benchmark::State& state) {
+  Index index;
+  Stats stats;
+  Fill(MakeTuples(state.range(0)), &index, &stats);
+  auto top_k = pra::make_incremental_top_k<Keys, 1, kK, KeyTuple>(&index,
+                                                                  &stats);
+  int time = 1;
+  while (state.KeepRunning()) {
+    const Tuple t(time % kNumGroups, -time);
+    auto pair = index.insert({t, CollectionTupleIds{0, {time}}});
+    stats.RecordMerge(t, pair.second);
+    time++;
+    ranges::for_each(top_k.ToRange(), [](const auto* entry) {
+      benchmark::DoNotOptimize(entry);
+    });
+    top_k.Reset();
+  }
+  state.SetItemsProcessed(state.iterations() * index.size());
+}
+BENCHMARK(IncrementalTopKInsertBench)->Range(64, 64 << 8);
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,182 @@
+#include "ra/physical/top_k.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "range/v3/all.hpp"
+
+#include "collections/collection_stats.h"
+#include "collections/collection_tuple_ids.h"
+#include "common/arena.h"
+#include "ra/keys.h"
+#include "ra/physical/iterable.h"
+#include "testing/test_util.h"
+
+namespace pra = fluent::ra::physical;
+
+namespace fluent {
+
+using StringInt = std::tuple<std::string, int>;
+
+TEST(TopK, EmptyInput) {
+  std::set<StringInt> xs;
+  using key_tuple = std::tuple<std::string>;
+  auto top_k = pra::make_top_k<ra::Keys<0>, 1, 2, key_tuple, StringInt>(
+      pra::make_iterable(&xs));
+  ExpectRngsUnorderedEqual(top_k.ToRange(), std::set<StringInt>{});
+}
+
+TEST(TopK, KeepsTheLargestKOfEveryGroup) {
+  std::set<StringInt> xs = {{"a", 1}, {"a", 5}, {"a", 3}, {"a", 4},
+                            {"b", 2}, {"c", 9}, {"c", 7}};
+  using key_tuple = std::tuple<std::string>;
+  auto top_k = pra::make_top_k<ra::Keys<0>, 1, 2, key_tuple, StringInt>(
+      pra::make_iterable(&xs));
+  std::set<StringInt> expected = {
+      {"a", 5}, {"a", 4}, {"b", 2}, {"c", 9}, {"c", 7}};
+  ExpectRngsUnorderedEqual(top_k.ToRange(), expected);
+}
+
+TEST(TopK, NoKeys) {
+  std::vector<std::tuple<int>> xs = {{3}, {1}, {4}, {1}, {5}, {9}, {2}, {6}};
+  using key_tuple = std::tuple<>;
+  using column_tuple = std::tuple<int>;
+  auto top_k = pra::make_top_k<ra::Keys<>, 0, 3, key_tuple, column_tuple>(
+      pra::make_iterable(&xs));
+  std::multiset<std::tuple<int>> expected = {{9}, {6}, {5}};
+  ExpectRngsUnorderedEqual(top_k.ToRange(), expected);
+}
+
+TEST(TopK, TiesAreBrokenByWholeTuples) {
+  using T = std::tuple<int, int, std::string>;
+  std::set<T> xs = {{0, 1, "a"}, {0, 1, "c"}, {0, 1, "b"}, {0, 0, "z"}};
+  using key_tuple = std::tuple<int>;
+  auto top_k = pra::make_top_k<ra::Keys<0>, 1, 2, key_tuple, T>(
+      pra::make_iterable(&xs));
+  std::set<T> expected = {{0, 1, "c"}, {0, 1, "b"}};
+  ExpectRngsUnorderedEqual(top_k.ToRange(), expected);
+}
+
+TEST(TopK, ResetAndReuse) {
+  Arena arena;
+  std::set<StringInt> xs = {{"a", 1}, {"a", 2}};
+  using key_tuple = std::tuple<std::string>;
+  auto top_k = pra::make_top_k<ra::Keys<0>, 1, 1, key_tuple, StringInt>(
+      pra::make_iterable(&xs), &arena);
+  std::set<StringInt> expected = {{"a", 2}};
+  ExpectRngsUnorderedEqual(top_k.ToRange(), expected);
+  top_k.Reset();
+  arena.Reset();
+
+  xs.insert({"a", 3});
+  expected = {{"a", 3}};
+  ExpectRngsUnorderedEqual(top_k.ToRange(), expected);
+}
+
+// A stand-in for a collection: an index and its statistics.
+class FakeCollection {
+ public:
+  using Index = std::map<StringInt, CollectionTupleIds>;
+
+  void Merge(const StringInt& t, int logical_time_inserted) {
+    auto pair = index_.insert({t, CollectionTupleIds{0, {}}});
+    pair.first->second.logical_times_inserted.insert(logical_time_inserted);
+    stats_.RecordMerge(t, pair.second);
+  }
+
+  void Delete(const StringInt& t) {
+    index_.erase(t);
+    stats_.RecordDelete();
+  }
+
+  void Tick() { stats_.Tick(index_); }
+
+  const Index& Get() const { return index_; }
+  const CollectionStats<std::string, int>& Stats() const { return stats_; }
+
+ private:
+  Index index_;
+  CollectionStats<std::string, int> stats_;
+};
+
+// The tuples of the entries produced by an IncrementalTopK.
+template <typename IncrementalTopK>
+std::set<StringInt> TopKTuples(IncrementalTopK* top_k) {
+  std::set<StringInt> tuples;
+  ranges::for_each(top_k->ToRange(), [&tuples](const auto* entry) {
+    tuples.insert(entry->first);
+  });
+  return tuples;
+}
+
+TEST(IncrementalTopK, InsertsAreIncremental) {
+  FakeCollection c;
+  using key_tuple = std::tuple<std::string>;
+  auto top_k = pra::make_incremental_top_k<ra::Keys<0>, 1, 2, key_tuple>(
+      &c.Get(), &c.Stats());
+  EXPECT_EQ(TopKTuples(&top_k), std::set<StringInt>{});
+
+  c.Merge({"a", 1}, 1);
+  c.Merge({"a", 2}, 1);
+  c.Merge({"b", 1}, 1);
+  std::set<StringInt> expected = {{"a", 1}, {"a", 2}, {"b", 1}};
+  EXPECT_EQ(TopKTuples(&top_k), expected);
+  top_k.Reset();
+
+  c.Tick();
+  c.Merge({"a", 3}, 2);
+  c.Merge({"a", 0}, 2);
+  expected = {{"a", 2}, {"a", 3}, {"b", 1}};
+  EXPECT_EQ(TopKTuples(&top_k), expected);
+
+  // Merging an existing tuple again changes nothing.
+  c.Merge({"a", 1}, 3);
+  EXPECT_EQ(TopKTuples(&top_k), expected);
+}
+
+TEST(IncrementalTopK, LateInsertWithAnEarlierTime) {
+  FakeCollection c;
+  using key_tuple = std::tuple<std::string>;
+  auto top_k = pra::make_incremental_top_k<ra::Keys<0>, 1, 1, key_tuple>(
+      &c.Get(), &c.Stats());
+  c.Merge({"a", 1}, 5);
+  std::set<StringInt> expected = {{"a", 1}};
+  EXPECT_EQ(TopKTuples(&top_k), expected);
+
+  // A tuple merged at an earlier logical time (e.g. by a deferred merge) isn't
+  // found by the incremental scan, so the heaps are rebuilt.
+  c.Merge({"a", 2}, 4);
+  expected = {{"a", 2}};
+  EXPECT_EQ(TopKTuples(&top_k), expected);
+}
+
+TEST(IncrementalTopK, DeletesRebuild) {
+  FakeCollection c;
+  using key_tuple = std::tuple<std::string>;
+  auto top_k = pra::make_incremental_top_k<ra::Keys<0>, 1, 1, key_tuple>(
+      &c.Get(), &c.Stats());
+  c.Merge({"a", 1}, 1);
+  c.Merge({"a", 2}, 1);
+  std::set<StringInt> expected = {{"a", 2}};
+  EXPECT_EQ(TopKTuples(&top_k), expected);
+
+  // A delete and an insert leave the index with the same size.
+  c.Delete({"a", 2});
+  c.Merge({"b", 1}, 0);
+  c.Tick();
+  expected = {{"a", 1}, {"b", 1}};
+  EXPECT_EQ(TopKTuples(&top_k), expected);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,300 @@
+#ifndef RA_PHYSICAL_WINDOW_H_
+#define RA_PHYSICAL_WINDOW_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <chrono>
+#include <initializer_list>
+#include <map>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "range/v3/all.hpp"
+
+#include "common/arena.h"
+#include "common/macros.h"
+#include "common/static_assert.h"
+#include "common/tuple_util.h"
+#include "common/type_traits.h"
+#include "ra/keys.h"
+#include "ra/physical/physical_ra.h"
+
+namespace fluent {
+namespace ra {
+namespace physical {
+namespace detail {
+
+struct GetAggregate {
+  template <typename AggregateImpl>
+  auto operator()(const AggregateImpl& agg) const {
+    return agg.Get();
+  }
+};
+
+template <typename... AggregateImpls, std::size_t... Is>
+void MergeAggregates(std::tuple<AggregateImpls...>* aggs,
+                     const std::tuple<AggregateImpls...>& other,
+                     std::index_sequence<Is...>) {
+  UNUSED(std::initializer_list<int>{
+      (std::get<Is>(*aggs).Merge(std::get<Is>(other)), 0)...});
+}
+
+// `FloorDiv(a, b)` is `a / b` rounded towards negative infinity.
+inline std::int64_t FloorDiv(std::int64_t a, std::int64_t b) {
+  return a / b - ((a % b != 0 && (a < 0) != (b < 0)) ? 1 : 0);
+}
+
+inline std::int64_t Gcd(std::int64_t a, std::int64_t b) {
+  while (b != 0) {
+    std::int64_t r = a % b;
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+}  // namespace detail
+
+// A Window aggregates the tuples of `events`, grouped by the key columns
+// `Ks`, over windows of time that are `size` long and start every `slide`.
+// Column `T` of an event is its time, and column `TriggerT` of a trigger is
+// the time at which windows are closed. See ra/logical/window.h.
+//
+// Time is cut into panes `gcd(size, slide)` long, so that every window is a
+// whole number of panes. Every event is folded into the aggregates of its
+// pane and group as soon as it's produced by `events`; events aren't
+// buffered. When `triggers` produces a trigger with time `t`, every window
+// that ended by `t` and hasn't been produced yet is computed by merging the
+// aggregates of its panes (see `Merge` in ra/aggregates.h), and the panes
+// that no later window covers are dropped. A Window thus keeps one set of
+// aggregates per pane and group no matter how many events it has seen, and
+// producing a window takes time proportional to its number of panes and
+// groups, not its number of events. Events that arrive after every window
+// that covers them has been produced are dropped.
+//
+// A Window produces the tuple `(k1, ..., kn, end, a1, ..., am, trigger)` for
+// every group of every window, where `end` is the time at which the window
+// ends and `trigger` is the trigger, converted to `TriggerTuple`, that closed
+// it. Unlike the panes, which are kept across calls to `ToRange`, the output
+// is allocated from `arena`, or from the heap if `arena` is null.
+template <typename Events, typename Triggers, typename Keys, std::size_t T,
+          std::size_t TriggerT, typename KeyColumnTuple,
+          typename AggregateImplTuple, typename TriggerTuple>
+class Window;
+
+template <typename Events, typename Triggers, std::size_t... Ks,
+          std::size_t T, std::size_t TriggerT, typename KeyColumnTuple,
+          typename AggregateImplTuple, typename TriggerTuple>
+class Window<Events, Triggers, Keys<Ks...>, T, TriggerT, KeyColumnTuple,
+             AggregateImplTuple, TriggerTuple> : public PhysicalRa {
+  static_assert(StaticAssert<std::is_base_of<PhysicalRa, Events>>::value, "");
+  static_assert(StaticAssert<std::is_base_of<PhysicalRa, Triggers>>::value,
+                "");
+  static_assert(StaticAssert<IsTuple<KeyColumnTuple>>::value, "");
+  static_assert(StaticAssert<IsTuple<AggregateImplTuple>>::value, "");
+  static_assert(StaticAssert<IsTuple<TriggerTuple>>::value, "");
+
+  using Time = typename std::decay<
+      typename std::tuple_element<TriggerT, TriggerTuple>::type>::type;
+  using Results = decltype(TupleMap(std::declval<const AggregateImplTuple&>(),
+                                    detail::GetAggregate()));
+  using Row = decltype(
+      std::tuple_cat(std::declval<KeyColumnTuple>(),
+                     std::declval<std::tuple<Time>>(), std::declval<Results>(),
+                     std::declval<std::tuple<TriggerTuple>>()));
+
+ public:
+  Window(Events events, Triggers triggers, std::chrono::microseconds size,
+         std::chrono::microseconds slide, Arena* arena = nullptr)
+      : events_(std::move(events)),
+        triggers_(std::move(triggers)),
+        pane_(PaneLength(size, slide)),
+        size_(size.count() / pane_),
+        slide_(slide.count() / pane_),
+        emitted_(false),
+        last_end_(0),
+        output_(ArenaAllocator<Row>(arena)) {}
+  DISALLOW_COPY_AND_ASSIGN(Window);
+  DEFAULT_MOVE_AND_ASSIGN(Window);
+
+  auto ToRange() {
+    ReleaseOutput();
+
+    ranges::for_each(events_.ToRange(), [this](const auto& t) {
+      const std::int64_t pane = PaneOf(std::get<T>(t));
+      if (emitted_ && pane < FirstLivePane()) {
+        return;
+      }
+      auto& group = panes_[pane][KeyColumnTuple(TupleProject<Ks...>(t))];
+      TupleIter(group, [this, &t](auto& agg) { this->UpdateAgg(&agg, t); });
+    });
+
+    ranges::for_each(triggers_.ToRange(), [this](const auto& trigger) {
+      this->Close(TriggerTuple(trigger));
+    });
+
+    return ranges::view::all(output_);
+  }
+
+  // Release the output of the last call to `ToRange`. The output is
+  // allocated from the arena, so `Reset` must be called before the arena is
+  // reset. The panes are kept.
+  void Reset() {
+    ReleaseOutput();
+    events_.Reset();
+    triggers_.Reset();
+  }
+
+  // The number of panes currently kept.
+  std::size_t NumPanes() const { return panes_.size(); }
+
+ private:
+  using Groups = std::map<KeyColumnTuple, AggregateImplTuple>;
+
+  // `clear` would keep the output's buffer, which is allocated from the arena
+  // and would dangle once the arena is reset, so we replace the output with
+  // an empty vector instead.
+  void ReleaseOutput() {
+    std::vector<Row, ArenaAllocator<Row>>(output_.get_allocator())
+        .swap(output_);
+  }
+
+  template <template <typename, typename> class AggregateImpl,  //
+            typename Columns, typename Ts, typename Tuple>
+  void UpdateAgg(AggregateImpl<Columns, Ts>* agg, const Tuple& t) {
+    agg->Update(TupleProjectBySizetList<Columns>(t));
+  }
+
+  static std::int64_t PaneLength(std::chrono::microseconds size,
+                                 std::chrono::microseconds slide) {
+    CHECK_GT(size.count(), 0);
+    CHECK_GT(slide.count(), 0);
+    return detail::Gcd(size.count(), slide.count());
+  }
+
+  std::int64_t PaneOf(const Time& time) const {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    const auto since_epoch = time.time_since_epoch();
+    return detail::FloorDiv(duration_cast<microseconds>(since_epoch).count(),
+                            pane_);
+  }
+
+  Time TimeOf(std::int64_t pane) const {
+    using duration = typename Time::duration;
+    return Time(std::chrono::duration_cast<duration>(
+        std::chrono::microseconds(pane * pane_)));
+  }
+
+  // The smallest multiple of `slide_` that is at least `pane`.
+  std::int64_t CeilToSlide(std::int64_t pane) const {
+    return -detail::FloorDiv(-pane, slide_) * slide_;
+  }
+
+  // The first pane of the first window that hasn't been produced yet. Only
+  // valid if `emitted_`.
+  std::int64_t FirstLivePane() const { return last_end_ + slide_ - size_; }
+
+  // Produce every window that ended by the time of `trigger`. A window that
+  // ends at (the start of) pane `e` covers the panes `[e - size_, e)`.
+  void Close(const TriggerTuple& trigger) {
+    const std::int64_t end =
+        detail::FloorDiv(PaneOf(std::get<TriggerT>(trigger)), slide_) * slide_;
+    if (emitted_ && end <= last_end_) {
+      return;
+    }
+
+    if (!panes_.empty()) {
+      // The first window that covers the oldest pane.
+      std::int64_t e = CeilToSlide(panes_.begin()->first + 1);
+      if (emitted_) {
+        e = std::max(e, last_end_ + slide_);
+      }
+      while (e <= end) {
+        auto pane = panes_.lower_bound(e - size_);
+        if (pane == panes_.end()) {
+          break;
+        }
+        if (pane->first >= e) {
+          // Skip the windows that cover no pane.
+          e = CeilToSlide(pane->first + 1);
+          continue;
+        }
+        Produce(e, trigger);
+        e += slide_;
+      }
+    }
+
+    emitted_ = true;
+    last_end_ = end;
+    panes_.erase(panes_.begin(), panes_.lower_bound(FirstLivePane()));
+  }
+
+  void Produce(std::int64_t end, const TriggerTuple& trigger) {
+    using indexes =
+        std::make_index_sequence<std::tuple_size<AggregateImplTuple>::value>;
+    Groups window;
+    auto first = panes_.lower_bound(end - size_);
+    auto last = panes_.lower_bound(end);
+    for (auto pane = first; pane != last; ++pane) {
+      for (const auto& group : pane->second) {
+        detail::MergeAggregates(&window[group.first], group.second,
+                                indexes());
+      }
+    }
+
+    const Time end_time = TimeOf(end);
+    for (const auto& group : window) {
+      output_.push_back(std::tuple_cat(
+          group.first, std::make_tuple(end_time),
+          TupleMap(group.second, detail::GetAggregate()),
+          std::make_tuple(trigger)));
+    }
+  }
+
+  Events events_;
+  Triggers triggers_;
+
+  // The length of a pane in microseconds, and the length of a window and the
+  // distance between the starts of consecutive windows in panes.
+  std::int64_t pane_;
+  std::int64_t size_;
+  std::int64_t slide_;
+
+  // The aggregates of every group of every pane, keyed by pane. Pane `p`
+  // covers the times `[p * pane_, (p + 1) * pane_)` since the epoch.
+  std::map<std::int64_t, Groups> panes_;
+
+  // Whether a window has been produced, and the end of the last one if so.
+  bool emitted_;
+  std::int64_t last_end_;
+
+  std::vector<Row, ArenaAllocator<Row>> output_;
+};
+
+template <typename Keys, std::size_t T, std::size_t TriggerT,
+          typename KeyColumnTuple, typename AggregateImplTuple,
+          typename TriggerTuple, typename Events, typename Triggers,
+          typename EventsDecayed = typename std::decay<Events>::type,
+          typename TriggersDecayed = typename std::decay<Triggers>::type>
+Window<EventsDecayed, TriggersDecayed, Keys, T, TriggerT, KeyColumnTuple,
+       AggregateImplTuple, TriggerTuple>
+make_window(Events&& events, Triggers&& triggers,
+            std::chrono::microseconds size, std::chrono::microseconds slide,
+            Arena* arena = nullptr) {
+  return Window<EventsDecayed, TriggersDecayed, Keys, T, TriggerT,
+                KeyColumnTuple, AggregateImplTuple, TriggerTuple>(
+      std::forward<Events>(events), std::forward<Triggers>(triggers), size,
+      slide, arena);
+}
+
+}  // namespace physical
+}  // namespace ra
+}  // namespace fluent
+
+#endif  // RA_PHYSICAL_WINDOW_H_
@@ -0,0 +1,103 @@
+#include "ra/physical/window.h"
+
+#include <chrono>
+#include <cstddef>
+
+#include <deque>
+#include <tuple>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "glog/logging.h"
+#include "range/v3/all.hpp"
+
+#include "common/sizet_list.h"
+#include "common/type_list.h"
+#include "ra/aggregates.h"
+#include "ra/keys.h"
+#include "ra/physical/group_by.h"
+#include "ra/physical/iterable.h"
+
+namespace pra = fluent::ra::physical;
+namespace ra = fluent::ra;
+
+// These benchmarks compute, every tick, the sum of the events of the last
+// `kWindowTicks` ticks in each of 16 groups. Every tick, `state.range(0)` new
+// `(group, time, value)` events arrive.
+
+namespace fluent {
+namespace {
+
+using Clock = std::chrono::system_clock;
+using Time = std::chrono::time_point<Clock>;
+using Event = std::tuple<int, Time, int>;
+using Trigger = std::tuple<std::size_t, Time>;
+using KeyTuple = std::tuple<int>;
+using AggImpls = std::tuple<ra::agg::SumImpl<SizetList<2>, TypeList<int>>>;
+constexpr int kNumGroups = 16;
+constexpr int kWindowTicks = 60;
+constexpr std::chrono::seconds kTick(1);
+
+std::vector<Event> MakeEvents(std::size_t n, int tick) {
+  std::vector<Event> events;
+  const Time time = Time(kTick * tick);
+  for (std::size_t i = 0; i < n; ++i) {
+    events.push_back(Event(static_cast<int>(i % kNumGroups), time, 1));
+  }
+  return events;
+}
+
+}  // namespace
+
+// Keep the events of the last `kWindowTicks` ticks and group all of them every
+// tick, which is how a window had to be computed before there was a Window.
+void RescanBench(benchmark::State& state) {
+  std::deque<Event> events;
+  int tick = 0;
+  while (state.KeepRunning()) {
+    for (const Event& e : MakeEvents(state.range(0), tick)) {
+      events.push_back(e);
+    }
+    const Time start = Time(kTick * (tick - kWindowTicks + 1));
+    while (!events.empty() && std::get<1>(events.front()) < start) {
+      events.pop_front();
+    }
+    tick++;
+
+    auto group_by = pra::make_group_by<ra::Keys<0>, KeyTuple, AggImpls>(
+        pra::make_iterable(&events));
+    ranges::for_each(group_by.ToRange(),
+                     [](const auto& t) { benchmark::DoNotOptimize(t); });
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(RescanBench)->Range(64, 64 << 6);
+
+void WindowBench(benchmark::State& state) {
+  std::vector<Event> events;
+  std::vector<Trigger> triggers;
+  auto window = pra::make_window<ra::Keys<0>, 1, 1, KeyTuple, AggImpls,
+                                 Trigger>(
+      pra::make_iterable(&events), pra::make_iterable(&triggers),
+      kTick * kWindowTicks, kTick);
+  int tick = 0;
+  while (state.KeepRunning()) {
+    events = MakeEvents(state.range(0), tick);
+    tick++;
+    triggers = {Trigger(tick, Time(kTick * tick))};
+    ranges::for_each(window.ToRange(),
+                     [](const auto& t) { benchmark::DoNotOptimize(t); });
+    window.Reset();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(WindowBench)->Range(64, 64 << 6);
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,204 @@
+#include "ra/physical/window.h"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "range/v3/all.hpp"
+
+#include "common/arena.h"
+#include "common/sizet_list.h"
+#include "common/type_list.h"
+#include "ra/aggregates.h"
+#include "ra/keys.h"
+#include "ra/physical/iterable.h"
+
+namespace pra = fluent::ra::physical;
+
+namespace fluent {
+namespace {
+
+using Clock = std::chrono::system_clock;
+using Time = std::chrono::time_point<Clock>;
+using std::chrono::seconds;
+
+Time At(int s) { return Time(seconds(s)); }
+
+// Events are `(key, time, value)` and triggers are `(id, time)`.
+using Event = std::tuple<std::string, Time, int>;
+using Trigger = std::tuple<int, Time>;
+using KeyTuple = std::tuple<std::string>;
+using AggImpls =
+    std::tuple<ra::agg::SumImpl<SizetList<2>, TypeList<int>>,
+               ra::agg::CountImpl<SizetList<2>, TypeList<int>>>;
+using Row = std::tuple<std::string, Time, int, std::size_t, Trigger>;
+
+template <typename Window>
+std::vector<Row> WindowRows(Window* window) {
+  std::vector<Row> rows;
+  ranges::for_each(window->ToRange(),
+                   [&rows](const auto& row) { rows.push_back(row); });
+  window->Reset();
+  return rows;
+}
+
+template <typename Events, typename Triggers>
+auto MakeWindow(Events* events, Triggers* triggers, seconds size,
+                seconds slide) {
+  return pra::make_window<ra::Keys<0>, 1, 1, KeyTuple, AggImpls, Trigger>(
+      pra::make_iterable(events), pra::make_iterable(triggers), size, slide);
+}
+
+}  // namespace
+
+TEST(Window, NoTriggersNoOutput) {
+  std::vector<Event> events = {{"a", At(1), 1}, {"b", At(2), 2}};
+  std::vector<Trigger> triggers;
+  auto window = MakeWindow(&events, &triggers, seconds(10), seconds(10));
+  EXPECT_EQ(WindowRows(&window), std::vector<Row>{});
+  EXPECT_EQ(window.NumPanes(), 1u);
+}
+
+TEST(Window, Tumbling) {
+  std::vector<Event> events = {
+      {"a", At(1), 1}, {"a", At(9), 2}, {"b", At(5), 3}, {"a", At(12), 4}};
+  std::vector<Trigger> triggers = {Trigger(0, At(10))};
+  auto window = MakeWindow(&events, &triggers, seconds(10), seconds(10));
+
+  std::vector<Row> expected = {
+      Row("a", At(10), 3, 2, Trigger(0, At(10))),
+      Row("b", At(10), 3, 1, Trigger(0, At(10))),
+  };
+  EXPECT_EQ(WindowRows(&window), expected);
+  // Only the pane that holds the event at time 12 is left.
+  EXPECT_EQ(window.NumPanes(), 1u);
+
+  // Events are seen only once, so the child can produce new events only.
+  events = {{"a", At(15), 5}};
+  triggers = {Trigger(1, At(19))};
+  EXPECT_EQ(WindowRows(&window), std::vector<Row>{});
+
+  events = {};
+  triggers = {Trigger(2, At(21))};
+  expected = {Row("a", At(20), 9, 2, Trigger(2, At(21)))};
+  EXPECT_EQ(WindowRows(&window), expected);
+  EXPECT_EQ(window.NumPanes(), 0u);
+}
+
+TEST(Window, Sliding) {
+  // Windows of 10 seconds every 5 seconds.
+  std::vector<Event> events = {
+      {"a", At(1), 1}, {"a", At(6), 2}, {"a", At(11), 4}, {"a", At(16), 8}};
+  std::vector<Trigger> triggers = {Trigger(0, At(20))};
+  auto window = MakeWindow(&events, &triggers, seconds(10), seconds(5));
+
+  // Windows [-5, 5), [0, 10), [5, 15), and [10, 20).
+  std::vector<Row> expected = {
+      Row("a", At(5), 1, 1, Trigger(0, At(20))),
+      Row("a", At(10), 3, 2, Trigger(0, At(20))),
+      Row("a", At(15), 6, 2, Trigger(0, At(20))),
+      Row("a", At(20), 12, 2, Trigger(0, At(20))),
+  };
+  EXPECT_EQ(WindowRows(&window), expected);
+  // Only the pane [15, 20) is covered by the next window, [15, 25).
+  EXPECT_EQ(window.NumPanes(), 1u);
+
+  events = {{"a", At(21), 16}};
+  triggers = {Trigger(1, At(25))};
+  expected = {Row("a", At(25), 24, 2, Trigger(1, At(25)))};
+  EXPECT_EQ(WindowRows(&window), expected);
+}
+
+TEST(Window, LateEventsAreDropped) {
+  std::vector<Event> events = {{"a", At(1), 1}};
+  std::vector<Trigger> triggers = {Trigger(0, At(10))};
+  auto window = MakeWindow(&events, &triggers, seconds(10), seconds(10));
+  std::vector<Row> expected = {Row("a", At(10), 1, 1, Trigger(0, At(10)))};
+  EXPECT_EQ(WindowRows(&window), expected);
+
+  events = {{"a", At(2), 2}, {"a", At(13), 3}};
+  triggers = {Trigger(1, At(20))};
+  expected = {Row("a", At(20), 3, 1, Trigger(1, At(20)))};
+  EXPECT_EQ(WindowRows(&window), expected);
+}
+
+TEST(Window, EmptyWindowsAreSkipped) {
+  std::vector<Event> events = {{"a", At(1), 1}, {"a", At(1000), 2}};
+  std::vector<Trigger> triggers = {Trigger(0, At(1001))};
+  auto window = MakeWindow(&events, &triggers, seconds(2), seconds(1));
+  std::vector<Row> expected = {
+      Row("a", At(2), 1, 1, Trigger(0, At(1001))),
+      Row("a", At(3), 1, 1, Trigger(0, At(1001))),
+      Row("a", At(1001), 2, 1, Trigger(0, At(1001))),
+  };
+  EXPECT_EQ(WindowRows(&window), expected);
+}
+
+TEST(Window, StaleTriggersAreIgnored) {
+  std::vector<Event> events = {{"a", At(1), 1}};
+  std::vector<Trigger> triggers = {Trigger(0, At(10)), Trigger(1, At(5))};
+  auto window = MakeWindow(&events, &triggers, seconds(10), seconds(10));
+  std::vector<Row> expected = {Row("a", At(10), 1, 1, Trigger(0, At(10)))};
+  EXPECT_EQ(WindowRows(&window), expected);
+}
+
+TEST(Window, OutputFromArena) {
+  Arena arena;
+  std::vector<Event> events = {{"a", At(1), 1}};
+  std::vector<Trigger> triggers = {Trigger(0, At(10))};
+  auto window = pra::make_window<ra::Keys<0>, 1, 1, KeyTuple, AggImpls,
+                                 Trigger>(pra::make_iterable(&events),
+                                          pra::make_iterable(&triggers),
+                                          seconds(10), seconds(10), &arena);
+  std::vector<Row> expected = {Row("a", At(10), 1, 1, Trigger(0, At(10)))};
+  EXPECT_EQ(WindowRows(&window), expected);
+  arena.Reset();
+
+  events = {{"a", At(11), 2}};
+  triggers = {Trigger(1, At(20))};
+  expected = {Row("a", At(20), 2, 1, Trigger(1, At(20)))};
+  EXPECT_EQ(WindowRows(&window), expected);
+}
+
+TEST(Window, OutputSurvivesArenaReuse) {
+  Arena arena;
+  std::vector<Event> events = {{"a", At(1), 1}, {"b", At(2), 2}};
+  std::vector<Trigger> triggers = {Trigger(0, At(10))};
+  auto window = pra::make_window<ra::Keys<0>, 1, 1, KeyTuple, AggImpls,
+                                 Trigger>(pra::make_iterable(&events),
+                                          pra::make_iterable(&triggers),
+                                          seconds(10), seconds(10), &arena);
+  std::vector<Row> expected = {Row("a", At(10), 1, 1, Trigger(0, At(10))),
+                               Row("b", At(10), 2, 1, Trigger(0, At(10)))};
+  EXPECT_EQ(WindowRows(&window), expected);
+  arena.Reset();
+
+  // Hand the memory that backed the last output to someone else, and have
+  // them scribble over it while the window's next output is still in use.
+  const std::size_t size = 64 * sizeof(Row);
+  void* other = arena.Allocate(size, alignof(Row));
+
+  events = {{"a", At(11), 3}, {"b", At(12), 4}};
+  triggers = {Trigger(1, At(20))};
+  auto output = window.ToRange();
+  std::memset(other, 0, size);
+  std::vector<Row> rows;
+  ranges::for_each(output, [&rows](const auto& row) { rows.push_back(row); });
+  window.Reset();
+
+  expected = {Row("a", At(20), 3, 1, Trigger(1, At(20))),
+              Row("b", At(20), 4, 1, Trigger(1, At(20)))};
+  EXPECT_EQ(rows, expected);
+}
+
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,141 @@
+#include "zmq_util/event_loop.h"
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "glog/logging.h"
+
+namespace fluent {
+namespace zmq_util {
+
+namespace {
+
+// Returns whether `socket` has a message to be read.
+bool SocketReadable(zmq::socket_t* socket) {
+  int events = 0;
+  std::size_t events_size = sizeof(events);
+  socket->getsockopt(ZMQ_EVENTS, static_cast<void*>(&events), &events_size);
+  return events & ZMQ_POLLIN;
+}
+
+}  // namespace
+
+void EventLoop::AppendReadySockets(std::vector<std::size_t>* ready) {
+  for (std::size_t id = 0; id < entries_.size(); ++id) {
+    if (entries_[id].socket != nullptr && SocketReadable(entries_[id].socket)) {
+      ready->push_back(id);
+    }
+  }
+}
+
+#ifdef __linux__
+
+EventLoop::EventLoop()
+    : epoll_fd_(epoll_create1(EPOLL_CLOEXEC)), events_(1) {
+  PCHECK(epoll_fd_ != -1) << "epoll_create1 failed";
+}
+
+EventLoop::~EventLoop() { close(epoll_fd_); }
+
+std::size_t EventLoop::AddSocket(zmq::socket_t* socket) {
+  CHECK_NOTNULL(socket);
+  int fd = -1;
+  std::size_t fd_size = sizeof(fd);
+  socket->getsockopt(ZMQ_FD, static_cast<void*>(&fd), &fd_size);
+
+  const std::size_t id = AddFd(fd);
+  entries_[id].socket = socket;
+  return id;
+}
+
+std::size_t EventLoop::AddFd(int fd) {
+  const std::size_t id = entries_.size();
+  entries_.push_back(Entry{nullptr, fd});
+  events_.resize(entries_.size());
+
+  struct epoll_event event;
+  std::memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN;
+  event.data.u64 = id;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == -1) {
+    // epoll refuses to wait on regular files, which are always readable.
+    PCHECK(errno == EPERM) << "epoll_ctl failed on fd " << fd;
+    always_ready_.push_back(id);
+  }
+  return id;
+}
+
+void EventLoop::Wait(long timeout, std::vector<std::size_t>* ready) {
+  ready->clear();
+
+  // A socket's `ZMQ_FD` is only signalled when its state changes, so a socket
+  // with unread messages may not have a readable `ZMQ_FD`. If any socket (or
+  // regular file) is already readable, we don't block.
+  AppendReadySockets(ready);
+  if (ready->size() != 0 || always_ready_.size() != 0) {
+    timeout = 0;
+  }
+
+  const int num_events =
+      epoll_wait(epoll_fd_, events_.data(), static_cast<int>(events_.size()),
+                 static_cast<int>(timeout));
+  PCHECK(num_events != -1 || errno == EINTR) << "epoll_wait failed";
+
+  for (int i = 0; i < num_events; ++i) {
+    const std::size_t id = events_[i].data.u64;
+    if (entries_[id].socket == nullptr) {
+      ready->push_back(id);
+    }
+  }
+  if (num_events > 0) {
+    AppendReadySockets(ready);
+  }
+  ready->insert(ready->end(), always_ready_.begin(), always_ready_.end());
+
+  std::sort(ready->begin(), ready->end());
+  ready->erase(std::unique(ready->begin(), ready->end()), ready->end());
+}
+
+#else
+
+EventLoop::EventLoop() {}
+
+EventLoop::~EventLoop() {}
+
+std::size_t EventLoop::AddSocket(zmq::socket_t* socket) {
+  CHECK_NOTNULL(socket);
+  entries_.push_back(Entry{socket, -1});
+  pollitems_.push_back(
+      {static_cast<void*>(*socket), /* fd */ 0, ZMQ_POLLIN, /* revents */ 0});
+  return entries_.size() - 1;
+}
+
+std::size_t EventLoop::AddFd(int fd) {
+  entries_.push_back(Entry{nullptr, fd});
+  pollitems_.push_back({/* socket */ nullptr, fd, ZMQ_POLLIN, /* revents */ 0});
+  return entries_.size() - 1;
+}
+
+void EventLoop::Wait(long timeout, std::vector<std::size_t>* ready) {
+  ready->clear();
+  for (zmq::pollitem_t& pollitem : pollitems_) {
+    pollitem.revents = 0;
+  }
+  zmq::poll(pollitems_.data(), pollitems_.size(), timeout);
+  for (std::size_t id = 0; id < pollitems_.size(); ++id) {
+    if (pollitems_[id].revents & ZMQ_POLLIN) {
+      ready->push_back(id);
+    }
+  }
+}
+
+#endif
+
+}  // namespace zmq_util
+}  // namespace fluent
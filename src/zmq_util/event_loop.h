@@ -0,0 +1,92 @@
+#ifndef ZMQ_UTIL_EVENT_LOOP_H_
+#define ZMQ_UTIL_EVENT_LOOP_H_
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+#include <cstddef>
+
+#include <vector>
+
+#include "zmq.hpp"
+
+#include "common/macros.h"
+
+namespace fluent {
+namespace zmq_util {
+
+// An EventLoop waits for any of a fixed set of ZeroMQ sockets and file
+// descriptors to become readable. Sockets and file descriptors are registered
+// once, and each is assigned an id equal to the number of sockets and file
+// descriptors registered before it. Then, every call to `Wait` blocks until at
+// least one of them is readable and reports the ids of those that are:
+//
+//   zmq::socket_t socket(context, ZMQ_PULL);
+//   EventLoop loop;
+//   std::size_t socket_id = loop.AddSocket(&socket); // 0
+//   std::size_t stdin_id = loop.AddFd(0);            // 1
+//   std::vector<std::size_t> ready;
+//   loop.Wait(-1, &ready); // e.g. {0}, {1}, or {0, 1}
+//
+// On Linux, an EventLoop is backed by an epoll instance, so the cost of a call
+// to `Wait` does not depend on how many sockets and file descriptors are
+// registered. ZeroMQ sockets are registered using their `ZMQ_FD` file
+// descriptor. `ZMQ_FD` is edge-triggered and only signals that the socket's
+// state may have changed, so `Wait` also checks every socket's `ZMQ_EVENTS`
+// before and after waiting [1]. On other platforms, an EventLoop is backed by
+// `zmq::poll` over a poll set that is built once, at registration time.
+//
+// [1]: http://api.zeromq.org/4-2:zmq-getsockopt
+class EventLoop {
+ public:
+  EventLoop();
+  ~EventLoop();
+  DISALLOW_COPY_AND_ASSIGN(EventLoop);
+
+  // Register a socket and return its id. `socket` must outlive the EventLoop.
+  std::size_t AddSocket(zmq::socket_t* socket);
+
+  // Register a file descriptor and return its id. `fd` must remain open for
+  // the lifetime of the EventLoop.
+  std::size_t AddFd(int fd);
+
+  // Wait at most `timeout` milliseconds (or forever if `timeout` is -1) for a
+  // registered socket or file descriptor to become readable. The ids of the
+  // readable ones are stored in `ready` in increasing order. If the timeout
+  // expires first, `ready` is empty.
+  void Wait(long timeout, std::vector<std::size_t>* ready);
+
+ private:
+  struct Entry {
+    // `socket` is null for file descriptors.
+    zmq::socket_t* socket;
+    int fd;
+  };
+
+  // Append the ids of the sockets that have a message to be read to `ready`.
+  void AppendReadySockets(std::vector<std::size_t>* ready);
+
+  std::vector<Entry> entries_;
+
+  // The ids of file descriptors that cannot be waited on because they refer
+  // to regular files (e.g. stdin redirected from a file). Regular files are
+  // always readable.
+  std::vector<std::size_t> always_ready_;
+
+#ifdef __linux__
+  int epoll_fd_;
+
+  // The buffer into which `epoll_wait` stores events. It has room for an
+  // event per registered socket and file descriptor (and at least one), and
+  // is resized at registration time rather than allocated on every `Wait`.
+  std::vector<struct epoll_event> events_;
+#else
+  std::vector<zmq::pollitem_t> pollitems_;
+#endif
+};
+
+}  // namespace zmq_util
+}  // namespace fluent
+
+#endif  // ZMQ_UTIL_EVENT_LOOP_H_
@@ -0,0 +1,140 @@
+#include "zmq_util/event_loop.h"
+
+#include <unistd.h>
+
+#include <cstddef>
+
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "zmq.hpp"
+
+#include "zmq_util/zmq_util.h"
+
+namespace fluent {
+namespace zmq_util {
+
+using ids = std::vector<std::size_t>;
+
+TEST(EventLoop, EmptyLoop) {
+  EventLoop loop;
+  ids ready = {42};
+  loop.Wait(0, &ready);
+  EXPECT_EQ(ready, ids({}));
+}
+
+TEST(EventLoop, Sockets) {
+  zmq::context_t context(1);
+  zmq::socket_t a(context, ZMQ_PULL);
+  zmq::socket_t b(context, ZMQ_PULL);
+  zmq::socket_t to_a(context, ZMQ_PUSH);
+  zmq::socket_t to_b(context, ZMQ_PUSH);
+  a.bind("inproc://a");
+  b.bind("inproc://b");
+  to_a.connect("inproc://a");
+  to_b.connect("inproc://b");
+
+  EventLoop loop;
+  EXPECT_EQ(loop.AddSocket(&a), static_cast<std::size_t>(0));
+  EXPECT_EQ(loop.AddSocket(&b), static_cast<std::size_t>(1));
+
+  ids ready;
+  loop.Wait(0, &ready);
+  EXPECT_EQ(ready, ids({}));
+
+  send_string("foo", &to_b);
+  loop.Wait(-1, &ready);
+  EXPECT_EQ(ready, ids({1}));
+  EXPECT_EQ("foo", recv_string(&b));
+
+  // A socket with more than one pending message stays ready until all of its
+  // messages have been read, even though its ZMQ_FD is edge-triggered.
+  send_string("bar", &to_a);
+  send_string("baz", &to_a);
+  send_string("qux", &to_b);
+  loop.Wait(-1, &ready);
+  EXPECT_EQ(ready, ids({0, 1}));
+  EXPECT_EQ("bar", recv_string(&a));
+  EXPECT_EQ("qux", recv_string(&b));
+  loop.Wait(-1, &ready);
+  EXPECT_EQ(ready, ids({0}));
+  EXPECT_EQ("baz", recv_string(&a));
+  loop.Wait(0, &ready);
+  EXPECT_EQ(ready, ids({}));
+}
+
+TEST(EventLoop, ManyFds) {
+  const std::size_t num_pipes = 8;
+  std::vector<int> read_fds;
+  std::vector<int> write_fds;
+  EventLoop loop;
+  for (std::size_t i = 0; i < num_pipes; ++i) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    read_fds.push_back(fds[0]);
+    write_fds.push_back(fds[1]);
+    EXPECT_EQ(loop.AddFd(fds[0]), i);
+  }
+
+  // Every pipe is readable at once, and `Wait` reports all of them.
+  ids expected;
+  char c = 'x';
+  for (std::size_t i = 0; i < num_pipes; ++i) {
+    ASSERT_EQ(write(write_fds[i], &c, 1), 1);
+    expected.push_back(i);
+  }
+  ids ready;
+  loop.Wait(-1, &ready);
+  EXPECT_EQ(ready, expected);
+
+  for (std::size_t i = 0; i < num_pipes; ++i) {
+    ASSERT_EQ(read(read_fds[i], &c, 1), 1);
+    close(read_fds[i]);
+    close(write_fds[i]);
+  }
+}
+
+TEST(EventLoop, SocketsAndFds) {
+  zmq::context_t context(1);
+  zmq::socket_t socket(context, ZMQ_PULL);
+  zmq::socket_t to_socket(context, ZMQ_PUSH);
+  socket.bind("inproc://socket");
+  to_socket.connect("inproc://socket");
+
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+
+  EventLoop loop;
+  EXPECT_EQ(loop.AddFd(fds[0]), static_cast<std::size_t>(0));
+  EXPECT_EQ(loop.AddSocket(&socket), static_cast<std::size_t>(1));
+
+  ids ready;
+  loop.Wait(0, &ready);
+  EXPECT_EQ(ready, ids({}));
+
+  char c = 'x';
+  ASSERT_EQ(write(fds[1], &c, 1), 1);
+  loop.Wait(-1, &ready);
+  EXPECT_EQ(ready, ids({0}));
+  ASSERT_EQ(read(fds[0], &c, 1), 1);
+  loop.Wait(0, &ready);
+  EXPECT_EQ(ready, ids({}));
+
+  send_string("foo", &to_socket);
+  loop.Wait(-1, &ready);
+  EXPECT_EQ(ready, ids({1}));
+  EXPECT_EQ("foo", recv_string(&socket));
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+}  // namespace zmq_util
+}  // namespace fluent
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
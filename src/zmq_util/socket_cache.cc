@@ -2,6 +2,8 @@
 
 #include <utility>
 
+#include "zmq_util/zmq_util.h"
+
 namespace fluent {
 namespace zmq_util {
 
@@ -20,5 +22,10 @@ zmq::socket_t& SocketCache::operator[](const std::string& addr) {
   return At(addr);
 }
 
+void SocketCache::Send(const std::string& address,
+                       std::vector<zmq::message_t> msgs) {
+  send_msgs(std::move(msgs), &At(address));
+}
+
 }  // namespace zmq_util
 }  // namespace fluent
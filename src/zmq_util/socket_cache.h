@@ -3,9 +3,12 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "zmq.hpp"
 
+#include "zmq_util/transport.h"
+
 namespace fluent {
 namespace zmq_util {
 
@@ -25,11 +28,16 @@ namespace zmq_util {
 //   zmq::socket_t& the_same_a_as_before = cache["inproc://a"];
 //   // cache.At("inproc://a") is 100% equivalent to cache["inproc://a"].
 //   zmq::socket_t& another_a = cache.At("inproc://a");
-class SocketCache {
+//
+// A SocketCache is also a Transport: `cache.Send(address, msgs)` sends `msgs`
+// over `cache[address]`.
+class SocketCache : public Transport {
  public:
   explicit SocketCache(zmq::context_t* context) : context_(context) {}
   zmq::socket_t& At(const std::string& addr);
   zmq::socket_t& operator[](const std::string& addr);
+  void Send(const std::string& address,
+            std::vector<zmq::message_t> msgs) override;
 
  private:
   zmq::context_t* context_;
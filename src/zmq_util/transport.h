@@ -0,0 +1,29 @@
+#ifndef ZMQ_UTIL_TRANSPORT_H_
+#define ZMQ_UTIL_TRANSPORT_H_
+
+#include <string>
+#include <vector>
+
+#include "zmq.hpp"
+
+namespace fluent {
+namespace zmq_util {
+
+// A Transport sends multipart messages to addresses. Channels send their
+// batches with a Transport (see collections/channel.h). Normally, it's a
+// SocketCache, which sends each message over a ZeroMQ PUSH socket connected to
+// the message's address, but it can be anything that moves messages around,
+// like the in-memory network of a simulation (see fluent/simulation.h).
+class Transport {
+ public:
+  virtual ~Transport() {}
+
+  // Send the multipart message `msgs` to `address`.
+  virtual void Send(const std::string& address,
+                    std::vector<zmq::message_t> msgs) = 0;
+};
+
+}  // namespace zmq_util
+}  // namespace fluent
+
+#endif  // ZMQ_UTIL_TRANSPORT_H_
@@ -18,6 +18,37 @@ zmq::message_t string_to_message(const std::string& s) {
   return msg;
 }
 
+zmq::message_t uint64_to_message(std::uint64_t x) {
+  zmq::message_t msg(sizeof(x));
+  unsigned char* data = static_cast<unsigned char*>(msg.data());
+  for (std::size_t i = 0; i < sizeof(x); ++i) {
+    data[i] = static_cast<unsigned char>(x >> (8 * i));
+  }
+  return msg;
+}
+
+namespace {
+
+std::uint64_t bytes_to_uint64(const unsigned char* data) {
+  std::uint64_t x = 0;
+  for (std::size_t i = 0; i < sizeof(x); ++i) {
+    x |= static_cast<std::uint64_t>(data[i]) << (8 * i);
+  }
+  return x;
+}
+
+}  // namespace
+
+std::uint64_t message_to_uint64(const zmq::message_t& message) {
+  CHECK_EQ(message.size(), sizeof(std::uint64_t));
+  return bytes_to_uint64(static_cast<const unsigned char*>(message.data()));
+}
+
+std::uint64_t string_to_uint64(const std::string& s) {
+  CHECK_EQ(s.size(), sizeof(std::uint64_t));
+  return bytes_to_uint64(reinterpret_cast<const unsigned char*>(s.data()));
+}
+
 void send_string(const std::string& s, zmq::socket_t* socket) {
   CHECK_NOTNULL(socket);
   socket->send(string_to_message(s));
@@ -1,6 +1,7 @@
 #ifndef ZMQ_UTIL_ZMQ_UTIL_H_
 #define ZMQ_UTIL_ZMQ_UTIL_H_
 
+#include <cstdint>
 #include <cstring>
 #include <ostream>
 #include <string>
@@ -18,6 +19,18 @@ std::string message_to_string(const zmq::message_t& message);
 // Converts a string into a `zmq::message_t`.
 zmq::message_t string_to_message(const std::string& s);
 
+// Converts a 64-bit integer into an 8-byte little-endian `zmq::message_t`.
+zmq::message_t uint64_to_message(std::uint64_t x);
+
+// Converts an 8-byte little-endian `zmq::message_t` into a 64-bit integer.
+// `message` must be exactly 8 bytes long.
+std::uint64_t message_to_uint64(const zmq::message_t& message);
+
+// Converts an 8-byte little-endian string (e.g. the contents of a message
+// produced by `uint64_to_message`) into a 64-bit integer. `s` must be exactly
+// 8 bytes long.
+std::uint64_t string_to_uint64(const std::string& s);
+
 // `send` a string over the socket.
 void send_string(const std::string& s, zmq::socket_t* socket);
 